@@ -7,6 +7,31 @@
 -- Module Name: Envelope Scale
 -- Description: 
 --   Applies an amplitude envelope to each played note.
+--
+--   Keeps a bitmap of active note slots, set while a note is keyed or its
+--   envelope is still sounding. Idle slots skip the envelope accumulator
+--   write, and the bitmap lets the earlier stages gate idle slots too.
+--
+--   The attack, decay, sustain and release amounts come from the timbre bank
+--   selected for each note.
+--
+--   A slot held by a pedal stays out of release after its key goes up, as
+--   if the key were still down. The sustain pedal of a timbre holds all its
+--   slots, the sostenuto pedal only the slots keyed when it went down; the
+--   sostenuto pedal state each slot last saw is updated on every pass, so
+--   the slots keyed on its down edge are caught within the frame.
+--
+--   Envelope states change at the start of a waveform cycle of the slot,
+--   except the release of a slot a pedal stops holding, which is taken on
+--   that pass. Every slot a pedal held is in release within a frame of the
+--   pedal going up, rather than spread over the notes' periods.
+--
+-- Revision:
+-- 10/19/2026 agt - active note bitmap and idle slot gating
+-- 10/19/2026 agt - per-note timbre select
+-- 10/19/2026 agt - sustain and sostenuto hold bitmap
+-- 10/19/2026 agt - cycle start and adsr state out for the pipeline trace
+-- 10/19/2026 agt - pedal-up release taken on the slot's next pass
 -- 
 ----------------------------------------------------------------------------------
 
@@ -27,10 +52,13 @@ entity envelope_scale is
   port (
     clk             : in  std_logic;
     rst             : in  std_logic;
-    attack_amt      : in  unsigned(ADSR_WIDTH-1 downto 0);
-    decay_amt       : in  unsigned(ADSR_WIDTH-1 downto 0);
-    sustain_amt     : in  unsigned(ADSR_WIDTH-1 downto 0);
-    release_amt     : in  unsigned(ADSR_WIDTH-1 downto 0);
+    attack_amt      : in  t_adsr;
+    decay_amt       : in  t_adsr;
+    sustain_amt     : in  t_adsr;
+    release_amt     : in  t_adsr;
+    note_timbres    : in  t_note_timbre;
+    sustain_pedals  : in  t_timbre_bits;
+    sostenuto_pedals: in  t_timbre_bits;
     -- pipeline in
     note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
     note_amp_in     : in  unsigned(NOTE_GAIN_WIDTH-1 downto 0);
@@ -38,7 +66,12 @@ entity envelope_scale is
     cycle_start_in  : in  std_logic;
     -- pipeline out
     note_index_out  : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
-    note_out        : out signed(DATA_WIDTH-1 downto 0)
+    note_out        : out signed(DATA_WIDTH-1 downto 0);
+    cycle_start_out : out std_logic;
+    -- adsr state of the slot out, in t_adsr_state order
+    adsr_state_out  : out unsigned(WIDTH_ADSR_STATE-1 downto 0);
+    -- note status
+    active_notes    : out t_note_bits
   );
 end entity;
 
@@ -94,20 +127,58 @@ architecture rtl of envelope_scale is
           sustain_level_d,
           sustain_level_q    : unsigned(ACC_WIDTH-1 downto 0);
 
+  -- timbre bank of the current note
+  signal  timbre        : integer range 0 to NUM_TIMBRES-1;
+  signal  timbre_q      : integer range 0 to NUM_TIMBRES-1;
+
+  -- pedal hold, slots caught by the sostenuto pedal and the sostenuto
+  -- pedal state each slot last saw, and the slots a pedal held last pass
+  signal  sost_held_q,
+          sost_seen_q,
+          held_q        : t_note_bits;
+  signal  slot_hold     : std_logic;
+  signal  pedal_release : std_logic;
+  signal  key_amp       : unsigned(WIDTH_NOTE_GAIN-1 downto 0);
+
   -- states
   type    t_adsr_state  is (E_START, E_ATTACK, E_DECAY, E_SUSTAIN, E_RELEASE);
   type    t_adsr_states is array (I_LOWEST_NOTE to I_HIGHEST_NOTE) of t_adsr_state;
   signal  adsr_state_d  : t_adsr_state;
   signal  adsr_states_q : t_adsr_states;
 
+  -- active note slots
+  signal  active_notes_q : t_note_bits;
+  signal  slot_idle      : std_logic;
+
 begin
 
   -- output assignments
-  note_index_out <= note_index_q;
-  note_out       <= note_q;
+  note_index_out  <= note_index_q;
+  note_out        <= note_q;
+  cycle_start_out <= cycle_start_q;
+  adsr_state_out  <= to_unsigned(t_adsr_state'pos(adsr_states_q(note_index_q)), WIDTH_ADSR_STATE);
+  active_notes    <= active_notes_q;
+
+  -- a slot is idle once its envelope has finished and the key is up
+  slot_idle <= '1' when (adsr_states_q(note_index_q) = E_START and
+                         note_amp_q = to_unsigned(0, WIDTH_NOTE_GAIN)) else '0';
 
   note_amps_20_q  <= note_amps_q(note_index_q) & '0' & x"000";
 
+  -- a held slot with its key up plays on at its stored amplitude
+  timbre_q  <= to_integer(note_timbres(note_index_q));
+  slot_hold <= (sustain_pedals(timbre_q) or
+                (sost_held_q(note_index_q) and sostenuto_pedals(timbre_q)))
+               when (adsr_states_q(note_index_q) = E_ATTACK or
+                     adsr_states_q(note_index_q) = E_DECAY  or
+                     adsr_states_q(note_index_q) = E_SUSTAIN) else '0';
+  key_amp   <= note_amps_q(note_index_q) when (slot_hold = '1' and note_amp_q = to_unsigned(0, WIDTH_NOTE_GAIN))
+               else note_amp_q;
+
+  -- the pedal let go of the slot with its key up, release it now
+  pedal_release <= '1' when (held_q(note_index_q) = '1' and slot_hold = '0' and
+                             note_amp_q = to_unsigned(0, WIDTH_NOTE_GAIN)) else '0';
+
   -- adsr state machine
   s_adsr_state_machine: process(
     adsr_states_q,
@@ -116,7 +187,9 @@ begin
     note_amps_acc,
     note_amps_q,
     cycle_start_q,
-    sustain_level_q
+    sustain_level_q,
+    key_amp,
+    step_q
 )
   begin
 
@@ -129,15 +202,15 @@ begin
       when E_START =>
         note_amp_d   <= (others => '0');
         -- go to attack state when a note is played
-        if (note_amp_q /= to_unsigned(0, WIDTH_NOTE_GAIN)) then
+        if (key_amp /= to_unsigned(0, WIDTH_NOTE_GAIN)) then
           adsr_state_d <= E_ATTACK;
         end if;
 
       when E_ATTACK =>
-        if (note_amp_q = to_unsigned(0, WIDTH_NOTE_GAIN)) then
+        if (key_amp = to_unsigned(0, WIDTH_NOTE_GAIN)) then
           -- if key is released, go to release state
           adsr_state_d <= E_RELEASE;
-        elsif (note_amp_q /= note_amps_q(note_index_q)) then
+        elsif (key_amp /= note_amps_q(note_index_q)) then
           -- reset attack amplitude if changed in this state
           note_amp_d   <= (others => '0');
         elsif (note_amps_acc(note_index_q) < note_amps_20_q) then
@@ -160,10 +233,10 @@ begin
         end if;
 
       when E_DECAY =>
-        if (note_amp_q = to_unsigned(0, WIDTH_NOTE_GAIN)) then
+        if (key_amp = to_unsigned(0, WIDTH_NOTE_GAIN)) then
           -- if key is released, go to release state
           adsr_state_d <= E_RELEASE;
-        elsif (note_amp_q /= note_amps_q(note_index_q)) then
+        elsif (key_amp /= note_amps_q(note_index_q)) then
           -- reset attack amplitude if changed in this state
           adsr_state_d <= E_ATTACK;
           note_amp_d   <= (others => '0');
@@ -186,18 +259,18 @@ begin
         end if;
 
       when E_SUSTAIN =>
-        if (note_amp_q = to_unsigned(0, WIDTH_NOTE_GAIN)) then
+        if (key_amp = to_unsigned(0, WIDTH_NOTE_GAIN)) then
           -- if key is released, go to release state
           adsr_state_d <= E_RELEASE;
-        elsif (note_amp_q /= note_amps_q(note_index_q)) then
+        elsif (key_amp /= note_amps_q(note_index_q)) then
           -- reset note amplitude and play again
           adsr_state_d <= E_ATTACK;
           note_amp_d   <= (others => '0');
         end if;
 
       when E_RELEASE =>
-        if (note_amp_q /= note_amps_q(note_index_q) and
-            note_amp_q /= to_unsigned(0, WIDTH_NOTE_GAIN)) then
+        if (key_amp /= note_amps_q(note_index_q) and
+            key_amp /= to_unsigned(0, WIDTH_NOTE_GAIN)) then
           -- go to attack state if note is played again
           adsr_state_d <= E_ATTACK;
           note_amp_d   <= (others => '0');
@@ -233,11 +306,15 @@ begin
       note_amp_q                   <= (others => '0');
       note_index_q                 <= I_LOWEST_NOTE;
       note_amps_acc                <= (others => (others => '0'));
+      active_notes_q               <= (others => '0');
       cycle_start_q                <= '0';
       sustain_level_q              <= (others => '0');
       step_q                       <= (others => '0');
+      sost_held_q                  <= (others => '0');
+      sost_seen_q                  <= (others => '0');
+      held_q                       <= (others => '0');
     elsif (rising_edge(clk)) then
-      if (cycle_start_q = '1') then
+      if (cycle_start_q = '1' or pedal_release = '1') then
         adsr_states_q(note_index_q)  <= adsr_state_d;
       else
         adsr_states_q(note_index_q)  <= adsr_states_q(note_index_q);
@@ -245,10 +322,22 @@ begin
       note_q                       <= note_d;
       note_amp_q                   <= note_amp_in;
       note_index_q                 <= note_index_in;
-      note_amps_acc(note_index_q)  <= note_amp_d;
+      -- idle slot accumulators are already zero, skip the write
+      if (slot_idle = '0') then
+        note_amps_acc(note_index_q) <= note_amp_d;
+      end if;
+      active_notes_q(note_index_q) <= not slot_idle;
       cycle_start_q                <= cycle_start_in;
       sustain_level_q              <= sustain_level_d;
       step_q                       <= step_d;
+      held_q(note_index_q)         <= slot_hold;
+      -- sostenuto catches the slots keyed on its down edge
+      sost_seen_q(note_index_q)    <= sostenuto_pedals(timbre_q);
+      if (sostenuto_pedals(timbre_q) = '0') then
+        sost_held_q(note_index_q)  <= '0';
+      elsif (sost_seen_q(note_index_q) = '0' and note_amp_q /= to_unsigned(0, WIDTH_NOTE_GAIN)) then
+        sost_held_q(note_index_q)  <= '1';
+      end if;
     end if;
   end process s_regs;
 
@@ -281,9 +370,11 @@ begin
 
   note_amps_20_d <= note_amps_q(note_index_in) & '0' & x"000";
 
-  step_amt <= attack_amt  when adsr_states_q(note_index_in) = E_ATTACK  else
-              decay_amt   when adsr_states_q(note_index_in) = E_DECAY   else
-              release_amt when adsr_states_q(note_index_in) = E_RELEASE else
+  timbre <= to_integer(note_timbres(note_index_in));
+
+  step_amt <= attack_amt(timbre)  when adsr_states_q(note_index_in) = E_ATTACK  else
+              decay_amt(timbre)   when adsr_states_q(note_index_in) = E_DECAY   else
+              release_amt(timbre) when adsr_states_q(note_index_in) = E_RELEASE else
               (others => '0');
 
   -- scale the step size
@@ -306,7 +397,7 @@ begin
   )
   port map (
     input_word  => note_amps_20_d,
-    gain_word   => sustain_amt,
+    gain_word   => sustain_amt(timbre),
     output_word => sustain_level_d
   );
 
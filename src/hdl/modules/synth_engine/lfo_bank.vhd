@@ -0,0 +1,158 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: LFO Bank
+--
+-- Description:
+--   A small bank of low frequency oscillators for the modulation matrix. Each
+--   LFO adds its rate to a phase accumulator once per tick (one audio frame),
+--   so the frequency is rate * frame rate / 2**WIDTH_LFO_PH, about 5.7 mHz
+--   per step and up to 375 Hz at a 96 kHz frame rate.
+--
+--   The shape selects a sine, triangle, sample and hold or square output.
+--   Sample and hold takes a new pseudo-random value each time the phase
+--   wraps.
+--
+--   The LFOs share one datapath and are updated one per clock after each
+--   tick, like the parameter slew.
+--
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+
+library xil_defaultlib;
+  use xil_defaultlib.synth_pkg.all;
+
+entity lfo_bank is
+  generic (
+    PHASE_WIDTH : natural := WIDTH_LFO_PH;
+    LFO_WIDTH   : natural := WIDTH_LFO
+  );
+  port (
+    clk      : in  std_logic;
+    rst      : in  std_logic;
+    tick     : in  std_logic;
+    rates    : in  t_lfo_rate;
+    shapes   : in  t_lfo_shape;
+    lfo_out  : out t_lfo_out
+  );
+end entity;
+
+architecture rtl of lfo_bank is
+
+  component sine_lut_interp is
+    generic (
+      PHASE_WIDTH : natural := 16;
+      TABLE_PH    : natural := 10;
+      SINE_WIDTH  : natural := 16
+    );
+    port (
+      clk      : in  std_logic;
+      phase    : in  std_logic_vector(PHASE_WIDTH-1 downto 0);
+      sine_out : out signed(SINE_WIDTH-1 downto 0)
+    );
+  end component sine_lut_interp;
+
+  -- phase bits into the sine table
+  constant SIN_PH : natural := 8;
+
+  type t_lfo_phase is array (0 to NUM_LFOS-1) of unsigned(PHASE_WIDTH-1 downto 0);
+
+  signal phase_q   : t_lfo_phase;
+  signal lfo_q     : t_lfo_out;
+
+  -- lfo being updated
+  signal index_q   : integer range 0 to NUM_LFOS-1;
+  signal busy_q    : std_logic;
+
+  -- next phase, with the carry out marking a wrap
+  signal phase_sum : unsigned(PHASE_WIDTH downto 0);
+  signal phase_d   : unsigned(PHASE_WIDTH-1 downto 0);
+
+  -- waveforms at the next phase
+  signal sine,
+         tri,
+         square,
+         wave_d    : signed(LFO_WIDTH-1 downto 0);
+  signal tri_mag   : unsigned(LFO_WIDTH-1 downto 0);
+
+  -- sample and hold noise source
+  signal lfsr_q    : std_logic_vector(15 downto 0);
+
+begin
+
+  lfo_out <= lfo_q;
+
+  phase_sum <= ('0' & phase_q(index_q)) + rates(index_q);
+  phase_d   <= phase_sum(PHASE_WIDTH-1 downto 0);
+
+  u_sine_lut: sine_lut_interp
+    generic map (
+      PHASE_WIDTH => SIN_PH,
+      TABLE_PH    => SIN_PH,
+      SINE_WIDTH  => LFO_WIDTH
+    )
+    port map (
+      clk      => clk,
+      phase    => std_logic_vector(phase_d(PHASE_WIDTH-1 downto PHASE_WIDTH-SIN_PH)),
+      sine_out => sine
+    );
+
+  -- triangle rises over the first half of the cycle and falls over the second
+  tri_mag <= phase_d(PHASE_WIDTH-2 downto PHASE_WIDTH-LFO_WIDTH-1) when phase_d(PHASE_WIDTH-1) = '0'
+             else not(phase_d(PHASE_WIDTH-2 downto PHASE_WIDTH-LFO_WIDTH-1));
+  tri     <= signed(not(tri_mag(LFO_WIDTH-1)) & tri_mag(LFO_WIDTH-2 downto 0));
+
+  square  <= to_signed(2**(LFO_WIDTH-1) - 1, LFO_WIDTH) when phase_d(PHASE_WIDTH-1) = '0'
+             else to_signed(1 - 2**(LFO_WIDTH-1), LFO_WIDTH);
+
+  -- waveform select, sample and hold only changes when the phase wraps
+  s_shape: process(shapes, index_q, sine, tri, square, phase_sum, lfsr_q, lfo_q)
+  begin
+    case to_integer(shapes(index_q)) is
+      when LFO_SINE => wave_d <= sine;
+      when LFO_TRI  => wave_d <= tri;
+      when LFO_SAH  =>
+        if (phase_sum(PHASE_WIDTH) = '1') then
+          wave_d <= signed(lfsr_q(LFO_WIDTH-1 downto 0));
+        else
+          wave_d <= lfo_q(index_q);
+        end if;
+      when others   => wave_d <= square;
+    end case;
+  end process s_shape;
+
+  -- synchronous registers
+  s_regs: process(rst, clk)
+  begin
+    if (rst = '1') then
+      phase_q <= (others => (others => '0'));
+      lfo_q   <= (others => (others => '0'));
+      index_q <= 0;
+      busy_q  <= '0';
+      lfsr_q  <= x"ACE1";
+    elsif (rising_edge(clk)) then
+      -- x^16 + x^14 + x^13 + x^11 + 1, advanced every clock
+      lfsr_q <= lfsr_q(14 downto 0) & (lfsr_q(15) xor lfsr_q(13) xor lfsr_q(12) xor lfsr_q(10));
+
+      if (busy_q = '1') then
+        phase_q(index_q) <= phase_d;
+        lfo_q(index_q)   <= wave_d;
+        if (index_q = NUM_LFOS-1) then
+          index_q <= 0;
+          busy_q  <= '0';
+        else
+          index_q <= index_q + 1;
+        end if;
+      elsif (tick = '1') then
+        busy_q <= '1';
+      end if;
+    end if;
+  end process s_regs;
+
+end architecture rtl;
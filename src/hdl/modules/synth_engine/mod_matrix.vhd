@@ -0,0 +1,169 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Modulation Matrix
+--
+-- Description:
+--   Routes the LFOs to the pitch, level, pulse width and waveform mix of each
+--   timbre bank. Every timbre selects an LFO and a depth for each destination,
+--   and a depth of zero passes the control through unchanged.
+--
+--     pitch    : signed modulation for the phase accumulator to scale the
+--                note phase increment by, see PITCH_MOD_SHIFT
+--     level    : tremolo, the level dips by up to depth/128 of itself
+--     pw       : the pulse width swings by up to +/- half its range
+--     waveform : moves amplitude between the bright pulse, ramp and saw and
+--                the smooth triangle and sine, by up to +/- depth/128
+--
+--   The timbres share one datapath and are updated one per clock after each
+--   tick (one audio frame), so every note slot sees new modulation each frame.
+--
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+
+library xil_defaultlib;
+  use xil_defaultlib.synth_pkg.all;
+
+entity mod_matrix is
+  port (
+    clk             : in  std_logic;
+    rst             : in  std_logic;
+    tick            : in  std_logic;
+    -- modulation sources and routing
+    lfos            : in  t_lfo_out;
+    mod_sels        : in  t_timbre_sel;
+    mod_depths      : in  t_timbre_dep;
+    -- timbre controls in
+    wfrm_amps       : in  t_timbre_amps;
+    pulse_width     : in  t_timbre_pw;
+    timbre_lvls     : in  t_timbre_lvl;
+    -- modulated timbre controls out
+    pitch_mods      : out t_timbre_mod;
+    wfrm_amps_out   : out t_timbre_amps;
+    pulse_width_out : out t_timbre_pw;
+    timbre_lvls_out : out t_timbre_lvl
+  );
+end entity;
+
+architecture rtl of mod_matrix is
+
+  type t_mod_amt is array (0 to NUM_MOD_DESTS-1) of signed(WIDTH_MOD-1 downto 0);
+
+  constant PW_MAX  : integer := 2**WIDTH_PULSE_WIDTH - 1;
+  constant AMP_MAX : integer := 2**WIDTH_WAVE_GAIN - 1;
+
+  -- timbre being updated
+  signal index_q   : integer range 0 to NUM_TIMBRES-1;
+  signal busy_q    : std_logic;
+
+  -- lfo scaled by depth for each destination of the current timbre
+  signal mod_amt   : t_mod_amt;
+
+  -- modulated controls of the current timbre
+  signal lvl_d     : unsigned(WIDTH_TIMBRE_LVL-1 downto 0);
+  signal pw_d      : unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
+  signal amps_d    : t_wfrm_amp;
+
+  -- modulated controls
+  signal pitch_q   : t_timbre_mod;
+  signal amps_q    : t_timbre_amps;
+  signal pw_q      : t_timbre_pw;
+  signal lvl_q     : t_timbre_lvl;
+
+begin
+
+  pitch_mods      <= pitch_q;
+  wfrm_amps_out   <= amps_q;
+  pulse_width_out <= pw_q;
+  timbre_lvls_out <= lvl_q;
+
+  g_mod_amt: for d in 0 to NUM_MOD_DESTS-1 generate
+    mod_amt(d) <= resize(lfos(to_integer(mod_sels(index_q)(d))) *
+                         signed('0' & mod_depths(index_q)(d)), WIDTH_MOD);
+  end generate g_mod_amt;
+
+  -- tremolo, unipolar lfo times depth takes up to 253/256 off the level
+  s_level: process(index_q, lfos, mod_sels, mod_depths, timbre_lvls)
+    variable lfo_uni : unsigned(WIDTH_LFO-1 downto 0);
+    variable dip     : unsigned(WIDTH_MOD-1 downto 0);
+    variable gain    : unsigned(WIDTH_LFO downto 0);
+    variable lvl     : unsigned(WIDTH_TIMBRE_LVL+WIDTH_LFO downto 0);
+  begin
+    lfo_uni := unsigned(lfos(to_integer(mod_sels(index_q)(I_MOD_AMP)))) xor to_unsigned(2**(WIDTH_LFO-1), WIDTH_LFO);
+    dip     := lfo_uni * mod_depths(index_q)(I_MOD_AMP);
+    gain    := to_unsigned(2**WIDTH_LFO, WIDTH_LFO+1) - resize(shift_right(dip, WIDTH_MOD_DEPTH), WIDTH_LFO+1);
+    lvl     := timbre_lvls(index_q) * gain;
+    lvl_d   <= lvl(WIDTH_TIMBRE_LVL+WIDTH_LFO-1 downto WIDTH_LFO);
+  end process s_level;
+
+  -- pulse width, saturated at either end
+  s_pw: process(index_q, mod_amt, pulse_width)
+    variable pw : signed(WIDTH_PULSE_WIDTH+1 downto 0);
+  begin
+    pw := signed(resize(pulse_width(index_q), WIDTH_PULSE_WIDTH+2)) + shift_left(resize(mod_amt(I_MOD_PW), WIDTH_PULSE_WIDTH+2), 1);
+    if (pw < 0) then
+      pw_d <= (others => '0');
+    elsif (pw > PW_MAX) then
+      pw_d <= (others => '1');
+    else
+      pw_d <= unsigned(pw(WIDTH_PULSE_WIDTH-1 downto 0));
+    end if;
+  end process s_pw;
+
+  -- waveform mix, bright waves up and smooth waves down for a positive lfo
+  s_wfrm: process(index_q, mod_amt, wfrm_amps)
+    variable shift : signed(WIDTH_LFO-1 downto 0);
+    variable gain  : signed(WIDTH_LFO+1 downto 0);
+    variable amp   : signed(WIDTH_WAVE_GAIN+WIDTH_LFO+2 downto 0);
+  begin
+    shift := resize(shift_right(mod_amt(I_MOD_WFRM), WIDTH_MOD_DEPTH), WIDTH_LFO);
+    for i in 0 to NUM_WFRMS-1 loop
+      if (i = I_TRI or i = I_SINE) then
+        gain := to_signed(2**WIDTH_MOD_DEPTH, WIDTH_LFO+2) - shift;
+      else
+        gain := to_signed(2**WIDTH_MOD_DEPTH, WIDTH_LFO+2) + shift;
+      end if;
+      amp := shift_right(signed('0' & wfrm_amps(index_q)(i)) * gain, WIDTH_MOD_DEPTH);
+      if (amp > AMP_MAX) then
+        amps_d(i) <= (others => '1');
+      else
+        amps_d(i) <= unsigned(amp(WIDTH_WAVE_GAIN-1 downto 0));
+      end if;
+    end loop;
+  end process s_wfrm;
+
+  -- synchronous registers
+  s_regs: process(rst, clk)
+  begin
+    if (rst = '1') then
+      pitch_q <= (others => (others => '0'));
+      amps_q  <= (others => (others => (others => '0')));
+      pw_q    <= (others => (others => '0'));
+      lvl_q   <= (others => (others => '0'));
+      index_q <= 0;
+      busy_q  <= '0';
+    elsif (rising_edge(clk)) then
+      if (busy_q = '1') then
+        pitch_q(index_q) <= mod_amt(I_MOD_PITCH);
+        amps_q(index_q)  <= amps_d;
+        pw_q(index_q)    <= pw_d;
+        lvl_q(index_q)   <= lvl_d;
+        if (index_q = NUM_TIMBRES-1) then
+          index_q <= 0;
+          busy_q  <= '0';
+        else
+          index_q <= index_q + 1;
+        end if;
+      elsif (tick = '1') then
+        busy_q <= '1';
+      end if;
+    end if;
+  end process s_regs;
+
+end architecture rtl;
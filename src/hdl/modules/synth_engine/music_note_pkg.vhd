@@ -7,6 +7,9 @@
 -- Module Name: Music Note Package
 -- Description: 
 --   Contains constant and type definitions for music notes.
+--
+--   GENERATED by src/tools/gen_tuning.py, do not edit. The firmware pitch.h
+--   is generated from the same parameters.
 -- 
 ----------------------------------------------------------------------------------
 
@@ -19,6 +22,11 @@ library xil_defaultlib;
 
 package music_note_pkg is
 
+  -- parameters the tables were generated for, checked against synth_pkg
+  constant TUNING_CLK_HZ    : natural := 12288000;
+  constant TUNING_NUM_NOTES : natural := 128;
+  constant TUNING_A4_MHZ    : natural := 440000;
+
   -- note frequency word definitions
   constant NOTE_WORD_C_0   : unsigned := x"000594d3";
   constant NOTE_WORD_Db_0  : unsigned := x"0005e9c9";
@@ -151,124 +159,122 @@ package music_note_pkg is
 
   -- phase increment lookup table array
   constant ph_inc_lut : t_ph_inc_lut := (
-    -- since frequency doubles every 12 notes, we can just keep the 12 largest
-    -- and left shift them as needed to conserve resources
-    -- NOTE_WORD_C_0,
-    -- NOTE_WORD_Db_0,
-    -- NOTE_WORD_D_0,
-    -- NOTE_WORD_Eb_0,
-    -- NOTE_WORD_E_0,
-    -- NOTE_WORD_F_0,
-    -- NOTE_WORD_Gb_0,
-    -- NOTE_WORD_G_0,
-    -- NOTE_WORD_Ab_0,
-    -- NOTE_WORD_A_0,
-    -- NOTE_WORD_Bb_0,
-    -- NOTE_WORD_B_0,
-    -- NOTE_WORD_C_1,
-    -- NOTE_WORD_Db_1,
-    -- NOTE_WORD_D_1,
-    -- NOTE_WORD_Eb_1,
-    -- NOTE_WORD_E_1,
-    -- NOTE_WORD_F_1,
-    -- NOTE_WORD_Gb_1,
-    -- NOTE_WORD_G_1,
-    -- NOTE_WORD_Ab_1,
-    -- NOTE_WORD_A_1,
-    -- NOTE_WORD_Bb_1,
-    -- NOTE_WORD_B_1,
-    -- NOTE_WORD_C_2,
-    -- NOTE_WORD_Db_2,
-    -- NOTE_WORD_D_2,
-    -- NOTE_WORD_Eb_2,
-    -- NOTE_WORD_E_2,
-    -- NOTE_WORD_F_2,
-    -- NOTE_WORD_Gb_2,
-    -- NOTE_WORD_G_2,
-    -- NOTE_WORD_Ab_2,
-    -- NOTE_WORD_A_2,
-    -- NOTE_WORD_Bb_2,
-    -- NOTE_WORD_B_2,
-    -- NOTE_WORD_C_3,
-    -- NOTE_WORD_Db_3,
-    -- NOTE_WORD_D_3,
-    -- NOTE_WORD_Eb_3,
-    -- NOTE_WORD_E_3,
-    -- NOTE_WORD_F_3,
-    -- NOTE_WORD_Gb_3,
-    -- NOTE_WORD_G_3,
-    -- NOTE_WORD_Ab_3,
-    -- NOTE_WORD_A_3,
-    -- NOTE_WORD_Bb_3,
-    -- NOTE_WORD_B_3,
-    -- NOTE_WORD_C_4,
-    -- NOTE_WORD_Db_4,
-    -- NOTE_WORD_D_4,
-    -- NOTE_WORD_Eb_4,
-    -- NOTE_WORD_E_4,
-    -- NOTE_WORD_F_4,
-    -- NOTE_WORD_Gb_4,
-    -- NOTE_WORD_G_4,
-    -- NOTE_WORD_Ab_4,
-    -- NOTE_WORD_A_4,
-    -- NOTE_WORD_Bb_4,
-    -- NOTE_WORD_B_4,
-    -- NOTE_WORD_C_5,
-    -- NOTE_WORD_Db_5,
-    -- NOTE_WORD_D_5,
-    -- NOTE_WORD_Eb_5,
-    -- NOTE_WORD_E_5,
-    -- NOTE_WORD_F_5,
-    -- NOTE_WORD_Gb_5,
-    -- NOTE_WORD_G_5,
-    -- NOTE_WORD_Ab_5,
-    -- NOTE_WORD_A_5,
-    -- NOTE_WORD_Bb_5,
-    -- NOTE_WORD_B_5,
-    -- NOTE_WORD_C_6,
-    -- NOTE_WORD_Db_6,
-    -- NOTE_WORD_D_6,
-    -- NOTE_WORD_Eb_6,
-    -- NOTE_WORD_E_6,
-    -- NOTE_WORD_F_6,
-    -- NOTE_WORD_Gb_6,
-    -- NOTE_WORD_G_6,
-    -- NOTE_WORD_Ab_6,
-    -- NOTE_WORD_A_6,
-    -- NOTE_WORD_Bb_6,
-    -- NOTE_WORD_B_6,
-    -- NOTE_WORD_C_7,
-    -- NOTE_WORD_Db_7,
-    -- NOTE_WORD_D_7,
-    -- NOTE_WORD_Eb_7,
-    -- NOTE_WORD_E_7,
-    -- NOTE_WORD_F_7,
-    -- NOTE_WORD_Gb_7,
-    -- NOTE_WORD_G_7,
-    -- NOTE_WORD_Ab_7,
-    -- NOTE_WORD_A_7,
-    -- NOTE_WORD_Bb_7,
-    -- NOTE_WORD_B_7,
-    -- NOTE_WORD_C_8,
-    -- NOTE_WORD_Db_8,
-    -- NOTE_WORD_D_8,
-    -- NOTE_WORD_Eb_8,
-    -- NOTE_WORD_E_8,
-    -- NOTE_WORD_F_8,
-    -- NOTE_WORD_Gb_8,
-    -- NOTE_WORD_G_8,
-    -- NOTE_WORD_Ab_8,
-    -- NOTE_WORD_A_8,
-    -- NOTE_WORD_Bb_8,
-    -- NOTE_WORD_B_8,
-    -- NOTE_WORD_C_9,
-    -- NOTE_WORD_Db_9,
-    -- NOTE_WORD_D_9,
-    -- NOTE_WORD_Eb_9,
-    -- NOTE_WORD_E_9,
-    -- NOTE_WORD_F_9,
-    -- NOTE_WORD_Gb_9,
-    -- NOTE_WORD_G_9,
+    NOTE_WORD_C_0,
+    NOTE_WORD_Db_0,
+    NOTE_WORD_D_0,
+    NOTE_WORD_Eb_0,
+    NOTE_WORD_E_0,
+    NOTE_WORD_F_0,
+    NOTE_WORD_Gb_0,
+    NOTE_WORD_G_0,
+    NOTE_WORD_Ab_0,
+    NOTE_WORD_A_0,
+    NOTE_WORD_Bb_0,
+    NOTE_WORD_B_0,
+    NOTE_WORD_C_1,
+    NOTE_WORD_Db_1,
+    NOTE_WORD_D_1,
+    NOTE_WORD_Eb_1,
+    NOTE_WORD_E_1,
+    NOTE_WORD_F_1,
+    NOTE_WORD_Gb_1,
+    NOTE_WORD_G_1,
+    NOTE_WORD_Ab_1,
+    NOTE_WORD_A_1,
+    NOTE_WORD_Bb_1,
+    NOTE_WORD_B_1,
+    NOTE_WORD_C_2,
+    NOTE_WORD_Db_2,
+    NOTE_WORD_D_2,
+    NOTE_WORD_Eb_2,
+    NOTE_WORD_E_2,
+    NOTE_WORD_F_2,
+    NOTE_WORD_Gb_2,
+    NOTE_WORD_G_2,
+    NOTE_WORD_Ab_2,
+    NOTE_WORD_A_2,
+    NOTE_WORD_Bb_2,
+    NOTE_WORD_B_2,
+    NOTE_WORD_C_3,
+    NOTE_WORD_Db_3,
+    NOTE_WORD_D_3,
+    NOTE_WORD_Eb_3,
+    NOTE_WORD_E_3,
+    NOTE_WORD_F_3,
+    NOTE_WORD_Gb_3,
+    NOTE_WORD_G_3,
+    NOTE_WORD_Ab_3,
+    NOTE_WORD_A_3,
+    NOTE_WORD_Bb_3,
+    NOTE_WORD_B_3,
+    NOTE_WORD_C_4,
+    NOTE_WORD_Db_4,
+    NOTE_WORD_D_4,
+    NOTE_WORD_Eb_4,
+    NOTE_WORD_E_4,
+    NOTE_WORD_F_4,
+    NOTE_WORD_Gb_4,
+    NOTE_WORD_G_4,
+    NOTE_WORD_Ab_4,
+    NOTE_WORD_A_4,
+    NOTE_WORD_Bb_4,
+    NOTE_WORD_B_4,
+    NOTE_WORD_C_5,
+    NOTE_WORD_Db_5,
+    NOTE_WORD_D_5,
+    NOTE_WORD_Eb_5,
+    NOTE_WORD_E_5,
+    NOTE_WORD_F_5,
+    NOTE_WORD_Gb_5,
+    NOTE_WORD_G_5,
+    NOTE_WORD_Ab_5,
+    NOTE_WORD_A_5,
+    NOTE_WORD_Bb_5,
+    NOTE_WORD_B_5,
+    NOTE_WORD_C_6,
+    NOTE_WORD_Db_6,
+    NOTE_WORD_D_6,
+    NOTE_WORD_Eb_6,
+    NOTE_WORD_E_6,
+    NOTE_WORD_F_6,
+    NOTE_WORD_Gb_6,
+    NOTE_WORD_G_6,
+    NOTE_WORD_Ab_6,
+    NOTE_WORD_A_6,
+    NOTE_WORD_Bb_6,
+    NOTE_WORD_B_6,
+    NOTE_WORD_C_7,
+    NOTE_WORD_Db_7,
+    NOTE_WORD_D_7,
+    NOTE_WORD_Eb_7,
+    NOTE_WORD_E_7,
+    NOTE_WORD_F_7,
+    NOTE_WORD_Gb_7,
+    NOTE_WORD_G_7,
+    NOTE_WORD_Ab_7,
+    NOTE_WORD_A_7,
+    NOTE_WORD_Bb_7,
+    NOTE_WORD_B_7,
+    NOTE_WORD_C_8,
+    NOTE_WORD_Db_8,
+    NOTE_WORD_D_8,
+    NOTE_WORD_Eb_8,
+    NOTE_WORD_E_8,
+    NOTE_WORD_F_8,
+    NOTE_WORD_Gb_8,
+    NOTE_WORD_G_8,
+    NOTE_WORD_Ab_8,
+    NOTE_WORD_A_8,
+    NOTE_WORD_Bb_8,
+    NOTE_WORD_B_8,
+    NOTE_WORD_C_9,
+    NOTE_WORD_Db_9,
+    NOTE_WORD_D_9,
+    NOTE_WORD_Eb_9,
+    NOTE_WORD_E_9,
+    NOTE_WORD_F_9,
+    NOTE_WORD_Gb_9,
+    NOTE_WORD_G_9,
     NOTE_WORD_Ab_9,
     NOTE_WORD_A_9,
     NOTE_WORD_Bb_9,
@@ -287,4 +293,3 @@ end music_note_pkg;
 package body music_note_pkg is
     -- No implementation needed for a package with only constants
 end music_note_pkg;
-
@@ -0,0 +1,106 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Parameter Slew
+--
+-- Description:
+--   Smooths a set of control registers towards their targets with a one-pole
+--   filter that updates once per tick (one audio frame). Each update moves a
+--   value by (target - value) / 2**rate, so a single register write ramps
+--   smoothly with a time constant of about 2**rate frames. A rate of zero
+--   bypasses the filter and passes the targets straight through.
+--
+--   The NUM_PARAMS values share one filter datapath and are updated one per
+--   clock after each tick, so NUM_PARAMS must fit within a frame.
+--
+--   The filter state carries FRAC_WIDTH extra bits so slow rates keep moving
+--   between output steps, and snaps to the target once the step rounds to
+--   zero so the output always settles exactly on the written value.
+--
+-- Revision:
+-- 10/19/2026 agt - shared datapath for multiple parameters
+--
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+
+entity param_slew is
+  generic (
+    NUM_PARAMS : natural := 1;
+    DATA_WIDTH : natural := 7;
+    RATE_WIDTH : natural := 4;
+    FRAC_WIDTH : natural := 16
+  );
+  port (
+    clk        : in  std_logic;
+    rst        : in  std_logic;
+    tick       : in  std_logic;
+    rate       : in  unsigned(RATE_WIDTH-1 downto 0);
+    targets    : in  std_logic_vector(NUM_PARAMS*DATA_WIDTH-1 downto 0);
+    values_out : out std_logic_vector(NUM_PARAMS*DATA_WIDTH-1 downto 0)
+  );
+end entity;
+
+architecture rtl of param_slew is
+
+  constant STATE_WIDTH : natural := DATA_WIDTH + FRAC_WIDTH;
+
+  type t_state is array (0 to NUM_PARAMS-1) of unsigned(STATE_WIDTH-1 downto 0);
+
+  signal target_ext : t_state;
+  signal value_q    : t_state;
+
+  -- parameter being updated
+  signal index_q    : integer range 0 to NUM_PARAMS-1;
+  signal busy_q     : std_logic;
+
+  signal diff       : signed(STATE_WIDTH downto 0);
+  signal step       : signed(STATE_WIDTH downto 0);
+
+begin
+
+  g_params: for i in 0 to NUM_PARAMS-1 generate
+    target_ext(i) <= shift_left(resize(unsigned(targets((i+1)*DATA_WIDTH-1 downto i*DATA_WIDTH)), STATE_WIDTH), FRAC_WIDTH);
+    values_out((i+1)*DATA_WIDTH-1 downto i*DATA_WIDTH) <= std_logic_vector(value_q(i)(STATE_WIDTH-1 downto FRAC_WIDTH));
+  end generate g_params;
+
+  -- one-pole step towards the target
+  diff <= signed('0' & target_ext(index_q)) - signed('0' & value_q(index_q));
+  step <= shift_right(diff, to_integer(rate));
+
+  -- synchronous registers
+  s_regs: process(rst, clk)
+  begin
+    if (rst = '1') then
+      value_q <= (others => (others => '0'));
+      index_q <= 0;
+      busy_q  <= '0';
+    elsif (rising_edge(clk)) then
+      if (rate = 0) then
+        value_q <= target_ext;
+        index_q <= 0;
+        busy_q  <= '0';
+      elsif (busy_q = '1') then
+        if (step = 0 or step = -1) then
+          value_q(index_q) <= target_ext(index_q);
+        else
+          value_q(index_q) <= resize(unsigned(signed('0' & value_q(index_q)) + step), STATE_WIDTH);
+        end if;
+        if (index_q = NUM_PARAMS-1) then
+          index_q <= 0;
+          busy_q  <= '0';
+        else
+          index_q <= index_q + 1;
+        end if;
+      elsif (tick = '1') then
+        busy_q  <= '1';
+      end if;
+    end if;
+  end process s_regs;
+
+end architecture rtl;
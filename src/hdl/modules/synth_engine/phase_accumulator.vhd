@@ -7,10 +7,26 @@
 -- Module Name: Phase Accumulator
 --
 -- Description:
---   Increments a circular counter by a given phase increment.
+--   Increments a circular counter by a given phase increment. The increment
+--   is scaled by the pitch modulation of the note's timbre bank. The tuning
+--   table stays in synth_axi_ctrl, which returns the increment of the slot
+--   this block puts out on slot_index.
+--
+--   Each note slot keeps its current increment next to the target from the
+--   tuning table, in a RAM with a second read port for the glide source. A
+--   glide start for the slot loads it with the current increment of its
+--   source slot, then the slot moves toward its target by a fixed fraction
+--   of itself each frame, so the glide is exponential in pitch. A glide
+--   rate of 0 for the note's timbre, or reaching the target, ends the glide
+--   and the slot follows the table again.
 --
 -- Revision:
 -- 04/01/2025 - modifications for pipelined datapath
+-- 10/19/2026 agt - full 128 note phase increment table, no octave shifting
+-- 10/19/2026 agt - per-timbre pitch modulation
+-- 10/19/2026 agt - per-slot portamento
+-- 10/19/2026 agt - tuning table read by slot index, not a port copy
+-- 10/19/2026 agt - glide start and source per slot, current increments in RAM
 -- 
 ----------------------------------------------------------------------------------
 
@@ -30,8 +46,15 @@ entity phase_accumulator is
     clk             : in  std_logic;
     rst             : in  std_logic;
     -- synth controls
-    phase_incs      : in  t_ph_inc_lut;
+    slot_index      : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+    ph_inc          : in  unsigned(PHASE_WIDTH-1 downto 0);
     note_amps       : in  t_note_amp;
+    note_timbres    : in  t_note_timbre;
+    pitch_mods      : in  t_timbre_mod;
+    glide_rates     : in  t_glide_rate;
+    -- glide start of the slot on slot_index and the note it glides from
+    glide_start     : in  std_logic;
+    glide_from      : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
     -- pipeline out
     note_index_out  : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
     phase_out       : out unsigned(PHASE_WIDTH-1 downto 0);
@@ -46,21 +69,30 @@ architecture rtl of phase_accumulator is
   signal  note_index_d,
           note_index_q,
           note_index_q2 : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
-  
-  -- phase index
-  signal  phase_index_d,
-          phase_index_q : integer range 116 to 127;
 
   -- phase
   signal  phase_d,
           phase_q,
           phase_inc_lookup,
-          phase_inc_shifted,
+          phase_inc_glide,
+          phase_inc_mod,
           phase_reg_lookup   : unsigned(PHASE_WIDTH-1 downto 0);
 
+  -- pitch modulation of the note's timbre and the increment it adds
+  signal  pitch_mod     : signed(WIDTH_MOD-1 downto 0);
+  signal  pitch_product : signed(PHASE_WIDTH+WIDTH_MOD downto 0);
+
   -- phase register table
   signal  phase_regs : t_ph_inc;
 
+  -- current increment of each slot and the slots still gliding
+  signal  cur_incs   : t_ph_inc := (others => (others => '0'));
+  signal  gliding_q  : t_note_bits;
+  signal  cur_lookup,
+          cur_from   : unsigned(PHASE_WIDTH-1 downto 0);
+  signal  glide_rate : unsigned(WIDTH_GLIDE_RATE-1 downto 0);
+  signal  gliding_d  : std_logic;
+
   -- note amplitude
   signal  note_amp_lookup_d,
           note_amp_lookup_q   : unsigned(NOTE_GAIN_WIDTH-1 downto 0);
@@ -69,9 +101,6 @@ architecture rtl of phase_accumulator is
   signal cycle_start_d,
          cycle_start_q   : std_logic;
 
-  -- shift amount
-  signal  shift_amt : integer range 0 to 10;
-
 begin
 
   -- output assignments
@@ -79,75 +108,99 @@ begin
   phase_out       <= phase_q;
   note_amp_out    <= note_amp_lookup_q;
   cycle_start_out <= cycle_start_q;
+  slot_index      <= note_index_q;
 
   -- index into registers
-  phase_inc_lookup  <= phase_incs(phase_index_q);
+  phase_inc_lookup  <= ph_inc;
   phase_reg_lookup  <= phase_regs(note_index_q);
   note_amp_lookup_d <= note_amps(note_index_q);
+  cur_lookup        <= cur_incs(note_index_q);
+  cur_from          <= cur_incs(glide_from);
+  glide_rate        <= glide_rates(to_integer(note_timbres(note_index_q)));
+
+  -- step the current increment toward the table, the +1 keeps the smallest
+  -- increments moving
+  s_glide: process(glide_start, cur_from, note_index_q, gliding_q, glide_rate,
+                   cur_lookup, phase_inc_lookup)
+    variable shift : natural range 0 to 2**WIDTH_GLIDE_RATE+GLIDE_SHIFT_BASE;
+    variable step  : unsigned(PHASE_WIDTH-1 downto 0);
+  begin
+    shift := to_integer(glide_rate) + GLIDE_SHIFT_BASE;
+    step  := shift_right(cur_lookup, shift) + 1;
+    if (glide_start = '1' and glide_rate /= 0) then
+      phase_inc_glide <= cur_from;
+      gliding_d       <= '1';
+    elsif (gliding_q(note_index_q) = '0' or glide_rate = 0) then
+      phase_inc_glide <= phase_inc_lookup;
+      gliding_d       <= '0';
+    elsif (cur_lookup < phase_inc_lookup and phase_inc_lookup - cur_lookup > step) then
+      phase_inc_glide <= cur_lookup + step;
+      gliding_d       <= '1';
+    elsif (cur_lookup > phase_inc_lookup and cur_lookup - phase_inc_lookup > step) then
+      phase_inc_glide <= cur_lookup - step;
+      gliding_d       <= '1';
+    else
+      phase_inc_glide <= phase_inc_lookup;
+      gliding_d       <= '0';
+    end if;
+  end process s_glide;
 
-  -- shift phase increment lookup
-  shift_amt <= 10 when note_index_q <   8 else
-                9 when note_index_q <  20 else
-                8 when note_index_q <  32 else
-                7 when note_index_q <  44 else
-                6 when note_index_q <  56 else
-                5 when note_index_q <  68 else
-                4 when note_index_q <  80 else
-                3 when note_index_q <  92 else
-                2 when note_index_q < 104 else
-                1 when note_index_q < 116 else
-                0;
-  phase_inc_shifted <= shift_right(phase_inc_lookup, shift_amt);
+  -- modulate the phase increment
+  pitch_mod     <= pitch_mods(to_integer(note_timbres(note_index_q)));
+  pitch_product <= signed('0' & phase_inc_glide) * pitch_mod;
+  phase_inc_mod <= phase_inc_glide + unsigned(resize(shift_right(pitch_product, PITCH_MOD_SHIFT), PHASE_WIDTH));
 
   -- increment phase
-  phase_d <= phase_reg_lookup + phase_inc_shifted;
+  phase_d <= phase_reg_lookup + phase_inc_mod;
 
   -- synchronous counters
-  s_counter: process(note_index_q, phase_index_q)
+  s_counter: process(note_index_q)
   begin
     -- note index cyclical counter over note range
     if note_index_q < I_HIGHEST_NOTE then
       note_index_d <= note_index_q + 1;
-      -- phase index cyclical counter from 116 to 127
-      if phase_index_q < 127 then
-        phase_index_d <= phase_index_q + 1;
-      else
-        phase_index_d <= 116;
-      end if;
     else
-      note_index_d  <= I_LOWEST_NOTE;
-      phase_index_d <= 120;
+      note_index_d <= I_LOWEST_NOTE;
     end if;
   end process s_counter;
   
   -- check for start of cycle
-  s_start_of_cycle: process(phase_inc_shifted, phase_d)
+  s_start_of_cycle: process(phase_inc_mod, phase_d)
   begin
     cycle_start_d <= '0';
-    if (phase_d < phase_inc_shifted) then
+    if (phase_d < phase_inc_mod) then
       cycle_start_d <= '1';
     end if;
   end process s_start_of_cycle;
 
+  -- current increments, kept out of the reset so they map to LUT RAM, each
+  -- pass of the engine writes every slot
+  s_cur_incs: process(clk)
+  begin
+    if rising_edge(clk) then
+      cur_incs(note_index_q) <= phase_inc_glide;
+    end if;
+  end process s_cur_incs;
+
   -- synchronous registers
   s_regs: process(clk, rst)
   begin
     if (rst = '1') then
       note_index_q      <= I_LOWEST_NOTE;
       note_index_q2     <= I_LOWEST_NOTE;
-      phase_index_q     <= 120;
       phase_q           <= (others => '0');
       phase_regs        <= (others => (others => '0'));
       note_amp_lookup_q <= (others => '0');
       cycle_start_q     <= '0';
+      gliding_q         <= (others => '0');
     elsif rising_edge(clk) then
       note_index_q              <= note_index_d;
       note_index_q2             <= note_index_q;
-      phase_index_q             <= phase_index_d;
       phase_q                   <= phase_d;
       phase_regs(note_index_q2) <= phase_q;
       note_amp_lookup_q         <= note_amp_lookup_d;
       cycle_start_q             <= cycle_start_d;
+      gliding_q(note_index_q)   <= gliding_d;
     end if;
   end process s_regs;
 
@@ -8,7 +8,13 @@
 -- Description: 
 --   Given a phase index, produces ramp, saw, triangle, square, and sine waveforms.
 --   Each waveform can be phase shifted and optionally mixed together into a single
---   output.
+--   output. The mix, phase shifts and pulse width come from the timbre bank
+--   selected for each note.
+--
+-- Revision:
+-- 10/19/2026 agt - optional interpolated sine lookup (SIN_INTERP_PH > 0)
+-- 10/19/2026 agt - operand gating of idle note slots
+-- 10/19/2026 agt - per-note timbre select
 -- 
 ----------------------------------------------------------------------------------
 
@@ -24,15 +30,18 @@ entity phase_to_wave is
     PHASE_WIDTH     : integer := WIDTH_PH_DATA;
     NOTE_GAIN_WIDTH : integer := WIDTH_NOTE_GAIN;
     DATA_WIDTH      : natural := WIDTH_WAVE_DATA;
-    SIN_LUT_PH      : natural := 12
+    SIN_LUT_PH      : natural := 12;
+    SIN_INTERP_PH   : natural := 0
   );
   port (
     clk             : in  std_logic;
     rst             : in  std_logic;
     -- synth controls
-    wfrm_amps       : in  t_wfrm_amp;
-    wfrm_phs        : in  t_wfrm_ph;
-    pulse_width     : in  unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
+    wfrm_amps       : in  t_timbre_amps;
+    wfrm_phs        : in  t_timbre_phs;
+    pulse_width     : in  t_timbre_pw;
+    note_timbres    : in  t_note_timbre;
+    active_notes    : in  t_note_bits;
     -- pipeline in
     note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
     phase_in        : in  unsigned(PHASE_WIDTH-1 downto 0);
@@ -60,6 +69,19 @@ architecture rtl of phase_to_wave is
     );
   end component sine_lut_full;
 
+  component sine_lut_interp is
+    generic (
+      PHASE_WIDTH : natural := 16;
+      TABLE_PH    : natural := 10;
+      SINE_WIDTH  : natural := 16
+    );
+    port (
+      clk      : in  std_logic;
+      phase    : in  std_logic_vector(PHASE_WIDTH-1 downto 0);
+      sine_out : out signed(SINE_WIDTH-1 downto 0)
+    );
+  end component sine_lut_interp;
+
   component scaler is
     generic (
       WIDTH_DATA : integer := 16;  -- Width of input and output samples
@@ -79,8 +101,11 @@ architecture rtl of phase_to_wave is
   -- half of the maximum amplitude
   constant HALF_MAX : signed(DATA_WIDTH-1 downto 0) := OUT_MAX/2;
 
+  -- phase bits into the sine lookup, table index plus interpolation bits
+  constant SIN_PH : natural := SIN_LUT_PH + SIN_INTERP_PH;
+
   -- sine phase shift to lookup table
-  signal phase_sin_lut : std_logic_vector(DATA_WIDTH-1 downto DATA_WIDTH-SIN_LUT_PH);
+  signal phase_sin_lut : std_logic_vector(DATA_WIDTH-1 downto DATA_WIDTH-SIN_PH);
 
   -- phase accumulators with offsets
   signal tri_ph_offset   : unsigned(DATA_WIDTH-1 downto 0);
@@ -88,6 +113,10 @@ architecture rtl of phase_to_wave is
   -- phase
   signal phase : unsigned(DATA_WIDTH-1 downto 0);
 
+  -- timbre bank of the current note
+  signal timbre     : integer range 0 to NUM_TIMBRES-1;
+  signal timbre_pw  : unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
+
   -- phase shifts
   signal  pulse_ph,
           ramp_ph,
@@ -123,6 +152,9 @@ architecture rtl of phase_to_wave is
   -- cycle start pipeline
   signal cycle_start_q, cycle_start_q2 : std_logic;
 
+  -- slot is keyed or still sounding
+  signal slot_active : std_logic;
+
   -- note amp pipeline
   signal note_amp_q, note_amp_q2       : unsigned(NOTE_GAIN_WIDTH-1 downto 0);
 
@@ -134,28 +166,35 @@ begin
   note_amp_out    <= note_amp_q2;
   cycle_start_out <= cycle_start_q2;
 
+  -- timbre bank select
+  timbre    <= to_integer(note_timbres(note_index_in));
+  timbre_pw <= pulse_width(timbre);
+
   -- phase shift assignments
-  pulse_ph <= wfrm_phs(I_PULSE);
-  ramp_ph  <= wfrm_phs(I_RAMP);
-  saw_ph   <= wfrm_phs(I_SAW);
-  tri_ph   <= wfrm_phs(I_TRI);
-  sine_ph  <= wfrm_phs(I_SINE);
+  pulse_ph <= wfrm_phs(timbre)(I_PULSE);
+  ramp_ph  <= wfrm_phs(timbre)(I_RAMP);
+  saw_ph   <= wfrm_phs(timbre)(I_SAW);
+  tri_ph   <= wfrm_phs(timbre)(I_TRI);
+  sine_ph  <= wfrm_phs(timbre)(I_SINE);
 
-  phase  <= phase_in(PHASE_WIDTH-1 downto PHASE_WIDTH - DATA_WIDTH);
+  -- hold the phase at zero through idle slots so the wave logic is static
+  slot_active <= '1' when (active_notes(note_index_in) = '1' or note_amp_in /= 0) else '0';
+  phase       <= phase_in(PHASE_WIDTH-1 downto PHASE_WIDTH - DATA_WIDTH) when (slot_active = '1') else
+                 (others => '0');
 
   -- waveform amplitude assignments
-  pulse_amp <= wfrm_amps(I_PULSE);
-  ramp_amp  <= wfrm_amps(I_RAMP);
-  saw_amp   <= wfrm_amps(I_SAW);
-  tri_amp   <= wfrm_amps(I_TRI);
-  sine_amp  <= wfrm_amps(I_SINE);
+  pulse_amp <= wfrm_amps(timbre)(I_PULSE);
+  ramp_amp  <= wfrm_amps(timbre)(I_RAMP);
+  saw_amp   <= wfrm_amps(timbre)(I_SAW);
+  tri_amp   <= wfrm_amps(timbre)(I_TRI);
+  sine_amp  <= wfrm_amps(timbre)(I_SINE);
 
   -- mix all waveforms
   mix_d <= pulse_q + ramp_q + saw_q + tri_q + sine_q;
 
   -- pwm phase to waveform logic
   pulse_d <= to_signed(0, DATA_WIDTH) when (pulse_amp = 0) else
-             OUT_MAX when (phase + pulse_ph) < pulse_width else OUT_MIN;
+             OUT_MAX when (phase + pulse_ph) < timbre_pw else OUT_MIN;
 
   -- ramp phase to waveform logic
   ramp_d  <= to_signed(0, DATA_WIDTH) when (ramp_amp = 0) else
@@ -173,23 +212,40 @@ begin
   
   -- phase offset to sine lookup table
   phase_sin_lut <= std_logic_vector(
-                      phase(DATA_WIDTH-1 downto DATA_WIDTH-SIN_LUT_PH)
-                    + sine_ph(DATA_WIDTH-1 downto DATA_WIDTH-SIN_LUT_PH)
-                    + 2**(SIN_LUT_PH-1));
+                      phase(DATA_WIDTH-1 downto DATA_WIDTH-SIN_PH)
+                    + sine_ph(DATA_WIDTH-1 downto DATA_WIDTH-SIN_PH)
+                    + 2**(SIN_PH-1));
 
   sine_d  <= to_signed(0, DATA_WIDTH) when (sine_amp = 0) else sine_lookup_d;
 
   -- sine phase to waveform lookup table
-  u_sine_lut: sine_lut_full
-  generic map (
-    PHASE_WIDTH => SIN_LUT_PH,
-    SINE_WIDTH  => DATA_WIDTH
-    )
-  port map(
-    clk      => clk,
-    phase    => phase_sin_lut,
-    sine_out => sine_lookup_d
-  );
+  g_sine_lut: if SIN_INTERP_PH = 0 generate
+    u_sine_lut: sine_lut_full
+    generic map (
+      PHASE_WIDTH => SIN_LUT_PH,
+      SINE_WIDTH  => DATA_WIDTH
+      )
+    port map(
+      clk      => clk,
+      phase    => phase_sin_lut,
+      sine_out => sine_lookup_d
+    );
+  end generate g_sine_lut;
+
+  -- sine phase to waveform interpolated lookup table
+  g_sine_interp: if SIN_INTERP_PH > 0 generate
+    u_sine_lut: sine_lut_interp
+    generic map (
+      PHASE_WIDTH => SIN_PH,
+      TABLE_PH    => SIN_LUT_PH,
+      SINE_WIDTH  => DATA_WIDTH
+      )
+    port map(
+      clk      => clk,
+      phase    => phase_sin_lut,
+      sine_out => sine_lookup_d
+    );
+  end generate g_sine_interp;
 
   -- assignments to mixer
   u_pulse_scaler: scaler
@@ -264,11 +320,14 @@ begin
       note_amp_q     <= (others => '0');
       note_amp_q2    <= (others => '0');
     elsif (rising_edge(clk)) then
-      pulse_q        <= pulse_scale_d;
-      ramp_q         <= ramp_scale_d;
-      saw_q          <= saw_scale_d;
-      tri_q          <= tri_scale_d;
-      sine_q         <= sine_scale_d;
+      -- idle slots are silent after the envelope, hold the wave registers
+      if (slot_active = '1') then
+        pulse_q      <= pulse_scale_d;
+        ramp_q       <= ramp_scale_d;
+        saw_q        <= saw_scale_d;
+        tri_q        <= tri_scale_d;
+        sine_q       <= sine_scale_d;
+      end if;
       mix_q          <= mix_d;
       note_index_q   <= note_index_in;
       note_index_q2  <= note_index_q;
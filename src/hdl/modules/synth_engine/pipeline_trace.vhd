@@ -0,0 +1,198 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Pipeline Trace
+--
+-- Description:
+--   Captures the envelope stage output into a block RAM, for looking at the
+--   pipeline on hardware without an ILA. Each entry is one slot on one
+--   clock: the note index, the cycle start flag, the adsr state and the
+--   sample, packed as the TRACE_* entry fields in synth_pkg.
+--
+--   A capture is armed with the control word and waits for its trigger on
+--   the traced slot: at once, the slot entering an adsr state, or the slot
+--   sample reaching a level in either direction. It then records either the
+--   traced slot once a frame, or every slot from the next frame start, until
+--   TRACE_DEPTH entries are written. The entry that triggers is the first
+--   one recorded for a slot trace. Arming again restarts the capture.
+--
+--   The buffer is read on its own port. The read address is taken with the
+--   AXI read address, so the entry is there with the read data valid.
+--
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+
+library xil_defaultlib;
+  use xil_defaultlib.synth_pkg.all;
+
+entity pipeline_trace is
+  generic (
+    DEPTH_BITS : natural := TRACE_DEPTH_BITS;
+    DATA_WIDTH : natural := WIDTH_WAVE_DATA
+  );
+  port (
+    clk             : in  std_logic;
+    rst             : in  std_logic;
+    -- trace controls
+    trace_ctrl      : in  std_logic_vector(31 downto 0);
+    trace_arm       : in  std_logic;
+    trace_status    : out std_logic_vector(31 downto 0);
+    -- pipeline in
+    note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+    note_in         : in  signed(DATA_WIDTH-1 downto 0);
+    cycle_start_in  : in  std_logic;
+    adsr_state_in   : in  unsigned(WIDTH_ADSR_STATE-1 downto 0);
+    -- buffer read port
+    rd_en           : in  std_logic;
+    rd_addr         : in  unsigned(DEPTH_BITS-1 downto 0);
+    rd_data         : out std_logic_vector(31 downto 0)
+  );
+end entity;
+
+architecture rtl of pipeline_trace is
+
+  type t_trace_mem is array (0 to 2**DEPTH_BITS-1) of std_logic_vector(31 downto 0);
+  signal trace_mem : t_trace_mem;
+
+  type t_trace_state is (T_IDLE, T_ARMED, T_WAIT_FRAME, T_CAPTURE);
+  signal state_q : t_trace_state;
+
+  -- control fields
+  signal frame_mode  : std_logic;
+  signal trig_sel    : natural range 0 to 3;
+  signal trig_state  : unsigned(WIDTH_ADSR_STATE-1 downto 0);
+  signal trig_slot   : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  signal trig_level  : unsigned(15 downto 0);
+
+  -- trigger logic
+  signal slot_hit    : std_logic;
+  signal magnitude   : unsigned(DATA_WIDTH-1 downto 0);
+  signal triggered   : std_logic;
+  signal last_state_q : unsigned(WIDTH_ADSR_STATE-1 downto 0);
+
+  -- capture
+  signal start       : std_logic;
+  signal wr_en       : std_logic;
+  signal entry       : std_logic_vector(31 downto 0);
+  signal wr_ptr_q    : unsigned(DEPTH_BITS downto 0);
+  signal done_q      : std_logic;
+  signal rd_data_q   : std_logic_vector(31 downto 0);
+
+begin
+
+  frame_mode <= trace_ctrl(TRACE_FRAME);
+  trig_sel   <= to_integer(unsigned(trace_ctrl(TRACE_TRIG_LSB+1 downto TRACE_TRIG_LSB)));
+  trig_state <= unsigned(trace_ctrl(TRACE_STATE_LSB+WIDTH_ADSR_STATE-1 downto TRACE_STATE_LSB));
+  trig_slot  <= to_integer(unsigned(trace_ctrl(TRACE_SLOT_LSB+6 downto TRACE_SLOT_LSB)));
+  trig_level <= unsigned(trace_ctrl(TRACE_LEVEL_LSB+15 downto TRACE_LEVEL_LSB));
+
+  slot_hit  <= '1' when note_index_in = trig_slot else '0';
+  -- the most negative sample reads as the largest magnitude
+  magnitude <= unsigned(abs(note_in)) when note_in /= to_signed(-2**(DATA_WIDTH-1), DATA_WIDTH)
+               else to_unsigned(2**(DATA_WIDTH-1), DATA_WIDTH);
+
+  triggered <= '1' when trig_sel = TRACE_TRIG_NOW else
+               slot_hit when (trig_sel = TRACE_TRIG_STATE and
+                              adsr_state_in = trig_state and last_state_q /= trig_state) else
+               slot_hit when (trig_sel = TRACE_TRIG_LEVEL and
+                              resize(magnitude, 16) >= trig_level) else
+               '0';
+
+  entry <= std_logic_vector(to_unsigned(0, 32-TRACE_ADSR_LSB-WIDTH_ADSR_STATE)) &
+           std_logic_vector(adsr_state_in) &
+           cycle_start_in &
+           std_logic_vector(to_unsigned(note_index_in, TRACE_CYCLE_BIT-TRACE_NOTE_LSB)) &
+           std_logic_vector(resize(note_in, TRACE_NOTE_LSB));
+
+  -- a slot trace starts on the trigger, a frame trace on the frame start
+  -- from it
+  start <= '1' when (state_q = T_ARMED and triggered = '1' and
+                     (frame_mode = '0' or note_index_in = I_LOWEST_NOTE)) else
+           '1' when (state_q = T_WAIT_FRAME and note_index_in = I_LOWEST_NOTE) else
+           '0';
+
+  wr_en <= (frame_mode or slot_hit) when (state_q = T_CAPTURE or start = '1') else '0';
+
+  s_status: process(state_q, done_q, wr_ptr_q)
+  begin
+    trace_status <= (others => '0');
+    if (state_q = T_ARMED or state_q = T_WAIT_FRAME) then
+      trace_status(TRACE_ARMED) <= '1';
+    end if;
+    if (state_q = T_CAPTURE) then
+      trace_status(TRACE_RUNNING) <= '1';
+    end if;
+    trace_status(TRACE_DONE) <= done_q;
+    trace_status(TRACE_COUNT_LSB+DEPTH_BITS downto TRACE_COUNT_LSB) <= std_logic_vector(wr_ptr_q);
+  end process s_status;
+
+  rd_data <= rd_data_q;
+
+  -- capture state machine
+  s_capture: process(clk, rst)
+  begin
+    if (rst = '1') then
+      state_q      <= T_IDLE;
+      wr_ptr_q     <= (others => '0');
+      done_q       <= '0';
+      last_state_q <= (others => '0');
+    elsif (rising_edge(clk)) then
+      -- the state the traced slot had last frame, for the state trigger
+      if (slot_hit = '1') then
+        last_state_q <= adsr_state_in;
+      end if;
+
+      case state_q is
+        when T_ARMED =>
+          if (start = '1') then
+            state_q <= T_CAPTURE;
+          elsif (triggered = '1') then
+            state_q <= T_WAIT_FRAME;
+          end if;
+
+        when T_WAIT_FRAME =>
+          if (start = '1') then
+            state_q <= T_CAPTURE;
+          end if;
+
+        when others =>
+          null;
+      end case;
+
+      if (wr_en = '1') then
+        wr_ptr_q <= wr_ptr_q + 1;
+        if (wr_ptr_q = 2**DEPTH_BITS-1) then
+          state_q <= T_IDLE;
+          done_q  <= '1';
+        end if;
+      end if;
+
+      -- arming wins over everything above
+      if (trace_arm = '1') then
+        state_q  <= T_ARMED;
+        wr_ptr_q <= (others => '0');
+        done_q   <= '0';
+      end if;
+    end if;
+  end process s_capture;
+
+  -- buffer, kept out of the reset so it maps to block RAM
+  s_mem: process(clk)
+  begin
+    if (rising_edge(clk)) then
+      if (wr_en = '1') then
+        trace_mem(to_integer(wr_ptr_q(DEPTH_BITS-1 downto 0))) <= entry;
+      end if;
+      if (rd_en = '1') then
+        rd_data_q <= trace_mem(to_integer(rd_addr));
+      end if;
+    end if;
+  end process s_mem;
+
+end architecture rtl;
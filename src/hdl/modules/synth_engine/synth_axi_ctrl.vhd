@@ -7,6 +7,24 @@
 -- Module Name: Synthesizer AXI controller
 -- Description: 
 --   Provides an AXI-4 LITE interface to set controls to the synthesizer engine.
+--
+--   The address space is split into 128 word regions by the upper address
+--   bits, see the REGION_* constants in synth_pkg. Each timbre bank holds a
+--   waveform mix, pulse width, level, adsr and modulation routing; the
+--   waveform and adsr registers in the settings region are timbre 0.
+--   Polyphonic pressure has a word per note, channel pressure and its depth
+--   a settings register per timbre.
+--   The sustain and sostenuto pedals are a bit per timbre in one register,
+--   exported on the frame boundary with the note amplitudes.
+--   The tuning table is two banks of LUT RAM: the engine reads the live
+--   bank by slot and writes go to the other, which becomes live on a frame
+--   boundary. Tuning words are written as whole words.
+--   A glide register write with the start bit records the source note for
+--   its target slot, so every glide of a chord or a batch of notes goes out
+--   on the next frame boundary; a second glide into the same slot before
+--   then replaces the first.
+--   The last region reads the pipeline trace buffer, the page register
+--   selecting which 128 entries it shows.
 -- 
 -- Note: This file was originally generated in Vivado 2024.2 as a AXI peripheral.
 ----------------------------------------------------------------------------------
@@ -30,18 +48,50 @@ entity synth_axi_ctrl is
     -- user clock domain
     clk          : in  std_logic;
     rst          : in  std_logic;
+    -- high while slot_index is on the last slot, the exports land after it
+    frame_tick   : in  std_logic;
     -- Synth controls
     note_amps       : out t_note_amp;
-    ph_inc_table    : out t_ph_inc_lut;
-    wfrm_amps       : out t_wfrm_amp;
-    wfrm_phs        : out t_wfrm_ph;
+    note_pans       : out t_note_pan;
+    -- phase increment of the slot the phase accumulator is on
+    slot_index      : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+    ph_inc          : out unsigned(WIDTH_PH_DATA-1 downto 0);
+    note_timbres    : out t_note_timbre;
+    wfrm_amps       : out t_timbre_amps;
+    wfrm_phs        : out t_timbre_phs;
+    pulse_width     : out t_timbre_pw;
+    timbre_lvls     : out t_timbre_lvl;
+    attack_amt      : out t_adsr;
+    decay_amt       : out t_adsr;
+    sustain_amt     : out t_adsr;
+    release_amt     : out t_adsr;
     out_amp         : out unsigned(WIDTH_OUT_GAIN-1 downto 0);
     out_shift       : out unsigned(WIDTH_OUT_SHIFT-1 downto 0);
-    pulse_width     : out unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
-    attack_amt      : out unsigned(WIDTH_ADSR_CC-1 downto 0);
-    decay_amt       : out unsigned(WIDTH_ADSR_CC-1 downto 0);
-    sustain_amt     : out unsigned(WIDTH_ADSR_CC-1 downto 0);
-    release_amt     : out unsigned(WIDTH_ADSR_CC-1 downto 0);
+    wfrm_slew_rate  : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+    out_slew_rate   : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+    pw_slew_rate    : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+    lfo_rates       : out t_lfo_rate;
+    lfo_shapes      : out t_lfo_shape;
+    mod_sels        : out t_timbre_sel;
+    mod_depths      : out t_timbre_dep;
+    glide_rates     : out t_glide_rate;
+    -- glide start of the slot at slot_index and the note it glides from
+    glide_start     : out std_logic;
+    glide_from      : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+    note_press      : out t_note_press;
+    timbre_press    : out t_timbre_press;
+    press_depths    : out t_timbre_press;
+    sustain_pedals  : out t_timbre_bits;
+    sostenuto_pedals: out t_timbre_bits;
+    -- Synth status
+    active_notes    : in  t_note_bits;
+    -- Pipeline trace
+    trace_ctrl      : out std_logic_vector(31 downto 0);
+    trace_arm       : out std_logic;
+    trace_status    : in  std_logic_vector(31 downto 0);
+    trace_rd_en     : out std_logic;
+    trace_rd_addr   : out unsigned(TRACE_DEPTH_BITS-1 downto 0);
+    trace_rd_data   : in  std_logic_vector(31 downto 0);
 
     -- Global Clock Signal
     S_AXI_ACLK  : in std_logic;
@@ -123,38 +173,119 @@ architecture arch_imp of synth_axi_ctrl is
 
   -- constants
   constant ADDR_LSB : integer := (C_S_AXI_DATA_WIDTH/32)+ 1;
-  constant OPT_MEM_ADDR_BITS : integer := 8;
-
-  -- note amplitudes array
-  signal note_amps_int : t_note_amp;
-
-  -- phase increment table array
-  signal ph_inc_table_int : t_ph_inc_lut;
+  constant OPT_MEM_ADDR_BITS : integer := 9;
+  constant REGION_BITS : integer := 3;
+  constant OFFSET_BITS : integer := OPT_MEM_ADDR_BITS + 1 - REGION_BITS;
+
+  -- note amplitudes array, and the copy exported to the engine each frame
+  signal note_amps_int,
+         note_amps_out   : t_note_amp;
+  signal release_pending : std_logic;
+
+  -- note pan positions array
+  signal note_pans_int : t_note_pan;
+  signal note_press_int : t_note_press;
+
+  -- channel pressure and pressure depth of each timbre
+  signal timbre_press_int,
+         press_depths_int : t_timbre_press;
+
+  -- note timbre array
+  signal note_timbres_int : t_note_timbre;
+
+  -- phase increment tables, two banks in one memory. The engine reads the
+  -- live bank while writes go to the other, and the banks swap on the frame
+  -- boundary with the note amplitudes. After a swap each entry of the new
+  -- edit bank is stale until the engine reads it from the live bank and it
+  -- is copied across, or it is written again; the next swap waits for that.
+  type t_ph_inc_banks is array (0 to 2*NUM_NOTES-1) of unsigned(WIDTH_PH_DATA-1 downto 0);
+
+  function ph_inc_banks_init return t_ph_inc_banks is
+    variable banks : t_ph_inc_banks;
+  begin
+    for i in I_LOWEST_NOTE to I_HIGHEST_NOTE loop
+      banks(i)           := ph_inc_lut(i);
+      banks(NUM_NOTES+i) := ph_inc_lut(i);
+    end loop;
+    return banks;
+  end function;
 
-  -- adsr arrays
-  signal  attack_steps_int,
-          decay_steps_int,
-          sustain_levels_int,
-          release_steps_int    : t_adsr;
+  function bank_addr(bank : std_logic; slot : natural) return natural is
+  begin
+    if bank = '1' then
+      return NUM_NOTES + slot;
+    end if;
+    return slot;
+  end function;
+
+  signal ph_inc_mem     : t_ph_inc_banks := ph_inc_banks_init;
+  signal ph_inc_live    : std_logic;
+  signal ph_inc_dirty   : std_logic;
+  signal ph_inc_stale   : t_note_bits;
+  signal ph_inc_slot    : unsigned(WIDTH_PH_DATA-1 downto 0);
+  signal ph_inc_axi_wr  : std_logic;
+  signal ph_inc_wr_addr : natural range 0 to 2*NUM_NOTES-1;
+  signal ph_inc_wr_data : unsigned(WIDTH_PH_DATA-1 downto 0);
+  signal ph_inc_wr_strb : std_logic_vector(3 downto 0);
+
+  -- timbre banks
+  type t_timbre_bank is record
+    amps    : t_timbre_amps;
+    phs     : t_timbre_phs;
+    pw      : t_timbre_pw;
+    lvl     : t_timbre_lvl;
+    attack  : t_adsr;
+    decay   : t_adsr;
+    sustain : t_adsr;
+    release : t_adsr;
+    mod_sel : t_timbre_sel;
+    mod_dep : t_timbre_dep;
+  end record;
+  signal timbre_bank : t_timbre_bank;
+
+  -- lfo settings
+  signal lfo_rates_int  : t_lfo_rate;
+  signal lfo_shapes_int : t_lfo_shape;
+
+  -- glide source note of each slot, the slots with a glide start waiting
+  -- for the frame boundary, and those exported and not yet reached by the
+  -- engine
+  type t_glide_from is array (I_LOWEST_NOTE to I_HIGHEST_NOTE) of integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+
+  signal glide_froms      : t_glide_from := (others => I_LOWEST_NOTE);
+  signal glide_pend_int   : t_note_bits;
+  signal glide_starts_out : t_note_bits;
+  signal glide_wr_data    : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+  signal glide_wr         : std_logic;
+  signal glide_wr_to,
+         glide_wr_from    : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+
+  -- pedals exported on the frame boundary with the note amplitudes
+  signal pedal_reg_out   : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+
+  -- trace arm command, one clock
+  signal trace_arm_out   : std_logic;
 
   -- memory-mapped registers
-  signal  pulse_width_reg,
-          pulse_reg,
-          ramp_reg,
-          saw_reg,
-          tri_reg,
-          sine_reg,
-          attack_reg,
-          decay_reg,
-          sustain_reg,
-          release_reg,
-          out_amp_reg,
+  signal  out_amp_reg,
           out_shift_reg,
+          slew_rate_reg,
+          glide_rate_reg,
+          glide_reg,
+          pedal_reg,
+          gate_vel_reg,
+          note_ctrl_reg,
+          trace_ctrl_reg,
+          trace_page_reg,
           wrapback_reg   : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
 
   -- address indexing signals
   signal byte_index  : integer;
   signal mem_logic   : std_logic_vector(ADDR_LSB + OPT_MEM_ADDR_BITS downto ADDR_LSB);
+  signal wr_region,
+         rd_region   : std_logic_vector(REGION_BITS-1 downto 0);
+  signal wr_offset,
+         rd_offset   : std_logic_vector(OFFSET_BITS-1 downto 0);
 
    -- State machine local parameters
   constant Idle : std_logic_vector(1 downto 0) := "00";
@@ -168,37 +299,164 @@ architecture arch_imp of synth_axi_ctrl is
   signal state_write: std_logic_vector(1 downto 0); 
 
   -- array address
-  signal array_addr : integer range ADDR_LSB to 2**(ADDR_LSB + OPT_MEM_ADDR_BITS);
+  signal array_addr : integer range 0 to 2**OFFSET_BITS-1;
+  signal read_addr  : integer range 0 to 2**OFFSET_BITS-1;
+
+  -- timbre bank register contents at the write and read addresses
+  signal wr_timbre_data,
+         rd_timbre_data : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+
+  -- four note amplitudes packed one per byte
+  function pack_note_amps(amps : t_note_amp; word : natural) return std_logic_vector is
+    variable data : std_logic_vector(31 downto 0) := (others => '0');
+  begin
+    for j in 0 to 3 loop
+      data(8*j+WIDTH_NOTE_GAIN-1 downto 8*j) := std_logic_vector(amps(4*word+j));
+    end loop;
+    return data;
+  end function;
+
+  -- one bit per sounding note, 32 notes per word
+  function note_gate_bits(amps : t_note_amp; word : natural) return std_logic_vector is
+    variable data : std_logic_vector(31 downto 0) := (others => '0');
+  begin
+    for j in 0 to 31 loop
+      if amps(32*word+j) /= 0 then
+        data(j) := '1';
+      end if;
+    end loop;
+    return data;
+  end function;
+
+  -- timbre bank register, waveform registers hold the phase in the upper half
+  function timbre_reg(bank : t_timbre_bank; t : natural; param : std_logic_vector(3 downto 0)) return std_logic_vector is
+    variable data : std_logic_vector(31 downto 0) := (others => '0');
+    variable w    : natural range 0 to NUM_WFRMS-1;
+  begin
+    case param is
+      when OFFSET_TIMBRE_PW =>
+        data(WIDTH_PULSE_WIDTH-1 downto 0) := std_logic_vector(bank.pw(t));
+      when OFFSET_TIMBRE_PULSE | OFFSET_TIMBRE_RAMP | OFFSET_TIMBRE_SAW |
+           OFFSET_TIMBRE_TRI   | OFFSET_TIMBRE_SINE =>
+        w := to_integer(unsigned(param)) - 1;
+        data(WIDTH_WAVE_GAIN-1 downto 0) := std_logic_vector(bank.amps(t)(w));
+        data(31 downto 16)               := std_logic_vector(bank.phs(t)(w));
+      when OFFSET_TIMBRE_LEVEL =>
+        data(WIDTH_TIMBRE_LVL-1 downto 0) := std_logic_vector(bank.lvl(t));
+      when OFFSET_TIMBRE_ATTACK =>
+        data(WIDTH_ADSR_CC-1 downto 0) := std_logic_vector(bank.attack(t));
+      when OFFSET_TIMBRE_DECAY =>
+        data(WIDTH_ADSR_CC-1 downto 0) := std_logic_vector(bank.decay(t));
+      when OFFSET_TIMBRE_SUSTAIN =>
+        data(WIDTH_ADSR_CC-1 downto 0) := std_logic_vector(bank.sustain(t));
+      when OFFSET_TIMBRE_RELEASE =>
+        data(WIDTH_ADSR_CC-1 downto 0) := std_logic_vector(bank.release(t));
+      when OFFSET_TIMBRE_MOD_SRC =>
+        for d in 0 to NUM_MOD_DESTS-1 loop
+          data(8*d+WIDTH_LFO_SEL-1 downto 8*d) := std_logic_vector(bank.mod_sel(t)(d));
+        end loop;
+      when OFFSET_TIMBRE_MOD_PITCH | OFFSET_TIMBRE_MOD_AMP |
+           OFFSET_TIMBRE_MOD_PW    | OFFSET_TIMBRE_MOD_WFRM =>
+        data(WIDTH_MOD_DEPTH-1 downto 0) := std_logic_vector(bank.mod_dep(t)(to_integer(unsigned(param(1 downto 0)))));
+      when others =>
+        null;
+    end case;
+    return data;
+  end function;
+
+  -- lfo register, rate in the lower half and shape above it
+  function lfo_reg(rates : t_lfo_rate; shapes : t_lfo_shape; i : natural) return std_logic_vector is
+    variable data : std_logic_vector(31 downto 0) := (others => '0');
+  begin
+    data(WIDTH_LFO_RATE-1 downto 0)     := std_logic_vector(rates(i));
+    data(16+WIDTH_LFO_SHAPE-1 downto 16) := std_logic_vector(shapes(i));
+    return data;
+  end function;
+
+  -- timbre pressure register, channel pressure and the level depth
+  function press_reg(press, depths : t_timbre_press; t : natural) return std_logic_vector is
+    variable data : std_logic_vector(31 downto 0) := (others => '0');
+  begin
+    data(PRESS_LSB+WIDTH_PRESSURE-1 downto PRESS_LSB)             := std_logic_vector(press(t));
+    data(PRESS_DEPTH_LSB+WIDTH_PRESSURE-1 downto PRESS_DEPTH_LSB) := std_logic_vector(depths(t));
+    return data;
+  end function;
+
+  -- timbre and register of a timbre bank address, settings aliases timbre 0
+  function timbre_of(region, offset : std_logic_vector) return natural is
+  begin
+    if region = REGION_TIMBRE_BANK then
+      return to_integer(unsigned(offset(6 downto 4)));
+    end if;
+    return 0;
+  end function;
+
+  function timbre_param(region, offset : std_logic_vector) return std_logic_vector is
+  begin
+    if region = REGION_TIMBRE_BANK then
+      return offset(3 downto 0);
+    elsif offset(5) = '1' then
+      -- adsr registers, 32 to 35
+      return '1' & offset(2 downto 0);
+    end if;
+    return offset(3 downto 0);
+  end function;
 
 begin
 
   rst_n <= not(rst);
   -- output port assignements
-  note_amps      <= note_amps_int;
-  ph_inc_table   <= ph_inc_table_int;
-
-  wfrm_amps(I_PULSE) <= unsigned(pulse_reg(WIDTH_WAVE_GAIN-1 downto 0));
-  wfrm_amps(I_RAMP)  <= unsigned(ramp_reg(WIDTH_WAVE_GAIN-1 downto 0));
-  wfrm_amps(I_SAW)   <= unsigned(saw_reg(WIDTH_WAVE_GAIN-1 downto 0));
-  wfrm_amps(I_TRI)   <= unsigned(tri_reg(WIDTH_WAVE_GAIN-1 downto 0));
-  wfrm_amps(I_SINE)  <= unsigned(sine_reg(WIDTH_WAVE_GAIN-1 downto 0));
-  
-  wfrm_phs(I_PULSE)  <= unsigned(pulse_reg(C_S_AXI_DATA_WIDTH-1 downto C_S_AXI_DATA_WIDTH/2));
-  wfrm_phs(I_RAMP)   <= unsigned(ramp_reg(C_S_AXI_DATA_WIDTH-1 downto C_S_AXI_DATA_WIDTH/2));
-  wfrm_phs(I_SAW)    <= unsigned(saw_reg(C_S_AXI_DATA_WIDTH-1 downto C_S_AXI_DATA_WIDTH/2));
-  wfrm_phs(I_TRI)    <= unsigned(tri_reg(C_S_AXI_DATA_WIDTH-1 downto C_S_AXI_DATA_WIDTH/2));
-  wfrm_phs(I_SINE)   <= unsigned(sine_reg(C_S_AXI_DATA_WIDTH-1 downto C_S_AXI_DATA_WIDTH/2));
-
-  pulse_width <= unsigned(pulse_width_reg(WIDTH_PULSE_WIDTH-1 downto 0));
-
-  attack_amt  <= unsigned(attack_reg(WIDTH_ADSR_CC-1 downto 0));
-  decay_amt   <= unsigned(decay_reg(WIDTH_ADSR_CC-1 downto 0));
-  sustain_amt <= unsigned(sustain_reg(WIDTH_ADSR_CC-1 downto 0));
-  release_amt <= unsigned(release_reg(WIDTH_ADSR_CC-1 downto 0));
+  note_amps      <= note_amps_out;
+  note_pans      <= note_pans_int;
+  note_press     <= note_press_int;
+  timbre_press   <= timbre_press_int;
+  press_depths   <= press_depths_int;
+  note_timbres   <= note_timbres_int;
+  ph_inc         <= ph_inc_slot;
+
+  wfrm_amps   <= timbre_bank.amps;
+  wfrm_phs    <= timbre_bank.phs;
+  pulse_width <= timbre_bank.pw;
+  timbre_lvls <= timbre_bank.lvl;
+
+  attack_amt  <= timbre_bank.attack;
+  decay_amt   <= timbre_bank.decay;
+  sustain_amt <= timbre_bank.sustain;
+  release_amt <= timbre_bank.release;
+
+  mod_sels    <= timbre_bank.mod_sel;
+  mod_depths  <= timbre_bank.mod_dep;
+  lfo_rates   <= lfo_rates_int;
+  lfo_shapes  <= lfo_shapes_int;
 
   out_amp   <= unsigned(out_amp_reg(WIDTH_OUT_GAIN-1 downto 0));
   out_shift <= unsigned(out_shift_reg(WIDTH_OUT_SHIFT-1 downto 0));
 
+  -- slew rates: [3:0] waveform amps, [11:8] output amp, [19:16] pulse width
+  wfrm_slew_rate <= unsigned(slew_rate_reg( 0+WIDTH_SLEW_RATE-1 downto  0));
+  out_slew_rate  <= unsigned(slew_rate_reg( 8+WIDTH_SLEW_RATE-1 downto  8));
+  pw_slew_rate   <= unsigned(slew_rate_reg(16+WIDTH_SLEW_RATE-1 downto 16));
+
+  -- glide rates, four bits per timbre from bit 0
+  g_glide_rates: for t in 0 to NUM_TIMBRES-1 generate
+    glide_rates(t) <= unsigned(glide_rate_reg(WIDTH_GLIDE_RATE*t+WIDTH_GLIDE_RATE-1 downto WIDTH_GLIDE_RATE*t));
+  end generate g_glide_rates;
+
+  sustain_pedals   <= pedal_reg_out(PEDAL_SUSTAIN_LSB+NUM_TIMBRES-1 downto PEDAL_SUSTAIN_LSB);
+  sostenuto_pedals <= pedal_reg_out(PEDAL_SOSTENUTO_LSB+NUM_TIMBRES-1 downto PEDAL_SOSTENUTO_LSB);
+
+  glide_start <= glide_starts_out(slot_index);
+  glide_from  <= glide_froms(slot_index);
+
+  trace_ctrl <= trace_ctrl_reg;
+  trace_arm  <= trace_arm_out;
+
+  -- the trace buffer is read on the clock the read address is taken, so
+  -- its entry is ready with the read data valid
+  trace_rd_en   <= S_AXI_ARVALID and axi_arready;
+  trace_rd_addr <= unsigned(trace_page_reg(TRACE_DEPTH_BITS-OFFSET_BITS-1 downto 0)) &
+                   unsigned(S_AXI_ARADDR(ADDR_LSB+OFFSET_BITS-1 downto ADDR_LSB));
+
   S_AXI_AWREADY <= axi_awready;
   S_AXI_WREADY  <= axi_wready;
   S_AXI_BRESP   <= axi_bresp;
@@ -209,8 +467,64 @@ begin
   mem_logic     <= S_AXI_AWADDR(ADDR_LSB + OPT_MEM_ADDR_BITS downto ADDR_LSB) when (S_AXI_AWVALID = '1')
                   else axi_awaddr(ADDR_LSB + OPT_MEM_ADDR_BITS downto ADDR_LSB);
 
+  -- region and offset of the write and read addresses
+  wr_region <= mem_logic(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB+OFFSET_BITS);
+  wr_offset <= mem_logic(ADDR_LSB+OFFSET_BITS-1 downto ADDR_LSB);
+  rd_region <= axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB+OFFSET_BITS);
+  rd_offset <= axi_araddr(ADDR_LSB+OFFSET_BITS-1 downto ADDR_LSB);
+
   -- array address logic
-  array_addr <= to_integer(unsigned(mem_logic(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB)));
+  array_addr <= to_integer(unsigned(wr_offset));
+  read_addr  <= to_integer(unsigned(rd_offset));
+
+  -- timbre bank register lookup
+  wr_timbre_data <= timbre_reg(timbre_bank, timbre_of(wr_region, wr_offset), timbre_param(wr_region, wr_offset));
+  rd_timbre_data <= timbre_reg(timbre_bank, timbre_of(rd_region, rd_offset), timbre_param(rd_region, rd_offset));
+
+  -- phase increment banks: the engine reads the live bank at its slot, the
+  -- write port takes AXI writes to the edit bank, or else copies the slot's
+  -- live increment across while the edit bank has it stale
+  ph_inc_slot    <= ph_inc_mem(bank_addr(ph_inc_live, slot_index));
+  ph_inc_axi_wr  <= '1' when (rst_n = '1' and S_AXI_WVALID = '1' and wr_region = REGION_PH_INC) else '0';
+  ph_inc_wr_addr <= bank_addr(not ph_inc_live, array_addr) when (ph_inc_axi_wr = '1') else
+                    bank_addr(not ph_inc_live, slot_index);
+  ph_inc_wr_data <= unsigned(S_AXI_WDATA) when (ph_inc_axi_wr = '1') else ph_inc_slot;
+  ph_inc_wr_strb <= S_AXI_WSTRB when (ph_inc_axi_wr = '1') else
+                    "1111"      when (ph_inc_stale(slot_index) = '1') else
+                    "0000";
+
+  -- kept out of the reset so the banks map to LUT RAM
+  s_ph_inc_mem: process(clk)
+  begin
+    if rising_edge(clk) then
+      for b in 0 to 3 loop
+        if ph_inc_wr_strb(b) = '1' then
+          ph_inc_mem(ph_inc_wr_addr)(8*b+7 downto 8*b) <= ph_inc_wr_data(8*b+7 downto 8*b);
+        end if;
+      end loop;
+    end if;
+  end process s_ph_inc_mem;
+
+  -- glide register as a write leaves it, a write with the start bit is a
+  -- glide to record
+  g_glide_wr: for b in 0 to C_S_AXI_DATA_WIDTH/8-1 generate
+    glide_wr_data(8*b+7 downto 8*b) <= S_AXI_WDATA(8*b+7 downto 8*b) when (S_AXI_WSTRB(b) = '1') else
+                                       glide_reg(8*b+7 downto 8*b);
+  end generate g_glide_wr;
+  glide_wr      <= '1' when (rst_n = '1' and S_AXI_WVALID = '1' and wr_region = REGION_SETTINGS and
+                             wr_offset = OFFSET_GLIDE_REG and glide_wr_data(GLIDE_START) = '1') else '0';
+  glide_wr_to   <= to_integer(unsigned(glide_wr_data(GLIDE_TO_LSB+6 downto GLIDE_TO_LSB)));
+  glide_wr_from <= to_integer(unsigned(glide_wr_data(GLIDE_FROM_LSB+6 downto GLIDE_FROM_LSB)));
+
+  -- kept out of the reset so the source notes map to LUT RAM
+  s_glide_mem: process(clk)
+  begin
+    if rising_edge(clk) then
+      if (glide_wr = '1') then
+        glide_froms(glide_wr_to) <= glide_wr_from;
+      end if;
+    end if;
+  end process s_glide_mem;
 
   -- Implement Write state machine
   -- Outstanding write transactions are not supported by the slave i.e., master should assert bready to receive response on or before it starts sending the new transaction
@@ -323,75 +637,253 @@ begin
     end loop;
   end procedure;
 
+
+    -- write a timbre bank register through the byte strobes
+    procedure write_timbre(t : natural; param : std_logic_vector(3 downto 0)) is
+      variable w : natural range 0 to NUM_WFRMS-1;
+    begin
+      temp := wr_timbre_data;
+      write_strobe_array(temp, S_AXI_WDATA, S_AXI_WSTRB);
+      case param is
+        when OFFSET_TIMBRE_PW =>
+          timbre_bank.pw(t) <= unsigned(temp(WIDTH_PULSE_WIDTH-1 downto 0));
+        when OFFSET_TIMBRE_PULSE | OFFSET_TIMBRE_RAMP | OFFSET_TIMBRE_SAW |
+             OFFSET_TIMBRE_TRI   | OFFSET_TIMBRE_SINE =>
+          w := to_integer(unsigned(param)) - 1;
+          timbre_bank.amps(t)(w) <= unsigned(temp(WIDTH_WAVE_GAIN-1 downto 0));
+          timbre_bank.phs(t)(w)  <= unsigned(temp(31 downto 16));
+        when OFFSET_TIMBRE_LEVEL =>
+          timbre_bank.lvl(t) <= unsigned(temp(WIDTH_TIMBRE_LVL-1 downto 0));
+        when OFFSET_TIMBRE_ATTACK =>
+          timbre_bank.attack(t) <= unsigned(temp(WIDTH_ADSR_CC-1 downto 0));
+        when OFFSET_TIMBRE_DECAY =>
+          timbre_bank.decay(t) <= unsigned(temp(WIDTH_ADSR_CC-1 downto 0));
+        when OFFSET_TIMBRE_SUSTAIN =>
+          timbre_bank.sustain(t) <= unsigned(temp(WIDTH_ADSR_CC-1 downto 0));
+        when OFFSET_TIMBRE_RELEASE =>
+          timbre_bank.release(t) <= unsigned(temp(WIDTH_ADSR_CC-1 downto 0));
+        when OFFSET_TIMBRE_MOD_SRC =>
+          for d in 0 to NUM_MOD_DESTS-1 loop
+            timbre_bank.mod_sel(t)(d) <= unsigned(temp(8*d+WIDTH_LFO_SEL-1 downto 8*d));
+          end loop;
+        when OFFSET_TIMBRE_MOD_PITCH | OFFSET_TIMBRE_MOD_AMP |
+             OFFSET_TIMBRE_MOD_PW    | OFFSET_TIMBRE_MOD_WFRM =>
+          timbre_bank.mod_dep(t)(to_integer(unsigned(param(1 downto 0)))) <= unsigned(temp(WIDTH_MOD_DEPTH-1 downto 0));
+        when others =>
+          null;
+      end case;
+    end procedure;
+
   begin
     if rising_edge(clk) then 
       if rst_n = '0' then
-        pulse_width_reg    <= (others => '0');
-        pulse_reg          <= (others => '0');
-        ramp_reg           <= (others => '0');
-        saw_reg            <= (others => '0');
-        tri_reg            <= (others => '0');
-        sine_reg           <= (others => '0');
         out_amp_reg        <= (others => '0');
         out_shift_reg      <= (others => '0');
+        slew_rate_reg      <= (others => '0');
+        glide_rate_reg     <= (others => '0');
+        glide_reg          <= (others => '0');
+        glide_pend_int     <= (others => '0');
+        glide_starts_out   <= (others => '0');
+        pedal_reg          <= (others => '0');
+        pedal_reg_out      <= (others => '0');
+        gate_vel_reg       <= (others => '0');
+        note_ctrl_reg      <= (others => '0');
+        trace_ctrl_reg     <= (others => '0');
+        trace_page_reg     <= (others => '0');
+        trace_arm_out      <= '0';
         wrapback_reg       <= (others => '0');
         note_amps_int      <= (others => (others => '0'));
-        ph_inc_table_int   <= ph_inc_lut;
-        attack_steps_int   <= (others => (others => '0'));
-        decay_steps_int    <= (others => (others => '0'));
-        sustain_levels_int <= (others => (others => '0'));
-        release_steps_int  <= (others => (others => '0'));
+        note_amps_out      <= (others => (others => '0'));
+        release_pending    <= '0';
+        note_pans_int      <= (others => to_unsigned(PAN_CENTER, WIDTH_NOTE_PAN));
+        note_press_int     <= (others => (others => '0'));
+        timbre_press_int   <= (others => (others => '0'));
+        press_depths_int   <= (others => (others => '0'));
+        note_timbres_int   <= (others => (others => '0'));
+        -- the banks keep their contents, the edit bank is brought up to
+        -- the live one
+        ph_inc_live        <= '0';
+        ph_inc_dirty       <= '0';
+        ph_inc_stale       <= (others => '1');
+        timbre_bank.amps    <= (others => (others => (others => '0')));
+        timbre_bank.phs     <= (others => (others => (others => '0')));
+        timbre_bank.pw      <= (others => (others => '0'));
+        timbre_bank.lvl     <= (others => (others => '1'));
+        timbre_bank.attack  <= (others => (others => '0'));
+        timbre_bank.decay   <= (others => (others => '0'));
+        timbre_bank.sustain <= (others => (others => '0'));
+        timbre_bank.release <= (others => (others => '0'));
+        -- each destination defaults to its own lfo
+        for t in 0 to NUM_TIMBRES-1 loop
+          for d in 0 to NUM_MOD_DESTS-1 loop
+            timbre_bank.mod_sel(t)(d) <= to_unsigned(d mod NUM_LFOS, WIDTH_LFO_SEL);
+          end loop;
+        end loop;
+        timbre_bank.mod_dep <= (others => (others => (others => '0')));
+        lfo_rates_int       <= (others => (others => '0'));
+        lfo_shapes_int      <= (others => (others => '0'));
       else
+        -- export note amplitudes and the tuning table on the frame boundary so
+        -- writes made in the same frame, or while held, all take effect together
+        trace_arm_out   <= '0';
+        -- each slot takes its glide start as the engine passes it
+        glide_starts_out(slot_index) <= '0';
+        -- the edit bank entry at the engine slot is copied across this clock
+        if (ph_inc_axi_wr = '0') then
+          ph_inc_stale(slot_index) <= '0';
+        end if;
+        if (frame_tick = '1' and (note_ctrl_reg(NOTE_CTRL_HOLD) = '0' or release_pending = '1')) then
+          note_amps_out    <= note_amps_int;
+          -- swap in the retuned bank once the edit bank is whole, not on a
+          -- clock the edit bank is written
+          if (ph_inc_dirty = '1' and ph_inc_stale = (ph_inc_stale'range => '0') and
+              ph_inc_axi_wr = '0') then
+            ph_inc_live  <= not ph_inc_live;
+            ph_inc_dirty <= '0';
+            ph_inc_stale <= (others => '1');
+          end if;
+          pedal_reg_out    <= pedal_reg;
+          release_pending <= '0';
+          -- glide starts go out once, with the notes they slide into
+          for i in I_LOWEST_NOTE to I_HIGHEST_NOTE loop
+            if (glide_pend_int(i) = '1') then
+              glide_starts_out(i) <= '1';
+            end if;
+          end loop;
+          glide_pend_int <= (others => '0');
+          glide_reg(GLIDE_START) <= '0';
+        end if;
+
         if (S_AXI_WVALID = '1') then
-          case(mem_logic(mem_logic'high downto mem_logic'high-1)) is
+          case(wr_region) is
 
-            when "00" =>
+            when REGION_NOTE_AMP =>
               write_strobe_array(temp, S_AXI_WDATA, S_AXI_WSTRB);
               note_amps_int(array_addr) <= unsigned(temp(WIDTH_NOTE_GAIN-1 downto 0));
 
-            when "01" =>
+            when REGION_SETTINGS =>
+              if (wr_offset(OFFSET_BITS-1 downto OFFSET_BITS-2) = OFFSET_NOTE_PACK_REG) then
+              -- Packed note amplitudes, one note per byte lane
+                for j in 0 to 3 loop
+                  if S_AXI_WSTRB(j) = '1' then
+                    note_amps_int(4*(array_addr mod 32)+j) <= unsigned(S_AXI_WDATA(8*j+WIDTH_NOTE_GAIN-1 downto 8*j));
+                  end if;
+                end loop;
+              elsif (wr_offset(OFFSET_BITS-1 downto OFFSET_BITS-4) = OFFSET_PRESS_REG) then
+              -- Channel pressure and pressure depth, one timbre per word
+                temp := press_reg(timbre_press_int, press_depths_int, array_addr mod NUM_TIMBRES);
+                write_strobe_array(temp, S_AXI_WDATA, S_AXI_WSTRB);
+                timbre_press_int(array_addr mod NUM_TIMBRES) <= unsigned(temp(PRESS_LSB+WIDTH_PRESSURE-1 downto PRESS_LSB));
+                press_depths_int(array_addr mod NUM_TIMBRES) <= unsigned(temp(PRESS_DEPTH_LSB+WIDTH_PRESSURE-1 downto PRESS_DEPTH_LSB));
+              else
               -- Registers for synth settings
-              case(mem_logic(mem_logic'high-2 downto ADDR_LSB)) is
-                when OFFSET_PULSE_WIDTH_REG  => write_strobe(pulse_width_reg,    S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_PULSE_REG        => write_strobe(pulse_reg,          S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_RAMP_REG         => write_strobe(ramp_reg,           S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_SAW_REG          => write_strobe(saw_reg,            S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_TRI_REG          => write_strobe(tri_reg,            S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_SINE_REG         => write_strobe(sine_reg,           S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_ATTACK_AMT       => write_strobe(attack_reg,         S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_DECAY_AMT        => write_strobe(decay_reg,          S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_SUSTAIN_AMT      => write_strobe(sustain_reg,        S_AXI_WDATA, S_AXI_WSTRB);
-                when OFFSET_RELEASE_AMT      => write_strobe(release_reg,        S_AXI_WDATA, S_AXI_WSTRB);
+              case(wr_offset) is
+                when OFFSET_PULSE_WIDTH_REG | OFFSET_PULSE_REG | OFFSET_RAMP_REG |
+                     OFFSET_SAW_REG | OFFSET_TRI_REG | OFFSET_SINE_REG |
+                     OFFSET_ATTACK_AMT | OFFSET_DECAY_AMT |
+                     OFFSET_SUSTAIN_AMT | OFFSET_RELEASE_AMT =>
+                  -- timbre 0 bank
+                  write_timbre(0, timbre_param(wr_region, wr_offset));
+
                 when OFFSET_GAIN_SCALE_REG   => write_strobe(out_amp_reg,        S_AXI_WDATA, S_AXI_WSTRB);
                 when OFFSET_GAIN_SHIFT_REG   => write_strobe(out_shift_reg,      S_AXI_WDATA, S_AXI_WSTRB);
+                when OFFSET_SLEW_RATE_REG    => write_strobe(slew_rate_reg,      S_AXI_WDATA, S_AXI_WSTRB);
+                when OFFSET_GLIDE_RATE_REG   => write_strobe(glide_rate_reg,     S_AXI_WDATA, S_AXI_WSTRB);
+                when OFFSET_GLIDE_REG        =>
+                  write_strobe(glide_reg, S_AXI_WDATA, S_AXI_WSTRB);
+                  if (glide_wr = '1') then
+                    glide_pend_int(glide_wr_to) <= '1';
+                  end if;
+
+                when OFFSET_LFO_REG0 | OFFSET_LFO_REG1 |
+                     OFFSET_LFO_REG2 | OFFSET_LFO_REG3 =>
+                  temp := lfo_reg(lfo_rates_int, lfo_shapes_int, array_addr mod NUM_LFOS);
+                  write_strobe_array(temp, S_AXI_WDATA, S_AXI_WSTRB);
+                  lfo_rates_int(array_addr mod NUM_LFOS)  <= unsigned(temp(WIDTH_LFO_RATE-1 downto 0));
+                  lfo_shapes_int(array_addr mod NUM_LFOS) <= unsigned(temp(16+WIDTH_LFO_SHAPE-1 downto 16));
+                when OFFSET_GATE_VEL_REG     => write_strobe(gate_vel_reg,       S_AXI_WDATA, S_AXI_WSTRB);
+
+                when OFFSET_NOTE_GATE_REG0 | OFFSET_NOTE_GATE_REG1 |
+                     OFFSET_NOTE_GATE_REG2 | OFFSET_NOTE_GATE_REG3 =>
+                  -- gate 32 notes on at the gate velocity or off
+                  for j in 0 to 31 loop
+                    if S_AXI_WSTRB(j/8) = '1' then
+                      if S_AXI_WDATA(j) = '1' then
+                        note_amps_int(32*(array_addr mod 4)+j) <= unsigned(gate_vel_reg(WIDTH_NOTE_GAIN-1 downto 0));
+                      else
+                        note_amps_int(32*(array_addr mod 4)+j) <= (others => '0');
+                      end if;
+                    end if;
+                  end loop;
+
+                when OFFSET_PEDAL_REG        => write_strobe(pedal_reg,          S_AXI_WDATA, S_AXI_WSTRB);
+
+                when OFFSET_NOTE_CTRL_REG =>
+                  write_strobe(note_ctrl_reg, S_AXI_WDATA, S_AXI_WSTRB);
+                  -- release all is a command, silence every note in one write
+                  if S_AXI_WSTRB(0) = '1' and S_AXI_WDATA(NOTE_CTRL_RELEASE_ALL) = '1' then
+                    note_amps_int   <= (others => (others => '0'));
+                    release_pending <= '1';
+                    note_ctrl_reg(NOTE_CTRL_RELEASE_ALL) <= '0';
+                  end if;
+
+                when OFFSET_TRACE_CTRL_REG =>
+                  write_strobe(trace_ctrl_reg, S_AXI_WDATA, S_AXI_WSTRB);
+                  -- arm is a command, the capture starts with this write
+                  if S_AXI_WSTRB(0) = '1' and S_AXI_WDATA(TRACE_ARM) = '1' then
+                    trace_arm_out <= '1';
+                    trace_ctrl_reg(TRACE_ARM) <= '0';
+                  end if;
+
+                when OFFSET_TRACE_PAGE_REG   => write_strobe(trace_page_reg,     S_AXI_WDATA, S_AXI_WSTRB);
+
                 when OFFSET_WRAPBACK_REG     => write_strobe(wrapback_reg,       S_AXI_WDATA, S_AXI_WSTRB);
                 
                 when others =>
 
-                  pulse_width_reg    <= pulse_width_reg;
-                  pulse_reg          <= pulse_reg;
-                  ramp_reg           <= ramp_reg;
-                  saw_reg            <= saw_reg;
-                  tri_reg            <= tri_reg;
-                  sine_reg           <= sine_reg;
-                  attack_reg         <= attack_reg;
-                  decay_reg          <= decay_reg;
-                  sustain_reg        <= sustain_reg;
-                  release_reg        <= release_reg;
                   out_amp_reg        <= out_amp_reg;
                   out_shift_reg      <= out_shift_reg;
+                  slew_rate_reg      <= slew_rate_reg;
+                  glide_rate_reg     <= glide_rate_reg;
+                  glide_reg          <= glide_reg;
+                  pedal_reg          <= pedal_reg;
+                  gate_vel_reg       <= gate_vel_reg;
+                  note_ctrl_reg      <= note_ctrl_reg;
+                  trace_ctrl_reg     <= trace_ctrl_reg;
+                  trace_page_reg     <= trace_page_reg;
                   wrapback_reg       <= wrapback_reg;
               
               end case;
+              end if;
             
-            when "10" =>
-            -- Registers for note frequency words
+            when REGION_PH_INC =>
+            -- Registers for note frequency words, the edit bank is written
+            -- on the write port above
+              ph_inc_dirty <= '1';
+              ph_inc_stale(array_addr) <= '0';
+
+            when REGION_NOTE_PAN =>
+            -- Registers for note pan positions
               write_strobe_array(temp, S_AXI_WDATA, S_AXI_WSTRB);
-              ph_inc_table_int(array_addr) <= unsigned(temp);
+              note_pans_int(array_addr) <= unsigned(temp(WIDTH_NOTE_PAN-1 downto 0));
+
+            when REGION_NOTE_TIMBRE =>
+            -- Registers for note timbre selection
+              write_strobe_array(temp, S_AXI_WDATA, S_AXI_WSTRB);
+              note_timbres_int(array_addr) <= unsigned(temp(WIDTH_TIMBRE-1 downto 0));
+
+            when REGION_NOTE_PRESS =>
+            -- Registers for polyphonic note pressure
+              write_strobe_array(temp, S_AXI_WDATA, S_AXI_WSTRB);
+              note_press_int(array_addr) <= unsigned(temp(WIDTH_PRESSURE-1 downto 0));
+
+            when REGION_TIMBRE_BANK =>
+            -- Registers for timbre banks, 16 per timbre
+              write_timbre(timbre_of(wr_region, wr_offset), timbre_param(wr_region, wr_offset));
             
             when others =>
               note_amps_int    <= note_amps_int;
-              ph_inc_table_int <= ph_inc_table_int;
+              note_pans_int    <= note_pans_int;
 
           end case;
         end if;
@@ -445,27 +937,68 @@ begin
   -- Implement memory mapped register select and read logic generation
   S_AXI_RDATA <= 
     -- read note amplitude
-    x"000000" & '0' & std_logic_vector(note_amps_int(to_integer(unsigned(axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB))))) when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB+OPT_MEM_ADDR_BITS-1) = "00" ) else
+    x"000000" & '0' & std_logic_vector(note_amps_int(read_addr)) when (rd_region = REGION_NOTE_AMP ) else
     -- read from note phase increment table
-    std_logic_vector(ph_inc_table_int(to_integer(unsigned(axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB))))) when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB+OPT_MEM_ADDR_BITS-1) = "10" ) else
-    -- read from synth settings
-    pulse_width_reg    when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_PULSE_WIDTH_REG   ) else 
-    pulse_reg          when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_PULSE_REG         ) else 
-    ramp_reg           when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_RAMP_REG          ) else 
-    saw_reg            when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_SAW_REG           ) else 
-    tri_reg            when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_TRI_REG           ) else 
-    sine_reg           when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_SINE_REG          ) else 
-    out_amp_reg        when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_GAIN_SCALE_REG    ) else
-    out_shift_reg      when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_GAIN_SHIFT_REG    ) else
+    -- an entry still stale in the edit bank reads from the live bank
+    std_logic_vector(ph_inc_mem(bank_addr(ph_inc_live xor not ph_inc_stale(read_addr), read_addr)))
+                         when (rd_region = REGION_PH_INC ) else
+    -- read note pan position
+    x"000000" & '0' & std_logic_vector(note_pans_int(read_addr)) when (rd_region = REGION_NOTE_PAN ) else
+    -- read note timbre
+    std_logic_vector(resize(note_timbres_int(read_addr), C_S_AXI_DATA_WIDTH)) when (rd_region = REGION_NOTE_TIMBRE ) else
+    -- read note pressure
+    std_logic_vector(resize(note_press_int(read_addr), C_S_AXI_DATA_WIDTH)) when (rd_region = REGION_NOTE_PRESS ) else
+    -- read timbre banks
+    rd_timbre_data when (rd_region = REGION_TIMBRE_BANK ) else
+    -- read the trace buffer
+    trace_rd_data when (rd_region = REGION_TRACE ) else
+    (others => '0') when (rd_region /= REGION_SETTINGS ) else
+    -- read packed note amplitudes and note gates
+    pack_note_amps(note_amps_int, read_addr mod 32) when (rd_offset(OFFSET_BITS-1 downto OFFSET_BITS-2) = OFFSET_NOTE_PACK_REG ) else
+    -- read channel pressure and pressure depth
+    press_reg(timbre_press_int, press_depths_int, read_addr mod NUM_TIMBRES) when (rd_offset(OFFSET_BITS-1 downto OFFSET_BITS-4) = OFFSET_PRESS_REG ) else
+    note_gate_bits(note_amps_int, 0) when (rd_offset = OFFSET_NOTE_GATE_REG0 ) else
+    note_gate_bits(note_amps_int, 1) when (rd_offset = OFFSET_NOTE_GATE_REG1 ) else
+    note_gate_bits(note_amps_int, 2) when (rd_offset = OFFSET_NOTE_GATE_REG2 ) else
+    note_gate_bits(note_amps_int, 3) when (rd_offset = OFFSET_NOTE_GATE_REG3 ) else
+    gate_vel_reg       when (rd_offset = OFFSET_GATE_VEL_REG      ) else
+    note_ctrl_reg      when (rd_offset = OFFSET_NOTE_CTRL_REG     ) else
+    pedal_reg          when (rd_offset = OFFSET_PEDAL_REG         ) else
+    -- read active note bitmap
+    active_notes( 31 downto  0) when (rd_offset = OFFSET_ACTIVE_REG0 ) else
+    active_notes( 63 downto 32) when (rd_offset = OFFSET_ACTIVE_REG1 ) else
+    active_notes( 95 downto 64) when (rd_offset = OFFSET_ACTIVE_REG2 ) else
+    active_notes(127 downto 96) when (rd_offset = OFFSET_ACTIVE_REG3 ) else
+    -- read trace control and status
+    trace_ctrl_reg     when (rd_offset = OFFSET_TRACE_CTRL_REG    ) else
+    trace_status       when (rd_offset = OFFSET_TRACE_STAT_REG    ) else
+    trace_page_reg     when (rd_offset = OFFSET_TRACE_PAGE_REG    ) else
+    -- read from synth settings, waveform and adsr settings are timbre 0
+    rd_timbre_data     when (rd_offset = OFFSET_PULSE_WIDTH_REG   ) else 
+    rd_timbre_data     when (rd_offset = OFFSET_PULSE_REG         ) else 
+    rd_timbre_data     when (rd_offset = OFFSET_RAMP_REG          ) else 
+    rd_timbre_data     when (rd_offset = OFFSET_SAW_REG           ) else 
+    rd_timbre_data     when (rd_offset = OFFSET_TRI_REG           ) else 
+    rd_timbre_data     when (rd_offset = OFFSET_SINE_REG          ) else 
+    out_amp_reg        when (rd_offset = OFFSET_GAIN_SCALE_REG    ) else
+    out_shift_reg      when (rd_offset = OFFSET_GAIN_SHIFT_REG    ) else
+    slew_rate_reg      when (rd_offset = OFFSET_SLEW_RATE_REG     ) else
+    glide_rate_reg     when (rd_offset = OFFSET_GLIDE_RATE_REG    ) else
+    glide_reg          when (rd_offset = OFFSET_GLIDE_REG         ) else
+    -- read lfo settings
+    lfo_reg(lfo_rates_int, lfo_shapes_int, 0) when (rd_offset = OFFSET_LFO_REG0 ) else
+    lfo_reg(lfo_rates_int, lfo_shapes_int, 1) when (rd_offset = OFFSET_LFO_REG1 ) else
+    lfo_reg(lfo_rates_int, lfo_shapes_int, 2) when (rd_offset = OFFSET_LFO_REG2 ) else
+    lfo_reg(lfo_rates_int, lfo_shapes_int, 3) when (rd_offset = OFFSET_LFO_REG3 ) else
     -- read from adsr settings
-    attack_reg         when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_ATTACK_AMT        ) else
-    decay_reg          when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_DECAY_AMT         ) else
-    sustain_reg        when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_SUSTAIN_AMT       ) else
-    release_reg        when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_RELEASE_AMT       ) else
+    rd_timbre_data     when (rd_offset = OFFSET_ATTACK_AMT        ) else
+    rd_timbre_data     when (rd_offset = OFFSET_DECAY_AMT         ) else
+    rd_timbre_data     when (rd_offset = OFFSET_SUSTAIN_AMT       ) else
+    rd_timbre_data     when (rd_offset = OFFSET_RELEASE_AMT       ) else
     -- read from info registers
-    SYNTH_ENG_REV      when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_REV_REG           ) else 
-    SYNTH_ENG_DATE     when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_DATE_REG          ) else 
-    wrapback_reg       when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS-2 downto ADDR_LSB) = OFFSET_WRAPBACK_REG      ) else 
+    SYNTH_ENG_REV      when (rd_offset = OFFSET_REV_REG           ) else 
+    SYNTH_ENG_DATE     when (rd_offset = OFFSET_DATE_REG          ) else 
+    wrapback_reg       when (rd_offset = OFFSET_WRAPBACK_REG      ) else 
     -- default
     (others => '0');
 
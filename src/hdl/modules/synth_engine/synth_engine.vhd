@@ -57,7 +57,8 @@ entity synth_engine is
     s_axi_rready  : in  std_logic;
 
     -- Digital audio output
-    audio_out     : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
+    audio_out_l   : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0);
+    audio_out_r   : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
   );
   end synth_engine;
   
@@ -73,18 +74,47 @@ architecture struct_synth_engine of synth_engine is
       -- user clock domain
       clk            : in  std_logic;
       rst            : in  std_logic;
+      frame_tick     : in  std_logic;
       -- synth controls out
       note_amps      : out t_note_amp;
-      ph_inc_table   : out t_ph_inc_lut;
-      wfrm_amps      : out t_wfrm_amp;
-      wfrm_phs       : out t_wfrm_ph;
+      note_pans      : out t_note_pan;
+      slot_index     : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      ph_inc         : out unsigned(WIDTH_PH_DATA-1 downto 0);
+      note_timbres   : out t_note_timbre;
+      wfrm_amps      : out t_timbre_amps;
+      wfrm_phs       : out t_timbre_phs;
+      pulse_width    : out t_timbre_pw;
+      timbre_lvls    : out t_timbre_lvl;
+      attack_amt     : out t_adsr;
+      decay_amt      : out t_adsr;
+      sustain_amt    : out t_adsr;
+      release_amt    : out t_adsr;
       out_amp        : out unsigned(WIDTH_OUT_GAIN-1 downto 0);
       out_shift      : out unsigned(WIDTH_OUT_SHIFT-1 downto 0);
-      pulse_width    : out unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
-      attack_amt     : out unsigned(WIDTH_ADSR_CC-1 downto 0);
-      decay_amt      : out unsigned(WIDTH_ADSR_CC-1 downto 0);
-      sustain_amt    : out unsigned(WIDTH_ADSR_CC-1 downto 0);
-      release_amt    : out unsigned(WIDTH_ADSR_CC-1 downto 0);
+      wfrm_slew_rate : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+      out_slew_rate  : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+      pw_slew_rate   : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+      lfo_rates      : out t_lfo_rate;
+      lfo_shapes     : out t_lfo_shape;
+      mod_sels       : out t_timbre_sel;
+      mod_depths     : out t_timbre_dep;
+      glide_rates    : out t_glide_rate;
+      glide_start    : out std_logic;
+      glide_from     : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      note_press     : out t_note_press;
+      timbre_press   : out t_timbre_press;
+      press_depths   : out t_timbre_press;
+      sustain_pedals : out t_timbre_bits;
+      sostenuto_pedals : out t_timbre_bits;
+      -- note status in
+      active_notes   : in  t_note_bits;
+      -- pipeline trace
+      trace_ctrl     : out std_logic_vector(31 downto 0);
+      trace_arm      : out std_logic;
+      trace_status   : in  std_logic_vector(31 downto 0);
+      trace_rd_en    : out std_logic;
+      trace_rd_addr  : out unsigned(TRACE_DEPTH_BITS-1 downto 0);
+      trace_rd_data  : in  std_logic_vector(31 downto 0);
 
       -- AXI control interface
       s_axi_aclk     : in  std_logic;
@@ -111,6 +141,59 @@ architecture struct_synth_engine of synth_engine is
     );
   end component synth_axi_ctrl;
 
+  component param_slew is
+    generic (
+      NUM_PARAMS : natural := 1;
+      DATA_WIDTH : natural := 7;
+      RATE_WIDTH : natural := 4;
+      FRAC_WIDTH : natural := 16
+    );
+    port (
+      clk        : in  std_logic;
+      rst        : in  std_logic;
+      tick       : in  std_logic;
+      rate       : in  unsigned(RATE_WIDTH-1 downto 0);
+      targets    : in  std_logic_vector(NUM_PARAMS*DATA_WIDTH-1 downto 0);
+      values_out : out std_logic_vector(NUM_PARAMS*DATA_WIDTH-1 downto 0)
+    );
+  end component param_slew;
+
+  component lfo_bank is
+    generic (
+      PHASE_WIDTH : natural := WIDTH_LFO_PH;
+      LFO_WIDTH   : natural := WIDTH_LFO
+    );
+    port (
+      clk      : in  std_logic;
+      rst      : in  std_logic;
+      tick     : in  std_logic;
+      rates    : in  t_lfo_rate;
+      shapes   : in  t_lfo_shape;
+      lfo_out  : out t_lfo_out
+    );
+  end component lfo_bank;
+
+  component mod_matrix is
+    port (
+      clk             : in  std_logic;
+      rst             : in  std_logic;
+      tick            : in  std_logic;
+      -- modulation sources and routing
+      lfos            : in  t_lfo_out;
+      mod_sels        : in  t_timbre_sel;
+      mod_depths      : in  t_timbre_dep;
+      -- timbre controls in
+      wfrm_amps       : in  t_timbre_amps;
+      pulse_width     : in  t_timbre_pw;
+      timbre_lvls     : in  t_timbre_lvl;
+      -- modulated timbre controls out
+      pitch_mods      : out t_timbre_mod;
+      wfrm_amps_out   : out t_timbre_amps;
+      pulse_width_out : out t_timbre_pw;
+      timbre_lvls_out : out t_timbre_lvl
+    );
+  end component mod_matrix;
+
   component phase_accumulator is
     generic (
       PHASE_WIDTH     : integer := WIDTH_PH_DATA;
@@ -120,8 +203,14 @@ architecture struct_synth_engine of synth_engine is
       clk             : in  std_logic;
       rst             : in  std_logic;
       -- synth controls
-      phase_incs      : in  t_ph_inc_lut;
+      slot_index      : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      ph_inc          : in  unsigned(WIDTH_PH_DATA-1 downto 0);
       note_amps       : in  t_note_amp;
+      note_timbres    : in  t_note_timbre;
+      pitch_mods      : in  t_timbre_mod;
+      glide_rates     : in  t_glide_rate;
+      glide_start     : in  std_logic;
+      glide_from      : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       -- pipeline out
       note_index_out  : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       phase_out       : out unsigned(PHASE_WIDTH-1 downto 0);
@@ -135,15 +224,18 @@ architecture struct_synth_engine of synth_engine is
       PHASE_WIDTH     : integer := WIDTH_PH_DATA;
       NOTE_GAIN_WIDTH : integer := WIDTH_NOTE_GAIN;
       DATA_WIDTH      : natural := WIDTH_WAVE_DATA;
-      SIN_LUT_PH      : natural := 12
+      SIN_LUT_PH      : natural := 12;
+      SIN_INTERP_PH   : natural := 0
     );
     port (
       clk             : in  std_logic;
       rst             : in  std_logic;
       -- synth controls
-      wfrm_amps       : in  t_wfrm_amp;
-      wfrm_phs        : in  t_wfrm_ph;
-      pulse_width     : in  unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
+      wfrm_amps       : in  t_timbre_amps;
+      wfrm_phs        : in  t_timbre_phs;
+      pulse_width     : in  t_timbre_pw;
+      note_timbres    : in  t_note_timbre;
+      active_notes    : in  t_note_bits;
       -- pipeline in
       note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       phase_in        : in  unsigned(PHASE_WIDTH-1 downto 0);
@@ -168,10 +260,13 @@ architecture struct_synth_engine of synth_engine is
       clk             : in  std_logic;
       rst             : in  std_logic;
       -- synth controls
-      attack_amt      : in  unsigned(ADSR_WIDTH-1 downto 0);
-      decay_amt       : in  unsigned(ADSR_WIDTH-1 downto 0);
-      sustain_amt     : in  unsigned(ADSR_WIDTH-1 downto 0);
-      release_amt     : in  unsigned(ADSR_WIDTH-1 downto 0);
+      attack_amt      : in  t_adsr;
+      decay_amt       : in  t_adsr;
+      sustain_amt     : in  t_adsr;
+      release_amt     : in  t_adsr;
+      note_timbres    : in  t_note_timbre;
+      sustain_pedals  : in  t_timbre_bits;
+      sostenuto_pedals: in  t_timbre_bits;
       -- pipeline in
       note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       note_amp_in     : in  unsigned(NOTE_GAIN_WIDTH-1 downto 0);
@@ -179,7 +274,35 @@ architecture struct_synth_engine of synth_engine is
       cycle_start_in  : in  std_logic;
       -- pipeline out
       note_index_out  : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
-      note_out        : out signed(DATA_WIDTH-1 downto 0)
+      note_out        : out signed(DATA_WIDTH-1 downto 0);
+      cycle_start_out : out std_logic;
+      adsr_state_out  : out unsigned(WIDTH_ADSR_STATE-1 downto 0);
+      -- note status
+      active_notes    : out t_note_bits
+    );
+  end component;
+
+  component pipeline_trace is
+    generic (
+      DEPTH_BITS : natural := TRACE_DEPTH_BITS;
+      DATA_WIDTH : natural := WIDTH_WAVE_DATA
+    );
+    port (
+      clk             : in  std_logic;
+      rst             : in  std_logic;
+      -- trace controls
+      trace_ctrl      : in  std_logic_vector(31 downto 0);
+      trace_arm       : in  std_logic;
+      trace_status    : out std_logic_vector(31 downto 0);
+      -- pipeline in
+      note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      note_in         : in  signed(DATA_WIDTH-1 downto 0);
+      cycle_start_in  : in  std_logic;
+      adsr_state_in   : in  unsigned(WIDTH_ADSR_STATE-1 downto 0);
+      -- buffer read port
+      rd_en           : in  std_logic;
+      rd_addr         : in  unsigned(DEPTH_BITS-1 downto 0);
+      rd_data         : out std_logic_vector(31 downto 0)
     );
   end component;
 
@@ -187,6 +310,7 @@ architecture struct_synth_engine of synth_engine is
     generic (
       OUT_GAIN_WIDTH  : integer := WIDTH_OUT_GAIN;
       OUT_SHIFT_WIDTH : integer := WIDTH_OUT_SHIFT;
+      PAN_WIDTH       : integer := WIDTH_NOTE_PAN;
       DATA_WIDTH      : natural := WIDTH_WAVE_DATA;
       OUT_DATA_WIDTH  : natural := WIDTH_WAVE_DATA+8
     );
@@ -196,11 +320,18 @@ architecture struct_synth_engine of synth_engine is
       -- synth controls
       out_amp         : in  unsigned(WIDTH_OUT_GAIN-1 downto 0);
       out_shift       : in  unsigned(WIDTH_OUT_SHIFT-1 downto 0);
+      note_pans       : in  t_note_pan;
+      note_timbres    : in  t_note_timbre;
+      timbre_lvls     : in  t_timbre_lvl;
+      note_press      : in  t_note_press;
+      timbre_press    : in  t_timbre_press;
+      press_depths    : in  t_timbre_press;
       -- pipeline in
       note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       note_in         : in  signed(DATA_WIDTH-1 downto 0);
       -- pipeline out
-      audio_out       : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
+      audio_out_l     : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0);
+      audio_out_r     : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
     );
   end component;
 
@@ -224,23 +355,91 @@ architecture struct_synth_engine of synth_engine is
 
   -- start of cycle pipeline signals
   signal cycle_start_q,
-         cycle_start_q2 : std_logic;
+         cycle_start_q2,
+         cycle_start_q3 : std_logic;
+
+  -- envelope state of the slot leaving the envelope stage
+  signal adsr_state_q3 : unsigned(WIDTH_ADSR_STATE-1 downto 0);
 
   -- synth controller signals
-  signal ph_inc_table    : t_ph_inc_lut;
+  signal ph_inc_slot     : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  signal ph_inc          : unsigned(WIDTH_PH_DATA-1 downto 0);
   signal note_amps       : t_note_amp;
-  signal wfrm_amps       : t_wfrm_amp;
-  signal wfrm_phs        : t_wfrm_ph;
+  signal note_pans       : t_note_pan;
+  signal note_timbres    : t_note_timbre;
+  signal wfrm_amps       : t_timbre_amps;
+  signal wfrm_phs        : t_timbre_phs;
+  signal pulse_width     : t_timbre_pw;
+  signal timbre_lvls     : t_timbre_lvl;
   signal out_amp         : unsigned(WIDTH_OUT_GAIN-1 downto 0);
   signal out_shift       : unsigned(WIDTH_OUT_SHIFT-1 downto 0);
-  signal pulse_width     : unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
   signal  attack_amt,
           decay_amt,
           sustain_amt,
-          release_amt   : unsigned(WIDTH_ADSR_CC-1 downto 0);
+          release_amt   : t_adsr;
+
+  -- control targets written over AXI, smoothed into the controls above
+  signal wfrm_amps_target   : t_timbre_amps;
+  signal out_amp_target     : unsigned(WIDTH_OUT_GAIN-1 downto 0);
+  signal pulse_width_target : t_timbre_pw;
+
+  -- slewed controls flattened one parameter after another
+  signal wfrm_amps_flat_target,
+         wfrm_amps_flat     : std_logic_vector(NUM_TIMBRES*NUM_WFRMS*WIDTH_WAVE_GAIN-1 downto 0);
+  signal pulse_width_flat_target,
+         pulse_width_flat   : std_logic_vector(NUM_TIMBRES*WIDTH_PULSE_WIDTH-1 downto 0);
+  signal  wfrm_slew_rate,
+          out_slew_rate,
+          pw_slew_rate      : unsigned(WIDTH_SLEW_RATE-1 downto 0);
+
+  -- lfos and modulation routing
+  signal lfo_rates          : t_lfo_rate;
+  signal lfo_shapes         : t_lfo_shape;
+  signal lfos               : t_lfo_out;
+  signal mod_sels           : t_timbre_sel;
+  signal mod_depths         : t_timbre_dep;
+
+  -- smoothed controls after modulation
+  signal pitch_mods         : t_timbre_mod;
+
+  -- portamento
+  signal glide_rates        : t_glide_rate;
+  signal glide_start        : std_logic;
+  signal glide_from         : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+
+  -- key pressure
+  signal note_press         : t_note_press;
+  signal timbre_press,
+         press_depths       : t_timbre_press;
+
+  -- sustain and sostenuto pedals
+  signal sustain_pedals,
+         sostenuto_pedals   : t_timbre_bits;
+  signal wfrm_amps_mod      : t_timbre_amps;
+  signal pulse_width_mod    : t_timbre_pw;
+  signal timbre_lvls_mod    : t_timbre_lvl;
+
+  -- note slots keyed or still sounding
+  signal active_notes       : t_note_bits;
+
+  -- one clock pulse per audio frame
+  signal frame_tick : std_logic;
+
+  -- pipeline trace
+  signal trace_ctrl,
+         trace_status,
+         trace_rd_data : std_logic_vector(31 downto 0);
+  signal trace_arm,
+         trace_rd_en   : std_logic;
+  signal trace_rd_addr : unsigned(TRACE_DEPTH_BITS-1 downto 0);
 
 begin
 
+  -- the default tuning table is generated for a given clock and slot count
+  assert (TUNING_CLK_HZ = SYNTH_CLK_HZ and TUNING_NUM_NOTES = NUM_NOTES)
+    report "music_note_pkg does not match synth_pkg, rerun src/tools/gen_tuning.py"
+    severity failure;
+
   rst_n     <= not(rst);
 
   u_synth_axi_ctrl: synth_axi_ctrl
@@ -254,18 +453,47 @@ begin
       -- user clock domain
       clk             => clk,
       rst             => rst,
+      frame_tick      => frame_tick,
       -- synth controls out
       note_amps       => note_amps,
-      ph_inc_table    => ph_inc_table,
-      wfrm_amps       => wfrm_amps,
+      note_pans       => note_pans,
+      slot_index      => ph_inc_slot,
+      ph_inc          => ph_inc,
+      note_timbres    => note_timbres,
+      wfrm_amps       => wfrm_amps_target,
       wfrm_phs        => wfrm_phs,
-      out_amp         => out_amp,
-      out_shift       => out_shift,
-      pulse_width     => pulse_width,
+      pulse_width     => pulse_width_target,
+      timbre_lvls     => timbre_lvls,
       attack_amt      => attack_amt,
       decay_amt       => decay_amt,
       sustain_amt     => sustain_amt,
       release_amt     => release_amt,
+      out_amp         => out_amp_target,
+      out_shift       => out_shift,
+      wfrm_slew_rate  => wfrm_slew_rate,
+      out_slew_rate   => out_slew_rate,
+      pw_slew_rate    => pw_slew_rate,
+      lfo_rates       => lfo_rates,
+      lfo_shapes      => lfo_shapes,
+      mod_sels        => mod_sels,
+      mod_depths      => mod_depths,
+      glide_rates     => glide_rates,
+      glide_start     => glide_start,
+      glide_from      => glide_from,
+      note_press      => note_press,
+      timbre_press    => timbre_press,
+      press_depths    => press_depths,
+      sustain_pedals  => sustain_pedals,
+      sostenuto_pedals => sostenuto_pedals,
+      -- note status in
+      active_notes    => active_notes,
+      -- pipeline trace
+      trace_ctrl      => trace_ctrl,
+      trace_arm       => trace_arm,
+      trace_status    => trace_status,
+      trace_rd_en     => trace_rd_en,
+      trace_rd_addr   => trace_rd_addr,
+      trace_rd_data   => trace_rd_data,
 
       -- AXI control interface
       s_axi_aclk    => s_axi_aclk,
@@ -290,7 +518,104 @@ begin
       s_axi_rvalid  => s_axi_rvalid,
       s_axi_rready  => s_axi_rready
     );
-  
+
+  -- control smoothing, updated once per frame. The tick is on the last slot
+  -- the phase accumulator reads, so what synth_axi_ctrl exports on it is
+  -- read by every slot of the next pass from slot 0.
+  frame_tick <= '1' when ph_inc_slot = I_HIGHEST_NOTE else '0';
+
+  -- each group of controls shares one slew datapath
+  g_timbre_flat: for t in 0 to NUM_TIMBRES-1 generate
+    g_wfrm_flat: for i in 0 to NUM_WFRMS-1 generate
+      wfrm_amps_flat_target(((t*NUM_WFRMS+i)+1)*WIDTH_WAVE_GAIN-1 downto (t*NUM_WFRMS+i)*WIDTH_WAVE_GAIN)
+                        <= std_logic_vector(wfrm_amps_target(t)(i));
+      wfrm_amps(t)(i)   <= unsigned(wfrm_amps_flat(((t*NUM_WFRMS+i)+1)*WIDTH_WAVE_GAIN-1 downto (t*NUM_WFRMS+i)*WIDTH_WAVE_GAIN));
+    end generate g_wfrm_flat;
+    pulse_width_flat_target((t+1)*WIDTH_PULSE_WIDTH-1 downto t*WIDTH_PULSE_WIDTH)
+                        <= std_logic_vector(pulse_width_target(t));
+    pulse_width(t)      <= unsigned(pulse_width_flat((t+1)*WIDTH_PULSE_WIDTH-1 downto t*WIDTH_PULSE_WIDTH));
+  end generate g_timbre_flat;
+
+  u_wfrm_amp_slew: param_slew
+    generic map (
+      NUM_PARAMS => NUM_TIMBRES*NUM_WFRMS,
+      DATA_WIDTH => WIDTH_WAVE_GAIN,
+      RATE_WIDTH => WIDTH_SLEW_RATE
+    )
+    port map (
+      clk        => clk,
+      rst        => rst,
+      tick       => frame_tick,
+      rate       => wfrm_slew_rate,
+      targets    => wfrm_amps_flat_target,
+      values_out => wfrm_amps_flat
+    );
+
+  u_out_amp_slew: param_slew
+    generic map (
+      NUM_PARAMS => 1,
+      DATA_WIDTH => WIDTH_OUT_GAIN,
+      RATE_WIDTH => WIDTH_SLEW_RATE
+    )
+    port map (
+      clk                   => clk,
+      rst                   => rst,
+      tick                  => frame_tick,
+      rate                  => out_slew_rate,
+      targets               => std_logic_vector(out_amp_target),
+      unsigned(values_out)  => out_amp
+    );
+
+  u_pulse_width_slew: param_slew
+    generic map (
+      NUM_PARAMS => NUM_TIMBRES,
+      DATA_WIDTH => WIDTH_PULSE_WIDTH,
+      RATE_WIDTH => WIDTH_SLEW_RATE
+    )
+    port map (
+      clk        => clk,
+      rst        => rst,
+      tick       => frame_tick,
+      rate       => pw_slew_rate,
+      targets    => pulse_width_flat_target,
+      values_out => pulse_width_flat
+    );
+
+  -- modulation, updated once per frame after the slew
+  u_lfo_bank: lfo_bank
+    generic map (
+      PHASE_WIDTH => WIDTH_LFO_PH,
+      LFO_WIDTH   => WIDTH_LFO
+    )
+    port map (
+      clk      => clk,
+      rst      => rst,
+      tick     => frame_tick,
+      rates    => lfo_rates,
+      shapes   => lfo_shapes,
+      lfo_out  => lfos
+    );
+
+  u_mod_matrix: mod_matrix
+    port map (
+      clk             => clk,
+      rst             => rst,
+      tick            => frame_tick,
+      -- modulation sources and routing
+      lfos            => lfos,
+      mod_sels        => mod_sels,
+      mod_depths      => mod_depths,
+      -- timbre controls in
+      wfrm_amps       => wfrm_amps,
+      pulse_width     => pulse_width,
+      timbre_lvls     => timbre_lvls,
+      -- modulated timbre controls out
+      pitch_mods      => pitch_mods,
+      wfrm_amps_out   => wfrm_amps_mod,
+      pulse_width_out => pulse_width_mod,
+      timbre_lvls_out => timbre_lvls_mod
+    );
+
   u_stage_0_phase_gen: phase_accumulator
     generic map (
       PHASE_WIDTH     => WIDTH_PH_DATA,
@@ -300,8 +625,14 @@ begin
       clk             => clk,
       rst             => rst,
       -- synth controls
-      phase_incs      => ph_inc_table,
+      slot_index      => ph_inc_slot,
+      ph_inc          => ph_inc,
       note_amps       => note_amps,
+      note_timbres    => note_timbres,
+      pitch_mods      => pitch_mods,
+      glide_rates     => glide_rates,
+      glide_start     => glide_start,
+      glide_from      => glide_from,
       -- pipeline out
       note_index_out  => note_index_q,
       phase_out       => phase_q,
@@ -314,15 +645,18 @@ begin
       PHASE_WIDTH     => WIDTH_PH_DATA,
       NOTE_GAIN_WIDTH => WIDTH_NOTE_GAIN,
       DATA_WIDTH      => WIDTH_WAVE_DATA,
-      SIN_LUT_PH      => 12
+      SIN_LUT_PH      => WIDTH_SIN_LUT_PH,
+      SIN_INTERP_PH   => WIDTH_SIN_INTERP_PH
     )
     port map (
       clk             => clk,
       rst             => rst,
       -- synth controls
-      wfrm_amps       => wfrm_amps,
+      wfrm_amps       => wfrm_amps_mod,
       wfrm_phs        => wfrm_phs,
-      pulse_width     => pulse_width,
+      pulse_width     => pulse_width_mod,
+      note_timbres    => note_timbres,
+      active_notes    => active_notes,
       -- pipeline in
       note_index_in   => note_index_q,
       phase_in        => phase_q,
@@ -350,6 +684,9 @@ begin
       decay_amt       => decay_amt,
       sustain_amt     => sustain_amt,
       release_amt     => release_amt,
+      note_timbres    => note_timbres,
+      sustain_pedals  => sustain_pedals,
+      sostenuto_pedals => sostenuto_pedals,
       -- pipeline in
       note_index_in   => note_index_q2,
       note_amp_in     => note_amp_q2,
@@ -357,13 +694,42 @@ begin
       cycle_start_in  => cycle_start_q2,
       -- pipeline out
       note_index_out  => note_index_q3,
-      note_out        => note_q3
+      note_out        => note_q3,
+      cycle_start_out => cycle_start_q3,
+      adsr_state_out  => adsr_state_q3,
+      -- note status
+      active_notes    => active_notes
+    );
+
+  -- trace of the envelope stage output, read over AXI
+  u_pipeline_trace: pipeline_trace
+    generic map (
+      DEPTH_BITS => TRACE_DEPTH_BITS,
+      DATA_WIDTH => WIDTH_WAVE_DATA
+    )
+    port map (
+      clk             => clk,
+      rst             => rst,
+      -- trace controls
+      trace_ctrl      => trace_ctrl,
+      trace_arm       => trace_arm,
+      trace_status    => trace_status,
+      -- pipeline in
+      note_index_in   => note_index_q3,
+      note_in         => note_q3,
+      cycle_start_in  => cycle_start_q3,
+      adsr_state_in   => adsr_state_q3,
+      -- buffer read port
+      rd_en           => trace_rd_en,
+      rd_addr         => trace_rd_addr,
+      rd_data         => trace_rd_data
     );
   
   u_stage_3_poly_mix: poly_mix
     generic map (
       OUT_GAIN_WIDTH  => WIDTH_OUT_GAIN,
       OUT_SHIFT_WIDTH => WIDTH_OUT_SHIFT,
+      PAN_WIDTH       => WIDTH_NOTE_PAN,
       DATA_WIDTH      => WIDTH_WAVE_DATA,
       OUT_DATA_WIDTH  => WIDTH_WAVE_DATA+8
     )
@@ -373,11 +739,18 @@ begin
       -- synth controls
       out_amp         => out_amp,
       out_shift       => out_shift,
+      note_pans       => note_pans,
+      note_timbres    => note_timbres,
+      timbre_lvls     => timbre_lvls_mod,
+      note_press      => note_press,
+      timbre_press    => timbre_press,
+      press_depths    => press_depths,
       -- pipeline in
       note_index_in   => note_index_q3,
       note_in         => note_q3,
       -- pipeline out
-      audio_out       => audio_out
+      audio_out_l     => audio_out_l,
+      audio_out_r     => audio_out_r
     );
 
 end struct_synth_engine;
\ No newline at end of file
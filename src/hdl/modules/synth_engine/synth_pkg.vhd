@@ -15,8 +15,18 @@ library IEEE;
   use IEEE.NUMERIC_STD.ALL;
 
 package synth_pkg is
-  constant SYNTH_ENG_REV  : std_logic_vector := x"00000002";
-  constant SYNTH_ENG_DATE : std_logic_vector := x"04032025";
+  constant SYNTH_ENG_REV  : std_logic_vector := x"0000000D";
+  constant SYNTH_ENG_DATE : std_logic_vector := x"19102026";
+
+  -- memory-mapped regions, 128 words each
+  constant REGION_NOTE_AMP        : std_logic_vector := "000";     -- 0x000
+  constant REGION_SETTINGS        : std_logic_vector := "001";     -- 0x200
+  constant REGION_PH_INC          : std_logic_vector := "010";     -- 0x400
+  constant REGION_NOTE_PAN        : std_logic_vector := "011";     -- 0x600
+  constant REGION_NOTE_TIMBRE     : std_logic_vector := "100";     -- 0x800
+  constant REGION_TIMBRE_BANK     : std_logic_vector := "101";     -- 0xA00
+  constant REGION_NOTE_PRESS      : std_logic_vector := "110";     -- 0xC00
+  constant REGION_TRACE           : std_logic_vector := "111";     -- 0xE00
 
   -- memmory-mapped address definitions
   constant OFFSET_PULSE_WIDTH_REG : std_logic_vector := "0000000"; --   0
@@ -31,10 +41,52 @@ package synth_pkg is
   constant OFFSET_DECAY_AMT       : std_logic_vector := "0100001"; --  33
   constant OFFSET_SUSTAIN_AMT     : std_logic_vector := "0100010"; --  34
   constant OFFSET_RELEASE_AMT     : std_logic_vector := "0100011"; --  35
+  constant OFFSET_SLEW_RATE_REG   : std_logic_vector := "0101000"; --  40
+  constant OFFSET_GLIDE_RATE_REG  : std_logic_vector := "0101001"; --  41
+  constant OFFSET_GLIDE_REG       : std_logic_vector := "0101010"; --  42
+  constant OFFSET_LFO_REG0        : std_logic_vector := "0110000"; --  48
+  constant OFFSET_LFO_REG1        : std_logic_vector := "0110001"; --  49
+  constant OFFSET_LFO_REG2        : std_logic_vector := "0110010"; --  50
+  constant OFFSET_LFO_REG3        : std_logic_vector := "0110011"; --  51
+  constant OFFSET_PRESS_REG       : std_logic_vector := "0111";    --  56 to 63
+  constant OFFSET_NOTE_PACK_REG   : std_logic_vector := "10";      --  64 to 95
+  constant OFFSET_NOTE_GATE_REG0  : std_logic_vector := "1100000"; --  96
+  constant OFFSET_NOTE_GATE_REG1  : std_logic_vector := "1100001"; --  97
+  constant OFFSET_NOTE_GATE_REG2  : std_logic_vector := "1100010"; --  98
+  constant OFFSET_NOTE_GATE_REG3  : std_logic_vector := "1100011"; --  99
+  constant OFFSET_GATE_VEL_REG    : std_logic_vector := "1100100"; -- 100
+  constant OFFSET_NOTE_CTRL_REG   : std_logic_vector := "1100101"; -- 101
+  constant OFFSET_PEDAL_REG       : std_logic_vector := "1100110"; -- 102
+  constant OFFSET_ACTIVE_REG0     : std_logic_vector := "1101000"; -- 104
+  constant OFFSET_ACTIVE_REG1     : std_logic_vector := "1101001"; -- 105
+  constant OFFSET_ACTIVE_REG2     : std_logic_vector := "1101010"; -- 106
+  constant OFFSET_ACTIVE_REG3     : std_logic_vector := "1101011"; -- 107
+  constant OFFSET_TRACE_CTRL_REG  : std_logic_vector := "1110000"; -- 112
+  constant OFFSET_TRACE_STAT_REG  : std_logic_vector := "1110001"; -- 113
+  constant OFFSET_TRACE_PAGE_REG  : std_logic_vector := "1110010"; -- 114
   constant OFFSET_REV_REG         : std_logic_vector := "1111000"; -- 120
   constant OFFSET_DATE_REG        : std_logic_vector := "1111001"; -- 121
   constant OFFSET_WRAPBACK_REG    : std_logic_vector := "1111111"; -- 127
 
+  -- timbre bank register offsets, 16 words per timbre. Timbre 0 is the same
+  -- storage as the waveform and adsr registers in the settings region.
+  constant OFFSET_TIMBRE_PW        : std_logic_vector := "0000"; --  0
+  constant OFFSET_TIMBRE_PULSE     : std_logic_vector := "0001"; --  1
+  constant OFFSET_TIMBRE_RAMP      : std_logic_vector := "0010"; --  2
+  constant OFFSET_TIMBRE_SAW       : std_logic_vector := "0011"; --  3
+  constant OFFSET_TIMBRE_TRI       : std_logic_vector := "0100"; --  4
+  constant OFFSET_TIMBRE_SINE      : std_logic_vector := "0101"; --  5
+  constant OFFSET_TIMBRE_LEVEL     : std_logic_vector := "0110"; --  6
+  constant OFFSET_TIMBRE_MOD_SRC   : std_logic_vector := "0111"; --  7
+  constant OFFSET_TIMBRE_ATTACK    : std_logic_vector := "1000"; --  8
+  constant OFFSET_TIMBRE_DECAY     : std_logic_vector := "1001"; --  9
+  constant OFFSET_TIMBRE_SUSTAIN   : std_logic_vector := "1010"; -- 10
+  constant OFFSET_TIMBRE_RELEASE   : std_logic_vector := "1011"; -- 11
+  constant OFFSET_TIMBRE_MOD_PITCH : std_logic_vector := "1100"; -- 12
+  constant OFFSET_TIMBRE_MOD_AMP   : std_logic_vector := "1101"; -- 13
+  constant OFFSET_TIMBRE_MOD_PW    : std_logic_vector := "1110"; -- 14
+  constant OFFSET_TIMBRE_MOD_WFRM  : std_logic_vector := "1111"; -- 15
+
   -- vector size definitions
   constant WIDTH_WAVE_DATA   : natural := 16;
   constant WIDTH_PH_DATA     : natural := 32;
@@ -45,11 +97,91 @@ package synth_pkg is
   constant WIDTH_PULSE_WIDTH : natural := 16;
   constant WIDTH_ADSR_COUNT  : natural := 20;
   constant WIDTH_ADSR_CC     : natural := 20;
+  constant WIDTH_NOTE_PAN    : natural := 7;
+  constant WIDTH_SLEW_RATE   : natural := 4;
+  constant WIDTH_GLIDE_RATE  : natural := 4;
+  constant WIDTH_TIMBRE      : natural := 3;
+  constant WIDTH_TIMBRE_LVL  : natural := 7;
+  constant WIDTH_LFO         : natural := 8;
+  constant WIDTH_LFO_PH      : natural := 24;
+  constant WIDTH_LFO_RATE    : natural := 16;
+  constant WIDTH_LFO_SHAPE   : natural := 2;
+  constant WIDTH_LFO_SEL     : natural := 2;
+  constant WIDTH_MOD_DEPTH   : natural := 7;
+  constant WIDTH_PRESSURE    : natural := 7;
+  constant WIDTH_MOD         : natural := WIDTH_LFO + WIDTH_MOD_DEPTH;
+
+  -- sine lookup sizing, table index bits and interpolated phase bits
+  constant WIDTH_SIN_LUT_PH    : natural := 10;
+  constant WIDTH_SIN_INTERP_PH : natural := 6;
 
   constant NUM_WFRMS       : natural := 5;
+  constant SYNTH_CLK_HZ    : natural := 12288000; -- engine clock, see gen_tuning.py
   constant NUM_NOTES       : natural := 128;
   constant I_LOWEST_NOTE   : natural := 0;
   constant I_HIGHEST_NOTE  : natural := I_LOWEST_NOTE + NUM_NOTES - 1;
+  constant NUM_TIMBRES     : natural := 2**WIDTH_TIMBRE;
+  constant NUM_LFOS        : natural := 2**WIDTH_LFO_SEL;
+  constant NUM_MOD_DESTS   : natural := 4;
+
+  -- pitch modulation scale, full depth is about one semitone
+  constant PITCH_MOD_SHIFT : natural := 18;
+
+  -- glide rate 1 moves the phase increment by 1/2**(1+GLIDE_SHIFT_BASE) of
+  -- itself each frame, each step up halves the glide speed
+  constant GLIDE_SHIFT_BASE : natural := 7;
+
+  -- glide register fields, target note, source note and start
+  constant GLIDE_TO_LSB    : natural := 0;
+  constant GLIDE_FROM_LSB  : natural := 8;
+  constant GLIDE_START     : natural := 15;
+
+  -- timbre pressure register fields, channel pressure and level depth
+  constant PRESS_LSB       : natural := 0;
+  constant PRESS_DEPTH_LSB : natural := 8;
+
+  -- pedal register fields, a sustain and a sostenuto bit per timbre
+  constant PEDAL_SUSTAIN_LSB   : natural := 0;
+  constant PEDAL_SOSTENUTO_LSB : natural := 8;
+
+  -- note control register bits
+  constant NOTE_CTRL_HOLD        : natural := 0;
+  constant NOTE_CTRL_RELEASE_ALL : natural := 1;
+
+  -- pipeline trace, TRACE_DEPTH entries read through the trace region a
+  -- page of 128 at a time
+  constant TRACE_DEPTH_BITS : natural := 10;
+  constant TRACE_DEPTH      : natural := 2**TRACE_DEPTH_BITS;
+
+  -- trace control register fields. Arm is a command, it starts a capture
+  -- with the rest of the register and reads back 0.
+  constant TRACE_ARM       : natural := 0;
+  constant TRACE_FRAME     : natural := 1;  -- every slot from a frame start
+  constant TRACE_TRIG_LSB  : natural := 2;
+  constant TRACE_STATE_LSB : natural := 4;  -- adsr state for TRACE_TRIG_STATE
+  constant TRACE_SLOT_LSB  : natural := 8;
+  constant TRACE_LEVEL_LSB : natural := 16; -- sample magnitude for TRACE_TRIG_LEVEL
+
+  -- trace triggers, on the traced slot
+  constant TRACE_TRIG_NOW   : natural := 0;
+  constant TRACE_TRIG_STATE : natural := 1; -- slot enters the adsr state
+  constant TRACE_TRIG_LEVEL : natural := 2; -- slot sample reaches the level
+
+  -- trace status register fields
+  constant TRACE_ARMED     : natural := 0;
+  constant TRACE_RUNNING   : natural := 1;
+  constant TRACE_DONE      : natural := 2;
+  constant TRACE_COUNT_LSB : natural := 16;
+
+  -- trace entry fields
+  constant TRACE_SAMPLE_LSB : natural := 0;
+  constant TRACE_NOTE_LSB   : natural := 16;
+  constant TRACE_CYCLE_BIT  : natural := 23;
+  constant TRACE_ADSR_LSB   : natural := 24;
+  constant WIDTH_ADSR_STATE : natural := 3;
+
+  -- pan position with equal left and right gain
+  constant PAN_CENTER      : natural := 2**(WIDTH_NOTE_PAN-1);
 
   -- waveform indexes
   constant I_PULSE : natural := 0;
@@ -58,15 +190,48 @@ package synth_pkg is
   constant I_TRI   : natural := 3;
   constant I_SINE  : natural := 4;
 
+  -- lfo shapes
+  constant LFO_SINE   : natural := 0;
+  constant LFO_TRI    : natural := 1;
+  constant LFO_SAH    : natural := 2;
+  constant LFO_SQUARE : natural := 3;
+
+  -- modulation destinations, in timbre bank order from OFFSET_TIMBRE_MOD_PITCH
+  constant I_MOD_PITCH : natural := 0;
+  constant I_MOD_AMP   : natural := 1;
+  constant I_MOD_PW    : natural := 2;
+  constant I_MOD_WFRM  : natural := 3;
+
   -- array data types
-  type t_ph_inc_lut  is array (116 to 127) of unsigned(WIDTH_PH_DATA-1 downto 0);
+  type t_ph_inc_lut  is array (I_LOWEST_NOTE to I_HIGHEST_NOTE) of unsigned(WIDTH_PH_DATA-1 downto 0);
   type t_ph_inc      is array (I_LOWEST_NOTE to I_HIGHEST_NOTE) of unsigned(WIDTH_PH_DATA-1 downto 0);
   type t_wave_data   is array (I_LOWEST_NOTE to I_HIGHEST_NOTE) of signed(WIDTH_WAVE_DATA-1 downto 0);
   type t_note_amp    is array (0 to 127) of unsigned(WIDTH_NOTE_GAIN-1 downto 0);
+  type t_note_pan    is array (0 to 127) of unsigned(WIDTH_NOTE_PAN-1 downto 0);
+  type t_note_press  is array (0 to 127) of unsigned(WIDTH_PRESSURE-1 downto 0);
+  subtype t_note_bits is std_logic_vector(I_HIGHEST_NOTE downto I_LOWEST_NOTE);
+  subtype t_timbre_bits is std_logic_vector(NUM_TIMBRES-1 downto 0);
   type t_wfrm_amp    is array (0 to NUM_WFRMS-1) of unsigned(WIDTH_WAVE_GAIN-1 downto 0);
   type t_wfrm_ph     is array (0 to NUM_WFRMS-1) of unsigned(WIDTH_WAVE_DATA-1 downto 0);
 
-  type t_adsr        is array (0 to 7) of unsigned(WIDTH_ADSR_COUNT-1 downto 0);
+  -- per timbre settings
+  type t_note_timbre is array (0 to 127) of unsigned(WIDTH_TIMBRE-1 downto 0);
+  type t_timbre_amps is array (0 to NUM_TIMBRES-1) of t_wfrm_amp;
+  type t_timbre_phs  is array (0 to NUM_TIMBRES-1) of t_wfrm_ph;
+  type t_timbre_pw   is array (0 to NUM_TIMBRES-1) of unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
+  type t_timbre_lvl  is array (0 to NUM_TIMBRES-1) of unsigned(WIDTH_TIMBRE_LVL-1 downto 0);
+  type t_adsr        is array (0 to NUM_TIMBRES-1) of unsigned(WIDTH_ADSR_CC-1 downto 0);
+  type t_timbre_press is array (0 to NUM_TIMBRES-1) of unsigned(WIDTH_PRESSURE-1 downto 0);
+  type t_glide_rate  is array (0 to NUM_TIMBRES-1) of unsigned(WIDTH_GLIDE_RATE-1 downto 0);
+  -- lfos and modulation routing
+  type t_lfo_rate    is array (0 to NUM_LFOS-1) of unsigned(WIDTH_LFO_RATE-1 downto 0);
+  type t_lfo_shape   is array (0 to NUM_LFOS-1) of unsigned(WIDTH_LFO_SHAPE-1 downto 0);
+  type t_lfo_out     is array (0 to NUM_LFOS-1) of signed(WIDTH_LFO-1 downto 0);
+  type t_mod_sel     is array (0 to NUM_MOD_DESTS-1) of unsigned(WIDTH_LFO_SEL-1 downto 0);
+  type t_mod_depth   is array (0 to NUM_MOD_DESTS-1) of unsigned(WIDTH_MOD_DEPTH-1 downto 0);
+  type t_timbre_sel  is array (0 to NUM_TIMBRES-1) of t_mod_sel;
+  type t_timbre_dep  is array (0 to NUM_TIMBRES-1) of t_mod_depth;
+  type t_timbre_mod  is array (0 to NUM_TIMBRES-1) of signed(WIDTH_MOD-1 downto 0);
   type t_adsr_count  is array (I_LOWEST_NOTE to I_HIGHEST_NOTE) of unsigned(WIDTH_ADSR_COUNT-1 downto 0);
   type t_note_acc    is array (I_LOWEST_NOTE to I_HIGHEST_NOTE) of unsigned(WIDTH_ADSR_COUNT-1 downto 0);
 
@@ -1,57 +1,52 @@
 ----------------------------------------------------------------------------------
--- Company: 
--- Engineer: 
--- 
+-- Company: beepboop
+-- Engineer: Tyler Huddleston
+--
 -- Create Date: 02/23/2025 08:03:45 PM
--- Design Name: 
--- Module Name: clkdivider_tb - Behavioral
--- Project Name: 
--- Target Devices: 
--- Tool Versions: 
--- Description: 
--- 
--- Dependencies: 
--- 
+-- Design Name: Utilities
+-- Module Name: Clock Divider Testbench
+-- Description:
+--   Runs the divider at three divide settings and checks the output period,
+--   two times G_DIVIDEBY/2 input clocks, and that the divided reset releases.
+--
 -- Revision:
 -- Revision 0.01 - File Created
--- Additional Comments:
--- 
+-- 10/19/2026 agt - current clkdivider ports, self-checking, ends on its own
+--
 ----------------------------------------------------------------------------------
 
-
-library IEEE;
-use IEEE.STD_LOGIC_1164.ALL;
-
--- Uncomment the following library declaration if using
--- arithmetic functions with Signed or Unsigned values
---use IEEE.NUMERIC_STD.ALL;
-
--- Uncomment the following library declaration if instantiating
--- any Xilinx leaf cells in this code.
---library UNISIM;
---use UNISIM.VComponents.all;
+library ieee;
+  use ieee.std_logic_1164.all;
 
 entity clkdivider_tb is
---  Port ( );
 end clkdivider_tb;
 
 architecture Behavioral of clkdivider_tb is
 
   component clkdivider is
-    generic (G_DIVIDEBY : natural := 2);
-    port ( clk : in std_logic;
-           reset : in std_logic;
-           pulseout : out std_logic);
+    generic (
+      G_DIVIDEBY : natural := 2
+    );
+    port (
+      clk      : in  std_logic;
+      rst      : in  std_logic;
+      clkout   : out std_logic;
+      rstout   : out std_logic
+    );
   end component clkdivider;
 
+  constant clk_period : time := 20 ns;
+
   signal clock    : std_logic := '0';
   signal reset    : std_logic := '1';
   signal clk_div2, clk_div3, clk_div4 : std_logic;
-  
+  signal rst_div2, rst_div3, rst_div4 : std_logic;
+  signal sim_done : boolean := false;
+
 begin
 
   -- Reset and clock
-  clock <= not clock after 10 ns;
+  clock <= not clock after clk_period / 2 when not sim_done else '0';
   reset <= '0' after 20 ns;
 
   -- Instantiate the design under test
@@ -60,29 +55,68 @@ begin
       G_DIVIDEBY => 2
     )
     port map (
-      clk      => clock,
-      reset    => reset,
-      pulseout => clk_div2
+      clk    => clock,
+      rst    => reset,
+      clkout => clk_div2,
+      rstout => rst_div2
     );
-    
-    u_div_by_3: clkdivider
+
+  u_div_by_3: clkdivider
     generic map (
       G_DIVIDEBY => 3
     )
     port map (
-      clk      => clock,
-      reset    => reset,
-      pulseout => clk_div3
+      clk    => clock,
+      rst    => reset,
+      clkout => clk_div3,
+      rstout => rst_div3
     );
-    
-    u_div_by_4: clkdivider
+
+  u_div_by_4: clkdivider
     generic map (
       G_DIVIDEBY => 4
     )
     port map (
-      clk      => clock,
-      reset    => reset,
-      pulseout => clk_div4
+      clk    => clock,
+      rst    => reset,
+      clkout => clk_div4,
+      rstout => rst_div4
     );
 
+  -- Checks
+  checker : process
+
+    -- time between rising edges of a divided clock over a few periods
+    procedure check_period(
+      signal   clkout   : in std_logic;
+      signal   rstout   : in std_logic;
+      constant divideby : in natural
+    ) is
+      constant expected : time := 2 * (divideby / 2) * clk_period;
+      variable last     : time;
+    begin
+      wait until rising_edge(clkout);
+      last := now;
+      for i in 0 to 7 loop
+        wait until rising_edge(clkout);
+        assert now - last = expected
+          report "divide by " & integer'image(divideby) & " period " & time'image(now - last) &
+                 ", expected " & time'image(expected) severity error;
+        last := now;
+      end loop;
+      assert rstout = '0'
+        report "divide by " & integer'image(divideby) & " reset not released" severity error;
+    end procedure;
+
+  begin
+    wait until reset = '0';
+    check_period(clk_div2, rst_div2, 2);
+    check_period(clk_div3, rst_div3, 3);
+    check_period(clk_div4, rst_div4, 4);
+
+    report "Testbench completed." severity note;
+    sim_done <= true;
+    wait;
+  end process checker;
+
 end Behavioral;
@@ -1,61 +1,34 @@
 ----------------------------------------------------------------------------------
--- Company: 
--- Engineer: 
--- 
+-- Company: beepboop
+-- Engineer: Tyler Huddleston
+--
 -- Create Date: 02/23/2025 08:56:17 PM
--- Design Name: 
--- Module Name: codec_i2s_tb - Behavioral
--- Project Name: 
--- Target Devices: 
--- Tool Versions: 
--- Description: 
--- 
--- Dependencies: 
--- 
+-- Design Name: Audio Codec
+-- Module Name: Codec I2S Testbench
+-- Description:
+--   Sends different left and right words through the I2S transmitter and
+--   decodes the playback data on the rising bit clock. Checks the bit clock
+--   is half the master clock, that a frame is 64 bit clocks, and that every
+--   word is the zero bit, the 24 data bits and the padding, alternating
+--   between the two channels.
+--
+--   The master clock is driven directly at 12.288 MHz, the clocking wizard
+--   cores are only needed on the board.
+--
 -- Revision:
 -- Revision 0.01 - File Created
--- Additional Comments:
--- 
+-- 10/19/2026 agt - self-checking, ends on its own, no clocking wizard cores
+--
 ----------------------------------------------------------------------------------
 
-
-library IEEE;
-use IEEE.STD_LOGIC_1164.ALL;
-
--- Uncomment the following library declaration if using
--- arithmetic functions with Signed or Unsigned values
---use IEEE.NUMERIC_STD.ALL;
-
--- Uncomment the following library declaration if instantiating
--- any Xilinx leaf cells in this code.
---library UNISIM;
---use UNISIM.VComponents.all;
+library ieee;
+  use ieee.std_logic_1164.all;
 
 entity codec_i2s_tb is
---  Port ( );
 end codec_i2s_tb;
 
 architecture Behavioral of codec_i2s_tb is
 
-  -- MCLK MMCM
-  component clk_wiz_mclk is
-  Port (
-    reset    : in  std_logic;
-    clk_in1  : in  std_logic;
-    locked   : out std_logic;
-    clk_out1 : out std_logic
-    );
-  end component clk_wiz_mclk;
-
-  component clk_wiz_25_to_100 is
-    port (
-      reset         : in  std_logic;
-      clk_in1       : in  std_logic;
-      locked        : out std_logic;
-      clk_out1     : out std_logic
-    );
-  end component clk_wiz_25_to_100;
-
   -- Audio codec
   component codec_i2s is
   generic (
@@ -82,65 +55,57 @@ architecture Behavioral of codec_i2s_tb is
     reclrc      : out std_logic;                                 -- codec record data left/right select
     mute_n      : out std_logic    );                            -- codec mute enable
   end component codec_i2s;
-  
+
+  constant DATA_WIDTH  : natural := 24;
+  constant WORDSIZE    : natural := 32;
+  constant PAD         : std_logic_vector(WORDSIZE-DATA_WIDTH-2 downto 0) := (others => '0');
+
+  constant DATA_L      : std_logic_vector(DATA_WIDTH-1 downto 0) := x"A5C30F";
+  constant DATA_R      : std_logic_vector(DATA_WIDTH-1 downto 0) := x"3C5A96";
+
+  -- words to check once the first latched data is on the line
+  constant NUM_WORDS   : natural := 16;
+
+  constant clk_period  : time := 40 ns;
+  constant mclk_period : time := 81380 ps;  -- 12.288 MHz
+
   signal clk25    : std_logic := '0';
   signal rst25    : std_logic := '1';
+  signal mclk_in  : std_logic := '0';
 
-  signal clk100   : std_logic;
-  
-  signal mclk_12p88 : std_logic;
-  signal mclk       : std_logic;
-  signal bclk       : std_logic;
-  signal pblrc      : std_logic;
-  signal pbdat      : std_logic;
-  signal mute_n     : std_logic;
-  signal clk25_locked : std_logic;
-  signal rst_sync   : std_logic;
+  signal mclk     : std_logic;
+  signal bclk     : std_logic;
+  signal pblrc    : std_logic;
+  signal pbdat    : std_logic;
+  signal mute_n   : std_logic;
+  signal sim_done : boolean := false;
+  signal clocks_checked : boolean := false;
 
 begin
 
-  -- Reset and clock
-  clk25 <= not clk25 after 20 ns;
-  rst25 <= '0' after 50 ns;
-  
-  rst_sync <= rst25 or not(clk25_locked);
-  
-  
--- MCLK MMCM
-u_mclk_mmcm: clk_wiz_mclk
-  port map (
-    reset         => rst25,
-    clk_in1       => clk100,
-    locked        => clk25_locked,
-    clk_out1     => mclk_12p88
-  );
-
-  u_mclk_25_to_100: clk_wiz_25_to_100
-    port map (
-      reset         => rst25,
-      clk_in1       => clk25,
-      locked        => open,
-      clk_out1     => clk100
-    );
+  -- Reset and clocks
+  clk25   <= not clk25 after clk_period / 2 when not sim_done else '0';
+  mclk_in <= not mclk_in after mclk_period / 2 when not sim_done else '0';
+  rst25   <= '0' after 50 ns;
 
   -- Audio codec
   u_audio_codec: component codec_i2s
   generic map (
     G_MCLK_BCLK_RATIO => 2,
-    G_DATA_WIDTH      => 24,
-    G_WORDSIZE        => 32
+    G_DATA_WIDTH      => DATA_WIDTH,
+    G_WORDSIZE        => WORDSIZE
   )
   port map (
     -- input clock domain
-    rst         => rst_sync,
+    rst         => rst25,
     clk         => clk25,
-    dac_data_l  => (others => '1'),
-    dac_data_r  => (others => '1'),
+    dac_data_l  => DATA_L,
+    dac_data_r  => DATA_R,
     dac_latched => open,
     adc_data    => open,
     adc_latched => open,
     -- mclk domain
-    mclk_in     => mclk_12p88,
+    mclk_in     => mclk_in,
     mclk        => mclk,
     bclk        => bclk,
     pbdat       => pbdat,
@@ -150,5 +115,82 @@ u_mclk_mmcm: clk_wiz_mclk
     mute_n      => mute_n
   );
 
+  -- Bit clock and frame length
+  clocks : process
+    variable last  : time;
+    variable count : natural;
+  begin
+    wait until rst25 = '0';
+    wait until rising_edge(bclk);
+    last := now;
+    for i in 0 to 15 loop
+      wait until rising_edge(bclk);
+      assert now - last = 2 * mclk_period
+        report "bclk period " & time'image(now - last) & ", expected mclk/2" severity error;
+      last := now;
+    end loop;
+
+    wait until rising_edge(pblrc);
+    for i in 0 to 3 loop
+      count := 0;
+      loop
+        wait until rising_edge(bclk) or rising_edge(pblrc);
+        exit when rising_edge(pblrc);
+        count := count + 1;
+      end loop;
+      assert count = 2 * WORDSIZE
+        report "frame of " & integer'image(count) & " bclk, expected " & integer'image(2 * WORDSIZE)
+        severity error;
+    end loop;
+    clocks_checked <= true;
+    wait;
+  end process clocks;
+
+  -- Playback data decode, a word starts on the first bit after pblrc changes
+  decode : process
+    variable word     : std_logic_vector(WORDSIZE-1 downto 0);
+    variable nbits    : natural := 0;
+    variable lrc_last : std_logic;
+    variable left     : boolean;
+    variable prev     : boolean;
+    variable checked  : natural := 0;
+  begin
+    wait until rst25 = '0';
+    wait until rising_edge(bclk);
+    lrc_last := pblrc;
+    while checked < NUM_WORDS loop
+      wait until rising_edge(bclk);
+      if pblrc /= lrc_last then
+        -- the first words go out before any data is latched
+        if nbits = WORDSIZE and not is_x(word) then
+          assert word = '0' & DATA_L & PAD or word = '0' & DATA_R & PAD
+            report "malformed word on pblrc = " & std_logic'image(lrc_last) severity error;
+          left := word = '0' & DATA_L & PAD;
+          if checked > 0 then
+            assert left /= prev
+              report "two words in a row for the same channel" severity error;
+          end if;
+          if left and checked < 2 then
+            report "left channel sent with pblrc = " & std_logic'image(lrc_last) severity note;
+          end if;
+          prev    := left;
+          checked := checked + 1;
+        end if;
+        nbits    := 0;
+        lrc_last := pblrc;
+      end if;
+      word  := word(WORDSIZE-2 downto 0) & pbdat;
+      nbits := nbits + 1;
+    end loop;
+
+    assert mute_n = '1' report "codec muted out of reset" severity error;
+    if not clocks_checked then
+      wait until clocks_checked;
+    end if;
+
+    report "Testbench completed." severity note;
+    sim_done <= true;
+    wait;
+  end process decode;
 
 end Behavioral;
@@ -0,0 +1,242 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Envelope Pedal Testbench
+-- Description:
+--   Simulation testbench for the pedal hold in the Envelope Scale. Keys a
+--   group of slots, holds them with the sustain pedal and then the
+--   sostenuto pedal, lets the keys go and checks the held slots stay out of
+--   release. With no cycle starts coming in, the pedal is let go and every
+--   held slot must be in release on its next pass, so the whole group is in
+--   release within a frame of the pedal going up.
+--
+-- Revision:
+-- 
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+
+library xil_defaultlib;
+  use xil_defaultlib.synth_pkg.all;
+
+entity envelope_pedal_tb is
+
+end envelope_pedal_tb;
+
+architecture tb of envelope_pedal_tb is
+
+  -- DUT Component
+  component envelope_scale is
+    generic (
+      NOTE_GAIN_WIDTH : integer := WIDTH_NOTE_GAIN;
+      DATA_WIDTH      : natural := WIDTH_WAVE_DATA;
+      ADSR_WIDTH      : natural := WIDTH_ADSR_CC;
+      ACC_WIDTH       : natural := WIDTH_ADSR_COUNT
+    );
+    port (
+      clk             : in  std_logic;
+      rst             : in  std_logic;
+      attack_amt      : in  t_adsr;
+      decay_amt       : in  t_adsr;
+      sustain_amt     : in  t_adsr;
+      release_amt     : in  t_adsr;
+      note_timbres    : in  t_note_timbre;
+      sustain_pedals  : in  t_timbre_bits;
+      sostenuto_pedals: in  t_timbre_bits;
+      note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      note_amp_in     : in  unsigned(NOTE_GAIN_WIDTH-1 downto 0);
+      note_in         : in  signed(DATA_WIDTH-1 downto 0);
+      cycle_start_in  : in  std_logic;
+      note_index_out  : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      note_out        : out signed(DATA_WIDTH-1 downto 0);
+      cycle_start_out : out std_logic;
+      adsr_state_out  : out unsigned(WIDTH_ADSR_STATE-1 downto 0);
+      active_notes    : out t_note_bits
+    );
+  end component;
+
+  signal clk : std_logic := '0';
+  signal rst : std_logic := '1';
+
+  -- Clock process
+  constant clk_period  : time := 40 ns;
+  constant clk_period2 : time := 80 ns;
+
+  -- adsr states as adsr_state_out numbers them
+  constant S_START   : natural := 0;
+  constant S_RELEASE : natural := 4;
+
+  -- keys, pedals of timbre 0, and cycle starts on every slot when on
+  signal note_amps      : t_note_amp := (others => (others => '0'));
+  signal sustain_ped    : t_timbre_bits := (others => '0');
+  signal sostenuto_ped  : t_timbre_bits := (others => '0');
+  signal cycles_on      : boolean := false;
+
+  -- pipeline in
+  signal note_index_in  : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE := I_LOWEST_NOTE;
+  signal note_amp_in    : unsigned(WIDTH_NOTE_GAIN-1 downto 0);
+  signal cycle_start_in : std_logic;
+
+  -- pipeline out
+  signal note_index_out  : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  signal note_out        : signed(WIDTH_WAVE_DATA-1 downto 0);
+  signal cycle_start_out : std_logic;
+  signal adsr_state_out  : unsigned(WIDTH_ADSR_STATE-1 downto 0);
+  signal active_notes    : t_note_bits;
+
+  signal sim_done : boolean := false;
+
+begin
+
+  -- slots come in one a clock, as the phase accumulator puts them out
+  note_amp_in    <= note_amps(note_index_in);
+  cycle_start_in <= '1' when cycles_on else '0';
+
+  -- Instantiate the DUT
+  uut: envelope_scale
+    port map (
+      clk             => clk,
+      rst             => rst,
+      -- fast attack and decay, a release too slow to finish in the test
+      attack_amt      => (others => to_unsigned(16#40000#, WIDTH_ADSR_CC)),
+      decay_amt       => (others => to_unsigned(16#1000#, WIDTH_ADSR_CC)),
+      sustain_amt     => (others => to_unsigned(16#C0000#, WIDTH_ADSR_CC)),
+      release_amt     => (others => to_unsigned(1, WIDTH_ADSR_CC)),
+      note_timbres    => (others => (others => '0')),
+      sustain_pedals  => sustain_ped,
+      sostenuto_pedals=> sostenuto_ped,
+      note_index_in   => note_index_in,
+      note_amp_in     => note_amp_in,
+      note_in         => to_signed(1000, WIDTH_WAVE_DATA),
+      cycle_start_in  => cycle_start_in,
+      note_index_out  => note_index_out,
+      note_out        => note_out,
+      cycle_start_out => cycle_start_out,
+      adsr_state_out  => adsr_state_out,
+      active_notes    => active_notes
+    );
+
+  -- Clock Process
+  clk_process : process
+  begin
+      while not sim_done loop
+          clk <= '0';
+          wait for clk_period / 2;
+          clk <= '1';
+          wait for clk_period / 2;
+      end loop;
+      wait;
+  end process;
+
+  -- note index cyclical counter over the note range
+  s_index: process(clk)
+  begin
+    if rising_edge(clk) then
+      if rst = '1' or note_index_in = I_HIGHEST_NOTE then
+        note_index_in <= I_LOWEST_NOTE;
+      else
+        note_index_in <= note_index_in + 1;
+      end if;
+    end if;
+  end process s_index;
+
+-- Stimulus Process
+stimulus : process
+  type t_states is array (I_LOWEST_NOTE to I_HIGHEST_NOTE) of natural;
+  variable states : t_states;
+
+  -- one frame, the adsr state of every slot as it comes out
+  procedure observe is
+  begin
+    for i in 0 to NUM_NOTES-1 loop
+      wait until rising_edge(clk);
+      states(note_index_out) := to_integer(adsr_state_out);
+    end loop;
+  end procedure;
+
+  procedure key(first, last : natural; amp : natural) is
+  begin
+    for n in first to last loop
+      note_amps(n) <= to_unsigned(amp, WIDTH_NOTE_GAIN);
+    end loop;
+  end procedure;
+
+  -- keyed or held slots stay out of release for frames
+  procedure check_held(first, last : natural; frames : natural; name : string) is
+  begin
+    for f in 1 to frames loop
+      observe;
+      for n in first to last loop
+        assert states(n) /= S_START and states(n) /= S_RELEASE
+          report name & " slot " & integer'image(n) & " not held, state " &
+                 integer'image(states(n)) severity error;
+      end loop;
+    end loop;
+  end procedure;
+
+  -- with no cycle starts, the pedal goes up and every held slot must be
+  -- in release on its next pass
+  procedure check_let_go(first, last : natural; name : string) is
+  begin
+    cycles_on <= false;
+    wait until rising_edge(clk);
+    if name = "sustain" then
+      sustain_ped(0) <= '0';
+    else
+      sostenuto_ped(0) <= '0';
+    end if;
+    -- the pass that sees the pedal up, then the next
+    observe;
+    observe;
+    for n in first to last loop
+      assert states(n) = S_RELEASE
+        report name & " slot " & integer'image(n) & " not in release a frame after pedal up, state " &
+               integer'image(states(n)) severity error;
+    end loop;
+    assert states(I_LOWEST_NOTE) = S_START
+      report "unkeyed slot not idle" severity error;
+    cycles_on <= true;
+  end procedure;
+
+begin
+  wait for clk_period2;
+  rst       <= '0';
+  cycles_on <= true;
+
+  -- sustain pedal, held down over the key-up
+  key(40, 47, 100);
+  observe;
+  check_held(40, 47, 4, "keyed");
+  sustain_ped(0) <= '1';
+  observe;
+  key(40, 47, 0);
+  check_held(40, 47, 8, "sustain");
+  check_let_go(40, 47, "sustain");
+
+  -- sostenuto pedal, only the slots keyed when it goes down are held
+  key(60, 63, 90);
+  observe;
+  check_held(60, 63, 4, "keyed");
+  sostenuto_ped(0) <= '1';
+  observe;
+  observe;
+  key(64, 64, 90);
+  observe;
+  check_held(64, 64, 4, "keyed");
+  key(60, 64, 0);
+  check_held(60, 63, 8, "sostenuto");
+  assert states(64) = S_RELEASE
+    report "slot keyed after the sostenuto pedal went down was held" severity error;
+  check_let_go(60, 63, "sostenuto");
+
+  report "Testbench completed." severity note;
+  sim_done <= true;
+  wait;
+end process stimulus;
+
+end tb;
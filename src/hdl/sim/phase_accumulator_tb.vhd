@@ -7,6 +7,17 @@
 -- Module Name: Phase Accumulator Testbench
 -- Description: 
 --   Simulation testbench for the Phase Accumulator in the Synthesizer Engine.
+--   Follows every note slot through 16 frames and checks the phase steps by
+--   the note's increment from the tuning table, the cycle start flags each
+--   wrap and the note amplitude comes out with its note. Then glides one
+--   slot up an octave from another: the first step is the source's
+--   increment, the steps rise to the target without passing it and stay
+--   there. A glide rate of 0 ignores a glide start and ends a glide.
+--
+-- Revision:
+-- 10/19/2026 agt - self-checking, ends on its own
+-- 10/19/2026 agt - tuning increment returned by slot index
+-- 10/19/2026 agt - glide start, glide to the target and glide rate 0
 -- 
 ----------------------------------------------------------------------------------
 
@@ -33,8 +44,14 @@ architecture tb of phase_accumulator_tb is
     port (
       clk             : in  std_logic;
       rst             : in  std_logic;
-      phase_incs      : in  t_ph_inc_lut;
+      slot_index      : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      ph_inc          : in  unsigned(WIDTH_PH_DATA-1 downto 0);
       note_amps       : in  t_note_amp;
+      note_timbres    : in  t_note_timbre;
+      pitch_mods      : in  t_timbre_mod;
+      glide_rates     : in  t_glide_rate;
+      glide_start     : in  std_logic;
+      glide_from      : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       note_index_out  : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       phase_out       : out unsigned(PHASE_WIDTH-1 downto 0);
       note_amp_out    : out unsigned(NOTE_GAIN_WIDTH-1 downto 0);
@@ -51,9 +68,33 @@ architecture tb of phase_accumulator_tb is
 
   -- note amps
   signal note_amps : t_note_amp;
+
+  -- tuning table read by slot, as synth_axi_ctrl returns it
+  signal slot_index : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  signal ph_inc     : unsigned(WIDTH_PH_DATA-1 downto 0);
+
+  -- pipeline out
+  signal note_index_out  : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  signal phase_out       : unsigned(WIDTH_PH_DATA-1 downto 0);
+  signal note_amp_out    : unsigned(WIDTH_NOTE_GAIN-1 downto 0);
+  signal cycle_start_out : std_logic;
+
+  -- frames to follow each slot through
+  constant NUM_FRAMES : natural := 16;
+
+  -- glide of one slot up an octave, on timbre 0
+  constant GLIDE_SLOT   : natural := 69;
+  constant GLIDE_SRC    : natural := 57;
+  constant GLIDE_FRAMES : natural := 400;
+  signal glide_rates : t_glide_rate := (others => (others => '0'));
+  signal glide_start : std_logic := '0';
+
+  signal sim_done : boolean := false;
   
     
 begin
+  ph_inc <= ph_inc_lut(slot_index);
+
   -- Instantiate the DUT
 
   uut: phase_accumulator
@@ -63,32 +104,149 @@ begin
     port map (
       clk             => clk,
       rst             => rst,
-      phase_incs      => ph_inc_lut,
+      slot_index      => slot_index,
+      ph_inc          => ph_inc,
       note_amps       => note_amps,
-      note_index_out  => open,
-      phase_out       => open,
-      note_amp_out    => open,
-      cycle_start_out => open
+      note_timbres    => (others => (others => '0')),
+      pitch_mods      => (others => (others => '0')),
+      glide_rates     => glide_rates,
+      glide_start     => glide_start,
+      glide_from      => GLIDE_SRC,
+      note_index_out  => note_index_out,
+      phase_out       => phase_out,
+      note_amp_out    => note_amp_out,
+      cycle_start_out => cycle_start_out
     );
   
   -- Clock Process
   clk_process : process
   begin
-      while true loop
+      while not sim_done loop
           clk <= '0';
           wait for clk_period / 2;
           clk <= '1';
           wait for clk_period / 2;
       end loop;
+      wait;
   end process;
 
 -- Stimulus Process
 stimulus : process
+  variable last_phase : t_ph_inc;
+  variable seen       : t_note_bits := (others => '0');
+  variable wraps      : natural := 0;
+  variable n          : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  variable step,
+           last_step  : unsigned(WIDTH_PH_DATA-1 downto 0);
+  variable reached    : boolean;
+
+  -- the step of the glide slot this frame, from its phase out
+  procedure next_step is
+  begin
+    loop
+      wait until rising_edge(clk);
+      exit when note_index_out = GLIDE_SLOT;
+    end loop;
+    step := phase_out - last_phase(GLIDE_SLOT);
+    last_phase(GLIDE_SLOT) := phase_out;
+  end procedure;
+
+  -- glide start for the glide slot on its next pass, as synth_axi_ctrl
+  -- returns it on slot_index
+  procedure start_glide is
+  begin
+    wait until falling_edge(clk) and slot_index = GLIDE_SLOT;
+    glide_start <= '1';
+    wait until falling_edge(clk);
+    glide_start <= '0';
+  end procedure;
 begin
-  note_amps    <= (others => (others => '0'));
-  note_amps(0) <= "1111111";
+  for i in I_LOWEST_NOTE to I_HIGHEST_NOTE loop
+    note_amps(i) <= to_unsigned(i, WIDTH_NOTE_GAIN);
+  end loop;
   wait for clk_period2;
   rst     <= '0';
+
+  -- skip the reset values still in the output registers
+  wait until rising_edge(clk);
+  wait until rising_edge(clk);
+
+  for i in 0 to NUM_FRAMES * NUM_NOTES - 1 loop
+    wait until rising_edge(clk);
+    n := note_index_out;
+
+    assert note_amp_out = note_amps(n)
+      report "note " & integer'image(n) & " amplitude out of step" severity error;
+    assert (cycle_start_out = '1') = (phase_out < ph_inc_lut(n))
+      report "note " & integer'image(n) & " cycle start does not match the wrap" severity error;
+
+    if seen(n) = '1' then
+      assert phase_out = last_phase(n) + ph_inc_lut(n)
+        report "note " & integer'image(n) & " phase stepped by x" &
+               to_hstring(phase_out - last_phase(n)) severity error;
+    end if;
+    seen(n)       := '1';
+    last_phase(n) := phase_out;
+
+    if n = I_HIGHEST_NOTE and cycle_start_out = '1' then
+      wraps := wraps + 1;
+    end if;
+  end loop;
+
+  assert seen = (seen'range => '1')
+    report "not every note slot came out" severity error;
+  assert wraps > 0
+    report "highest note never started a cycle" severity error;
+
+  -- glide rate 0 ignores the start
+  next_step;
+  start_glide;
+  for f in 1 to 4 loop
+    next_step;
+    assert step = ph_inc_lut(GLIDE_SLOT)
+      report "glide started with glide rate 0, step x" & to_hstring(step) severity error;
+  end loop;
+
+  -- glide up an octave, from the source's increment to the table's
+  glide_rates(0) <= to_unsigned(1, WIDTH_GLIDE_RATE);
+  start_glide;
+  next_step;
+  assert step = ph_inc_lut(GLIDE_SRC)
+    report "glide did not start from the source, step x" & to_hstring(step) severity error;
+  last_step := step;
+  reached   := false;
+  for f in 1 to GLIDE_FRAMES loop
+    next_step;
+    if step = ph_inc_lut(GLIDE_SLOT) then
+      reached := true;
+      exit;
+    end if;
+    assert step > last_step and step < ph_inc_lut(GLIDE_SLOT)
+      report "glide step x" & to_hstring(step) & " after x" & to_hstring(last_step) severity error;
+    last_step := step;
+  end loop;
+  assert reached
+    report "glide did not reach its target in " & integer'image(GLIDE_FRAMES) & " frames" severity error;
+  for f in 1 to 4 loop
+    next_step;
+    assert step = ph_inc_lut(GLIDE_SLOT)
+      report "glide left its target, step x" & to_hstring(step) severity error;
+  end loop;
+
+  -- glide rate 0 ends a glide under way
+  start_glide;
+  for f in 1 to 8 loop
+    next_step;
+  end loop;
+  assert step < ph_inc_lut(GLIDE_SLOT)
+    report "glide over before the rate went to 0" severity error;
+  glide_rates(0) <= (others => '0');
+  next_step;
+  assert step = ph_inc_lut(GLIDE_SLOT)
+    report "glide rate 0 did not end the glide, step x" & to_hstring(step) severity error;
+
+  report "Testbench completed." severity note;
+  sim_done <= true;
   wait;
 end process stimulus;
 
@@ -7,12 +7,21 @@
 -- Module Name: Phase to Waveform Testbench
 -- Description: 
 --   Simulation testbench for the Phase to Waveform in the Synthesizer Engine.
+--   The phase accumulator drives every note slot. Notes 0 to 63 play timbre 0,
+--   a mix of the pulse, ramp, saw and triangle with phase shifts, checked
+--   exactly against a model of the waveform and scaler arithmetic. Notes 64
+--   to 127 play timbre 1, a full scale sine, checked against an ideal sine.
+--
+-- Revision:
+-- 10/19/2026 agt - engine sine lookup generics, self-checking, ends on its own
+-- 10/19/2026 agt - tuning increment returned by slot index
 -- 
 ----------------------------------------------------------------------------------
 
 library ieee;
   use ieee.std_logic_1164.all;
   use ieee.numeric_std.all;
+  use ieee.math_real.all;
 
 library xil_defaultlib;
   use xil_defaultlib.synth_pkg.all;
@@ -30,16 +39,18 @@ architecture tb of phase_to_wave_tb is
       PHASE_WIDTH     : integer := WIDTH_PH_DATA;
       NOTE_GAIN_WIDTH : integer := WIDTH_NOTE_GAIN;
       DATA_WIDTH      : natural := WIDTH_WAVE_DATA;
-      SIN_LUT_PH      : natural := 12
+      SIN_LUT_PH      : natural := 12;
+      SIN_INTERP_PH   : natural := 0
     );
     port (
       clk             : in  std_logic;
       rst             : in  std_logic;
       -- synth controls
-      wfrm_amps       : in  t_wfrm_amp;
-      wfrm_phs        : in  t_wfrm_ph;
-      pulse_width     : in  unsigned(WIDTH_PULSE_WIDTH-1 downto 0);
-      wave_mix_amp    : in  unsigned(WIDTH_NOTE_GAIN-1 downto 0);
+      wfrm_amps       : in  t_timbre_amps;
+      wfrm_phs        : in  t_timbre_phs;
+      pulse_width     : in  t_timbre_pw;
+      note_timbres    : in  t_note_timbre;
+      active_notes    : in  t_note_bits;
       -- pipeline in
       note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       phase_in        : in  unsigned(PHASE_WIDTH-1 downto 0);
@@ -61,8 +72,14 @@ architecture tb of phase_to_wave_tb is
     port (
       clk             : in  std_logic;
       rst             : in  std_logic;
-      phase_incs      : in  t_ph_inc_lut;
+      slot_index      : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      ph_inc          : in  unsigned(WIDTH_PH_DATA-1 downto 0);
       note_amps       : in  t_note_amp;
+      note_timbres    : in  t_note_timbre;
+      pitch_mods      : in  t_timbre_mod;
+      glide_rates     : in  t_glide_rate;
+      glide_start     : in  std_logic;
+      glide_from      : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       note_index_out  : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
       phase_out       : out unsigned(PHASE_WIDTH-1 downto 0);
       note_amp_out    : out unsigned(NOTE_GAIN_WIDTH-1 downto 0);
@@ -81,8 +98,89 @@ architecture tb of phase_to_wave_tb is
 
   signal cycle_start_q : std_logic;
 
-  signal wfrm_amps : t_wfrm_amp;
-  signal wfrm_phs  : t_wfrm_ph;
+  signal wfrm_amps    : t_timbre_amps;
+  signal wfrm_phs     : t_timbre_phs;
+  signal pulse_width  : t_timbre_pw;
+  signal note_timbres : t_note_timbre;
+
+  -- pipeline out
+  signal note_index_out  : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  signal note_out        : signed(WIDTH_WAVE_DATA-1 downto 0);
+  signal note_amp_out    : unsigned(WIDTH_NOTE_GAIN-1 downto 0);
+
+  -- timbre 0 mix, amplitudes and phase shifts in waveform order
+  type t_int_wfrm is array (0 to NUM_WFRMS-1) of natural;
+  constant MIX_AMPS : t_int_wfrm := (20, 30, 25, 40, 0);
+  constant MIX_PHS  : t_int_wfrm := (16#1000#, 16#2000#, 16#3000#, 16#4000#, 0);
+  constant MIX_PW   : natural := 16#6000#;
+
+  -- allowed deviation of the timbre 1 sine from an ideal sine, in LSBs
+  constant MAX_SINE_ERROR : real := 8.0;
+
+  -- frames to check, after the pipeline has seen every slot twice
+  constant NUM_FRAMES : natural := 8;
+
+  signal sim_done : boolean := false;
+
+  -- wrap to a 16-bit signed sample
+  function wrap16(v : integer) return integer is
+    variable m : integer;
+  begin
+    m := v mod 2**WIDTH_WAVE_DATA;
+    if m >= 2**(WIDTH_WAVE_DATA-1) then
+      return m - 2**WIDTH_WAVE_DATA;
+    end if;
+    return m;
+  end function;
+
+  -- arithmetic shift right
+  function shr(x : integer; i : natural) return integer is
+  begin
+    if x >= 0 then
+      return x / 2**i;
+    end if;
+    return -((-x + 2**i - 1) / 2**i);
+  end function;
+
+  -- the scaler, a sum of the shifted sample for each gain bit, halved
+  function scale(x : integer; gain : natural) return integer is
+    variable sum : integer := 0;
+  begin
+    for i in 0 to WIDTH_WAVE_GAIN-1 loop
+      if (gain / 2**(WIDTH_WAVE_GAIN-1-i)) mod 2 = 1 then
+        sum := sum + shr(x, i);
+      end if;
+    end loop;
+    return shr(sum, 1);
+  end function;
+
+  -- timbre 0 mix for a 16-bit phase
+  function mix_model(p : natural) return integer is
+    variable pulse, ramp, saw, tri : integer;
+    variable offset, doubled, pre  : natural;
+  begin
+    if (p + MIX_PHS(I_PULSE)) mod 2**16 < MIX_PW then
+      pulse := 32767;
+    else
+      pulse := -32768;
+    end if;
+    ramp    := wrap16(p + 2**15 + MIX_PHS(I_RAMP));
+    saw     := wrap16(MIX_PHS(I_SAW) - p);
+    offset  := (p + MIX_PHS(I_TRI)) mod 2**16;
+    doubled := (2 * offset) mod 2**16;
+    if (offset / 2**14) mod 2 = 1 then
+      pre := 2**16 - 1 - doubled;
+    else
+      pre := doubled;
+    end if;
+    if offset >= 2**15 then
+      tri := pre;
+    else
+      tri := -pre;
+    end if;
+    return wrap16(scale(pulse, MIX_AMPS(I_PULSE)) + scale(ramp, MIX_AMPS(I_RAMP)) +
+                  scale(saw,   MIX_AMPS(I_SAW))   + scale(tri,  MIX_AMPS(I_TRI)));
+  end function;
 
   -- Clock process
   constant clk_period  : time := 40 ns;
@@ -90,16 +188,23 @@ architecture tb of phase_to_wave_tb is
 
   -- note amps
   signal note_amps : t_note_amp;
-  
+
+  -- tuning table read by slot, as synth_axi_ctrl returns it
+  signal slot_index : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  signal ph_inc     : unsigned(WIDTH_PH_DATA-1 downto 0);
+
     
 begin
+  ph_inc <= ph_inc_lut(slot_index);
+
   -- Instantiate the DUT
   uut: phase_to_wave
     generic map (
       PHASE_WIDTH     => WIDTH_PH_DATA,
       NOTE_GAIN_WIDTH => WIDTH_NOTE_GAIN,
       DATA_WIDTH      => WIDTH_WAVE_DATA,
-      SIN_LUT_PH      => 12
+      SIN_LUT_PH      => WIDTH_SIN_LUT_PH,
+      SIN_INTERP_PH   => WIDTH_SIN_INTERP_PH
     )
     port map (
       clk             => clk,
@@ -107,17 +212,18 @@ begin
       -- synth controls
       wfrm_amps       => wfrm_amps,
       wfrm_phs        => wfrm_phs,
-      pulse_width     => x"4000",
-      wave_mix_amp    => "1111111",
+      pulse_width     => pulse_width,
+      note_timbres    => note_timbres,
+      active_notes    => (others => '1'),
       -- pipeline in
       note_index_in   => note_index_q,
       phase_in        => phase_q,
       note_amp_in     => note_amp_q,
       cycle_start_in  => cycle_start_q,
       -- pipeline out
-      note_index_out  => open,
-      note_out        => open,
-      note_amp_out    => open,
+      note_index_out  => note_index_out,
+      note_out        => note_out,
+      note_amp_out    => note_amp_out,
       cycle_start_out => open
     );
 
@@ -128,8 +234,14 @@ begin
     port map (
       clk             => clk,
       rst             => rst,
-      phase_incs      => ph_inc_lut,
+      slot_index      => slot_index,
+      ph_inc          => ph_inc,
       note_amps       => note_amps,
+      note_timbres    => note_timbres,
+      pitch_mods      => (others => (others => '0')),
+      glide_rates     => (others => (others => '0')),
+      glide_start     => '0',
+      glide_from      => I_LOWEST_NOTE,
       note_index_out  => note_index_q,
       phase_out       => phase_q,
       note_amp_out    => note_amp_q,
@@ -139,23 +251,76 @@ begin
   -- Clock Process
   clk_process : process
   begin
-      while true loop
+      while not sim_done loop
           clk <= '0';
           wait for clk_period / 2;
           clk <= '1';
           wait for clk_period / 2;
       end loop;
+      wait;
   end process;
 
 -- Stimulus Process
 stimulus : process
+  variable phase_in : t_ph_inc;
+  variable n        : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+  variable p        : natural;
+  variable ideal    : real;
+  variable err      : real;
+  variable max_err  : real := 0.0;
 begin
-  note_amps    <= (others => (others => '0'));
-  note_amps(0) <= "1111111";
-  wfrm_amps    <= (others => (others => '1'));
-  wfrm_phs     <= (others => (others => '1'));
+  for i in I_LOWEST_NOTE to I_HIGHEST_NOTE loop
+    note_amps(i) <= to_unsigned(i, WIDTH_NOTE_GAIN);
+    if i < NUM_NOTES / 2 then
+      note_timbres(i) <= to_unsigned(0, WIDTH_TIMBRE);
+    else
+      note_timbres(i) <= to_unsigned(1, WIDTH_TIMBRE);
+    end if;
+  end loop;
+  wfrm_amps   <= (others => (others => (others => '0')));
+  wfrm_phs    <= (others => (others => (others => '0')));
+  pulse_width <= (others => x"8000");
+  for w in 0 to NUM_WFRMS-1 loop
+    wfrm_amps(0)(w) <= to_unsigned(MIX_AMPS(w), WIDTH_WAVE_GAIN);
+    wfrm_phs(0)(w)  <= to_unsigned(MIX_PHS(w), WIDTH_WAVE_DATA);
+  end loop;
+  pulse_width(0)      <= to_unsigned(MIX_PW, WIDTH_PULSE_WIDTH);
+  wfrm_amps(1)(I_SINE) <= to_unsigned(127, WIDTH_WAVE_GAIN);
   wait for clk_period2;
   rst     <= '0';
+
+  -- the phase into the waveform logic comes out as a sample two clocks later
+  for i in 0 to (NUM_FRAMES + 2) * NUM_NOTES - 1 loop
+    wait until rising_edge(clk);
+    if i >= 2 * NUM_NOTES then
+      n := note_index_out;
+      p := to_integer(phase_in(n)(WIDTH_PH_DATA-1 downto WIDTH_PH_DATA-WIDTH_WAVE_DATA));
+
+      assert note_amp_out = note_amps(n)
+        report "note " & integer'image(n) & " amplitude out of step" severity error;
+
+      if note_timbres(n) = 0 then
+        assert to_integer(note_out) = mix_model(p)
+          report "note " & integer'image(n) & " phase " & integer'image(p) & " mix " &
+                 integer'image(to_integer(note_out)) & ", expected " & integer'image(mix_model(p))
+          severity error;
+      else
+        ideal := 32767.0 * sin(MATH_2_PI * real(p) / 65536.0) * 127.0 / 128.0;
+        err   := abs(real(to_integer(note_out)) - ideal);
+        if err > max_err then
+          max_err := err;
+        end if;
+      end if;
+    end if;
+    phase_in(note_index_q) := phase_q;
+  end loop;
+
+  report "sine max error: " & real'image(max_err) & " LSB" severity note;
+  assert max_err <= MAX_SINE_ERROR
+    report "sine error exceeds " & real'image(MAX_SINE_ERROR) & " LSB" severity error;
+
+  report "Testbench completed." severity note;
+  sim_done <= true;
   wait;
 end process stimulus;
 
@@ -0,0 +1,453 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+-- 
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Pipeline Trace Testbench
+-- Description: 
+--   Testbench for the pipeline trace in the Synthesizer Engine.
+--   Runs a scripted set of captures over AXI on a sine patch: a slot trace
+--   of note 57 triggered by its attack, a frame trace triggered at once and
+--   a slot trace triggered by the note 57 level. Checks the status, the
+--   control readback and the entries of each. The slot and frame captures
+--   go to trace_slot.txt and trace_frame.txt for tools/trace_vcd.py, a
+--   header line with the control and status words then one entry a line.
+--
+-- Revision:
+-- 10/19/2026 agt - report the status and an entry of each capture
+-- 
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+
+library std;
+  use std.textio.all;
+
+library xil_defaultlib;
+  use xil_defaultlib.synth_pkg.all;
+
+entity pipeline_trace_tb is
+end pipeline_trace_tb;
+
+architecture tb of pipeline_trace_tb is
+
+  constant AXI_DATA_WIDTH : integer := 32;
+  constant AXI_ADDR_WIDTH : integer := 31;
+
+  -- AXI signals
+  signal clk      : std_logic := '0';
+  signal rst      : std_logic := '1';
+  signal rst_n    : std_logic := '0';
+
+  signal awaddr   : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+  signal awvalid  : std_logic;
+  signal awready  : std_logic;
+
+  signal wdata    : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+  signal wstrb    : std_logic_vector(3 downto 0);
+  signal wvalid   : std_logic;
+  signal wready   : std_logic;
+
+  signal bresp    : std_logic_vector(1 downto 0);
+  signal bvalid   : std_logic;
+  signal bready   : std_logic;
+
+  signal araddr   : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+  signal arvalid  : std_logic;
+  signal arready  : std_logic;
+
+  signal rdata    : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+  signal rresp    : std_logic_vector(1 downto 0);
+  signal rvalid   : std_logic;
+  signal rready   : std_logic;
+
+  -- Digital audio output
+  signal audio_l  : std_logic_vector(WIDTH_WAVE_DATA+8-1 downto 0);
+  signal audio_r  : std_logic_vector(WIDTH_WAVE_DATA+8-1 downto 0);
+
+  signal sim_done : boolean := false;
+
+  -- Clock process
+  constant clk_period  : time := 40 ns;
+  constant clk_period2 : time := 80 ns;
+    
+  -- DUT Component
+  component synth_engine is
+    generic (
+      -- AXI parameters
+      C_S_AXI_DATA_WIDTH  : integer  := 32;
+      C_S_AXI_ADDR_WIDTH  : integer  := 31;
+      -- waveform parameters
+      DATA_WIDTH     : natural := WIDTH_WAVE_DATA;
+      OUT_DATA_WIDTH : natural := WIDTH_WAVE_DATA+8
+    );
+    port (
+      -- clock and reset
+      clk           : in std_logic;
+      rst           : in std_logic;
+
+      -- AXI control interface
+      s_axi_aclk    : in  std_logic;
+      s_axi_aresetn : in  std_logic;
+      s_axi_awaddr   : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+      s_axi_awprot   : in std_logic_vector(2 downto 0);
+      s_axi_awvalid  : in std_logic;
+      s_axi_awready  : out std_logic;
+      s_axi_wdata    : in  std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+      s_axi_wstrb    : in  std_logic_vector(3 downto 0);
+      s_axi_wvalid   : in  std_logic;
+      s_axi_wready   : out std_logic;
+      s_axi_bresp    : out std_logic_vector(1 downto 0);
+      s_axi_bvalid   : out std_logic;
+      s_axi_bready   : in  std_logic;
+      s_axi_araddr   : in  std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+      s_axi_arprot   : in  std_logic_vector(2 downto 0);
+      s_axi_arvalid  : in  std_logic;
+      s_axi_arready  : out std_logic;
+      s_axi_rdata    : out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+      s_axi_rresp    : out std_logic_vector(1 downto 0);
+      s_axi_rvalid   : out std_logic;
+      s_axi_rready   : in  std_logic;
+
+      -- Digital audio output
+      audio_out_l   : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0);
+      audio_out_r   : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
+    );
+  end component synth_engine;
+    
+begin
+
+  rst_n <= not(rst);
+
+  -- Instantiate the DUT
+
+  uut: synth_engine
+    generic map (
+      C_S_AXI_DATA_WIDTH  => AXI_DATA_WIDTH,
+      C_S_AXI_ADDR_WIDTH  => AXI_ADDR_WIDTH,
+      DATA_WIDTH     => WIDTH_WAVE_DATA,
+      OUT_DATA_WIDTH => WIDTH_WAVE_DATA+8
+    )
+    port map (
+      -- AXI control interface
+      clk           => clk,
+      rst           => rst,
+      s_axi_aclk    => clk,
+      s_axi_aresetn => rst_n,
+      s_axi_awaddr  => awaddr,
+      s_axi_awprot  => "000",
+      s_axi_awvalid  => awvalid,
+      s_axi_awready  => awready,
+      s_axi_wdata    => wdata,
+      s_axi_wstrb    => wstrb,
+      s_axi_wvalid  => wvalid,
+      s_axi_wready  => wready,
+      s_axi_bresp    => bresp,
+      s_axi_bvalid  => bvalid,
+      s_axi_bready  => bready,
+      s_axi_araddr  => araddr,
+      s_axi_arprot  => "000",
+      s_axi_arvalid  => arvalid,
+      s_axi_arready  => arready,
+      s_axi_rdata    => rdata,
+      s_axi_rresp    => rresp,
+      s_axi_rvalid  => rvalid,
+      s_axi_rready  => rready,
+
+      -- Digital audio output
+      audio_out_l   => audio_l,
+      audio_out_r   => audio_r
+    );
+  
+  -- Clock Process
+  clk_process : process
+  begin
+      while not sim_done loop
+          clk <= '0';
+          wait for clk_period / 2;
+          clk <= '1';
+          wait for clk_period / 2;
+      end loop;
+      wait;
+  end process;
+
+  -- Stimulus Process
+  stimulus : process
+  
+    procedure axi_write(
+      address : in std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+      data : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0)
+    ) is begin
+      awaddr  <= address;
+      awvalid <= '1';
+      wdata   <= data;
+      wstrb   <= "1111";
+      wvalid  <= '1';
+      bready  <= '1';
+
+      wait until rising_edge(clk);
+      awvalid <= '0';
+      wvalid  <= '0';
+
+      wait until rising_edge(clk);
+      if bvalid = '0' then
+          wait until bvalid = '1';
+      end if;
+      
+      bready  <= '0';
+      
+    end procedure;
+    
+    procedure axi_read(
+      address : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+      data    : out std_logic_vector(AXI_DATA_WIDTH-1 downto 0)
+    ) is begin
+      araddr  <= address;
+      arvalid <= '1';
+      rready  <= '1';
+      
+      loop
+        wait until rising_edge(clk);
+        exit when arready = '1';
+      end loop;
+      arvalid <= '0';
+      
+      loop
+        wait until rising_edge(clk);
+        exit when rvalid = '1';
+      end loop;
+      data    := rdata;
+      rready  <= '0';
+    
+    end procedure;
+
+    -- read and compare the bits set in the mask
+    procedure check_read(
+      address  : in std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+      expected : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+      mask     : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0) := x"FFFFFFFF"
+    ) is
+      variable data : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    begin
+      axi_read(address, data);
+      assert (data and mask) = (expected and mask)
+        report "read x" & to_hstring(address) & " = x" & to_hstring(data) &
+               ", expected x" & to_hstring(expected and mask) severity error;
+    end procedure;
+    
+    constant TRACE_CTRL_ADDR : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0) := "000" & x"00003C0";
+    constant TRACE_STAT_ADDR : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0) := "000" & x"00003C4";
+    constant TRACE_PAGE_ADDR : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0) := "000" & x"00003C8";
+    constant TRACE_BUF_ADDR  : unsigned(AXI_ADDR_WIDTH-1 downto 0) := to_unsigned(16#E00#, AXI_ADDR_WIDTH);
+
+    -- adsr states as the entries carry them
+    constant ADSR_ATTACK  : natural := 1;
+    constant ADSR_RELEASE : natural := 4;
+
+    type t_entries is array (0 to TRACE_DEPTH-1) of std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    variable entries : t_entries;
+    variable data    : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    variable status  : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    variable ctrl    : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    variable last    : natural;
+    variable state   : natural;
+    variable heard   : boolean;
+
+    function trace_word(
+      frame : std_logic;
+      trig  : natural;
+      state : natural;
+      slot  : natural;
+      level : natural
+    ) return std_logic_vector is
+      variable w : std_logic_vector(AXI_DATA_WIDTH-1 downto 0) := (others => '0');
+    begin
+      w(TRACE_ARM)   := '1';
+      w(TRACE_FRAME) := frame;
+      w(TRACE_TRIG_LSB+1 downto TRACE_TRIG_LSB) := std_logic_vector(to_unsigned(trig, 2));
+      w(TRACE_STATE_LSB+WIDTH_ADSR_STATE-1 downto TRACE_STATE_LSB) :=
+        std_logic_vector(to_unsigned(state, WIDTH_ADSR_STATE));
+      w(TRACE_SLOT_LSB+6 downto TRACE_SLOT_LSB) := std_logic_vector(to_unsigned(slot, 7));
+      w(TRACE_LEVEL_LSB+15 downto TRACE_LEVEL_LSB) := std_logic_vector(to_unsigned(level, 16));
+      return w;
+    end function;
+
+    function entry_note(e : std_logic_vector) return natural is
+    begin
+      return to_integer(unsigned(e(TRACE_CYCLE_BIT-1 downto TRACE_NOTE_LSB)));
+    end function;
+
+    function entry_state(e : std_logic_vector) return natural is
+    begin
+      return to_integer(unsigned(e(TRACE_ADSR_LSB+WIDTH_ADSR_STATE-1 downto TRACE_ADSR_LSB)));
+    end function;
+
+    function entry_sample(e : std_logic_vector) return integer is
+    begin
+      return to_integer(signed(e(TRACE_NOTE_LSB-1 downto TRACE_SAMPLE_LSB)));
+    end function;
+
+    -- poll the status until a bit in the mask is set, a frame apart
+    procedure wait_status(
+      mask   : in  std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+      frames : in  natural;
+      status : out std_logic_vector(AXI_DATA_WIDTH-1 downto 0)
+    ) is
+      variable data : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    begin
+      for i in 0 to frames loop
+        axi_read(TRACE_STAT_ADDR, data);
+        exit when (data and mask) /= x"00000000";
+        wait for clk_period * NUM_NOTES;
+      end loop;
+      assert (data and mask) /= x"00000000"
+        report "trace status x" & to_hstring(data) & " timed out" severity error;
+      status := data;
+    end procedure;
+
+    -- read the whole buffer, a page of NUM_NOTES entries at a time
+    procedure read_trace(entries : out t_entries) is
+      variable data : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    begin
+      for page in 0 to TRACE_DEPTH/NUM_NOTES-1 loop
+        axi_write(TRACE_PAGE_ADDR, std_logic_vector(to_unsigned(page, AXI_DATA_WIDTH)));
+        for i in 0 to NUM_NOTES-1 loop
+          axi_read(std_logic_vector(TRACE_BUF_ADDR + 4*i), data);
+          entries(page*NUM_NOTES + i) := data;
+        end loop;
+      end loop;
+    end procedure;
+
+    -- the capture for trace_vcd.py
+    procedure dump_trace(
+      name    : in string;
+      ctrl    : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+      status  : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+      entries : in t_entries
+    ) is
+      file     f_trace : text;
+      variable l       : line;
+    begin
+      file_open(f_trace, name, write_mode);
+      write(l, string'("ctrl 0x") & to_hstring(ctrl) & string'(" status 0x") & to_hstring(status));
+      writeline(f_trace, l);
+      for i in entries'range loop
+        write(l, to_hstring(entries(i)));
+        writeline(f_trace, l);
+      end loop;
+      file_close(f_trace);
+    end procedure;
+
+  begin
+    -- Reset
+    rst      <= '1';
+    awaddr  <= "000" & x"0000000";
+    awvalid <= '0';
+    wdata   <= x"00000000";
+    wstrb   <= "0000";
+    wvalid  <= '0';
+    bready  <= '0';
+    araddr  <= "000" & x"0000000";
+    arvalid <= '0';
+    rready  <= '0';
+    wait for clk_period2;
+    rst     <= '0';
+    wait for clk_period2;
+
+    wait for clk_period * 1024;
+
+    check_read("000" & x"00003E0", SYNTH_ENG_REV);
+    -- Nothing armed out of reset
+    check_read(TRACE_STAT_ADDR, x"00000000");
+
+    -- Sine patch on timbre 0
+    axi_write("000" & x"0000220", x"00000008");
+    axi_write("000" & x"0000224", x"0000003F");
+    axi_write("000" & x"0000214", x"0000007F");
+    axi_write("000" & x"0000280", x"00002000");
+    axi_write("000" & x"0000284", x"00002000");
+    axi_write("000" & x"0000288", x"00080000");
+    axi_write("000" & x"000028C", x"00002000");
+
+    -- Slot trace of note 57, triggered by its attack
+    ctrl := trace_word('0', TRACE_TRIG_STATE, ADSR_ATTACK, 57, 0);
+    axi_write(TRACE_CTRL_ADDR, ctrl);
+    -- arm is a command and reads back clear
+    ctrl(TRACE_ARM) := '0';
+    check_read(TRACE_CTRL_ADDR, ctrl);
+    -- stays armed while the note is off
+    wait for clk_period * NUM_NOTES * 16;
+    check_read(TRACE_STAT_ADDR, x"00000001");
+
+    -- Play note 57
+    axi_write("000" & x"00000E4", x"00000064");
+    wait_status(x"00000004", TRACE_DEPTH + 64, status);
+    check_read(TRACE_STAT_ADDR, x"04000004");
+    read_trace(entries);
+    dump_trace("trace_slot.txt", ctrl, status, entries);
+    report "slot trace: status x" & to_hstring(status) & ", first entry x" &
+           to_hstring(entries(0)) & ", last x" & to_hstring(entries(TRACE_DEPTH-1)) severity note;
+
+    -- every entry is note 57, starting in attack and never going back
+    assert entry_state(entries(0)) = ADSR_ATTACK
+      report "slot trace starts in state " & integer'image(entry_state(entries(0))) severity error;
+    last  := ADSR_ATTACK;
+    heard := false;
+    for i in entries'range loop
+      assert entry_note(entries(i)) = 57
+        report "slot trace entry " & integer'image(i) & " is note " &
+               integer'image(entry_note(entries(i))) severity error;
+      state := entry_state(entries(i));
+      assert state >= last and state < ADSR_RELEASE
+        report "slot trace entry " & integer'image(i) & " in state " &
+               integer'image(state) severity error;
+      last := state;
+      if entry_sample(entries(i)) /= 0 then
+        heard := true;
+      end if;
+    end loop;
+    assert heard report "slot trace of note 57 is silent" severity error;
+
+    -- Frame trace at once, every slot in order from slot 0
+    ctrl := trace_word('1', TRACE_TRIG_NOW, 0, 0, 0);
+    axi_write(TRACE_CTRL_ADDR, ctrl);
+    ctrl(TRACE_ARM) := '0';
+    wait_status(x"00000004", 64, status);
+    read_trace(entries);
+    dump_trace("trace_frame.txt", ctrl, status, entries);
+    report "frame trace: status x" & to_hstring(status) & ", note 57 entry x" &
+           to_hstring(entries(57)) severity note;
+    for i in entries'range loop
+      assert entry_note(entries(i)) = i mod NUM_NOTES
+        report "frame trace entry " & integer'image(i) & " is note " &
+               integer'image(entry_note(entries(i))) severity error;
+    end loop;
+    assert entry_sample(entries(57)) /= 0 or entry_sample(entries(NUM_NOTES+57)) /= 0
+      report "frame trace has note 57 silent" severity error;
+
+    -- Slot trace of note 57 on its level, the first entry is the trigger
+    ctrl := trace_word('0', TRACE_TRIG_LEVEL, 0, 57, 16#0100#);
+    axi_write(TRACE_CTRL_ADDR, ctrl);
+    -- arming again clears the done capture
+    check_read(TRACE_STAT_ADDR, x"00000000", x"04000004");
+    wait_status(x"00000002", 64, status);
+    axi_write(TRACE_PAGE_ADDR, x"00000000");
+    axi_read(std_logic_vector(TRACE_BUF_ADDR), data);
+    report "level trace: status x" & to_hstring(status) & ", trigger entry x" &
+           to_hstring(data) severity note;
+    assert entry_note(data) = 57 and abs(entry_sample(data)) >= 16#0100#
+      report "level trigger entry x" & to_hstring(data) severity error;
+
+    -- Release note 57
+    axi_write("000" & x"00000E4", x"00000000");
+    -- End Simulation
+    wait for clk_period2;
+    report "Testbench completed." severity note;
+    sim_done <= true;
+  wait;
+end process;
+
+end tb;
@@ -1,38 +1,25 @@
 ----------------------------------------------------------------------------------
--- Company: 
--- Engineer: 
--- 
+-- Company: beepboop
+-- Engineer: Tyler Huddleston
+--
 -- Create Date: 02/23/2025 03:11:56 PM
--- Design Name: 
--- Module Name: rst_sync_tb - Behavioral
--- Project Name: 
--- Target Devices: 
--- Tool Versions: 
--- Description: 
--- 
--- Dependencies: 
--- 
+-- Design Name: Utilities
+-- Module Name: Reset Synchronizer Testbench
+-- Description:
+--   Applies the reset at points unrelated to the clock and checks that the
+--   synchronized reset follows it straight away, then releases it and checks
+--   that the output holds for one rising edge and drops on the second.
+--
 -- Revision:
 -- Revision 0.01 - File Created
--- Additional Comments:
--- 
+-- 10/19/2026 agt - self-checking, ends on its own
+--
 ----------------------------------------------------------------------------------
 
-
-library IEEE;
-use IEEE.STD_LOGIC_1164.ALL;
-
--- Uncomment the following library declaration if using
--- arithmetic functions with Signed or Unsigned values
---use IEEE.NUMERIC_STD.ALL;
-
--- Uncomment the following library declaration if instantiating
--- any Xilinx leaf cells in this code.
---library UNISIM;
---use UNISIM.VComponents.all;
+library ieee;
+  use ieee.std_logic_1164.all;
 
 entity rst_sync_tb is
---  Port ( );
 end rst_sync_tb;
 
 architecture Behavioral of rst_sync_tb is
@@ -45,15 +32,17 @@ architecture Behavioral of rst_sync_tb is
     );
   end component rst_sync;
 
+  constant clk_period : time := 20 ns;
+
   signal clock    : std_logic := '0';
   signal reset    : std_logic := '1';
   signal rst_out  : std_logic;
+  signal sim_done : boolean := false;
 
 begin
 
-  -- Reset and clock
-  clock <= not clock after 10 ns;
-  reset <= not reset after 137 ns;
+  -- Clock, stopped at the end so the simulation runs out of events
+  clock <= not clock after clk_period / 2 when not sim_done else '0';
 
   -- Instantiate the design under test
   dut: rst_sync
@@ -63,4 +52,43 @@ begin
       rst_sync_out => rst_out
     );
 
+  -- Stimulus and checks
+  stimulus : process
+  begin
+    for i in 0 to 7 loop
+      -- apply part way through a clock period
+      wait until falling_edge(clock);
+      wait for (i mod 4) * 2 ns + 1 ns;
+      reset <= '1';
+      wait for 1 ns;
+      assert rst_out = '1'
+        report "reset not applied asynchronously" severity error;
+
+      wait for clk_period * (2 + i mod 3);
+      assert rst_out = '1'
+        report "reset dropped while applied" severity error;
+
+      -- release away from the rising edge, the first edge still holds it
+      wait until falling_edge(clock);
+      wait for (i mod 4) * 2 ns + 1 ns;
+      reset <= '0';
+      wait until rising_edge(clock);
+      wait for 1 ns;
+      assert rst_out = '1'
+        report "reset released on the first edge" severity error;
+      wait until rising_edge(clock);
+      wait for 1 ns;
+      assert rst_out = '0'
+        report "reset not released on the second edge" severity error;
+
+      wait for clk_period * (3 + i);
+      assert rst_out = '0'
+        report "reset asserted while released" severity error;
+    end loop;
+
+    report "Testbench completed." severity note;
+    sim_done <= true;
+    wait;
+  end process stimulus;
+
 end Behavioral;
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""
+audio_metrics.py
+
+Spectral quality metrics for sample dumps written by the GHDL testbenches.
+
+Each input file holds one signed integer sample per line. Captures are
+expected to be coherent (an integer number of cycles in a power-of-two
+record), so no window is applied and the fundamental falls in a single bin.
+
+Usage:
+  audio_metrics.py [--full-scale N] [--harmonics N] [--min-sfdr dB] FILE...
+
+Reported per file:
+  fund   fundamental level relative to full scale (dBFS)
+  THD    total harmonic distortion over the first N harmonics (dBc)
+  SFDR   spur-free dynamic range, fundamental to largest other bin (dBc)
+  SINAD  signal to noise-and-distortion ratio (dB)
+  ENOB   effective number of bits derived from SINAD
+
+Only the Python standard library is used so the script runs on a bare host.
+"""
+
+import argparse
+import cmath
+import math
+import sys
+
+
+def load_samples(path):
+    samples = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line:
+                samples.append(int(line))
+    return samples
+
+
+def fft(x):
+    """In-place iterative radix-2 FFT of a list of complex values."""
+    n = len(x)
+    if n & (n - 1):
+        raise ValueError("record length %d is not a power of two" % n)
+
+    # bit reversal permutation
+    j = 0
+    for i in range(1, n):
+        bit = n >> 1
+        while j & bit:
+            j ^= bit
+            bit >>= 1
+        j |= bit
+        if i < j:
+            x[i], x[j] = x[j], x[i]
+
+    size = 2
+    while size <= n:
+        half = size // 2
+        w_step = cmath.exp(-2j * math.pi / size)
+        for start in range(0, n, size):
+            w = 1.0
+            for k in range(start, start + half):
+                t = w * x[k + half]
+                x[k + half] = x[k] - t
+                x[k] = x[k] + t
+                w *= w_step
+        size *= 2
+    return x
+
+
+def power_spectrum(samples):
+    """One-sided power spectrum, bins 0 .. N/2."""
+    n = len(samples)
+    spec = fft([complex(s) for s in samples])
+    return [abs(spec[k]) ** 2 for k in range(n // 2 + 1)]
+
+
+def alias_bin(k, n):
+    """Fold an arbitrary bin index back into 0 .. N/2."""
+    k %= n
+    return n - k if k > n // 2 else k
+
+
+def db(ratio):
+    return 10.0 * math.log10(ratio) if ratio > 0 else float("-inf")
+
+
+def analyze(samples, full_scale, harmonics):
+    n = len(samples)
+    pwr = power_spectrum(samples)
+
+    fund = max(range(1, len(pwr)), key=lambda k: pwr[k])
+    p_fund = pwr[fund]
+
+    harm_bins = set()
+    for h in range(2, harmonics + 1):
+        b = alias_bin(h * fund, n)
+        if b not in (0, fund):
+            harm_bins.add(b)
+    p_harm = sum(pwr[b] for b in harm_bins)
+
+    spurs = [pwr[k] for k in range(1, len(pwr)) if k != fund]
+    p_spur = max(spurs) if spurs else 0.0
+    p_noise = sum(spurs)
+
+    # full-scale sine of amplitude A lands (A*N/2)^2 in its bin
+    p_fs = (full_scale * n / 2.0) ** 2
+    sinad = db(p_fund / p_noise) if p_noise else float("inf")
+
+    return {
+        "bin":   fund,
+        "fund":  db(p_fund / p_fs),
+        "thd":   db(p_harm / p_fund) if p_harm else float("-inf"),
+        "sfdr":  db(p_fund / p_spur) if p_spur else float("inf"),
+        "sinad": sinad,
+        "enob":  (sinad - 1.76) / 6.02,
+    }
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("files", nargs="+")
+    parser.add_argument("--full-scale", type=float, default=32767.0,
+                        help="peak amplitude of a full-scale sine (default 32767)")
+    parser.add_argument("--harmonics", type=int, default=10,
+                        help="number of harmonics included in THD (default 10)")
+    parser.add_argument("--min-sfdr", type=float, default=None,
+                        help="fail if any file's SFDR is below this (dBc)")
+    args = parser.parse_args(argv)
+
+    failed = False
+    print("%-32s %6s %9s %9s %9s %9s %6s" %
+          ("file", "bin", "fund dBFS", "THD dBc", "SFDR dBc", "SINAD dB", "ENOB"))
+    for path in args.files:
+        m = analyze(load_samples(path), args.full_scale, args.harmonics)
+        print("%-32s %6d %9.2f %9.2f %9.2f %9.2f %6.2f" %
+              (path, m["bin"], m["fund"], m["thd"], m["sfdr"], m["sinad"], m["enob"]))
+        if args.min_sfdr is not None and m["sfdr"] < args.min_sfdr:
+            print("FAIL: %s SFDR %.2f dBc below %.2f dBc" % (path, m["sfdr"], args.min_sfdr))
+            failed = True
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,119 @@
+#!/bin/sh
+#
+# run_regression.sh
+#
+# Compiles the engine packages and modules into xil_defaultlib with GHDL,
+# runs every self-checking testbench in sim/, then checks the sine lookup
+# and the waveform quality captures against their limits and the tracked
+# baseline in sim/wave_quality_baseline.txt. A missing baseline is a
+# failure. -u records the baseline from this run's captures instead, with
+# the GHDL version in its header, to be reviewed and checked in. The
+# pipeline trace captures are turned into VCDs with tools/trace_vcd.py.
+#
+# A testbench passes when it reports "Testbench completed." before the stop
+# time with no error or failure assertions. Logs, sample dumps and the
+# wave_quality.txt results are left in the work dir.
+#
+# Usage: run_regression.sh [-u] [work dir]
+#
+
+set -e
+
+UPDATE=0
+if [ "$1" = "-u" ]; then
+  UPDATE=1
+  shift
+fi
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+HDL_DIR=$(cd "$SCRIPT_DIR/../.." && pwd)
+WORK_DIR=${1:-"$HDL_DIR/sim/work"}
+
+GHDL=${GHDL:-ghdl}
+GHDL_FLAGS="--std=08 --workdir=$WORK_DIR --work=xil_defaultlib"
+# numeric_std warns on every truncating conversion in the waveform logic
+RUN_FLAGS="--assert-level=failure --ieee-asserts=disable --stop-time=20ms"
+
+# packages first, the rest bind at elaboration
+MODULES="
+  synth_engine/synth_pkg.vhd
+  synth_engine/music_note_pkg.vhd
+  synth_engine/scaler.vhd
+  synth_engine/scaler_unsigned.vhd
+  synth_engine/sine_lut_interp.vhd
+  synth_engine/sine_lut_full.vhd
+  synth_engine/phase_to_wave.vhd
+  synth_engine/phase_accumulator.vhd
+  synth_engine/envelope_scale.vhd
+  synth_engine/poly_mix.vhd
+  synth_engine/param_slew.vhd
+  synth_engine/lfo_bank.vhd
+  synth_engine/mod_matrix.vhd
+  synth_engine/pipeline_trace.vhd
+  synth_engine/amp_gate.vhd
+  synth_engine/synth_note_mixer.vhd
+  synth_engine/synth_axi_ctrl.vhd
+  synth_engine/synth_engine.vhd
+  util/rst_sync.vhd
+  util/clkdivider.vhd
+  codec_i2s/codec_i2s.vhd
+"
+
+TESTBENCHES="
+  rst_sync_tb
+  clkdivider_tb
+  codec_i2s_tb
+  phase_accumulator_tb
+  tuning_bank_tb
+  phase_to_wave_tb
+  envelope_pedal_tb
+  sine_lut_interp_tb
+  wave_quality_tb
+  synth_engine_tb
+  pipeline_trace_tb
+"
+
+mkdir -p "$WORK_DIR"
+cd "$WORK_DIR"
+
+for f in $MODULES; do
+  $GHDL -a $GHDL_FLAGS "$HDL_DIR/modules/$f"
+done
+
+failed=0
+for tb in $TESTBENCHES; do
+  log="$tb.log"
+  if $GHDL -a $GHDL_FLAGS "$HDL_DIR/sim/$tb.vhd" > "$log" 2>&1 &&
+     $GHDL -e $GHDL_FLAGS "$tb" >> "$log" 2>&1 &&
+     $GHDL -r $GHDL_FLAGS "$tb" $RUN_FLAGS >> "$log" 2>&1 &&
+     grep -q "Testbench completed\." "$log" &&
+     ! grep -Eq "\((assertion|report) (error|failure)\)" "$log"; then
+    echo "PASS  $tb"
+  else
+    echo "FAIL  $tb, see $WORK_DIR/$log"
+    failed=$((failed + 1))
+  fi
+done
+
+echo
+python3 "$SCRIPT_DIR/audio_metrics.py" --min-sfdr 100 sine_lut_interp.txt || failed=$((failed + 1))
+echo
+BASELINE="$HDL_DIR/sim/wave_quality_baseline.txt"
+if [ $UPDATE -eq 1 ]; then
+  python3 "$SCRIPT_DIR/wave_metrics.py" --update --tool "$($GHDL --version | head -n 1)" \
+    --results wave_quality.txt wave_*.txt || failed=$((failed + 1))
+  echo "recorded $BASELINE, review and check it in"
+else
+  python3 "$SCRIPT_DIR/wave_metrics.py" --results wave_quality.txt wave_*.txt || failed=$((failed + 1))
+fi
+echo
+for f in trace_slot.txt trace_frame.txt; do
+  python3 "$HDL_DIR/../tools/trace_vcd.py" "$f" || failed=$((failed + 1))
+done
+
+echo
+if [ $failed -ne 0 ]; then
+  echo "$failed failed"
+  exit 1
+fi
+echo "all passed"
@@ -0,0 +1,29 @@
+#!/bin/sh
+#
+# run_sine_quality.sh
+#
+# Simulates sine_lut_interp_tb with GHDL and reports THD/SFDR for the
+# existing 1024 entry sine table and the interpolated table.
+#
+# Usage: run_sine_quality.sh [work dir]
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+HDL_DIR=$(cd "$SCRIPT_DIR/../.." && pwd)
+WORK_DIR=${1:-"$HDL_DIR/sim/work"}
+
+GHDL=${GHDL:-ghdl}
+GHDL_FLAGS="--std=08 --workdir=$WORK_DIR"
+
+mkdir -p "$WORK_DIR"
+cd "$WORK_DIR"
+
+$GHDL -a $GHDL_FLAGS "$HDL_DIR/modules/synth_engine/sine_lut_interp.vhd"
+$GHDL -a $GHDL_FLAGS "$HDL_DIR/sim/sine_lut_interp_tb.vhd"
+$GHDL -e $GHDL_FLAGS sine_lut_interp_tb
+$GHDL -r $GHDL_FLAGS sine_lut_interp_tb --assert-level=failure
+
+python3 "$SCRIPT_DIR/audio_metrics.py" sine_lut_full.txt
+python3 "$SCRIPT_DIR/audio_metrics.py" --min-sfdr 100 sine_lut_interp.txt
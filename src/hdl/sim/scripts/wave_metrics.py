@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""
+wave_metrics.py
+
+Waveform quality numbers for the wave_quality_tb captures, checked against a
+tracked baseline so DSP regressions and improvements both show up.
+
+Each capture is wave_<waveform>_<note>.txt, one signed sample per line, a
+coherent record with a prime number of cycles (see audio_metrics.py). The
+fundamental bin is the largest, its multiples below Nyquist are the
+waveform's own harmonics, and the multiples above Nyquist fold back to bins
+of their own.
+
+Usage:
+  wave_metrics.py [--baseline FILE] [--update [--tool NAME]] [--tolerance dB]
+                  [--results FILE] CAPTURE...
+
+Reported per capture:
+  SNR    fundamental and in-band harmonics against every other bin (dB)
+  THD    in-band harmonics against the fundamental (dBc)
+  alias  harmonics folded back from ALIAS_ZONES Nyquist zones, against the
+         fundamental and in-band harmonics (dBc)
+
+A capture fails when its SNR drops or its alias energy rises by more than
+the tolerance, and for the sine when its THD rises. THD is the shape of the
+other waveforms, so a change there is only reported. --update rewrites the
+baseline from the captures given, naming the simulator that made them when
+--tool is given. With no baseline every capture fails, the baseline has to
+be recorded from simulator captures of the RTL first.
+
+Only the Python standard library is used so the script runs on a bare host.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from audio_metrics import alias_bin, db, load_samples, power_spectrum
+
+# Nyquist zones of harmonics counted as alias energy
+ALIAS_ZONES = 4
+
+# metrics are floored here so a perfect record still compares as a number
+FLOOR_DB = -200.0
+
+CAPTURE_RE = re.compile(r"wave_([a-z]+)_([a-z0-9]+)\.txt$")
+
+HEADER = """\
+# Waveform quality baseline, written by wave_metrics.py --update
+"""
+
+COLUMNS = """\
+# wave   note       SNR dB    THD dBc  alias dBc
+"""
+
+
+def clamp(value):
+    return max(value, FLOOR_DB)
+
+
+def analyze(samples):
+    n = len(samples)
+    half = n // 2
+    pwr = power_spectrum(samples)
+
+    fund = max(range(1, len(pwr)), key=lambda k: pwr[k])
+
+    harm_bins = set(range(fund, half + 1, fund))
+    p_fund = pwr[fund]
+    p_harm = sum(pwr[b] for b in harm_bins) - p_fund
+    p_signal = p_fund + p_harm
+
+    alias_bins = set()
+    for h in range(half // fund + 1, ALIAS_ZONES * half // fund + 1):
+        b = alias_bin(h * fund, n)
+        if b != 0 and b not in harm_bins:
+            alias_bins.add(b)
+    p_alias = sum(pwr[b] for b in alias_bins)
+
+    p_rest = sum(pwr[k] for k in range(1, half + 1) if k not in harm_bins)
+
+    return {
+        "bin":   fund,
+        "snr":   -clamp(db(p_rest / p_signal)) if p_rest else -FLOOR_DB,
+        "thd":   clamp(db(p_harm / p_fund)) if p_harm else FLOOR_DB,
+        "alias": clamp(db(p_alias / p_signal)) if p_alias else FLOOR_DB,
+    }
+
+
+def load_table(path):
+    table = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            wave, note, snr, thd, alias = line.split()
+            table[(wave, note)] = {"snr": float(snr), "thd": float(thd), "alias": float(alias)}
+    return table
+
+
+def write_table(path, table, tool=None):
+    with open(path, "w") as f:
+        f.write(HEADER)
+        if tool:
+            f.write("# from captures made with %s\n" % tool)
+        f.write(COLUMNS)
+        for (wave, note), m in sorted(table.items()):
+            f.write("%-6s %-5s %10.2f %10.2f %10.2f\n" % (wave, note, m["snr"], m["thd"], m["alias"]))
+
+
+def compare(key, now, base, tolerance):
+    """Returns (failures, notes) for one capture against its baseline."""
+    name = "%s %s" % key
+    fails, notes = [], []
+
+    def worse(label, change):
+        if change > tolerance:
+            fails.append("%s %s worse by %.2f dB" % (name, label, change))
+        elif change < -tolerance:
+            notes.append("%s %s better by %.2f dB" % (name, label, -change))
+
+    worse("SNR", base["snr"] - now["snr"])
+    worse("alias", now["alias"] - base["alias"])
+    if key[0] == "sine":
+        worse("THD", now["thd"] - base["thd"])
+    elif abs(now["thd"] - base["thd"]) > tolerance:
+        notes.append("%s THD changed by %+.2f dB" % (name, now["thd"] - base["thd"]))
+    return fails, notes
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("captures", nargs="+")
+    parser.add_argument("--baseline", default=os.path.join(
+                        os.path.dirname(os.path.abspath(__file__)), "..", "wave_quality_baseline.txt"),
+                        help="tracked baseline (default sim/wave_quality_baseline.txt)")
+    parser.add_argument("--update", action="store_true",
+                        help="write the results as the new baseline")
+    parser.add_argument("--tool", default=None,
+                        help="simulator and version that made the captures, for the baseline header")
+    parser.add_argument("--tolerance", type=float, default=0.5,
+                        help="change in dB treated as a regression or improvement (default 0.5)")
+    parser.add_argument("--results", default=None,
+                        help="also write the results table here")
+    args = parser.parse_args(argv)
+
+    results = {}
+    print("%-6s %-5s %5s %9s %9s %9s" % ("wave", "note", "bin", "SNR dB", "THD dBc", "alias dBc"))
+    for path in args.captures:
+        match = CAPTURE_RE.search(os.path.basename(path))
+        if not match:
+            print("skipping %s, not a wave_<waveform>_<note>.txt capture" % path)
+            continue
+        key = (match.group(1), match.group(2))
+        m = analyze(load_samples(path))
+        results[key] = m
+        print("%-6s %-5s %5d %9.2f %9.2f %9.2f" % (key[0], key[1], m["bin"], m["snr"], m["thd"], m["alias"]))
+
+    if args.results:
+        write_table(args.results, results)
+
+    if args.update:
+        write_table(args.baseline, results, args.tool)
+        print("baseline %s updated" % args.baseline)
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print("FAIL: no baseline %s, record one with run_regression.sh -u or --update from these captures" % args.baseline)
+        return 1
+    base = load_table(args.baseline)
+    fails, notes = [], []
+    for key in sorted(base):
+        if key not in results:
+            fails.append("%s %s missing from the captures" % key)
+            continue
+        f, n = compare(key, results[key], base[key], args.tolerance)
+        fails += f
+        notes += n
+    for key in sorted(set(results) - set(base)):
+        notes.append("%s %s not in the baseline" % key)
+
+    for line in notes:
+        print("note: " + line)
+    for line in fails:
+        print("FAIL: " + line)
+    if notes and not fails:
+        print("changes beyond %.2f dB, rerun with --update once they are intended" % args.tolerance)
+    return 1 if fails else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
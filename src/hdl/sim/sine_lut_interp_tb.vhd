@@ -0,0 +1,136 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Sine Wave Interpolated Lookup Table Testbench
+-- Description:
+--   Sweeps one coherent sine cycle set through the 1024 entry quarter wave
+--   table used by sine_lut_full and through sine_lut_interp, and writes both
+--   outputs to text files for spectral analysis:
+--
+--     sine_lut_full.txt    - 12-bit phase into the sine_lut.coe table
+--     sine_lut_interp.txt  - 16-bit phase into a 10-bit interpolated table
+--
+--   The sine_quarter_wave_lut core is a Vivado IP, so the reference path
+--   models it with the formula that generated src/init/sine_lut.coe.
+--
+--   Run with scripts/run_sine_quality.sh to print THD/SFDR for both.
+--
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+  use ieee.math_real.all;
+
+library std;
+  use std.textio.all;
+
+entity sine_lut_interp_tb is
+end sine_lut_interp_tb;
+
+architecture tb of sine_lut_interp_tb is
+
+  -- DUT Component
+  component sine_lut_interp is
+    generic (
+      PHASE_WIDTH : natural := 16;
+      TABLE_PH    : natural := 10;
+      SINE_WIDTH  : natural := 16
+    );
+    port (
+      clk      : in  std_logic;
+      phase    : in  std_logic_vector(PHASE_WIDTH-1 downto 0);
+      sine_out : out signed(SINE_WIDTH-1 downto 0)
+    );
+  end component sine_lut_interp;
+
+  constant PHASE_WIDTH : natural := 16;
+  constant SINE_WIDTH  : natural := 16;
+  constant REF_PH      : natural := 12;
+  constant INTERP_PH   : natural := 10;
+
+  -- coherent capture: prime cycle count over every 16-bit phase value
+  constant NUM_SAMPLES : natural := 2**PHASE_WIDTH;
+  constant NUM_CYCLES  : natural := 1013;
+
+  -- allowed deviation from an ideal sine, in LSBs
+  constant MAX_ERROR   : real := 2.0;
+
+  -- sine_lut.coe entry i: round(32767 * sin(pi/2 * i/1023))
+  function coe_sample(i : natural) return integer is
+  begin
+    return integer(round(32767.0 * sin(MATH_PI_OVER_2 * real(i) / 1023.0)));
+  end function;
+
+  -- behavioral model of sine_lut_full with the sine_quarter_wave_lut core
+  function sine_lut_full_model(ph : unsigned(REF_PH-1 downto 0)) return integer is
+    variable addr : unsigned(REF_PH-3 downto 0);
+  begin
+    addr := ph(REF_PH-3 downto 0);
+    if ph(REF_PH-2) = '1' then
+      addr := not addr;
+    end if;
+    if ph(REF_PH-1) = '1' then
+      return coe_sample(to_integer(addr));
+    else
+      return -coe_sample(to_integer(addr));
+    end if;
+  end function;
+
+  signal clk          : std_logic := '0';
+  signal phase        : unsigned(PHASE_WIDTH-1 downto 0) := (others => '0');
+  signal sine_interp  : signed(SINE_WIDTH-1 downto 0);
+
+begin
+
+  -- Instantiate the DUT
+  uut: sine_lut_interp
+    generic map (
+      PHASE_WIDTH => PHASE_WIDTH,
+      TABLE_PH    => INTERP_PH,
+      SINE_WIDTH  => SINE_WIDTH
+    )
+    port map (
+      clk      => clk,
+      phase    => std_logic_vector(phase),
+      sine_out => sine_interp
+    );
+
+  -- Stimulus Process
+  stimulus : process
+    file     f_full   : text open write_mode is "sine_lut_full.txt";
+    file     f_interp : text open write_mode is "sine_lut_interp.txt";
+    variable l        : line;
+    variable ideal    : real;
+    variable err      : real;
+    variable max_err  : real := 0.0;
+  begin
+    for i in 0 to NUM_SAMPLES-1 loop
+      phase <= to_unsigned((i * NUM_CYCLES) mod NUM_SAMPLES, PHASE_WIDTH);
+      wait for 1 ns;
+
+      write(l, sine_lut_full_model(phase(PHASE_WIDTH-1 downto PHASE_WIDTH-REF_PH)));
+      writeline(f_full, l);
+      write(l, to_integer(sine_interp));
+      writeline(f_interp, l);
+
+      -- the table polarity is inverted, negative from 0 to pi
+      ideal := -32767.0 * sin(MATH_2_PI * real(to_integer(phase)) / real(NUM_SAMPLES));
+      err   := abs(real(to_integer(sine_interp)) - ideal);
+      if err > max_err then
+        max_err := err;
+      end if;
+    end loop;
+
+    report "sine_lut_interp max error: " & real'image(max_err) & " LSB" severity note;
+    assert max_err <= MAX_ERROR
+      report "sine_lut_interp error exceeds " & real'image(MAX_ERROR) & " LSB" severity failure;
+
+    report "Testbench completed." severity note;
+    wait;
+  end process stimulus;
+
+end tb;
@@ -7,6 +7,13 @@
 -- Module Name: Synthesizer Engine Testbench
 -- Description: 
 --   Testbench for the Synthesizer Engine simulation.
+--   Sets up a sine patch over AXI, plays notes on two timbres and checks the
+--   register readbacks, the info registers, the tuning table, the active note
+--   bitmap and that both channels make sound. One line per engine frame of
+--   left and right output goes to synth_engine_audio.txt.
+--
+-- Revision:
+-- 10/19/2026 agt - self-checking readbacks and audio, ends on its own
 -- 
 ----------------------------------------------------------------------------------
 
@@ -14,6 +21,9 @@ library ieee;
   use ieee.std_logic_1164.all;
   use ieee.numeric_std.all;
 
+library std;
+  use std.textio.all;
+
 library xil_defaultlib;
   use xil_defaultlib.synth_pkg.all;
   use xil_defaultlib.music_note_pkg.all;
@@ -53,6 +63,14 @@ architecture tb of synth_engine_tb is
   signal rvalid   : std_logic;
   signal rready   : std_logic;
 
+  -- Digital audio output
+  signal audio_l  : std_logic_vector(WIDTH_WAVE_DATA+8-1 downto 0);
+  signal audio_r  : std_logic_vector(WIDTH_WAVE_DATA+8-1 downto 0);
+  signal heard_l  : boolean := false;
+  signal heard_r  : boolean := false;
+
+  signal sim_done : boolean := false;
+
   -- Clock process
   constant clk_period  : time := 40 ns;
   constant clk_period2 : time := 80 ns;
@@ -96,7 +114,8 @@ architecture tb of synth_engine_tb is
       s_axi_rready   : in  std_logic;
 
       -- Digital audio output
-      audio_out     : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
+      audio_out_l   : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0);
+      audio_out_r   : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
     );
   end component synth_engine;
     
@@ -140,18 +159,44 @@ begin
       s_axi_rready  => rready,
 
       -- Digital audio output
-      audio_out     => open
+      audio_out_l   => audio_l,
+      audio_out_r   => audio_r
     );
   
   -- Clock Process
   clk_process : process
   begin
-      while true loop
+      while not sim_done loop
           clk <= '0';
           wait for clk_period / 2;
           clk <= '1';
           wait for clk_period / 2;
       end loop;
+      wait;
+  end process;
+
+  -- Audio capture, one sample per frame
+  monitor : process
+    file     f_audio : text open write_mode is "synth_engine_audio.txt";
+    variable l       : line;
+  begin
+    wait until rst = '0';
+    while not sim_done loop
+      for i in 1 to NUM_NOTES loop
+        wait until rising_edge(clk);
+      end loop;
+      write(l, to_integer(signed(audio_l)));
+      write(l, ' ');
+      write(l, to_integer(signed(audio_r)));
+      writeline(f_audio, l);
+      if signed(audio_l) /= 0 then
+        heard_l <= true;
+      end if;
+      if signed(audio_r) /= 0 then
+        heard_r <= true;
+      end if;
+    end loop;
+    wait;
   end process;
   
   -- Stimulus Process
@@ -182,19 +227,41 @@ begin
     end procedure;
     
     procedure axi_read(
-      address : in std_logic_vector(AXI_ADDR_WIDTH-1 downto 0)
+      address : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+      data    : out std_logic_vector(AXI_DATA_WIDTH-1 downto 0)
     ) is begin
       araddr  <= address;
       arvalid <= '1';
       rready  <= '1';
       
-      wait until rising_edge(clk);
+      loop
+        wait until rising_edge(clk);
+        exit when arready = '1';
+      end loop;
       arvalid <= '0';
       
-      wait until rising_edge(clk);
+      loop
+        wait until rising_edge(clk);
+        exit when rvalid = '1';
+      end loop;
+      data    := rdata;
       rready  <= '0';
     
     end procedure;
+
+    -- read and compare the bits set in the mask
+    procedure check_read(
+      address  : in std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+      expected : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+      mask     : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0) := x"FFFFFFFF"
+    ) is
+      variable data : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    begin
+      axi_read(address, data);
+      assert (data and mask) = (expected and mask)
+        report "read x" & to_hstring(address) & " = x" & to_hstring(data) &
+               ", expected x" & to_hstring(expected and mask) severity error;
+    end procedure;
     
   begin
     -- Reset
@@ -217,14 +284,21 @@ begin
     -- Write to register 0
     axi_write("000" & x"0000000", x"00000018");
     -- Read from register 0
-    axi_read("000" & x"0000000");
+    check_read("000" & x"0000000", x"00000018");
     -- Write to note 69 (A4) reg
     axi_write("000" & x"0000114", x"0000007F");
     -- Write to note 127 reg
     axi_write("000" & x"00001FC", x"0000007F");
+    -- Write notes 64 and 66 in one packed write
+    axi_write("000" & x"0000340", x"007F007F");
+    -- Pan note 69 hard left and note 127 hard right
+    axi_write("000" & x"0000714", x"00000000");
+    axi_write("000" & x"00007FC", x"0000007F");
     -- Write to output amplitude register
     axi_write("000" & x"0000220", x"00000008");
     axi_write("000" & x"0000224", x"0000003F");
+    -- Smooth waveform amps, output amp and pulse width over ~256 frames
+    axi_write("000" & x"00002A0", x"00080808");
     -- Write to pulse reg
     axi_write("000" & x"0000200", x"00004000");
     axi_write("000" & x"0000204", x"00000000");
@@ -239,15 +313,15 @@ begin
     -- Write to wrapback reg
     axi_write("000" & x"00003FC", x"ABCD1234");
     -- Read from wrapback reg
-    axi_read("000" & x"00003FC");
+    check_read("000" & x"00003FC", x"ABCD1234");
     -- Read from rev reg
-    axi_read("000" & x"00003E0");
+    check_read("000" & x"00003E0", SYNTH_ENG_REV);
     -- Read from date reg
-    axi_read("000" & x"00003E4");
+    check_read("000" & x"00003E4", SYNTH_ENG_DATE);
     -- Read from phase increment table note 117
-    axi_read("000" & x"00005D4");
+    check_read("000" & x"00005D4", std_logic_vector(ph_inc_lut(117)));
     -- Read from phase increment table note 119
-    axi_read("000" & x"00005DC");
+    check_read("000" & x"00005DC", std_logic_vector(ph_inc_lut(119)));
     -- Write to attack regs
     axi_write("000" & x"0000280", x"00002000");
     -- Write to decay regs
@@ -256,14 +330,57 @@ begin
     axi_write("000" & x"0000288", x"00080000");
     -- Write to release regs
     axi_write("000" & x"000028C", x"00002000");
+    -- Play note 127 on timbre 1, a quieter sine with the same envelope
+    axi_write("000" & x"00009FC", x"00000001");
+    axi_write("000" & x"0000A54", x"0000007F");
+    axi_write("000" & x"0000A58", x"00000040");
+    axi_write("000" & x"0000A60", x"00002000");
+    axi_write("000" & x"0000A64", x"00002000");
+    axi_write("000" & x"0000A68", x"00080000");
+    axi_write("000" & x"0000A6C", x"00002000");
+    check_read("000" & x"0000A54", x"0000007F");
+    -- Vibrato on timbre 1 from lfo 0, a sine at about 22 Hz
+    axi_write("000" & x"00002C0", x"00000400");
+    axi_write("000" & x"0000A5C", x"00000000");
+    axi_write("000" & x"0000A70", x"00000040");
+    check_read("000" & x"00002C0", x"00000400");
+    check_read("000" & x"0000A70", x"00000040");
+    -- Glide note 127 up from note 117 at rate 4 on timbre 1
+    axi_write("000" & x"00002A4", x"00000040");
+    axi_write("000" & x"00002A8", x"0000F57F");
+    -- the start bit clears once the frame takes it
+    check_read("000" & x"00002A8", x"0000757F", x"00007FFF");
+    -- Half pressure on note 127, timbre 1 level follows pressure at depth 64
+    axi_write("000" & x"00002E4", x"00004000");
+    axi_write("000" & x"0000DFC", x"00000040");
+    check_read("000" & x"00002E4", x"00004000");
+    check_read("000" & x"0000DFC", x"00000040");
+    -- Sustain pedal down on timbre 1
+    axi_write("000" & x"0000398", x"00000002");
+    check_read("000" & x"0000398", x"00000002");
 
     wait for 6e6 ns;
     wait until rising_edge(clk);
+    -- Notes 64, 66, 69 and 127 sounding, 69 on the left and 127 on the right
+    check_read("000" & x"00003A8", x"00000025", x"00000025");
+    check_read("000" & x"00003AC", x"80000000", x"80000000");
+    assert heard_l report "no audio on the left channel" severity error;
+    assert heard_r report "no audio on the right channel" severity error;
     -- Write to note 127 reg
     axi_write("000" & x"00001FC", x"00000000");
+    wait for 1e6 ns;
+    -- Sustain pedal up, note 127 releases
+    axi_write("000" & x"0000398", x"00000000");
+    wait for 1e6 ns;
+    -- Release all notes
+    axi_write("000" & x"0000394", x"00000002");
+    check_read("000" & x"0000394", x"00000000");
+    check_read("000" & x"0000114", x"00000000");
+    check_read("000" & x"0000100", x"00000000");
     -- End Simulation
     wait for clk_period2;
     report "Testbench completed." severity note;
+    sim_done <= true;
   wait;
 end process;
 
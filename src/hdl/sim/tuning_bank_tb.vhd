@@ -0,0 +1,476 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Tuning Bank Testbench
+-- Description:
+--   Testbench for the banked tuning table in the Synthesizer AXI controller.
+--   Steps slot_index the way the phase accumulator does, with the frame
+--   tick on the last slot as synth_engine drives it, and checks every pass
+--   of slots 0 to 127 reads one table, the old or the new, never a mix.
+--   Retunes the whole table as the firmware does, held and written from
+--   partway through a frame, released partway through a later one, then
+--   retunes two notes unheld within one frame. Each retune goes live on the
+--   pass after it completes and reads back over AXI as written.
+--
+-- Revision:
+--
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+
+library xil_defaultlib;
+  use xil_defaultlib.synth_pkg.all;
+  use xil_defaultlib.music_note_pkg.all;
+
+entity tuning_bank_tb is
+end tuning_bank_tb;
+
+architecture tb of tuning_bank_tb is
+
+  constant AXI_DATA_WIDTH : integer := 32;
+  constant AXI_ADDR_WIDTH : integer := 31;
+
+  signal clk      : std_logic := '0';
+  signal rst      : std_logic := '1';
+  signal rst_n    : std_logic := '0';
+
+  signal awaddr   : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+  signal awvalid  : std_logic;
+  signal awready  : std_logic;
+
+  signal wdata    : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+  signal wstrb    : std_logic_vector(3 downto 0);
+  signal wvalid   : std_logic;
+  signal wready   : std_logic;
+
+  signal bresp    : std_logic_vector(1 downto 0);
+  signal bvalid   : std_logic;
+  signal bready   : std_logic;
+
+  signal araddr   : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+  signal arvalid  : std_logic;
+  signal arready  : std_logic;
+
+  signal rdata    : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+  signal rresp    : std_logic_vector(1 downto 0);
+  signal rvalid   : std_logic;
+  signal rready   : std_logic;
+
+  -- engine side
+  signal slot_index : integer range I_LOWEST_NOTE to I_HIGHEST_NOTE := I_LOWEST_NOTE;
+  signal frame_tick : std_logic;
+  signal ph_inc     : unsigned(WIDTH_PH_DATA-1 downto 0);
+
+  -- the tables a pass may read, and what the last whole pass read
+  constant PASS_OLD : natural := 1;
+  constant PASS_NEW : natural := 2;
+
+  signal expect_old : t_ph_inc_lut := ph_inc_lut;
+  signal expect_new : t_ph_inc_lut := ph_inc_lut;
+  signal monitor_on : boolean := false;
+  signal pass_count : natural := 0;
+  signal pass_table : natural := PASS_OLD;
+
+  signal sim_done : boolean := false;
+
+  -- Clock process
+  constant clk_period  : time := 40 ns;
+  constant clk_period2 : time := 80 ns;
+
+  -- every word up by a sixteenth, about a semitone
+  function retuned return t_ph_inc_lut is
+    variable table : t_ph_inc_lut;
+  begin
+    for i in table'range loop
+      table(i) := ph_inc_lut(i) + shift_right(ph_inc_lut(i), 4);
+    end loop;
+    return table;
+  end function;
+
+  -- DUT Component
+  component synth_axi_ctrl is
+    generic (
+      -- AXI parameters
+      C_S_AXI_DATA_WIDTH  : integer  := 32;
+      C_S_AXI_ADDR_WIDTH  : integer  := 31
+    );
+    port (
+      -- user clock domain
+      clk            : in  std_logic;
+      rst            : in  std_logic;
+      frame_tick     : in  std_logic;
+      -- synth controls out
+      note_amps      : out t_note_amp;
+      note_pans      : out t_note_pan;
+      slot_index     : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      ph_inc         : out unsigned(WIDTH_PH_DATA-1 downto 0);
+      note_timbres   : out t_note_timbre;
+      wfrm_amps      : out t_timbre_amps;
+      wfrm_phs       : out t_timbre_phs;
+      pulse_width    : out t_timbre_pw;
+      timbre_lvls    : out t_timbre_lvl;
+      attack_amt     : out t_adsr;
+      decay_amt      : out t_adsr;
+      sustain_amt    : out t_adsr;
+      release_amt    : out t_adsr;
+      out_amp        : out unsigned(WIDTH_OUT_GAIN-1 downto 0);
+      out_shift      : out unsigned(WIDTH_OUT_SHIFT-1 downto 0);
+      wfrm_slew_rate : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+      out_slew_rate  : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+      pw_slew_rate   : out unsigned(WIDTH_SLEW_RATE-1 downto 0);
+      lfo_rates      : out t_lfo_rate;
+      lfo_shapes     : out t_lfo_shape;
+      mod_sels       : out t_timbre_sel;
+      mod_depths     : out t_timbre_dep;
+      glide_rates    : out t_glide_rate;
+      glide_start    : out std_logic;
+      glide_from     : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      note_press     : out t_note_press;
+      timbre_press   : out t_timbre_press;
+      press_depths   : out t_timbre_press;
+      sustain_pedals : out t_timbre_bits;
+      sostenuto_pedals : out t_timbre_bits;
+      -- note status in
+      active_notes   : in  t_note_bits;
+      -- pipeline trace
+      trace_ctrl     : out std_logic_vector(31 downto 0);
+      trace_arm      : out std_logic;
+      trace_status   : in  std_logic_vector(31 downto 0);
+      trace_rd_en    : out std_logic;
+      trace_rd_addr  : out unsigned(TRACE_DEPTH_BITS-1 downto 0);
+      trace_rd_data  : in  std_logic_vector(31 downto 0);
+
+      -- AXI control interface
+      s_axi_aclk     : in  std_logic;
+      s_axi_aresetn  : in  std_logic;
+      s_axi_awaddr   : in  std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+      s_axi_awprot   : in  std_logic_vector(2 downto 0);
+      s_axi_awvalid  : in  std_logic;
+      s_axi_awready  : out std_logic;
+      s_axi_wdata    : in  std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+      s_axi_wstrb    : in  std_logic_vector(3 downto 0);
+      s_axi_wvalid   : in  std_logic;
+      s_axi_wready   : out std_logic;
+      s_axi_bresp    : out std_logic_vector(1 downto 0);
+      s_axi_bvalid   : out std_logic;
+      s_axi_bready   : in  std_logic;
+      s_axi_araddr   : in  std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+      s_axi_arprot   : in  std_logic_vector(2 downto 0);
+      s_axi_arvalid  : in  std_logic;
+      s_axi_arready  : out std_logic;
+      s_axi_rdata    : out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+      s_axi_rresp    : out std_logic_vector(1 downto 0);
+      s_axi_rvalid   : out std_logic;
+      s_axi_rready   : in  std_logic
+    );
+  end component synth_axi_ctrl;
+
+begin
+
+  rst_n <= not(rst);
+
+  -- Instantiate the DUT
+  u_synth_axi_ctrl: synth_axi_ctrl
+    generic map (
+      C_S_AXI_DATA_WIDTH => AXI_DATA_WIDTH,
+      C_S_AXI_ADDR_WIDTH => AXI_ADDR_WIDTH
+    )
+    port map (
+      clk              => clk,
+      rst              => rst,
+      frame_tick       => frame_tick,
+      note_amps        => open,
+      note_pans        => open,
+      slot_index       => slot_index,
+      ph_inc           => ph_inc,
+      note_timbres     => open,
+      wfrm_amps        => open,
+      wfrm_phs         => open,
+      pulse_width      => open,
+      timbre_lvls      => open,
+      attack_amt       => open,
+      decay_amt        => open,
+      sustain_amt      => open,
+      release_amt      => open,
+      out_amp          => open,
+      out_shift        => open,
+      wfrm_slew_rate   => open,
+      out_slew_rate    => open,
+      pw_slew_rate     => open,
+      lfo_rates        => open,
+      lfo_shapes       => open,
+      mod_sels         => open,
+      mod_depths       => open,
+      glide_rates      => open,
+      glide_start      => open,
+      glide_from       => open,
+      note_press       => open,
+      timbre_press     => open,
+      press_depths     => open,
+      sustain_pedals   => open,
+      sostenuto_pedals => open,
+      active_notes     => (others => '0'),
+      trace_ctrl       => open,
+      trace_arm        => open,
+      trace_status     => (others => '0'),
+      trace_rd_en      => open,
+      trace_rd_addr    => open,
+      trace_rd_data    => (others => '0'),
+
+      s_axi_aclk    => clk,
+      s_axi_aresetn => rst_n,
+      s_axi_awaddr  => awaddr,
+      s_axi_awprot  => "000",
+      s_axi_awvalid => awvalid,
+      s_axi_awready => awready,
+      s_axi_wdata   => wdata,
+      s_axi_wstrb   => wstrb,
+      s_axi_wvalid  => wvalid,
+      s_axi_wready  => wready,
+      s_axi_bresp   => bresp,
+      s_axi_bvalid  => bvalid,
+      s_axi_bready  => bready,
+      s_axi_araddr  => araddr,
+      s_axi_arprot  => "000",
+      s_axi_arvalid => arvalid,
+      s_axi_arready => arready,
+      s_axi_rdata   => rdata,
+      s_axi_rresp   => rresp,
+      s_axi_rvalid  => rvalid,
+      s_axi_rready  => rready
+    );
+
+  -- Clock Process
+  clk_process : process
+  begin
+      while not sim_done loop
+          clk <= '0';
+          wait for clk_period / 2;
+          clk <= '1';
+          wait for clk_period / 2;
+      end loop;
+      wait;
+  end process;
+
+  -- slot counter of the phase accumulator, the tick on its last slot
+  slot_process : process(clk)
+  begin
+    if rising_edge(clk) then
+      if (rst = '1' or slot_index = I_HIGHEST_NOTE) then
+        slot_index <= I_LOWEST_NOTE;
+      else
+        slot_index <= slot_index + 1;
+      end if;
+    end if;
+  end process;
+
+  frame_tick <= '1' when slot_index = I_HIGHEST_NOTE else '0';
+
+  -- Sort each slot's word into the old table, the new one or both, and
+  -- check no pass from slot 0 to 127 reads from both or from neither
+  monitor : process(clk)
+    variable saw_old, saw_new, saw_none : boolean := false;
+  begin
+    if rising_edge(clk) and monitor_on then
+      if (ph_inc = expect_old(slot_index) and ph_inc = expect_new(slot_index)) then
+        null;
+      elsif (ph_inc = expect_old(slot_index)) then
+        saw_old := true;
+      elsif (ph_inc = expect_new(slot_index)) then
+        saw_new := true;
+      else
+        saw_none := true;
+        report "pass " & integer'image(pass_count) & " slot " & integer'image(slot_index) &
+               " reads x" & to_hstring(std_logic_vector(ph_inc)) severity error;
+      end if;
+
+      if (slot_index = I_HIGHEST_NOTE) then
+        assert not (saw_old and saw_new)
+          report "pass " & integer'image(pass_count) & " mixes the old and new tables" severity error;
+        if saw_new then
+          pass_table <= PASS_NEW;
+        else
+          pass_table <= PASS_OLD;
+        end if;
+        pass_count <= pass_count + 1;
+        saw_old  := false;
+        saw_new  := false;
+        saw_none := false;
+      end if;
+    end if;
+  end process;
+
+  -- Stimulus Process
+  stimulus : process
+
+    procedure axi_write(
+      address : in std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+      data : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0)
+    ) is begin
+      awaddr  <= address;
+      awvalid <= '1';
+      wdata   <= data;
+      wstrb   <= "1111";
+      wvalid  <= '1';
+      bready  <= '1';
+
+      wait until rising_edge(clk);
+      awvalid <= '0';
+      wvalid  <= '0';
+
+      wait until rising_edge(clk);
+      if bvalid = '0' then
+          wait until bvalid = '1';
+      end if;
+
+      bready  <= '0';
+
+    end procedure;
+
+    procedure axi_read(
+      address : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+      data    : out std_logic_vector(AXI_DATA_WIDTH-1 downto 0)
+    ) is begin
+      araddr  <= address;
+      arvalid <= '1';
+      rready  <= '1';
+
+      loop
+        wait until rising_edge(clk);
+        exit when arready = '1';
+      end loop;
+      arvalid <= '0';
+
+      loop
+        wait until rising_edge(clk);
+        exit when rvalid = '1';
+      end loop;
+      data    := rdata;
+      rready  <= '0';
+
+    end procedure;
+
+    procedure check_read(
+      address  : in std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+      expected : in std_logic_vector(AXI_DATA_WIDTH-1 downto 0)
+    ) is
+      variable data : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+    begin
+      axi_read(address, data);
+      assert data = expected
+        report "read x" & to_hstring(address) & " = x" & to_hstring(data) &
+               ", expected x" & to_hstring(expected) severity error;
+    end procedure;
+
+    constant NOTE_CTRL_ADDR : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0) := "000" & x"0000394";
+
+    function tuning_addr(note : natural) return std_logic_vector is
+    begin
+      return std_logic_vector(to_unsigned(16#400# + 4*note, AXI_ADDR_WIDTH));
+    end function;
+
+    -- waits out whole passes, the last one read is in pass_table
+    procedure wait_passes(n : in natural) is
+      variable target : natural;
+    begin
+      target := pass_count + n;
+      wait until pass_count = target;
+    end procedure;
+
+    -- waits for a retune to go live, at most the pass after the current one
+    procedure wait_live(what : in string) is
+      variable target : natural;
+    begin
+      target := pass_count + 2;
+      while pass_table /= PASS_NEW and pass_count < target loop
+        wait until pass_count'event;
+      end loop;
+      assert pass_table = PASS_NEW
+        report what & " not live by pass " & integer'image(pass_count) severity error;
+    end procedure;
+
+    -- moves the expected tables on, at a pass boundary
+    procedure expect(old_table, new_table : in t_ph_inc_lut) is
+    begin
+      wait until rising_edge(clk) and slot_index = I_HIGHEST_NOTE;
+      expect_old <= old_table;
+      expect_new <= new_table;
+    end procedure;
+
+    variable table_b : t_ph_inc_lut;
+    variable table_c : t_ph_inc_lut;
+
+  begin
+    -- Reset
+    rst     <= '1';
+    awaddr  <= "000" & x"0000000";
+    awvalid <= '0';
+    wdata   <= x"00000000";
+    wstrb   <= "0000";
+    wvalid  <= '0';
+    bready  <= '0';
+    araddr  <= "000" & x"0000000";
+    arvalid <= '0';
+    rready  <= '0';
+    wait for clk_period2;
+    rst     <= '0';
+    wait for clk_period2;
+
+    -- Both banks come up with the equal temperament table
+    wait until rising_edge(clk) and slot_index = I_HIGHEST_NOTE;
+    monitor_on <= true;
+    wait_passes(2);
+    assert pass_table = PASS_OLD report "reset table not read" severity error;
+
+    -- Whole table retune, held from slot 40 as rxMidiMsg batches it
+    table_b := retuned;
+    expect(ph_inc_lut, table_b);
+    wait until rising_edge(clk) and slot_index = 40;
+    axi_write(NOTE_CTRL_ADDR, x"00000001");
+    for i in I_LOWEST_NOTE to I_HIGHEST_NOTE loop
+      axi_write(tuning_addr(i), std_logic_vector(table_b(i)));
+    end loop;
+    -- written words read back from the edit bank before the swap
+    check_read(tuning_addr(0),   std_logic_vector(table_b(0)));
+    check_read(tuning_addr(127), std_logic_vector(table_b(127)));
+    -- the engine keeps the old table while held
+    wait_passes(3);
+    assert pass_table = PASS_OLD report "held retune went live" severity error;
+
+    -- Release partway through a frame
+    wait until rising_edge(clk) and slot_index = 90;
+    axi_write(NOTE_CTRL_ADDR, x"00000000");
+    wait_live("held retune");
+    wait_passes(2);
+    assert pass_table = PASS_NEW report "retune did not stay live" severity error;
+    check_read(tuning_addr(57), std_logic_vector(table_b(57)));
+
+    -- Two notes back to equal temperament, unheld, from slot 5 of one frame
+    table_c      := table_b;
+    table_c(10)  := ph_inc_lut(10);
+    table_c(100) := ph_inc_lut(100);
+    expect(table_b, table_c);
+    wait until rising_edge(clk) and slot_index = 5;
+    axi_write(tuning_addr(10),  std_logic_vector(table_c(10)));
+    axi_write(tuning_addr(100), std_logic_vector(table_c(100)));
+    wait_live("two note retune");
+    wait_passes(2);
+    assert pass_table = PASS_NEW report "two note retune did not stay live" severity error;
+    check_read(tuning_addr(10),  std_logic_vector(table_c(10)));
+    check_read(tuning_addr(100), std_logic_vector(table_c(100)));
+    check_read(tuning_addr(11),  std_logic_vector(table_b(11)));
+
+    -- End Simulation
+    report "checked " & integer'image(pass_count) & " passes" severity note;
+    wait for clk_period2;
+    report "Testbench completed." severity note;
+    sim_done <= true;
+  wait;
+end process;
+
+end tb;
@@ -0,0 +1,184 @@
+----------------------------------------------------------------------------------
+-- Company: beepboop
+-- Engineer: agent
+--
+-- Create Date: 10/19/2026
+-- Design Name: Synthesizer Engine
+-- Module Name: Waveform Quality Testbench
+-- Description:
+--   Plays each waveform of phase_to_wave on its own at full level, at four
+--   pitches from the bottom to the top of the keyboard, and writes one
+--   coherent capture of each to a text file for spectral analysis:
+--
+--     wave_<waveform>_<note>.txt - NUM_SAMPLES output samples, one per line
+--
+--   The phase steps by a prime number of cycles over the capture, standing in
+--   for the phase accumulator of a note at the engine frame rate, so every
+--   harmonic and every alias of one lands on its own FFT bin. The sine uses
+--   the same lookup generics as the engine.
+--
+--   Run with scripts/run_regression.sh, scripts/wave_metrics.py compares the
+--   SNR, THD and alias energy of each capture against wave_quality_baseline.txt.
+--
+----------------------------------------------------------------------------------
+
+library ieee;
+  use ieee.std_logic_1164.all;
+  use ieee.numeric_std.all;
+
+library std;
+  use std.textio.all;
+
+library xil_defaultlib;
+  use xil_defaultlib.synth_pkg.all;
+
+entity wave_quality_tb is
+end wave_quality_tb;
+
+architecture tb of wave_quality_tb is
+
+  -- DUT Component
+  component phase_to_wave is
+    generic (
+      PHASE_WIDTH     : integer := WIDTH_PH_DATA;
+      NOTE_GAIN_WIDTH : integer := WIDTH_NOTE_GAIN;
+      DATA_WIDTH      : natural := WIDTH_WAVE_DATA;
+      SIN_LUT_PH      : natural := 12;
+      SIN_INTERP_PH   : natural := 0
+    );
+    port (
+      clk             : in  std_logic;
+      rst             : in  std_logic;
+      -- synth controls
+      wfrm_amps       : in  t_timbre_amps;
+      wfrm_phs        : in  t_timbre_phs;
+      pulse_width     : in  t_timbre_pw;
+      note_timbres    : in  t_note_timbre;
+      active_notes    : in  t_note_bits;
+      -- pipeline in
+      note_index_in   : in  integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      phase_in        : in  unsigned(PHASE_WIDTH-1 downto 0);
+      note_amp_in     : in  unsigned(NOTE_GAIN_WIDTH-1 downto 0);
+      cycle_start_in  : in  std_logic;
+      -- pipeline out
+      note_index_out  : out integer range I_LOWEST_NOTE to I_HIGHEST_NOTE;
+      note_out        : out signed(DATA_WIDTH-1 downto 0);
+      note_amp_out    : out unsigned(NOTE_GAIN_WIDTH-1 downto 0);
+      cycle_start_out : out std_logic
+    );
+  end component;
+
+  -- coherent capture, 2**SAMPLE_BITS samples
+  constant SAMPLE_BITS : natural := 13;
+  constant NUM_SAMPLES : natural := 2**SAMPLE_BITS;
+
+  -- cycles per capture, about 59 Hz, 434 Hz, 2.1 kHz and 8.2 kHz at 96 kHz
+  constant NUM_PITCHES : natural := 4;
+  type t_cycles is array (0 to NUM_PITCHES-1) of natural;
+  constant CYCLES : t_cycles := (5, 37, 179, 701);
+
+  -- capture names, nearest note to each pitch
+  function note_name(i : natural) return string is
+  begin
+    case i is
+      when 0      => return "as1";
+      when 1      => return "a4";
+      when 2      => return "c7";
+      when others => return "c9";
+    end case;
+  end function;
+
+  function wave_name(w : natural) return string is
+  begin
+    case w is
+      when I_PULSE => return "pulse";
+      when I_RAMP  => return "ramp";
+      when I_SAW   => return "saw";
+      when I_TRI   => return "tri";
+      when others  => return "sine";
+    end case;
+  end function;
+
+  -- phase to waveform latency in clocks
+  constant LATENCY : natural := 2;
+
+  constant clk_period : time := 40 ns;
+
+  signal clk       : std_logic := '0';
+  signal rst       : std_logic := '1';
+  signal wfrm_amps : t_timbre_amps := (others => (others => (others => '0')));
+  signal phase     : unsigned(WIDTH_PH_DATA-1 downto 0) := (others => '0');
+  signal note_out  : signed(WIDTH_WAVE_DATA-1 downto 0);
+  signal sim_done  : boolean := false;
+
+begin
+
+  -- Instantiate the DUT
+  uut: phase_to_wave
+    generic map (
+      PHASE_WIDTH     => WIDTH_PH_DATA,
+      NOTE_GAIN_WIDTH => WIDTH_NOTE_GAIN,
+      DATA_WIDTH      => WIDTH_WAVE_DATA,
+      SIN_LUT_PH      => WIDTH_SIN_LUT_PH,
+      SIN_INTERP_PH   => WIDTH_SIN_INTERP_PH
+    )
+    port map (
+      clk             => clk,
+      rst             => rst,
+      -- synth controls
+      wfrm_amps       => wfrm_amps,
+      wfrm_phs        => (others => (others => (others => '0'))),
+      pulse_width     => (others => x"8000"),
+      note_timbres    => (others => (others => '0')),
+      active_notes    => (others => '1'),
+      -- pipeline in
+      note_index_in   => I_LOWEST_NOTE,
+      phase_in        => phase,
+      note_amp_in     => (others => '1'),
+      cycle_start_in  => '0',
+      -- pipeline out
+      note_index_out  => open,
+      note_out        => note_out,
+      note_amp_out    => open,
+      cycle_start_out => open
+    );
+
+  -- Clock Process
+  clk <= not clk after clk_period / 2 when not sim_done else '0';
+
+  -- Stimulus Process
+  stimulus : process
+    file     f_out : text;
+    variable l     : line;
+  begin
+    wait for clk_period * 2;
+    rst <= '0';
+
+    for w in 0 to NUM_WFRMS-1 loop
+      wfrm_amps    <= (others => (others => (others => '0')));
+      wfrm_amps(0)(w) <= (others => '1');
+
+      for p in 0 to NUM_PITCHES-1 loop
+        file_open(f_out, "wave_" & wave_name(w) & "_" & note_name(p) & ".txt", write_mode);
+
+        -- the sample for phase step i is out LATENCY clocks after it goes in
+        for i in 0 to NUM_SAMPLES + LATENCY - 1 loop
+          phase <= to_unsigned((i * CYCLES(p)) mod NUM_SAMPLES, SAMPLE_BITS) &
+                   to_unsigned(0, WIDTH_PH_DATA - SAMPLE_BITS);
+          wait until rising_edge(clk);
+          if i >= LATENCY then
+            write(l, to_integer(note_out));
+            writeline(f_out, l);
+          end if;
+        end loop;
+
+        file_close(f_out);
+      end loop;
+    end loop;
+
+    report "Testbench completed." severity note;
+    sim_done <= true;
+    wait;
+  end process stimulus;
+
+end tb;
@@ -174,7 +174,8 @@ end top;
         s_axi_rready  : in  std_logic;
   
         -- Digital audio output
-        audio_out     : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
+        audio_out_l   : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0);
+        audio_out_r   : out std_logic_vector(OUT_DATA_WIDTH-1 downto 0)
       );
     end component synth_engine;
       
@@ -227,7 +228,8 @@ end top;
     signal rst12p288   : std_logic;
     signal rst12p288_n : std_logic;
     
-    signal audio_data : std_logic_vector(23 downto 0);
+    signal audio_data_l : std_logic_vector(23 downto 0);
+    signal audio_data_r : std_logic_vector(23 downto 0);
     
     signal btn_tri_i_0 : STD_LOGIC_VECTOR ( 0 to 0 );
     signal btn_tri_i_1 : STD_LOGIC_VECTOR ( 1 to 1 );
@@ -384,7 +386,8 @@ end top;
       s_axi_rready  => rready,
 
       -- Digital audio output
-      audio_out     => audio_data
+      audio_out_l   => audio_data_l,
+      audio_out_r   => audio_data_r
     );
     
   -- Audio codec
@@ -398,8 +401,8 @@ end top;
       -- input clock domain
       rst         => rst25,
       clk         => clk25,
-      dac_data_l  => audio_data,
-      dac_data_r  => audio_data,
+      dac_data_l  => audio_data_l,
+      dac_data_r  => audio_data_r,
       dac_latched => open,
       adc_data    => open,
       adc_latched => open,
@@ -0,0 +1,495 @@
+/****************************************************************************/
+/**
+* amp.c
+*
+* This file contains the glue between the two cores of a dual-core (AMP)
+* build, see amp.h. Each direction is an SPSC queue in the shared OCM
+* block: the voice core sends its debug text and the presets and tuning
+* it stores to the service core, which prints and saves them, and the
+* service core sends the SD card library, console register writes and
+* preset uploads the other way. Counters and latency histograms are
+* published by the voice core when it is idle.
+*
+* The voice core only polls its queue when there is no MIDI waiting, and
+* never waits on the service core: when a queue is full, debug text is
+* dropped and counted.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include "amp.h"
+
+#if defined(AMP_SERVICE) || defined(AMP_VOICE)
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "xil_io.h"
+#include "xil_mmu.h"
+#include "xpseudo_asm.h"
+
+#include "../utils/utils.h"
+#include "../boot/boot.h"
+#include "../midi/midi.h"
+#include "../storage/storage.h"
+#include "../synth_ctrl/synth_ctrl.h"
+
+#define amp_shared ((AmpShared *)AMP_SHARED_BASE)
+
+// the shared block has to fit below the FSBL stack
+typedef char amp_shared_fits[(sizeof(AmpShared) <= AMP_SHARED_SIZE) ? 1 : -1];
+
+// frequency word messages that carry a whole tuning table
+#define AMP_TUNING_MSGS ((MAX_NOTE + AMP_MSG_WORDS) / AMP_MSG_WORDS)
+
+// queue this core sends on
+#ifdef AMP_VOICE
+#define amp_tx (&amp_shared->to_service)
+#define amp_rx (&amp_shared->to_voice)
+#else
+#define amp_tx (&amp_shared->to_voice)
+#define amp_rx (&amp_shared->to_service)
+#endif
+
+/***************************************************************************
+* Both cores
+****************************************************************************/
+
+/***************************************************************************/
+/**
+* This function sends a copy of a stored preset to the other core.
+*
+* @param  program is the preset number
+*
+* @return XST_SUCCESS, or XST_FAILURE when the queue is full
+*
+****************************************************************************/
+int ampSendPreset(u8 program) {
+    const SynthPreset *preset = getPreset(program);
+    AmpMsg msg;
+
+    if (preset == NULL) {
+        return XST_FAILURE;
+    }
+    msg.type = AMP_MSG_PRESET;
+    msg.len = PRESET_REGS;
+    msg.arg = program;
+    memcpy(msg.data, preset->regs, sizeof(preset->regs));
+
+    return spscPush(amp_tx, &msg);
+}
+
+/***************************************************************************/
+/**
+* This function sends a tuning table as AMP_TUNING_MSGS messages.
+*
+* @return XST_SUCCESS, or XST_FAILURE when the queue has no room for all
+*         of them
+*
+****************************************************************************/
+static int ampSendFreqWords(const u32 *freq_words) {
+    AmpMsg msg;
+
+    if (AMP_QUEUE_SLOTS - spscCount(amp_tx) < AMP_TUNING_MSGS) {
+        return XST_FAILURE;
+    }
+
+    msg.type = AMP_MSG_TUNING;
+    for (u16 note = 0; note <= MAX_NOTE; note += AMP_MSG_WORDS) {
+        msg.arg = note;
+        msg.len = (MAX_NOTE + 1 - note < AMP_MSG_WORDS) ? MAX_NOTE + 1 - note : AMP_MSG_WORDS;
+        memcpy(msg.data, &freq_words[note], 4 * msg.len);
+        spscPush(amp_tx, &msg);
+    }
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function copies a tuning message into the tuning table.
+*
+* @return 1 when it was the last part of the table, 0 otherwise
+*
+****************************************************************************/
+static int ampTakeFreqWords(const AmpMsg *msg) {
+    if (msg->arg + msg->len > MAX_NOTE + 1) {
+        return 0;
+    }
+    memcpy(&FreqWordBase[msg->arg], msg->data, 4 * msg->len);
+    return msg->arg + msg->len == MAX_NOTE + 1;
+}
+
+#ifdef AMP_SERVICE
+
+/***************************************************************************
+* Service core
+****************************************************************************/
+
+/***************************************************************************/
+/**
+* This function maps the shared block and empties both queues.
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+* @note   Call before the voice core is started.
+*
+****************************************************************************/
+int ampServiceInit(void) {
+    // the whole 1 MB section, see AMP_SHARED_ATTR
+    Xil_SetTlbAttributes(AMP_SHARED_BASE, AMP_SHARED_ATTR);
+
+    memset(amp_shared, 0, sizeof(AmpShared));
+    RETURN_ON_FAILURE(spscInit(&amp_shared->to_service, amp_shared->to_service_slots,
+                               AMP_QUEUE_SLOTS, sizeof(AmpMsg)));
+    RETURN_ON_FAILURE(spscInit(&amp_shared->to_voice, amp_shared->to_voice_slots,
+                               AMP_QUEUE_SLOTS, sizeof(AmpMsg)));
+    storeRelease(&amp_shared->magic, AMP_MAGIC);
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function releases core 1 from its WFE loop into the voice
+* application.
+*
+****************************************************************************/
+void ampStartVoice(void) {
+    Xil_Out32(AMP_CPU1_START, AMP_VOICE_ENTRY);
+    dsb();
+    sev();
+}
+
+/***************************************************************************/
+/**
+* This function waits for the voice core to bring up the synth and MIDI,
+* and takes its boot stamps.
+*
+* @return XST_SUCCESS, or XST_FAILURE when it did not start in
+*         AMP_START_TIMEOUT_US
+*
+****************************************************************************/
+int ampWaitVoice(void) {
+    XTime start, now;
+
+    XTime_GetTime(&start);
+    while (!loadAcquire(&amp_shared->voice_ready)) {
+        XTime_GetTime(&now);
+        if (now - start > AMP_START_TIMEOUT_US * (COUNTS_PER_SECOND / 1000000)) {
+            return XST_FAILURE;
+        }
+    }
+    boot_stamps[BOOT_SYNTH] = amp_shared->stats.synth;
+    boot_stamps[BOOT_MIDI] = amp_shared->stats.midi;
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function sends the preset bank and tuning table to the voice core.
+*
+* @param  freq_words is the tuning table
+* @param  loaded is set when they came from the SD card, the voice core
+*         then recalls preset 0 on every timbre
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int ampSendLibrary(const u32 *freq_words, int loaded) {
+    AmpMsg msg;
+
+    for (u16 p = 0; p < NUM_PRESETS; p ++) {
+        RETURN_ON_FAILURE(ampSendPreset(p));
+    }
+    RETURN_ON_FAILURE(ampSendFreqWords(freq_words));
+
+    if (loaded) {
+        msg.type = AMP_MSG_RECALL;
+        msg.len = 0;
+        msg.arg = 0;
+        RETURN_ON_FAILURE(spscPush(amp_tx, &msg));
+    }
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function has the voice core write engine registers.
+*
+* @param  offset is the engine byte offset of the first word
+* @param  words are the values
+* @param  count is the word count
+*
+* @return XST_SUCCESS, or XST_FAILURE when the queue has no room for all
+*         of them
+*
+****************************************************************************/
+int ampSendWrite(u16 offset, const u32 *words, u16 count) {
+    AmpMsg msg;
+
+    if (AMP_QUEUE_SLOTS - spscCount(amp_tx) < (u32)(count + AMP_MSG_WORDS - 1) / AMP_MSG_WORDS) {
+        return XST_FAILURE;
+    }
+
+    msg.type = AMP_MSG_WRITE;
+    for (u16 i = 0; i < count; i += AMP_MSG_WORDS) {
+        msg.arg = offset + 4 * i;
+        msg.len = (count - i < AMP_MSG_WORDS) ? count - i : AMP_MSG_WORDS;
+        memcpy(msg.data, &words[i], 4 * msg.len);
+        spscPush(amp_tx, &msg);
+    }
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function has the voice core empty its latency histograms.
+*
+* @return XST_SUCCESS, or XST_FAILURE when the queue is full
+*
+****************************************************************************/
+int ampClearLatency(void) {
+    AmpMsg msg;
+
+    msg.type = AMP_MSG_LAT_CLEAR;
+    msg.len = 0;
+    msg.arg = 0;
+    return spscPush(amp_tx, &msg);
+}
+
+/***************************************************************************/
+/**
+* This function copies what the voice core last published.
+*
+* @param  stats receives a consistent copy
+*
+****************************************************************************/
+void ampReadStats(AmpStats *stats) {
+    u32 seq;
+
+    do {
+        seq = loadAcquire(&amp_shared->stats.seq);
+        memcpy(stats, &amp_shared->stats, sizeof(*stats));
+        fenceAcquire();
+    } while ((seq & 1) || seq != loadRelaxed(&amp_shared->stats.seq));
+}
+
+/***************************************************************************/
+/**
+* This function prints the voice core's debug text and saves the presets
+* and tuning it stored.
+*
+* @note   Called from the service core's main loop, handles at most
+*         AMP_SERVICE_BUDGET messages.
+*
+****************************************************************************/
+void ampServiceDrain(void) {
+    AmpMsg msg;
+
+    for (u8 n = 0; n < AMP_SERVICE_BUDGET && spscPop(amp_rx, &msg) == XST_SUCCESS; n ++) {
+        switch (msg.type) {
+            case AMP_MSG_LOG:
+                xil_printf("%s", (const char *)msg.data);
+                break;
+
+            case AMP_MSG_PRESET:
+                loadPreset(msg.arg, (const SynthPreset *)msg.data);
+                break;
+
+            case AMP_MSG_TUNING:
+                if (ampTakeFreqWords(&msg)) {
+                    saveLibrary();
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+#endif /* AMP_SERVICE */
+
+#ifdef AMP_VOICE
+
+/***************************************************************************
+* Voice core
+****************************************************************************/
+
+// debug text stops here so presets and tuning always have room
+#define AMP_LOG_LIMIT (3 * AMP_QUEUE_SLOTS / 4)
+
+// time between publishing the counters
+#define AMP_STATS_US 10000
+
+static u32 log_drops;
+static XTime stats_at;
+
+/***************************************************************************/
+/**
+* This function brings up the synth and MIDI on the voice core, the
+* service core has already started the codec and queued the library.
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int ampVoiceInit(void) {
+    // the whole 1 MB section, see AMP_SHARED_ATTR
+    Xil_SetTlbAttributes(AMP_SHARED_BASE, AMP_SHARED_ATTR);
+
+    if (loadAcquire(&amp_shared->magic) != AMP_MAGIC) {
+        return XST_FAILURE;
+    }
+
+    if (initSynth()) {
+        return XST_FAILURE;
+    }
+    XTime_GetTime(&amp_shared->stats.synth);
+
+    // the UART interrupt is routed to this core when it is enabled
+    if (configMidi(MIDI_BASEADDR, 0)) {
+        return XST_FAILURE;
+    }
+    XTime_GetTime(&amp_shared->stats.midi);
+
+    storeRelease(&amp_shared->voice_ready, 1);
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function publishes the counters and histograms for the service
+* core.
+*
+****************************************************************************/
+static void ampPublishStats(void) {
+    AmpStats *s = &amp_shared->stats;
+    u32 seq = s->seq + 1;
+
+    storeRelaxed(&s->seq, seq);
+    fenceRelease();
+
+    s->counters[AMP_STAT_MIDI_STRAY]      = midi_parser.stray_bytes;
+    s->counters[AMP_STAT_SYSEX_OVERFLOWS] = midi_parser.sysex_overflows;
+    s->counters[AMP_STAT_SYSEX_ABORTS]    = midi_parser.sysex_aborts;
+    s->counters[AMP_STAT_SUPERSEDED]      = midi_coalescer.superseded;
+    s->counters[AMP_STAT_EARLY_FLUSHES]   = midi_coalescer.early_flushes;
+    s->counters[AMP_STAT_LOG_DROPS]       = log_drops;
+    s->first_note = boot_stamps[BOOT_FIRST_NOTE];
+#ifdef LATENCY
+    memcpy(s->lat, lat_hists, sizeof(s->lat));
+#endif
+
+    storeRelease(&s->seq, seq + 1);
+}
+
+/***************************************************************************/
+/**
+* This function takes the library, register writes and preset uploads
+* from the service core, and publishes the counters now and then.
+*
+* @note   Called from the voice core's main loop when there is no MIDI
+*         to process, handles at most AMP_SERVICE_BUDGET messages.
+*
+****************************************************************************/
+void ampVoiceService(void) {
+    AmpMsg msg;
+    XTime now;
+
+    for (u8 n = 0; n < AMP_SERVICE_BUDGET && spscPop(amp_rx, &msg) == XST_SUCCESS; n ++) {
+        switch (msg.type) {
+            case AMP_MSG_PRESET:
+                loadPreset(msg.arg, (const SynthPreset *)msg.data);
+                break;
+
+            case AMP_MSG_TUNING:
+                if (ampTakeFreqWords(&msg)) {
+                    applyFreqWordBase();
+                }
+                break;
+
+            case AMP_MSG_RECALL:
+                for (u8 t = 0; t < NUM_TIMBRES; t ++) {
+                    recallPreset(t, 0);
+                }
+                break;
+
+            case AMP_MSG_WRITE:
+                for (u8 i = 0; i < msg.len; i ++) {
+                    synthWrite(msg.arg + 4 * i, msg.data[i]);
+                }
+                break;
+
+            case AMP_MSG_LAT_CLEAR:
+                latClear();
+                stats_at = 0;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    XTime_GetTime(&now);
+    if (now - stats_at >= AMP_STATS_US * (COUNTS_PER_SECOND / 1000000)) {
+        ampPublishStats();
+        stats_at = now;
+    }
+}
+
+/***************************************************************************/
+/**
+* This function sends the tuning table to the service core to be saved.
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int ampSendTuning(const u32 *freq_words) {
+    return ampSendFreqWords(freq_words);
+}
+
+/***************************************************************************/
+/**
+* This function formats debug text and queues it for the service core to
+* print, so the voice core never waits on the UART.
+*
+* @note   Text that does not fit in a message is cut short, and text is
+*         dropped and counted once the queue is three quarters full.
+*
+****************************************************************************/
+void ampLog(const char *fmt, ...) {
+    AmpMsg msg;
+    va_list args;
+
+    if (spscCount(amp_tx) >= AMP_LOG_LIMIT) {
+        log_drops++;
+        return;
+    }
+
+    va_start(args, fmt);
+    vsnprintf((char *)msg.data, sizeof(msg.data), fmt, args);
+    va_end(args);
+
+    msg.type = AMP_MSG_LOG;
+    msg.len = 0;
+    msg.arg = strlen((const char *)msg.data);
+    if (spscPush(amp_tx, &msg) != XST_SUCCESS) {
+        log_drops++;
+    }
+}
+
+#endif /* AMP_VOICE */
+
+#endif /* AMP_SERVICE || AMP_VOICE */
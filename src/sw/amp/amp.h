@@ -0,0 +1,152 @@
+#ifndef AMP_H_
+#define AMP_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+
+#include "spsc.h"
+#include "../latency/latency.h"
+#include "../synth_ctrl/synth_preset.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+/*
+ * Dual-core (AMP) builds. The firmware is built twice from the same
+ * sources, one application per core:
+ *
+ *   AMP_SERVICE  core 0: boot, codec, SD card library, console and the
+ *                debug text
+ *   AMP_VOICE    core 1: MIDI UART interrupt, parsing, voice allocation
+ *                and every engine register write once it has started,
+ *                its BSP built with USE_AMP=1
+ *
+ * Neither defined is the single-core build. The cores share nothing but
+ * the block below in the high OCM, mapped non-cacheable on both so the
+ * queue index barriers are all the ordering it needs.
+ */
+#define AMP_SHARED_BASE   0xFFFF0000
+#define AMP_SHARED_SIZE   0xC000      // below the FSBL stack and vectors
+#define AMP_SHARED_ATTR   0x14DE2     // normal non-cacheable, shareable
+
+/*
+ * Xil_SetTlbAttributes sets a whole 1 MB section, so AMP_SHARED_ATTR
+ * covers 0xFFF00000 to 0xFFFFFFFF on each core. That section is the high
+ * OCM from 0xFFFC0000 and nothing below it. Neither application links
+ * anything there, both run from DDR. The rest of the OCM holds the FSBL
+ * stack and vectors, which are dead once the applications run, and
+ * AMP_CPU1_START, which core 1 reads with its MMU off. Making all of it
+ * non-cacheable only slows accesses to it. The call cleans and
+ * invalidates the data cache with the new entry, and each core makes it
+ * before its first access to the shared block, so no stale line of the
+ * section is ever read.
+ */
+
+// core 1 waits in WFE for its entry point here
+#define AMP_CPU1_START    0xFFFFFFF0
+#ifndef AMP_VOICE_ENTRY
+#define AMP_VOICE_ENTRY   0x10000000  // voice application load address
+#endif
+
+#define AMP_MAGIC         0x504D415A  // "ZAMP"
+#define AMP_QUEUE_SLOTS   256
+#define AMP_MSG_WORDS     15
+
+// messages serviced per call, the rest wait for the next call
+#define AMP_SERVICE_BUDGET 16
+
+// time the service core waits for the voice core to start
+#define AMP_START_TIMEOUT_US 100000
+
+/*
+ * Message types. Presets and tuning go both ways, whichever core changed
+ * them sends a copy to the other.
+ */
+typedef enum {
+    AMP_MSG_LOG = 1,    // voice to service: arg bytes of debug text
+    AMP_MSG_PRESET,     // arg is the program, data its register image
+    AMP_MSG_TUNING,     // arg is the first note, len frequency words
+    AMP_MSG_RECALL,     // service to voice: recall preset 0 on every timbre
+    AMP_MSG_WRITE,      // service to voice: arg is an engine offset, len words
+    AMP_MSG_LAT_CLEAR   // service to voice: empty the latency histograms
+} AmpMsgType;
+
+// voice core counters published for the console
+typedef enum {
+    AMP_STAT_MIDI_STRAY,
+    AMP_STAT_SYSEX_OVERFLOWS,
+    AMP_STAT_SYSEX_ABORTS,
+    AMP_STAT_SUPERSEDED,
+    AMP_STAT_EARLY_FLUSHES,
+    AMP_STAT_LOG_DROPS,
+    NUM_AMP_STATS
+} AmpStat;
+
+/***************************************************************************
+* Type definitions
+****************************************************************************/
+
+// one queue slot, two cache lines
+typedef struct {
+    u8  type;
+    u8  len;    // data words used
+    u16 arg;
+    u32 data[AMP_MSG_WORDS];
+} AmpMsg;
+
+/*
+ * What the voice core publishes when it is idle. seq is odd while an
+ * update is being written, a reader copies the block until it reads the
+ * same even seq before and after.
+ */
+typedef struct {
+    u32     seq;
+    u32     counters[NUM_AMP_STATS];
+    XTime   synth;        // boot stamps taken on the voice core
+    XTime   midi;
+    XTime   first_note;
+#ifdef LATENCY
+    LatHist lat[NUM_LAT_POINTS];
+#endif
+} AmpStats;
+
+typedef struct {
+    u32       magic;
+    u32       voice_ready;
+    AmpStats  stats;
+    SpscQueue to_service;
+    SpscQueue to_voice;
+    AmpMsg    to_service_slots[AMP_QUEUE_SLOTS];
+    AmpMsg    to_voice_slots[AMP_QUEUE_SLOTS];
+} AmpShared;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+// both cores
+int  ampSendPreset(u8 program);
+
+// service core
+int  ampServiceInit(void);
+void ampStartVoice(void);
+int  ampWaitVoice(void);
+int  ampSendLibrary(const u32 *freq_words, int loaded);
+int  ampSendWrite(u16 offset, const u32 *words, u16 count);
+int  ampClearLatency(void);
+void ampReadStats(AmpStats *stats);
+void ampServiceDrain(void);
+
+// voice core
+int  ampVoiceInit(void);
+void ampVoiceService(void);
+int  ampSendTuning(const u32 *freq_words);
+void ampLog(const char *fmt, ...);
+
+#endif /* AMP_H_ */
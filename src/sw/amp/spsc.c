@@ -0,0 +1,116 @@
+/****************************************************************************/
+/**
+* spsc.c
+*
+* This file contains the lock-free single producer, single consumer queue
+* that carries messages between the two cores. It has no hardware or BSP
+* dependencies beyond the types, so the same code builds on the host and
+* is stressed there with a thread on each side.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <string.h>
+
+#include "spsc.h"
+
+/***************************************************************************/
+/**
+* This function empties a queue and sets its slots.
+*
+* @param  q is the queue
+* @param  slots is num_slots * slot_size bytes
+* @param  num_slots is the slot count, a power of two
+* @param  slot_size is the message size in bytes
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+* @note   Call before either side uses the queue.
+*
+****************************************************************************/
+int spscInit(SpscQueue *q, void *slots, u32 num_slots, u32 slot_size) {
+
+    if (num_slots == 0 || (num_slots & (num_slots - 1)) || slot_size == 0) {
+        return XST_FAILURE;
+    }
+
+    memset(q, 0, sizeof(*q));
+    q->mask = num_slots - 1;
+    q->slot_size = slot_size;
+    q->slots = slots;
+    fenceRelease();
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function copies a message into the queue, producer side only.
+*
+* @param  q is the queue
+* @param  msg is slot_size bytes
+*
+* @return XST_SUCCESS, or XST_FAILURE when the queue is full
+*
+****************************************************************************/
+int spscPush(SpscQueue *q, const void *msg) {
+    u32 head = q->head;
+
+    if (head - q->tail_cache > q->mask) {
+        q->tail_cache = loadAcquire(&q->tail);
+        if (head - q->tail_cache > q->mask) {
+            q->dropped++;
+            return XST_FAILURE;
+        }
+    }
+
+    memcpy(q->slots + (head & q->mask) * q->slot_size, msg, q->slot_size);
+    storeRelease(&q->head, head + 1);
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function copies the oldest message out of the queue, consumer side
+* only.
+*
+* @param  q is the queue
+* @param  msg receives slot_size bytes
+*
+* @return XST_SUCCESS, or XST_FAILURE when the queue is empty
+*
+****************************************************************************/
+int spscPop(SpscQueue *q, void *msg) {
+    u32 tail = q->tail;
+
+    if (tail == q->head_cache) {
+        q->head_cache = loadAcquire(&q->head);
+        if (tail == q->head_cache) {
+            return XST_FAILURE;
+        }
+    }
+
+    memcpy(msg, q->slots + (tail & q->mask) * q->slot_size, q->slot_size);
+    storeRelease(&q->tail, tail + 1);
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function counts the messages waiting, from either side.
+*
+* @return the count, a snapshot that the other side may change
+*
+****************************************************************************/
+u32 spscCount(const SpscQueue *q) {
+    u32 tail = loadAcquire(&q->tail);
+    return loadAcquire(&q->head) - tail;
+}
@@ -0,0 +1,74 @@
+#ifndef SPSC_H_
+#define SPSC_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// cache line size, the producer and consumer indices are kept a line
+// apart. 32 bytes on the Cortex-A9, the host test builds with 64.
+#ifndef SPSC_LINE
+#define SPSC_LINE 32
+#endif
+
+/***************************************************************************
+* Macro functions
+****************************************************************************/
+
+/*
+ * Index loads and stores. On the Cortex-A9 the acquire and release
+ * orderings compile to a DMB ISH after the load and before the store,
+ * which orders the slot copies against the index for the other core in
+ * the inner shareable domain. On the host they order them between
+ * threads.
+ */
+#define loadAcquire(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define loadRelaxed(p)      __atomic_load_n((p), __ATOMIC_RELAXED)
+#define storeRelease(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define storeRelaxed(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define fenceAcquire()      __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define fenceRelease()      __atomic_thread_fence(__ATOMIC_RELEASE)
+
+/***************************************************************************
+* Type definitions
+****************************************************************************/
+
+/*
+ * Single producer, single consumer queue of fixed size slots. head and
+ * tail run freely and wrap at 2^32, the slot is the index masked by the
+ * slot count, a power of two. Each side keeps the last index it read from
+ * the other side, so it only touches the other side's line when the queue
+ * looks full or empty. The producer only writes the first line and the
+ * consumer only the second.
+ */
+typedef struct {
+    // producer
+    u32 head __attribute__((aligned(SPSC_LINE)));  // next slot written
+    u32 tail_cache;                                // tail as last read
+    u32 dropped;                                   // pushes refused while full
+    // consumer
+    u32 tail __attribute__((aligned(SPSC_LINE)));  // next slot read
+    u32 head_cache;                                // head as last read
+    // fixed at init
+    u32 mask __attribute__((aligned(SPSC_LINE)));
+    u32 slot_size;
+    u8 *slots;
+} SpscQueue;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+int  spscInit(SpscQueue *q, void *slots, u32 num_slots, u32 slot_size);
+int  spscPush(SpscQueue *q, const void *msg);
+int  spscPop(SpscQueue *q, void *msg);
+u32  spscCount(const SpscQueue *q);
+
+#endif /* SPSC_H_ */
@@ -0,0 +1,186 @@
+/****************************************************************************/
+/**
+* boot.c
+*
+* This file contains the boot sequencer. The codec power-up is started
+* first and runs in the background through its VMID delay while the synth,
+* the MIDI UART and the SD card library are brought up, and each phase is
+* stamped with the global timer so the time to the first note can be
+* measured.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Start the voice core in dual-core builds
+* 0.02  agt    10/19/26 Self-test before the voice core owns the engine
+*
+****************************************************************************/
+
+#include <string.h>
+
+#include "boot.h"
+#include "../utils/utils.h"
+#include "../midi/midi.h"
+#include "../ssm2603/ssm2603.h"
+#include "../synth_ctrl/synth_ctrl.h"
+#include "../synth_ctrl/synth_preset.h"
+#include "../storage/storage.h"
+#include "../amp/amp.h"
+
+XTime boot_stamps[NUM_BOOT_STAMPS];
+
+static const char *boot_stamp_names[NUM_BOOT_STAMPS] = {
+    "start",
+    "codec queued",
+    "synth",
+    "self-test",
+    "midi",
+    "library",
+    "codec",
+    "ready",
+    "first note"
+};
+
+/***************************************************************************
+* Synth controller self-test, only with BOOT_DIAG
+****************************************************************************/
+
+static void selfTest(void) {
+    if (checkSynthCtrl()) {
+        xil_printf("Synthesizer controller test failed!\r\n");
+    }
+    bootStamp(BOOT_SELF_TEST);
+    codecService();
+}
+
+/***************************************************************************
+* Bring up the system, returns XST_FAILURE when the synth cannot run
+****************************************************************************/
+
+int bootSystem(u32 flags) {
+    int status = XST_SUCCESS;
+    int codec;
+    int loaded;
+
+    memset(boot_stamps, 0, sizeof(boot_stamps));
+    bootStamp(BOOT_START);
+
+    // power bits first, the codec then needs 73 ms before it goes active
+    codecStart(flags & BOOT_DIAG);
+    bootStamp(BOOT_CODEC_QUEUED);
+
+#ifdef AMP_SERVICE
+    // the self-test writes the engine, which is the voice core's once it
+    // starts
+    if (flags & BOOT_DIAG) {
+        selfTest();
+    }
+
+    // the voice core brings up the synth and MIDI, stamping them itself
+    if (ampServiceInit()) {
+        xil_printf("Shared memory initialization error occurred!\r\n");
+        return XST_FAILURE;
+    }
+    ampStartVoice();
+    initFreqWords();
+    initPresets();
+#else
+    if (initSynth() || initPresets()) {
+        xil_printf("Synthesizer initialization error occurred!\r\n");
+    }
+    bootStamp(BOOT_SYNTH);
+#endif
+    codecService();
+
+#ifndef AMP_SERVICE
+    if (flags & BOOT_DIAG) {
+        selfTest();
+    }
+
+    if (configMidi(MIDI_BASEADDR, flags & BOOT_DIAG)) {
+        xil_printf("Failed to configure midi interface\r\n");
+        status = XST_FAILURE;
+    }
+    bootStamp(BOOT_MIDI);
+    codecService();
+#endif
+
+    // load presets and tuning from the SD card, defaults stay without one
+    loaded = initStorage(FreqWordBase) == XST_SUCCESS && loadLibrary() == XST_SUCCESS;
+#ifdef AMP_SERVICE
+    // the voice core writes them to the engine, defaults included
+    if (ampSendLibrary(FreqWordBase, loaded)) {
+        xil_printf("Failed to send the library to the voice core\r\n");
+    }
+#else
+    if (loaded) {
+        applyFreqWordBase();
+        for (u8 t = 0; t < NUM_TIMBRES; t ++) {
+            recallPreset(t, 0);
+        }
+    }
+#endif
+    if (loaded) {
+        xil_printf("Library loaded\r\n");
+    }
+    bootStamp(BOOT_LIBRARY);
+
+    while ((codec = codecService()) == CODEC_BUSY) {
+    }
+    if (codec != XST_SUCCESS) {
+        xil_printf("Config codec error occurred!\r\n");
+    } else if (flags & BOOT_DIAG) {
+        print_codec_config();
+    }
+    bootStamp(BOOT_CODEC);
+
+#ifdef AMP_SERVICE
+    if (ampWaitVoice()) {
+        xil_printf("Voice core did not start\r\n");
+        status = XST_FAILURE;
+    }
+#endif
+
+    bootStamp(BOOT_READY);
+    // the diagnostic prints alone take longer than the budget
+    if (!(flags & BOOT_DIAG) && bootElapsedUs(BOOT_READY) > BOOT_BUDGET_US) {
+        xil_printf("Boot took %u us, over the %u us budget\r\n",
+                   (unsigned)bootElapsedUs(BOOT_READY), BOOT_BUDGET_US);
+    }
+
+    return status;
+}
+
+/***************************************************************************
+* Time from the start of boot to a stamp, 0 when it has not been taken
+****************************************************************************/
+
+u32 bootElapsedUs(BootStamp s) {
+    if (boot_stamps[s] == 0) {
+        return 0;
+    }
+    return (u32)((boot_stamps[s] - boot_stamps[BOOT_START]) / (COUNTS_PER_SECOND / 1000000));
+}
+
+/***************************************************************************
+* Print the boot timestamps and the time each phase took
+****************************************************************************/
+
+void printBootTimes(void) {
+    u32 last = 0;
+
+    debug_print("boot phase       at (us)  took (us)\r\n");
+    for (int s = BOOT_START; s < NUM_BOOT_STAMPS; s ++) {
+        if (s != BOOT_START && boot_stamps[s] == 0) {
+            continue;
+        }
+        u32 at = bootElapsedUs(s);
+        // the voice core's stamps can land between the service core's
+        debug_print("%-14s %9u %10u\r\n", boot_stamp_names[s], (unsigned)at,
+                    (unsigned)(at > last ? at - last : 0));
+        last = at;
+    }
+}
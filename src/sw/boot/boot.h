@@ -0,0 +1,67 @@
+#ifndef BOOT_H_
+#define BOOT_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// boot flags, BOOT_DIAG runs the self-tests and reads back and prints the
+// codec configuration
+#define BOOT_DIAG 0x1
+
+#ifndef BOOT_FLAGS
+#define BOOT_FLAGS 0
+#endif
+
+// time from reset to ready without BOOT_DIAG, a longer boot is reported
+// as a regression
+#define BOOT_BUDGET_US 80000
+
+/*
+ * Boot timestamps from the global timer, in the order they are taken.
+ * The codec waits 73 ms for its VMID capacitor after the first writes,
+ * and the synth, UART and library bring-up run in that time.
+ */
+typedef enum {
+    BOOT_START,         // boot sequencer entered
+    BOOT_CODEC_QUEUED,  // codec power bits written, VMID delay running
+    BOOT_SYNTH,         // synth registers and presets initialized
+    BOOT_SELF_TEST,     // self-tests done, only with BOOT_DIAG
+    BOOT_MIDI,          // MIDI UART and interrupts up
+    BOOT_LIBRARY,       // SD card library loaded or skipped
+    BOOT_CODEC,         // codec active with its output enabled
+    BOOT_READY,         // main loop about to start
+    BOOT_FIRST_NOTE,    // first note on dispatched
+    NUM_BOOT_STAMPS
+} BootStamp;
+
+/***************************************************************************
+* Global variable definitions
+****************************************************************************/
+
+extern XTime boot_stamps[NUM_BOOT_STAMPS];
+
+/***************************************************************************
+* Macro functions
+****************************************************************************/
+
+#define bootStamp(s)     XTime_GetTime(&boot_stamps[(s)])
+#define bootStampOnce(s) do { if (boot_stamps[(s)] == 0) bootStamp(s); } while (0)
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+int  bootSystem(u32 flags);
+u32  bootElapsedUs(BootStamp s);
+void printBootTimes(void);
+
+#endif /* BOOT_H_ */
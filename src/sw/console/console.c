@@ -0,0 +1,553 @@
+/****************************************************************************/
+/**
+* console.c
+*
+* This file contains the binary command console on the debug UART. Framed
+* requests peek and poke the engine registers, dump the codec registers,
+* read the counters and latency histograms and upload presets. See
+* console.h for the frame format and the commands.
+*
+* The console is serviced from the main loop when there is no MIDI to
+* process. Each call reads a bounded number of bytes, handles at most one
+* request, sends only what fits in the transmit FIFO and leaves codec reads
+* on the I2C queue, so it never holds up the MIDI dispatch.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Go through the voice core in dual-core builds
+*
+****************************************************************************/
+
+#include <string.h>
+
+#include "xuartps.h"
+
+#include "console.h"
+#include "../boot/boot.h"
+#include "../i2c/i2c.h"
+#include "../latency/latency.h"
+#include "../midi/midi.h"
+#include "../midi/midi_sysex.h"
+#include "../ssm2603/ssm2603.h"
+#include "../synth_ctrl/synth_ctrl.h"
+#include "../synth_ctrl/synth_preset.h"
+#include "../amp/amp.h"
+
+// codec registers in a CODEC response
+static const u8 con_codec_regs[] = {
+    CODEC_L_ADC_VOL, CODEC_R_ADC_VOL, CODEC_L_DAC_VOL, CODEC_R_DAC_VOL,
+    CODEC_AN_AUDIO_PATH, CODEC_DIG_AUDIO_PATH, CODEC_PWR_MGMT,
+    CODEC_DIG_AUDIO_IF, CODEC_SAMPLE_RATE, CODEC_ACTIVE,
+    CODEC_ALC_CTRL1, CODEC_ALC_CTRL2, CODEC_NOISE_GATE
+};
+
+#define NUM_CON_CODEC_REGS (sizeof(con_codec_regs) / sizeof(con_codec_regs[0]))
+
+static ConsoleRx con_rx;
+static u8  con_req[CON_MAX_FRAME];
+static u8  con_resp[CON_MAX_MSG + 2];
+
+// response frame being sent
+static u8  con_tx[CON_MAX_FRAME];
+static u16 con_tx_len;
+static u16 con_tx_pos;
+
+// codec dump waiting on the I2C queue
+static u8  con_codec_pending;
+static u8  con_codec_bufs[NUM_CON_CODEC_REGS][2];
+
+#ifdef AMP_SERVICE
+// last counters and histograms read from the voice core
+static AmpStats con_stats;
+#endif
+
+/***************************************************************************
+* Little endian fields
+****************************************************************************/
+
+static u16 get16(const u8 *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static u32 get32(const u8 *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32)p[3] << 24);
+}
+
+static u8 *put16(u8 *p, u16 v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static u8 *put32(u8 *p, u32 v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+    return p + 4;
+}
+
+/***************************************************************************
+* Framing
+****************************************************************************/
+
+/***************************************************************************/
+/**
+* This function calculates the CRC-16/CCITT-FALSE of a message.
+*
+****************************************************************************/
+u16 conCrc16(const u8 *data, u16 len) {
+    u16 crc = 0xFFFF;
+
+    for (u16 i = 0; i < len; i ++) {
+        crc ^= (u16)data[i] << 8;
+        for (u8 b = 0; b < 8; b ++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+/***************************************************************************/
+/**
+* This function COBS encodes a block so it has no 00 bytes.
+*
+* @param  in is the block
+* @param  len is the block length
+* @param  out receives up to len + len / 254 + 1 bytes
+*
+* @return the encoded length
+*
+****************************************************************************/
+u16 conCobsEncode(const u8 *in, u16 len, u8 *out) {
+    u16 code_at = 0;
+    u16 o = 1;
+    u8  code = 1;
+
+    for (u16 i = 0; i < len; i ++) {
+        if (in[i] == 0) {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        } else {
+            out[o++] = in[i];
+            if (++code == 0xFF) {
+                out[code_at] = code;
+                code_at = o++;
+                code = 1;
+            }
+        }
+    }
+    out[code_at] = code;
+
+    return o;
+}
+
+/***************************************************************************/
+/**
+* This function decodes a COBS block.
+*
+* @param  in is the encoded block, without delimiters
+* @param  len is the encoded length
+* @param  out receives up to len bytes
+*
+* @return the decoded length, or -1 when the block is malformed
+*
+****************************************************************************/
+int conCobsDecode(const u8 *in, u16 len, u8 *out) {
+    u16 i = 0;
+    u16 o = 0;
+
+    while (i < len) {
+        u8 code = in[i++];
+        if (code == 0) {
+            return -1;
+        }
+        for (u8 j = 1; j < code; j ++) {
+            if (i >= len || in[i] == 0) {
+                return -1;
+            }
+            out[o++] = in[i++];
+        }
+        if (code != 0xFF && i < len) {
+            out[o++] = 0;
+        }
+    }
+
+    return o;
+}
+
+/***************************************************************************/
+/**
+* This function frames a message with its CRC for sending.
+*
+* @param  msg is the message, with two spare bytes after it for the CRC
+* @param  len is the message length
+* @param  frame receives up to CON_MAX_FRAME bytes
+*
+* @return the frame length
+*
+****************************************************************************/
+u16 conFrame(u8 *msg, u16 len, u8 *frame) {
+    put16(&msg[len], conCrc16(msg, len));
+
+    frame[0] = 0;
+    u16 n = conCobsEncode(msg, len + 2, &frame[1]);
+    frame[n + 1] = 0;
+
+    return n + 2;
+}
+
+/***************************************************************************/
+/**
+* This function takes a received byte and returns a message once a whole
+* frame with a good CRC is in.
+*
+* @param  rx is the receive state
+* @param  byte is the byte received
+* @param  msg receives the message, CON_MAX_FRAME bytes
+*
+* @return the message length, 0 while a frame is incomplete or was dropped
+*
+****************************************************************************/
+u16 conRxByte(ConsoleRx *rx, u8 byte, u8 *msg) {
+    int n;
+
+    if (byte != 0) {
+        if (rx->len < sizeof(rx->buf)) {
+            rx->buf[rx->len++] = byte;
+        } else {
+            rx->overflow = 1;
+        }
+        return 0;
+    }
+
+    // the delimiter before a frame
+    if (rx->len == 0) {
+        return 0;
+    }
+
+    n = rx->overflow ? -1 : conCobsDecode(rx->buf, rx->len, msg);
+    rx->len = 0;
+    rx->overflow = 0;
+
+    if (n < 4 || conCrc16(msg, n - 2) != get16(&msg[n - 2])) {
+        rx->bad_frames++;
+        return 0;
+    }
+    rx->frames++;
+
+    return n - 2;
+}
+
+/***************************************************************************
+* Command handlers, each fills in the response payload and returns the
+* status, *len is the payload length
+****************************************************************************/
+
+static u8 conPing(const u8 *req, u16 req_len, u8 *out, u16 *len) {
+    (void)req;
+    if (req_len != 0) {
+        return CON_ERR_LEN;
+    }
+    out = put32(out, readRev());
+    out = put32(out, readDateCode());
+    put16(out, CON_MAX_WORDS);
+    *len = 10;
+    return CON_OK;
+}
+
+static u8 conCheckRange(u16 offset, u16 words) {
+    if (words == 0 || words > CON_MAX_WORDS || (offset & 3) ||
+        offset + 4 * words > SYNTH_ADDR_SPAN) {
+        return CON_ERR_RANGE;
+    }
+    return CON_OK;
+}
+
+static u8 conRead(const u8 *req, u16 req_len, u8 *out, u16 *len) {
+    if (req_len != 3) {
+        return CON_ERR_LEN;
+    }
+    u16 offset = get16(req);
+    u8  words = req[2];
+    if (conCheckRange(offset, words)) {
+        return CON_ERR_RANGE;
+    }
+
+    for (u8 i = 0; i < words; i ++) {
+        out = put32(out, synthRead(offset + 4 * i));
+    }
+    *len = 4 * words;
+    return CON_OK;
+}
+
+static u8 conWrite(const u8 *req, u16 req_len, u8 *out, u16 *len) {
+    (void)out;
+    (void)len;
+    if (req_len < 6 || (req_len - 2) % 4) {
+        return CON_ERR_LEN;
+    }
+    u16 offset = get16(req);
+    u16 words = (req_len - 2) / 4;
+    if (conCheckRange(offset, words)) {
+        return CON_ERR_RANGE;
+    }
+
+#ifdef AMP_SERVICE
+    // the voice core owns the engine writes
+    u32 values[CON_MAX_WORDS];
+    for (u16 i = 0; i < words; i ++) {
+        values[i] = get32(&req[2 + 4 * i]);
+    }
+    if (ampSendWrite(offset, values, words)) {
+        return CON_ERR_IO;
+    }
+#else
+    for (u16 i = 0; i < words; i ++) {
+        synthWrite(offset + 4 * i, get32(&req[2 + 4 * i]));
+    }
+#endif
+    return CON_OK;
+}
+
+static u8 conCounters(const u8 *req, u16 req_len, u8 *out, u16 *len) {
+    u32 cnt[NUM_CON_COUNTERS];
+
+    (void)req;
+    if (req_len != 0) {
+        return CON_ERR_LEN;
+    }
+
+#ifdef AMP_SERVICE
+    // MIDI counters as the voice core last published them
+    ampReadStats(&con_stats);
+    if (boot_stamps[BOOT_FIRST_NOTE] == 0) {
+        boot_stamps[BOOT_FIRST_NOTE] = con_stats.first_note;
+    }
+    cnt[CON_CNT_MIDI_STRAY]      = con_stats.counters[AMP_STAT_MIDI_STRAY];
+    cnt[CON_CNT_SYSEX_OVERFLOWS] = con_stats.counters[AMP_STAT_SYSEX_OVERFLOWS];
+    cnt[CON_CNT_SYSEX_ABORTS]    = con_stats.counters[AMP_STAT_SYSEX_ABORTS];
+    cnt[CON_CNT_SUPERSEDED]      = con_stats.counters[AMP_STAT_SUPERSEDED];
+    cnt[CON_CNT_EARLY_FLUSHES]   = con_stats.counters[AMP_STAT_EARLY_FLUSHES];
+#else
+    cnt[CON_CNT_MIDI_STRAY]      = midi_parser.stray_bytes;
+    cnt[CON_CNT_SYSEX_OVERFLOWS] = midi_parser.sysex_overflows;
+    cnt[CON_CNT_SYSEX_ABORTS]    = midi_parser.sysex_aborts;
+    cnt[CON_CNT_SUPERSEDED]      = midi_coalescer.superseded;
+    cnt[CON_CNT_EARLY_FLUSHES]   = midi_coalescer.early_flushes;
+#endif
+
+    cnt[CON_CNT_I2C_DONE]        = i2c_stats.done;
+    cnt[CON_CNT_I2C_RETRIES]     = i2c_stats.retries;
+    cnt[CON_CNT_I2C_TIMEOUTS]    = i2c_stats.timeouts;
+    cnt[CON_CNT_I2C_FAILED]      = i2c_stats.failed;
+    cnt[CON_CNT_FRAMES]          = con_rx.frames;
+    cnt[CON_CNT_BAD_FRAMES]      = con_rx.bad_frames;
+    cnt[CON_CNT_BOOT_READY_US]   = bootElapsedUs(BOOT_READY);
+    cnt[CON_CNT_FIRST_NOTE_US]   = bootElapsedUs(BOOT_FIRST_NOTE);
+
+    for (int i = 0; i < NUM_CON_COUNTERS; i ++) {
+        out = put32(out, cnt[i]);
+    }
+    *len = 4 * NUM_CON_COUNTERS;
+    return CON_OK;
+}
+
+static u8 conLatency(const u8 *req, u16 req_len, u8 *out, u16 *len) {
+#ifdef LATENCY
+    if (req_len != 1) {
+        return CON_ERR_LEN;
+    }
+
+#ifdef AMP_SERVICE
+    // histograms as the voice core last published them
+    ampReadStats(&con_stats);
+    const LatHist *hists = con_stats.lat;
+#else
+    const LatHist *hists = lat_hists;
+#endif
+
+    u8 *start = out;
+    for (int p = 0; p < NUM_LAT_POINTS; p ++) {
+        const LatHist *h = &hists[p];
+        out = put32(out, h->count);
+        out = put32(out, h->min_ns);
+        out = put32(out, h->max_ns);
+        out = put32(out, h->count ? (u32)(h->sum_ns / h->count) : 0);
+        for (int b = 0; b < LAT_BUCKETS; b ++) {
+            out = put32(out, h->buckets[b]);
+        }
+    }
+    *len = out - start;
+
+    if (req[0] & CON_LATENCY_CLEAR) {
+#ifdef AMP_SERVICE
+        ampClearLatency();
+#else
+        latClear();
+#endif
+    }
+    return CON_OK;
+#else
+    (void)req;
+    (void)req_len;
+    (void)out;
+    (void)len;
+    return CON_ERR_CMD;
+#endif
+}
+
+static u8 conPreset(const u8 *req, u16 req_len, u8 *out, u16 *len) {
+    SynthPatch patch;
+    u8 program;
+
+    (void)out;
+    (void)len;
+    if (sysexDecodePreset(req, req_len, &program, &patch) != XST_SUCCESS) {
+        return CON_ERR_LEN;
+    }
+    if (storePreset(program, &patch) != XST_SUCCESS) {
+        return CON_ERR_RANGE;
+    }
+#ifdef AMP_SERVICE
+    if (ampSendPreset(program)) {
+        return CON_ERR_IO;
+    }
+#endif
+    return CON_OK;
+}
+
+/***************************************************************************
+* The codec registers are read through the I2C queue, the response goes
+* out once the reads are in
+****************************************************************************/
+
+static u8 conCodecStart(u16 req_len) {
+    if (req_len != 0) {
+        return CON_ERR_LEN;
+    }
+    for (u8 i = 0; i < NUM_CON_CODEC_REGS; i ++) {
+        if (codecQueueRead(con_codec_regs[i], con_codec_bufs[i])) {
+            return CON_ERR_IO;
+        }
+    }
+    con_codec_pending = 1;
+    return CON_OK;
+}
+
+static u8 conCodecFinish(u8 *out, u16 *len) {
+    if (i2cResult() != XST_SUCCESS) {
+        return CON_ERR_IO;
+    }
+    for (u8 i = 0; i < NUM_CON_CODEC_REGS; i ++) {
+        *out++ = con_codec_regs[i];
+        out = put16(out, codecReadValue(con_codec_bufs[i]));
+    }
+    *len = 3 * NUM_CON_CODEC_REGS;
+    return CON_OK;
+}
+
+/***************************************************************************
+* Queue a response frame
+****************************************************************************/
+
+static void conRespond(u8 status, u16 len) {
+    con_resp[2] = status;
+    con_tx_len = conFrame(con_resp, 3 + (status == CON_OK ? len : 0), con_tx);
+    con_tx_pos = 0;
+}
+
+/***************************************************************************
+* Handle a request
+****************************************************************************/
+
+static void conHandle(const u8 *msg, u16 msg_len) {
+    const u8 *req = &msg[2];
+    u16 req_len = msg_len - 2;
+    u8 *out = &con_resp[3];
+    u16 len = 0;
+    u8 status;
+
+    con_resp[0] = msg[0] | CON_RESPONSE;
+    con_resp[1] = msg[1];
+
+    switch (msg[0]) {
+        case CON_CMD_PING:     status = conPing(req, req_len, out, &len);     break;
+        case CON_CMD_READ:     status = conRead(req, req_len, out, &len);     break;
+        case CON_CMD_WRITE:    status = conWrite(req, req_len, out, &len);    break;
+        case CON_CMD_COUNTERS: status = conCounters(req, req_len, out, &len); break;
+        case CON_CMD_LATENCY:  status = conLatency(req, req_len, out, &len);  break;
+        case CON_CMD_PRESET:   status = conPreset(req, req_len, out, &len);   break;
+
+        case CON_CMD_CODEC:
+            status = conCodecStart(req_len);
+            if (status == CON_OK) {
+                return;
+            }
+            break;
+
+        default:
+            status = CON_ERR_CMD;
+            break;
+    }
+
+    conRespond(status, len);
+}
+
+/***************************************************************************/
+/**
+* This function resets the console.
+*
+****************************************************************************/
+void consoleInit(void) {
+    memset(&con_rx, 0, sizeof(con_rx));
+    con_tx_len = con_tx_pos = 0;
+    con_codec_pending = 0;
+}
+
+/***************************************************************************/
+/**
+* This function moves the console along: it sends the next bytes of a
+* response, finishes a codec dump once its reads are in, and takes the
+* next request.
+*
+* @note   Called from the main loop when there is no MIDI to process.
+*
+****************************************************************************/
+void consoleService(void) {
+    u16 len;
+
+    while (con_tx_pos < con_tx_len && !XUartPs_IsTransmitFull(CONSOLE_BASEADDR)) {
+        XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_FIFO_OFFSET, con_tx[con_tx_pos++]);
+    }
+
+    if (con_codec_pending) {
+        i2cService();
+        if (i2cBusy()) {
+            return;
+        }
+        con_codec_pending = 0;
+        len = 0;
+        u8 status = conCodecFinish(&con_resp[3], &len);
+        conRespond(status, len);
+        return;
+    }
+
+    // one response at a time, the host waits for it before the next request
+    if (con_tx_pos < con_tx_len) {
+        return;
+    }
+
+    for (u8 n = 0; n < CON_RX_BUDGET && XUartPs_IsReceiveData(CONSOLE_BASEADDR); n ++) {
+        len = conRxByte(&con_rx, XUartPs_RecvByte(CONSOLE_BASEADDR), con_req);
+        if (len) {
+            conHandle(con_req, len);
+            break;
+        }
+    }
+}
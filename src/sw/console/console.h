@@ -0,0 +1,117 @@
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xparameters.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// the console shares the debug UART with xil_printf
+#define CONSOLE_BASEADDR  STDOUT_BASEADDRESS
+
+/*
+ * Frames on the debug UART:
+ *
+ *   00 <COBS encoded message and CRC-16> 00
+ *
+ *   request:  <cmd> <seq> <payload ...>
+ *   response: <cmd | CON_RESPONSE> <seq> <status> <payload ...>
+ *
+ * COBS leaves no 00 bytes inside a frame, and the debug text has none, so
+ * the host tells frames from text by the delimiters. The CRC is
+ * CRC-16/CCITT-FALSE over the message, sent LSB first, as are all
+ * multi-byte fields. A frame with a bad CRC is dropped without a response,
+ * the host sends it again with the same seq.
+ */
+#define CON_MAX_WORDS   128
+#define CON_MAX_MSG     (3 + 4 * CON_MAX_WORDS)
+#define CON_MAX_FRAME   (2 + CON_MAX_MSG + 2 + (CON_MAX_MSG + 2) / 254 + 1)
+
+/*
+ * Commands, with their request and response payloads:
+ *
+ *   PING      -                    u32 engine rev, u32 date, u16 max words
+ *   READ      u16 offset, u8 n     n u32 engine registers from offset
+ *   WRITE     u16 offset, u32 ...  -
+ *   CODEC     -                    u8 reg, u16 value per codec register
+ *   COUNTERS  -                    u32 counters, CON_CNT_* order
+ *   LATENCY   u8 flags             per histogram u32 count, min, max,
+ *                                  mean and LAT_BUCKETS buckets, in ns
+ *   PRESET    SysEx preset store   -
+ *
+ * Offsets are engine byte offsets, word aligned and below SYNTH_ADDR_SPAN.
+ * The PRESET payload is the preset store message without F0 and F7.
+ */
+#define CON_CMD_PING      0x01
+#define CON_CMD_READ      0x02
+#define CON_CMD_WRITE     0x03
+#define CON_CMD_CODEC     0x04
+#define CON_CMD_COUNTERS  0x05
+#define CON_CMD_LATENCY   0x06
+#define CON_CMD_PRESET    0x07
+#define CON_RESPONSE      0x80
+
+// LATENCY request flags
+#define CON_LATENCY_CLEAR 0x01
+
+// response status
+#define CON_OK            0
+#define CON_ERR_CMD       1   // unknown command, or not in this build
+#define CON_ERR_LEN       2   // payload length does not fit the command
+#define CON_ERR_RANGE     3   // offset or count outside the engine registers
+#define CON_ERR_IO        4   // the codec or storage did not answer
+
+// COUNTERS order
+enum {
+    CON_CNT_I2C_DONE,
+    CON_CNT_I2C_RETRIES,
+    CON_CNT_I2C_TIMEOUTS,
+    CON_CNT_I2C_FAILED,
+    CON_CNT_MIDI_STRAY,
+    CON_CNT_SYSEX_OVERFLOWS,
+    CON_CNT_SYSEX_ABORTS,
+    CON_CNT_SUPERSEDED,
+    CON_CNT_EARLY_FLUSHES,
+    CON_CNT_FRAMES,
+    CON_CNT_BAD_FRAMES,
+    CON_CNT_BOOT_READY_US,
+    CON_CNT_FIRST_NOTE_US,
+    NUM_CON_COUNTERS
+};
+
+// received bytes handled per service call
+#define CON_RX_BUDGET     32
+
+/***************************************************************************
+* Type definitions
+****************************************************************************/
+
+typedef struct {
+    u8  buf[CON_MAX_FRAME];
+    u16 len;
+    u8  overflow;
+    u32 frames;      // good frames received
+    u32 bad_frames;  // frames dropped for their length or CRC
+} ConsoleRx;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+u16  conCrc16(const u8 *data, u16 len);
+u16  conCobsEncode(const u8 *in, u16 len, u8 *out);
+int  conCobsDecode(const u8 *in, u16 len, u8 *out);
+u16  conFrame(u8 *msg, u16 len, u8 *frame);
+u16  conRxByte(ConsoleRx *rx, u8 byte, u8 *msg);
+
+void consoleInit(void);
+void consoleService(void);
+
+#endif /* CONSOLE_H_ */
@@ -0,0 +1,387 @@
+/****************************************************************************/
+/**
+* cosim.c
+*
+* This file contains the firmware end of the co-simulation. The firmware
+* boots on the stand-in BSP as in zynthd, but the register stand-in is
+* backed by an engine in another process, served on a Unix socket (see
+* cosim_proto.h), so every synthWrite and synthRead goes over the socket.
+* zynth_engine serves the C engine model, an end for the RTL would speak
+* the same protocol.
+*
+* Raw MIDI bytes are split into messages with the firmware parser and
+* handed to the UART stand-in one message at a time, each followed by a
+* gap of engine time. The wire time of the bytes is run on the engine
+* before the firmware sees them, as a message is only in the UART once
+* its last byte is.
+*
+* The latency of each note on is measured in engine clocks from the start
+* of its first byte on the wire to the first clock the engine output is
+* not zero. That needs the output to be silent when the byte starts, note
+* ons over sounding notes are counted but not timed. The firmware's own
+* run time is not modelled, it runs between two engine clocks, so the
+* clocks are the wire, the register accesses, the wait for the frame
+* boundary and the pipeline. zynth_engine gives register accesses no
+* clocks and times the output to the frame.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Served by zynth_engine, the Verilator end is gone
+*
+****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "xil_io.h"
+#include "xil_printf.h"
+#include "xuartps.h"
+#include "cosim_proto.h"
+#include "../boot/boot.h"
+#include "../midi/midi.h"
+#include "../midi/midi_parser.h"
+
+#define ENGINE_CLK_HZ    12288000
+#define ENGINE_SLOTS     128
+#define ENGINE_FRAME_HZ  (ENGINE_CLK_HZ / ENGINE_SLOTS)
+
+// one MIDI byte on the wire, 10 bits at 31250 baud
+#define WIRE_CLOCKS      (ENGINE_CLK_HZ * 10 / 31250)
+
+#define DEFAULT_GAP_S    0.25
+#define DEFAULT_TAIL_S   1.0
+
+// tries a second apart to connect while the engine starts up
+#define CONNECT_TRIES    30
+
+// bytes handed over at most at once, SysEx longer than this goes in parts
+#define CHUNK_BYTES      256
+
+/***************************************************************************
+* Options and state
+****************************************************************************/
+
+typedef struct {
+    const char *socket;
+    const char *raw;
+    double gap;
+    double tail;
+    int   no_wire;
+    int   verbose;
+} Options;
+
+static int sock = -1;
+static int sock_failed;
+
+// message splitting
+static MidiParser splitter;
+static int msg_done;
+static int msg_note_on;
+
+// results
+static u32 messages, note_ons, not_quiet, timed_out;
+static u32 lat_count;
+static u64 lat_sum;
+static u32 lat_min = ~0U, lat_max;
+
+/***************************************************************************
+* Socket to the engine
+****************************************************************************/
+
+static int openSocket(const char *path) {
+    struct sockaddr_un addr;
+    struct timespec wait = { 1, 0 };
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return XST_FAILURE;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    for (int i = 0; i < CONNECT_TRIES; i ++) {
+        sock = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (sock < 0) {
+            return XST_FAILURE;
+        }
+        if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            return XST_SUCCESS;
+        }
+        close(sock);
+        sock = -1;
+        nanosleep(&wait, NULL);
+    }
+    return XST_FAILURE;
+}
+
+static int sendAll(const void *buf, size_t len) {
+    const char *p = buf;
+
+    while (len) {
+        ssize_t n = write(sock, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return XST_FAILURE;
+        }
+        p += n;
+        len -= n;
+    }
+    return XST_SUCCESS;
+}
+
+static int recvAll(void *buf, size_t len) {
+    char *p = buf;
+
+    while (len) {
+        ssize_t n = read(sock, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return XST_FAILURE;
+        }
+        p += n;
+        len -= n;
+    }
+    return XST_SUCCESS;
+}
+
+// one request and its reply. After the first failure nothing more is sent
+// and the replies read 0, the run ends at the next check of sock_failed.
+static u32 request(u32 op, u32 addr, u32 data) {
+    CosimRequest req = { op, addr, data };
+    CosimReply reply;
+
+    if (sock_failed) {
+        return 0;
+    }
+    if (sendAll(&req, sizeof(req)) || recvAll(&reply, sizeof(reply)) ||
+        reply.status != COSIM_OK) {
+        sock_failed = 1;
+        return 0;
+    }
+    return reply.data;
+}
+
+static void runClocks(u64 clocks) {
+    while (clocks) {
+        u32 n = (clocks > 0x7FFFFFFF) ? 0x7FFFFFFF : (u32)clocks;
+        request(COSIM_RUN, 0, n);
+        clocks -= n;
+    }
+}
+
+/***************************************************************************
+* Engine behind the register stand-in
+****************************************************************************/
+
+static void modelWrite(void *ref, u32 offset, u32 value) {
+    (void)ref;
+    request(COSIM_WRITE, offset, value);
+}
+
+static u32 modelRead(void *ref, u32 offset) {
+    (void)ref;
+    return request(COSIM_READ, offset, 0);
+}
+
+static const HostSynthModel model = { modelWrite, modelRead, NULL };
+
+/***************************************************************************
+* MIDI
+****************************************************************************/
+
+static void onMsg(u8 *msg, u8 len) {
+    msg_done = 1;
+    msg_note_on = len == 3 && (msg[0] & 0xF0) == 0x90 && msg[2];
+}
+
+static void onSysEx(u8 *data, u16 len) {
+    (void)data;
+    (void)len;
+    msg_done = 1;
+}
+
+static void measure(int verbose) {
+    u32 clocks = request(COSIM_LATENCY, 0, 0);
+
+    if (clocks == COSIM_NOT_QUIET) {
+        not_quiet++;
+        return;
+    }
+    if (clocks == COSIM_PENDING) {
+        timed_out++;
+        return;
+    }
+    lat_count++;
+    lat_sum += clocks;
+    lat_min = (clocks < lat_min) ? clocks : lat_min;
+    lat_max = (clocks > lat_max) ? clocks : lat_max;
+    if (verbose) {
+        printf("note on %u: %u clocks, %.1f us\n", note_ons, clocks, 1e6 * clocks / ENGINE_CLK_HZ);
+    }
+}
+
+// one message, or part of a long SysEx, through the UART and the firmware
+// receive path, then the gap
+static void playMessage(const Options *opt, const u8 *bytes, int len) {
+    int timed = 0;
+
+    if (msg_note_on) {
+        note_ons++;
+        timed = 1;
+        request(COSIM_MARK, 0, 0);
+    }
+    if (!opt->no_wire) {
+        runClocks((u64)len * WIRE_CLOCKS);
+    }
+    host_uart_send(bytes, len);
+    XUartPs_InterruptHandler(&MidiPs);
+    rxMidiMsg();
+
+    runClocks((u64)(opt->gap * ENGINE_CLK_HZ));
+    if (timed) {
+        measure(opt->verbose);
+    }
+    messages++;
+}
+
+static int playRaw(const Options *opt) {
+    u8 bytes[CHUNK_BYTES];
+    int len = 0;
+    int fd;
+    u8 b;
+
+    fd = strcmp(opt->raw, "-") ? open(opt->raw, O_RDONLY) : STDIN_FILENO;
+    if (fd < 0) {
+        return XST_FAILURE;
+    }
+    midiParserInit(&splitter, onMsg, onSysEx);
+    while (!sock_failed && read(fd, &b, 1) == 1) {
+        bytes[len++] = b;
+        msg_done = 0;
+        msg_note_on = 0;
+        midiParseByte(&splitter, b);
+        if (msg_done || len == CHUNK_BYTES) {
+            playMessage(opt, bytes, len);
+            len = 0;
+        }
+    }
+    // an unfinished message still goes to the firmware
+    if (len && !sock_failed) {
+        msg_note_on = 0;
+        playMessage(opt, bytes, len);
+    }
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return XST_SUCCESS;
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: zynth_cosim -s socket -i raw [-g seconds] [-t seconds] [-w] [-v]\n"
+            "  -s  Unix socket zynth_engine -c serves the engine on\n"
+            "  -i  raw MIDI bytes from a file, - for stdin\n"
+            "  -g  engine time after each message (%.2f)\n"
+            "  -t  engine time after the last message (%.2f)\n"
+            "  -w  hand bytes over without their wire time\n"
+            "  -v  show the firmware output and each latency\n",
+            DEFAULT_GAP_S, DEFAULT_TAIL_S);
+}
+
+static int parseOptions(int argc, char **argv, Options *opt) {
+    int c;
+
+    memset(opt, 0, sizeof(*opt));
+    opt->gap = DEFAULT_GAP_S;
+    opt->tail = DEFAULT_TAIL_S;
+    while ((c = getopt(argc, argv, "s:i:g:t:wv")) != -1) {
+        switch (c) {
+            case 's': opt->socket = optarg;       break;
+            case 'i': opt->raw = optarg;          break;
+            case 'g': opt->gap = atof(optarg);    break;
+            case 't': opt->tail = atof(optarg);   break;
+            case 'w': opt->no_wire = 1;           break;
+            case 'v': opt->verbose = 1;           break;
+            default:  return XST_FAILURE;
+        }
+    }
+    if (!opt->socket || !opt->raw || opt->gap < 0 || opt->tail < 0) {
+        return XST_FAILURE;
+    }
+    return XST_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    u32 frames;
+
+    if (parseOptions(argc, argv, &opt)) {
+        usage();
+        return 1;
+    }
+    if (openSocket(opt.socket)) {
+        fprintf(stderr, "zynth_cosim: could not connect to %s\n", opt.socket);
+        return 1;
+    }
+
+    // the firmware boots against the engine
+    host_synth_model = &model;
+    host_printf_mute = !opt.verbose;
+    if (bootSystem(0) || sock_failed) {
+        fprintf(stderr, "zynth_cosim: boot failed\n");
+        return 1;
+    }
+
+    if (playRaw(&opt)) {
+        fprintf(stderr, "zynth_cosim: could not open %s\n", opt.raw);
+        return 1;
+    }
+    runClocks((u64)(opt.tail * ENGINE_CLK_HZ));
+    frames = request(COSIM_QUIT, 0, 0);
+    close(sock);
+    if (sock_failed) {
+        fprintf(stderr, "zynth_cosim: lost the engine\n");
+        return 1;
+    }
+
+    printf("%u messages, %u frames, %.2f s of engine time\n",
+           messages, frames, (double)frames / ENGINE_FRAME_HZ);
+    printf("note on latency, wire %s: ", opt.no_wire ? "excluded" : "included");
+    if (lat_count) {
+        printf("%u timed, clocks min %u mean %llu max %u, us min %.1f max %.1f\n",
+               lat_count, lat_min, (unsigned long long)(lat_sum / lat_count), lat_max,
+               1e6 * lat_min / ENGINE_CLK_HZ, 1e6 * lat_max / ENGINE_CLK_HZ);
+    } else {
+        printf("none timed\n");
+    }
+    if (not_quiet) {
+        printf("%u note ons over sounding notes, not timed\n", not_quiet);
+    }
+    // a note on the engine never played is a failure
+    if (timed_out) {
+        printf("FAIL: %u note ons still silent after the gap\n", timed_out);
+        return 1;
+    }
+    return 0;
+}
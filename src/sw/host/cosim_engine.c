@@ -0,0 +1,294 @@
+/****************************************************************************/
+/**
+* cosim_engine.c
+*
+* This file contains the engine end of the firmware co-simulation, the C
+* engine model served on a Unix socket (see cosim_proto.h). zynth_cosim
+* connects and its register accesses become engineWrite and engineRead
+* calls, and its clock runs render the model and write the audio out.
+*
+* The model renders whole frames, so clocks are kept as a count and a
+* frame is rendered once the count passes its end. A register access takes
+* no clocks of its own and lands between two frames, which is where the
+* engine would copy it anyway. The output of a frame counts from the last
+* clock of that frame, so latencies are whole frames less the clocks
+* between the mark and the start of its frame.
+*
+* This is the engine as the C model has it, not the RTL. It checks the
+* firmware, the socket protocol and the audio path end to end, not the
+* VHDL.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "engine_model.h"
+#include "host_sink.h"
+#include "cosim_proto.h"
+
+/***************************************************************************
+* Options and state
+****************************************************************************/
+
+typedef struct {
+    const char *socket;
+    const char *wav;
+} Options;
+
+static Engine engine;
+static HostSink sink;
+
+static u64 clocks;          // clocks run so far
+static s32 last_l, last_r;  // output of the last frame rendered
+static u32 peak;            // largest output magnitude written
+
+// latency measurement
+static int marked;
+static int quiet;
+static u64 mark_clock;
+static s64 latency_clocks = -1;
+
+/***************************************************************************
+* Socket
+****************************************************************************/
+
+static int readFull(int fd, void *buf, size_t len) {
+    char *p = buf;
+
+    while (len) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return XST_FAILURE;
+        }
+        p += n;
+        len -= n;
+    }
+    return XST_SUCCESS;
+}
+
+static int writeFull(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+
+    while (len) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return XST_FAILURE;
+        }
+        p += n;
+        len -= n;
+    }
+    return XST_SUCCESS;
+}
+
+static int listenOn(const char *path) {
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "%s: socket path too long\n", path);
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) || listen(fd, 1)) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/***************************************************************************
+* Engine
+****************************************************************************/
+
+static u32 magnitude(s32 x) {
+    return (x < 0) ? (u32)-x : (u32)x;
+}
+
+// the frames ending in the next n clocks, into the sink
+static void runClocks(u32 n) {
+    static s32 out[2 * ENG_MAX_BLOCK];
+    u64 first = clocks / ENG_SLOTS;
+    u64 frames = (clocks + n) / ENG_SLOTS - first;
+
+    while (frames) {
+        int block = (frames > ENG_MAX_BLOCK) ? ENG_MAX_BLOCK : (int)frames;
+
+        engineRun(&engine, out, block);
+        for (int i = 0; i < block; i ++) {
+            s32 l = out[2 * i], r = out[2 * i + 1];
+
+            if (marked && (l || r)) {
+                latency_clocks = (s64)((first + i + 1) * ENG_SLOTS - 1 - mark_clock);
+                marked = 0;
+            }
+            peak = (magnitude(l) > peak) ? magnitude(l) : peak;
+            peak = (magnitude(r) > peak) ? magnitude(r) : peak;
+            last_l = l;
+            last_r = r;
+        }
+        sink.write(&sink, out, block);
+        first += block;
+        frames -= block;
+    }
+    clocks += n;
+}
+
+// one request, 0 once the client has quit
+static int handle(const CosimRequest *req, CosimReply *reply) {
+    reply->status = COSIM_OK;
+    reply->data = 0;
+
+    switch (req->op) {
+        case COSIM_WRITE:
+            engineWrite(&engine, req->addr, req->data);
+            break;
+        case COSIM_READ:
+            reply->data = engineRead(&engine, req->addr);
+            break;
+        case COSIM_RUN:
+            runClocks(req->data);
+            break;
+        case COSIM_MARK:
+            quiet = !last_l && !last_r;
+            marked = quiet;
+            mark_clock = clocks;
+            latency_clocks = -1;
+            reply->data = quiet;
+            break;
+        case COSIM_LATENCY:
+            if (latency_clocks >= 0) {
+                reply->data = (u32)latency_clocks;
+            } else {
+                reply->data = quiet ? COSIM_PENDING : COSIM_NOT_QUIET;
+            }
+            break;
+        case COSIM_QUIT:
+            reply->data = (u32)(clocks / ENG_SLOTS);
+            return 0;
+        default:
+            reply->status = COSIM_BAD_OP;
+            break;
+    }
+    return 1;
+}
+
+// serves one client until it quits or hangs up
+static int serve(const char *path) {
+    CosimRequest req;
+    CosimReply reply;
+    int running = 1;
+    int lfd, fd;
+
+    lfd = listenOn(path);
+    if (lfd < 0) {
+        return XST_FAILURE;
+    }
+    printf("waiting for the firmware on %s\n", path);
+    fflush(stdout);
+    do {
+        fd = accept(lfd, NULL, NULL);
+    } while (fd < 0 && errno == EINTR);
+    close(lfd);
+    unlink(path);
+    if (fd < 0) {
+        perror("accept");
+        return XST_FAILURE;
+    }
+
+    while (running && readFull(fd, &req, sizeof(req)) == XST_SUCCESS) {
+        running = handle(&req, &reply);
+        if (writeFull(fd, &reply, sizeof(reply))) {
+            break;
+        }
+    }
+    close(fd);
+    return XST_SUCCESS;
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: zynth_engine -c socket [-o out.wav]\n"
+            "  -c  Unix socket to serve zynth_cosim on\n"
+            "  -o  write the audio, 24 bit stereo at %d Hz\n",
+            ENG_FRAME_HZ);
+}
+
+static int parseOptions(int argc, char **argv, Options *opt) {
+    int c;
+
+    memset(opt, 0, sizeof(*opt));
+    while ((c = getopt(argc, argv, "c:o:")) != -1) {
+        switch (c) {
+            case 'c': opt->socket = optarg;   break;
+            case 'o': opt->wav = optarg;      break;
+            default:  return XST_FAILURE;
+        }
+    }
+    return opt->socket ? XST_SUCCESS : XST_FAILURE;
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    int status = XST_SUCCESS;
+
+    if (parseOptions(argc, argv, &opt)) {
+        usage();
+        return 1;
+    }
+    if (opt.wav) {
+        status = hostSinkWav(&sink, opt.wav, ENG_FRAME_HZ);
+    } else {
+        hostSinkNull(&sink, ENG_FRAME_HZ);
+    }
+    if (status) {
+        fprintf(stderr, "zynth_engine: could not open %s\n", opt.wav);
+        return 1;
+    }
+
+    engineInit(&engine);
+    status = serve(opt.socket);
+    sink.close(&sink);
+    if (status) {
+        return 1;
+    }
+
+    printf("%llu frames out, peak %u of %u", (unsigned long long)sink.frames,
+           peak, 1U << (ENG_OUT_BITS - 1));
+    printf("%s%s\n", opt.wav ? " into " : "", opt.wav ? opt.wav : "");
+    return 0;
+}
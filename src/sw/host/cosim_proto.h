@@ -0,0 +1,52 @@
+#ifndef COSIM_PROTO_H_
+#define COSIM_PROTO_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+
+/*
+ * Messages between the host firmware (zynth_cosim) and the engine end
+ * (zynth_engine), over a Unix stream socket. Every request is answered
+ * before the next is sent, so the engine only runs when the firmware tells
+ * it to and the two never race. Words are in host order,
+ * both ends run on the same machine.
+ */
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+#define COSIM_WRITE     1   // AXI write of data to addr
+#define COSIM_READ      2   // AXI read of addr, the reply data is the word
+#define COSIM_RUN       3   // run data engine clocks
+#define COSIM_MARK      4   // start a latency measurement at this clock
+#define COSIM_LATENCY   5   // reply data is the last measurement
+#define COSIM_QUIT      6   // reply data is the frames run, then close
+
+// status of a reply
+#define COSIM_OK        0
+#define COSIM_BAD_OP    1
+
+// latency replies while there is no measurement
+#define COSIM_PENDING   0xFFFFFFFF  // marked, no sample since
+#define COSIM_NOT_QUIET 0xFFFFFFFE  // the output was not silent at the mark
+
+/***************************************************************************
+* Type definitions
+****************************************************************************/
+
+typedef struct {
+    u32 op;
+    u32 addr;
+    u32 data;
+} CosimRequest;
+
+typedef struct {
+    u32 status;
+    u32 data;
+} CosimReply;
+
+#endif /* COSIM_PROTO_H_ */
@@ -0,0 +1,861 @@
+/****************************************************************************/
+/**
+* engine_model.c
+*
+* This file contains a behavioral model of the synth engine for the host.
+* It takes the same register writes as the AXI interface and renders the
+* same samples: every scaler, wrap and saturation follows the VHDL, so a
+* note played through the firmware on the host sounds as it does on the
+* board.
+*
+* The model steps a frame at a time where the engine steps a clock at a
+* time. Controls that the engine updates one timbre per clock after the
+* frame tick (slew, lfos and the modulation matrix) are updated in that
+* order at the start of the frame, and take effect for all of it. A glide
+* start takes the increment its source slot had at the end of the last
+* frame, where the engine takes it as it reaches the slot. Neither moves a sample by more than a frame.
+*
+* A block is rendered in three steps so the slots can be split across
+* threads: engineControl() commits the registers and works out the
+* controls of each frame, engineRenderSlots() runs a range of slots
+* through the pipeline into a partial mix, and engineOutput() scales the
+* sum of the partial mixes. Only the middle step touches slot state.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Glide starts kept per slot as the engine keeps them
+*
+****************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include <math.h>
+#include <string.h>
+
+#include "engine_model.h"
+#include "../midi/pitch.h"
+
+// register regions and settings offsets, see synth_pkg.vhd
+#define REGION_NOTE_AMP    0
+#define REGION_SETTINGS    1
+#define REGION_PH_INC      2
+#define REGION_NOTE_PAN    3
+#define REGION_NOTE_TIMBRE 4
+#define REGION_TIMBRE_BANK 5
+#define REGION_NOTE_PRESS  6
+
+#define OFF_PULSE_WIDTH    0
+#define OFF_SINE           5
+#define OFF_GAIN_SHIFT     8
+#define OFF_GAIN_SCALE     9
+#define OFF_ATTACK         32
+#define OFF_RELEASE        35
+#define OFF_SLEW_RATE      40
+#define OFF_GLIDE_RATE     41
+#define OFF_GLIDE          42
+#define OFF_LFO0           48
+#define OFF_LFO3           51
+#define OFF_PRESS          56
+#define OFF_NOTE_PACK      64
+#define OFF_NOTE_GATE0     96
+#define OFF_NOTE_GATE3     99
+#define OFF_GATE_VEL       100
+#define OFF_NOTE_CTRL      101
+#define OFF_PEDAL          102
+#define OFF_ACTIVE0        104
+#define OFF_ACTIVE3        107
+#define OFF_REV            120
+#define OFF_DATE           121
+#define OFF_WRAPBACK       127
+
+// timbre bank registers
+#define TB_PW              0
+#define TB_PULSE           1
+#define TB_SINE            5
+#define TB_LEVEL           6
+#define TB_MOD_SRC         7
+#define TB_ATTACK          8
+#define TB_DECAY           9
+#define TB_SUSTAIN         10
+#define TB_RELEASE         11
+#define TB_MOD_PITCH       12
+
+#define CTRL_HOLD          0x1
+#define CTRL_RELEASE_ALL   0x2
+#define GLIDE_START_BIT    0x8000
+
+#define MASK7              0x7F
+#define ADSR_MASK          0xFFFFF
+#define SLEW_FRAC          16
+#define GLIDE_SHIFT_BASE   7
+#define PITCH_MOD_SHIFT    18
+
+enum { I_PULSE, I_RAMP, I_SAW, I_TRI, I_SINE };
+enum { E_START, E_ATTACK, E_DECAY, E_SUSTAIN, E_RELEASE };
+enum { LFO_SINE, LFO_TRI, LFO_SAH, LFO_SQUARE };
+
+/***************************************************************************
+* Sine tables, as sine_lut_interp.vhd builds them
+****************************************************************************/
+
+// wave sine, 16 phase bits: 10 into a 257 entry quarter wave, 6 interpolated
+#define SINE_ADDR_BITS 8
+#define SINE_FRAC_BITS 6
+static u16 sine_table[(1 << SINE_ADDR_BITS) + 1];
+static u16 slope_table[(1 << SINE_ADDR_BITS) + 1];
+
+// lfo sine, 8 phase bits into a 65 entry quarter wave
+#define LFO_ADDR_BITS 6
+static u8 lfo_table[(1 << LFO_ADDR_BITS) + 1];
+
+static void buildTables(void) {
+    int size = 1 << SINE_ADDR_BITS;
+
+    for (int i = 0; i <= size; i ++) {
+        sine_table[i] = (u16)round(32767.0 * sin(M_PI / 2 * i / size));
+    }
+    for (int i = 0; i < size; i ++) {
+        slope_table[i] = sine_table[i + 1] - sine_table[i];
+    }
+    size = 1 << LFO_ADDR_BITS;
+    for (int i = 0; i <= size; i ++) {
+        lfo_table[i] = (u8)round(127.0 * sin(M_PI / 2 * i / size));
+    }
+}
+
+/***************************************************************************
+* Datapath helpers
+****************************************************************************/
+
+// scaler.vhd: sum of x shifted right once for each gain bit below the top,
+// then halved. Unsigned inputs go through the same sum.
+static inline s32 scale(s32 x, u32 gain, int gain_bits) {
+    s32 sum = 0;
+
+    while (gain) {
+        int b = 31 - __builtin_clz(gain);
+        sum += x >> (gain_bits - 1 - b);
+        gain ^= 1u << b;
+    }
+    return sum >> 1;
+}
+
+static inline s32 sext24(u32 x) {
+    return (s32)(x << (32 - ENG_OUT_BITS)) >> (32 - ENG_OUT_BITS);
+}
+
+static inline s16 sineInterp(u16 phase) {
+    u32 quarter = phase & 0x3FFF;
+    u32 pos = (phase & 0x4000) ? 0x4000 - quarter : quarter;
+    u32 addr = pos >> SINE_FRAC_BITS;
+    u32 frac = pos & ((1 << SINE_FRAC_BITS) - 1);
+    s32 sine = sine_table[addr] +
+               ((slope_table[addr] * frac + (1 << (SINE_FRAC_BITS - 1))) >> SINE_FRAC_BITS);
+
+    return (phase & 0x8000) ? sine : -sine;
+}
+
+static inline u16 lfsrStep(u16 x) {
+    return (u16)((x << 1) | (((x >> 15) ^ (x >> 13) ^ (x >> 12) ^ (x >> 10)) & 1));
+}
+
+/***************************************************************************
+* Registers
+****************************************************************************/
+
+static void writeTimbre(EngineRegs *r, u32 t, u32 param, u32 value) {
+    if (param == TB_PW) {
+        r->pw[t] = value & 0xFFFF;
+    } else if (param >= TB_PULSE && param <= TB_SINE) {
+        r->amps[t][param - TB_PULSE] = value & MASK7;
+        r->phs[t][param - TB_PULSE] = value >> 16;
+    } else if (param == TB_LEVEL) {
+        r->lvl[t] = value & MASK7;
+    } else if (param == TB_MOD_SRC) {
+        for (int d = 0; d < ENG_MOD_DESTS; d ++) {
+            r->mod_sel[t][d] = (value >> (8 * d)) & (ENG_LFOS - 1);
+        }
+    } else if (param == TB_ATTACK) {
+        r->attack[t] = value & ADSR_MASK;
+    } else if (param == TB_DECAY) {
+        r->decay[t] = value & ADSR_MASK;
+    } else if (param == TB_SUSTAIN) {
+        r->sustain[t] = value & ADSR_MASK;
+    } else if (param == TB_RELEASE) {
+        r->release[t] = value & ADSR_MASK;
+    } else {
+        r->mod_dep[t][param - TB_MOD_PITCH] = value & MASK7;
+    }
+}
+
+static u32 readTimbre(const EngineRegs *r, u32 t, u32 param) {
+    if (param == TB_PW) {
+        return r->pw[t];
+    } else if (param >= TB_PULSE && param <= TB_SINE) {
+        return r->amps[t][param - TB_PULSE] | ((u32)r->phs[t][param - TB_PULSE] << 16);
+    } else if (param == TB_LEVEL) {
+        return r->lvl[t];
+    } else if (param == TB_MOD_SRC) {
+        u32 data = 0;
+        for (int d = 0; d < ENG_MOD_DESTS; d ++) {
+            data |= (u32)r->mod_sel[t][d] << (8 * d);
+        }
+        return data;
+    } else if (param == TB_ATTACK) {
+        return r->attack[t];
+    } else if (param == TB_DECAY) {
+        return r->decay[t];
+    } else if (param == TB_SUSTAIN) {
+        return r->sustain[t];
+    } else if (param == TB_RELEASE) {
+        return r->release[t];
+    }
+    return r->mod_dep[t][param - TB_MOD_PITCH];
+}
+
+// timbre 0 register of a settings offset, the adsr registers are 32 to 35
+static u32 settingsParam(u32 off) {
+    return (off >= OFF_ATTACK) ? TB_ATTACK + (off - OFF_ATTACK) : off;
+}
+
+static void writeSettings(EngineRegs *r, u32 off, u32 value) {
+    if (off >= OFF_NOTE_PACK && off < OFF_NOTE_GATE0) {
+        for (int j = 0; j < 4; j ++) {
+            r->note_amps[4 * (off - OFF_NOTE_PACK) + j] = (value >> (8 * j)) & MASK7;
+        }
+    } else if (off >= OFF_PRESS && off < OFF_NOTE_PACK) {
+        r->timbre_press[off - OFF_PRESS] = value & MASK7;
+        r->press_depths[off - OFF_PRESS] = (value >> 8) & MASK7;
+    } else if (off <= OFF_SINE || (off >= OFF_ATTACK && off <= OFF_RELEASE)) {
+        writeTimbre(r, 0, settingsParam(off), value);
+    } else if (off >= OFF_LFO0 && off <= OFF_LFO3) {
+        r->lfo_rates[off - OFF_LFO0] = value & 0xFFFF;
+        r->lfo_shapes[off - OFF_LFO0] = (value >> 16) & 0x3;
+    } else if (off >= OFF_NOTE_GATE0 && off <= OFF_NOTE_GATE3) {
+        for (int j = 0; j < 32; j ++) {
+            r->note_amps[32 * (off - OFF_NOTE_GATE0) + j] =
+                ((value >> j) & 1) ? (r->gate_vel & MASK7) : 0;
+        }
+    } else {
+        switch (off) {
+            case OFF_GAIN_SCALE: r->out_amp    = value; break;
+            case OFF_GAIN_SHIFT: r->out_shift  = value; break;
+            case OFF_SLEW_RATE:  r->slew_rate  = value; break;
+            case OFF_GLIDE_RATE: r->glide_rate = value; break;
+            case OFF_GLIDE:
+                r->glide = value;
+                // each target slot keeps its own start, a second one
+                // before the frame replaces the first
+                if (value & GLIDE_START_BIT) {
+                    r->glide_from[value & MASK7] = (value >> 8) & MASK7;
+                    r->glide_pend[value & MASK7] = 1;
+                }
+                break;
+            case OFF_GATE_VEL:   r->gate_vel   = value; break;
+            case OFF_PEDAL:      r->pedal      = value; break;
+            case OFF_WRAPBACK:   r->wrapback   = value; break;
+            case OFF_NOTE_CTRL:
+                r->note_ctrl = value;
+                // release all is a command, silence every note in one write
+                if (value & CTRL_RELEASE_ALL) {
+                    memset(r->note_amps, 0, sizeof(r->note_amps));
+                    r->release_pending = 1;
+                    r->note_ctrl &= ~CTRL_RELEASE_ALL;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static u32 readSettings(const Engine *e, u32 off) {
+    const EngineRegs *r = &e->regs;
+    u32 data = 0;
+
+    if (off >= OFF_NOTE_PACK && off < OFF_NOTE_GATE0) {
+        for (int j = 0; j < 4; j ++) {
+            data |= (u32)r->note_amps[4 * (off - OFF_NOTE_PACK) + j] << (8 * j);
+        }
+    } else if (off >= OFF_PRESS && off < OFF_NOTE_PACK) {
+        data = r->timbre_press[off - OFF_PRESS] | ((u32)r->press_depths[off - OFF_PRESS] << 8);
+    } else if (off <= OFF_SINE || (off >= OFF_ATTACK && off <= OFF_RELEASE)) {
+        data = readTimbre(r, 0, settingsParam(off));
+    } else if (off >= OFF_LFO0 && off <= OFF_LFO3) {
+        data = r->lfo_rates[off - OFF_LFO0] | ((u32)r->lfo_shapes[off - OFF_LFO0] << 16);
+    } else if (off >= OFF_NOTE_GATE0 && off <= OFF_NOTE_GATE3) {
+        for (int j = 0; j < 32; j ++) {
+            data |= (u32)(r->note_amps[32 * (off - OFF_NOTE_GATE0) + j] != 0) << j;
+        }
+    } else if (off >= OFF_ACTIVE0 && off <= OFF_ACTIVE3) {
+        for (int j = 0; j < 32; j ++) {
+            data |= (u32)e->slots[32 * (off - OFF_ACTIVE0) + j].active << j;
+        }
+    } else {
+        switch (off) {
+            case OFF_GAIN_SCALE: data = r->out_amp;    break;
+            case OFF_GAIN_SHIFT: data = r->out_shift;  break;
+            case OFF_SLEW_RATE:  data = r->slew_rate;  break;
+            case OFF_GLIDE_RATE: data = r->glide_rate; break;
+            case OFF_GLIDE:      data = r->glide;      break;
+            case OFF_GATE_VEL:   data = r->gate_vel;   break;
+            case OFF_NOTE_CTRL:  data = r->note_ctrl;  break;
+            case OFF_PEDAL:      data = r->pedal;      break;
+            case OFF_REV:        data = ENG_REV;       break;
+            case OFF_DATE:       data = ENG_DATE;      break;
+            case OFF_WRAPBACK:   data = r->wrapback;   break;
+            default:             break;
+        }
+    }
+    return data;
+}
+
+/***************************************************************************/
+/**
+* This function resets the engine, as the reset input does.
+*
+* @param  e is the engine
+*
+****************************************************************************/
+void engineInit(Engine *e) {
+    EngineRegs *r = &e->regs;
+
+    if (sine_table[1 << SINE_ADDR_BITS] == 0) {
+        buildTables();
+    }
+
+    memset(e, 0, sizeof(*e));
+    memset(r->note_pans, 64, sizeof(r->note_pans));
+    memset(r->lvl, MASK7, sizeof(r->lvl));
+    for (int t = 0; t < ENG_TIMBRES; t ++) {
+        for (int d = 0; d < ENG_MOD_DESTS; d ++) {
+            r->mod_sel[t][d] = d % ENG_LFOS;
+        }
+    }
+    memcpy(r->freq_words, FreqWordDefaults, sizeof(r->freq_words));
+    memcpy(e->freq_out, FreqWordDefaults, sizeof(e->freq_out));
+    e->lfsr = 0xACE1;
+}
+
+/***************************************************************************/
+/**
+* This function writes an engine register.
+*
+* @param  e is the engine
+* @param  offset is the byte offset from the engine base address
+* @param  value is written with every byte lane enabled
+*
+* @note   Not while a block is rendering.
+*
+****************************************************************************/
+void engineWrite(Engine *e, u32 offset, u32 value) {
+    EngineRegs *r = &e->regs;
+    u32 region = offset >> 9;
+    u32 off = (offset >> 2) & 0x7F;
+
+    switch (region) {
+        case REGION_NOTE_AMP:    r->note_amps[off] = value & MASK7;          break;
+        case REGION_SETTINGS:    writeSettings(r, off, value);               break;
+        case REGION_PH_INC:      r->freq_words[off] = value;                 break;
+        case REGION_NOTE_PAN:    r->note_pans[off] = value & MASK7;          break;
+        case REGION_NOTE_TIMBRE: r->note_timbres[off] = value & (ENG_TIMBRES - 1); break;
+        case REGION_NOTE_PRESS:  r->note_press[off] = value & MASK7;         break;
+        case REGION_TIMBRE_BANK: writeTimbre(r, off >> 4, off & 0xF, value); break;
+        default:                 break;
+    }
+}
+
+/***************************************************************************/
+/**
+* This function reads an engine register.
+*
+* @param  e is the engine
+* @param  offset is the byte offset from the engine base address
+*
+* @return the register
+*
+****************************************************************************/
+u32 engineRead(const Engine *e, u32 offset) {
+    const EngineRegs *r = &e->regs;
+    u32 region = offset >> 9;
+    u32 off = (offset >> 2) & 0x7F;
+
+    switch (region) {
+        case REGION_NOTE_AMP:    return r->note_amps[off];
+        case REGION_SETTINGS:    return readSettings(e, off);
+        case REGION_PH_INC:      return r->freq_words[off];
+        case REGION_NOTE_PAN:    return r->note_pans[off];
+        case REGION_NOTE_TIMBRE: return r->note_timbres[off];
+        case REGION_NOTE_PRESS:  return r->note_press[off];
+        case REGION_TIMBRE_BANK: return readTimbre(r, off >> 4, off & 0xF);
+        default:                 return 0;
+    }
+}
+
+/***************************************************************************
+* Frame controls
+****************************************************************************/
+
+// note amplitudes, tuning, pedals and glide starts go out together on the
+// frame boundary unless held
+static void commitFrame(Engine *e) {
+    EngineRegs *r = &e->regs;
+
+    if ((r->note_ctrl & CTRL_HOLD) && !r->release_pending) {
+        return;
+    }
+    memcpy(e->note_amps_out, r->note_amps, sizeof(e->note_amps_out));
+    memcpy(e->freq_out, r->freq_words, sizeof(e->freq_out));
+    e->pedal_out = r->pedal;
+    r->release_pending = 0;
+
+    for (int n = 0; n < ENG_SLOTS; n ++) {
+        if (r->glide_pend[n]) {
+            e->slots[n].glide_inc = e->slots[r->glide_from[n]].cur_inc;
+            e->slots[n].glide_pending = 1;
+            r->glide_pend[n] = 0;
+        }
+    }
+    r->glide &= ~GLIDE_START_BIT;
+}
+
+// param_slew.vhd, one-pole step towards the target
+static inline void slew(u32 *value, u32 target, u32 rate) {
+    s64 diff = ((s64)target << SLEW_FRAC) - *value;
+    s64 step = diff >> rate;
+
+    if (rate == 0 || step == 0 || step == -1) {
+        *value = target << SLEW_FRAC;
+    } else {
+        *value += (s32)step;
+    }
+}
+
+static void slewFrame(Engine *e, int zero_rates) {
+    const EngineRegs *r = &e->regs;
+    u32 wfrm = r->slew_rate & 0xF;
+    u32 out = (r->slew_rate >> 8) & 0xF;
+    u32 pw = (r->slew_rate >> 16) & 0xF;
+
+    // a zero rate follows the target every clock, the others step once a
+    // frame after the modulation matrix has read them
+    if ((wfrm == 0) == zero_rates) {
+        for (int t = 0; t < ENG_TIMBRES; t ++) {
+            for (int i = 0; i < ENG_WAVES; i ++) {
+                slew(&e->slew_amps[t][i], r->amps[t][i], wfrm);
+            }
+        }
+    }
+    if ((pw == 0) == zero_rates) {
+        for (int t = 0; t < ENG_TIMBRES; t ++) {
+            slew(&e->slew_pw[t], r->pw[t], pw);
+        }
+    }
+    if ((out == 0) == zero_rates) {
+        slew(&e->slew_out, r->out_amp & MASK7, out);
+    }
+}
+
+// lfo_bank.vhd, lfsr is the noise source as this lfo reads it
+static void lfoUpdate(Engine *e, int i, u16 lfsr) {
+    u32 sum = e->lfo_phase[i] + e->regs.lfo_rates[i];
+    u32 phase = sum & 0xFFFFFF;
+    u32 p8 = phase >> 16;
+    u32 mag;
+
+    switch (e->regs.lfo_shapes[i]) {
+        case LFO_SINE: {
+            u32 q = p8 & 0x3F;
+            s32 sine = lfo_table[(p8 & 0x40) ? 64 - q : q];
+            e->lfo_out[i] = (p8 & 0x80) ? sine : -sine;
+            break;
+        }
+        case LFO_TRI:
+            mag = (phase >> 15) & 0xFF;
+            if (phase & 0x800000) {
+                mag = ~mag & 0xFF;
+            }
+            e->lfo_out[i] = (s8)(mag ^ 0x80);
+            break;
+        case LFO_SAH:
+            if (sum >> 24) {
+                e->lfo_out[i] = (s8)(lfsr & 0xFF);
+            }
+            break;
+        default:
+            e->lfo_out[i] = (phase & 0x800000) ? -127 : 127;
+            break;
+    }
+    e->lfo_phase[i] = phase;
+}
+
+// mod_matrix.vhd for one timbre, from the slewed controls
+static void modTimbre(Engine *e, int t) {
+    const EngineRegs *r = &e->regs;
+    EngineFrame *m = &e->mod;
+    s32 amt[ENG_MOD_DESTS];
+
+    for (int d = 0; d < ENG_MOD_DESTS; d ++) {
+        amt[d] = e->lfo_out[r->mod_sel[t][d]] * r->mod_dep[t][d];
+    }
+    m->pitch[t] = amt[0];
+
+    // tremolo, unipolar lfo times depth takes up to 253/256 off the level
+    u32 dip = ((u8)e->lfo_out[r->mod_sel[t][1]] ^ 0x80) * r->mod_dep[t][1];
+    u32 gain = 256 - (dip >> 7);
+    m->lvl[t] = ((r->lvl[t] * gain) >> 8) & MASK7;
+
+    // pulse width, saturated at either end
+    s32 pw = (s32)(e->slew_pw[t] >> SLEW_FRAC) + 2 * amt[2];
+    m->pw[t] = (pw < 0) ? 0 : (pw > 0xFFFF) ? 0xFFFF : pw;
+
+    // waveform mix, bright waves up and smooth waves down for a positive lfo
+    s32 shift = amt[3] >> 7;
+    for (int i = 0; i < ENG_WAVES; i ++) {
+        s32 g = (i == I_TRI || i == I_SINE) ? 128 - shift : 128 + shift;
+        s32 amp = ((s32)(e->slew_amps[t][i] >> SLEW_FRAC) * g) >> 7;
+        m->amps[t][i] = (amp > MASK7) ? MASK7 : (amp & MASK7);
+    }
+}
+
+/***************************************************************************/
+/**
+* This function commits the registers and works out the controls of each
+* frame of the next block.
+*
+* @param  e is the engine
+* @param  frames is the block length, up to ENG_MAX_BLOCK
+*
+* @note   Writes between blocks take effect on the first frame.
+*
+****************************************************************************/
+void engineControl(Engine *e, int frames) {
+    if (frames > ENG_MAX_BLOCK) {
+        frames = ENG_MAX_BLOCK;
+    }
+    e->frames = frames;
+
+    for (int f = 0; f < frames; f ++) {
+        if (f == 0) {
+            commitFrame(e);
+        }
+        slewFrame(e, 1);
+
+        // timbre t is updated the clock after lfo t-1, one lfo a clock
+        u16 lfsr = e->lfsr;
+        for (int t = 0; t < ENG_TIMBRES; t ++) {
+            modTimbre(e, t);
+            if (t < ENG_LFOS) {
+                lfoUpdate(e, t, lfsr);
+                lfsr = lfsrStep(lfsr);
+            }
+        }
+        for (int i = 0; i < ENG_SLOTS; i ++) {
+            e->lfsr = lfsrStep(e->lfsr);
+        }
+
+        slewFrame(e, 0);
+        e->ctl[f] = e->mod;
+        e->ctl[f].out_amp = e->slew_out >> SLEW_FRAC;
+    }
+}
+
+/***************************************************************************
+* Slots
+****************************************************************************/
+
+// phase_to_wave.vhd, the five scaled waveforms summed
+static inline s16 waveMix(u32 phase32, const EngineFrame *ctl, const EngineRegs *r, int t) {
+    u16 phase = phase32 >> 16;
+    const u8 *amps = ctl->amps[t];
+    const u16 *phs = r->phs[t];
+    s32 mix = 0;
+
+    if (amps[I_PULSE]) {
+        s32 pulse = (u16)(phase + phs[I_PULSE]) < ctl->pw[t] ? 32767 : -32768;
+        mix += scale(pulse, amps[I_PULSE], 7);
+    }
+    if (amps[I_RAMP]) {
+        mix += scale((s16)(u16)(phase + 0x8000 + phs[I_RAMP]), amps[I_RAMP], 7);
+    }
+    if (amps[I_SAW]) {
+        mix += scale((s16)(u16)(phs[I_SAW] - phase), amps[I_SAW], 7);
+    }
+    if (amps[I_TRI]) {
+        u16 tri_ph = phase + phs[I_TRI];
+        u16 pre = (tri_ph & 0x4000) ? (u16)~(tri_ph << 1) : (u16)(tri_ph << 1);
+        s16 tri = (tri_ph & 0x8000) ? (s16)pre : (s16)(u16)(0 - pre);
+        mix += scale(tri, amps[I_TRI], 7);
+    }
+    if (amps[I_SINE]) {
+        mix += scale(sineInterp((u16)(phase + phs[I_SINE] + 0x8000)), amps[I_SINE], 7);
+    }
+    return (s16)(u16)mix;
+}
+
+/***************************************************************************/
+/**
+* This function runs a range of slots through the pipeline for the block
+* set up by engineControl() and adds them to a mix.
+*
+* @param  e is the engine
+* @param  first is the first slot
+* @param  last is one past the last slot
+* @param  mix_l and mix_r are frames long, the slots are added in
+*
+* @note   Ranges that do not overlap can run at the same time.
+*
+****************************************************************************/
+void engineRenderSlots(Engine *e, int first, int last, s32 *mix_l, s32 *mix_r) {
+    const EngineRegs *r = &e->regs;
+    int frames = e->frames;
+
+    for (int s = first; s < last; s ++) {
+        EngineSlot sl = e->slots[s];
+        int t = r->note_timbres[s];
+        u32 amp = e->note_amps_out[s];
+        u32 table_inc = e->freq_out[s];
+        u32 glide_rate = (r->glide_rate >> (4 * t)) & 0xF;
+        u32 sus_pedal = (e->pedal_out >> t) & 1;
+        u32 sost_pedal = (e->pedal_out >> (8 + t)) & 1;
+        u32 pan = r->note_pans[s];
+
+        // pressure gain of poly_mix.vhd
+        u32 press = (r->note_press[s] > r->timbre_press[t]) ? r->note_press[s] : r->timbre_press[t];
+        u32 press_gain = 128 - ((r->press_depths[t] * (~press & MASK7)) >> 7);
+
+        // an idle slot only moves its phase
+        if (sl.state == E_START && sl.acc == 0 && amp == 0 &&
+            !sl.glide_pending && (!sl.gliding || glide_rate == 0)) {
+            for (int f = 0; f < frames; f ++) {
+                sl.phase += table_inc + (u32)(s32)(((s64)table_inc * e->ctl[f].pitch[t]) >> PITCH_MOD_SHIFT);
+            }
+            sl.cur_inc = table_inc;
+            sl.gliding = 0;
+            sl.amp_q = 0;
+            sl.active = 0;
+            if (!sost_pedal) {
+                sl.sost_held = 0;
+            }
+            sl.sost_seen = sost_pedal;
+            e->slots[s] = sl;
+            continue;
+        }
+
+        // envelope steps for the velocity playing
+        u32 steps_q = ~0u;
+        u32 step_attack = 0, step_decay = 0, step_release = 0, sustain_level = 0;
+
+        for (int f = 0; f < frames; f ++) {
+            const EngineFrame *ctl = &e->ctl[f];
+            u32 inc;
+
+            // phase accumulator, the glide steps the increment toward the
+            // table, the +1 keeps the smallest increments moving
+            if (sl.glide_pending && glide_rate) {
+                inc = sl.glide_inc;
+                sl.gliding = 1;
+            } else if (!sl.gliding || glide_rate == 0) {
+                inc = table_inc;
+                sl.gliding = 0;
+            } else {
+                u32 step = (sl.cur_inc >> (glide_rate + GLIDE_SHIFT_BASE)) + 1;
+                if (sl.cur_inc < table_inc && table_inc - sl.cur_inc > step) {
+                    inc = sl.cur_inc + step;
+                } else if (sl.cur_inc > table_inc && sl.cur_inc - table_inc > step) {
+                    inc = sl.cur_inc - step;
+                } else {
+                    inc = table_inc;
+                    sl.gliding = 0;
+                }
+            }
+            sl.glide_pending = 0;
+            sl.cur_inc = inc;
+
+            u32 inc_mod = inc + (u32)(s32)(((s64)inc * ctl->pitch[t]) >> PITCH_MOD_SHIFT);
+            sl.phase += inc_mod;
+            int cycle_start = sl.phase < inc_mod;
+
+            // envelope inputs from the state before this frame, an idle
+            // slot has a zero envelope so its waveform is not needed
+            u32 state = sl.state;
+            if (sl.amp_q != steps_q) {
+                steps_q = sl.amp_q;
+                step_attack = scale(r->attack[t], steps_q, 7);
+                step_decay = scale(r->decay[t], steps_q, 7);
+                step_release = scale(r->release[t], steps_q, 7);
+                sustain_level = scale(steps_q << 13, r->sustain[t], 20);
+            }
+            u32 step = (state == E_ATTACK)  ? step_attack  :
+                       (state == E_DECAY)   ? step_decay   :
+                       (state == E_RELEASE) ? step_release : 0;
+            u32 amp20 = sl.amp_q << 13;
+            s32 note = 0;
+            if (sl.acc && (sl.active || amp)) {
+                note = scale(waveMix(sl.phase, ctl, r, t), sl.acc, 20);
+            }
+
+            // adsr state machine of envelope_scale.vhd
+            int idle = (state == E_START && amp == 0);
+            int held = (state != E_START && state != E_RELEASE) && (sus_pedal || sl.sost_held);
+            u32 key = (held && amp == 0) ? sl.amp_q : amp;
+            u32 next = state;
+            u32 acc = sl.acc;
+
+            switch (state) {
+                case E_START:
+                    acc = 0;
+                    if (key) {
+                        next = E_ATTACK;
+                    }
+                    break;
+
+                case E_ATTACK:
+                    if (key == 0) {
+                        next = E_RELEASE;
+                    } else if (key != sl.amp_q) {
+                        acc = 0;
+                    } else if (sl.acc < amp20) {
+                        if (amp20 - sl.acc >= step) {
+                            acc = sl.acc + (step ? step : 1);
+                        } else {
+                            next = E_DECAY;
+                        }
+                    } else {
+                        next = E_DECAY;
+                    }
+                    break;
+
+                case E_DECAY:
+                    if (key == 0) {
+                        next = E_RELEASE;
+                    } else if (key != sl.amp_q) {
+                        next = E_ATTACK;
+                        acc = 0;
+                    } else if (sl.acc > sustain_level) {
+                        if (sl.acc - sustain_level >= step) {
+                            acc = sl.acc - (step ? step : 1);
+                        } else {
+                            acc = sustain_level;
+                            next = E_SUSTAIN;
+                        }
+                    } else {
+                        next = E_SUSTAIN;
+                    }
+                    break;
+
+                case E_SUSTAIN:
+                    if (key == 0) {
+                        next = E_RELEASE;
+                    } else if (key != sl.amp_q) {
+                        next = E_ATTACK;
+                        acc = 0;
+                    }
+                    break;
+
+                default:
+                    if (key != sl.amp_q && key != 0) {
+                        next = E_ATTACK;
+                        acc = 0;
+                    } else if (sl.acc > 0) {
+                        if (sl.acc <= step) {
+                            acc = 0;
+                            next = E_START;
+                        } else {
+                            acc = sl.acc - (step ? step : 1);
+                        }
+                    } else {
+                        next = E_START;
+                    }
+                    break;
+            }
+
+            if (cycle_start) {
+                sl.state = next;
+            }
+            if (!idle) {
+                sl.acc = acc;
+            }
+            sl.active = !idle;
+
+            // sostenuto catches the slots keyed on its down edge
+            if (!sost_pedal) {
+                sl.sost_held = 0;
+            } else if (!sl.sost_seen && amp) {
+                sl.sost_held = 1;
+            }
+            sl.sost_seen = sost_pedal;
+
+            // velocity the envelope plays, kept through the release
+            if (state == E_START || (state != E_RELEASE && amp)) {
+                sl.amp_q = amp;
+            }
+
+            // level, pressure and pan of poly_mix.vhd
+            if (note) {
+                u32 lvl = ((ctl->lvl[t] * press_gain) >> 7) & MASK7;
+                s32 x2 = scale(note, lvl, 7) * 2;
+                s32 right = scale(x2, pan, 7);
+                mix_l[f] += x2 - right;
+                mix_r[f] += right;
+            }
+        }
+        e->slots[s] = sl;
+    }
+}
+
+/***************************************************************************/
+/**
+* This function scales a block mix to the output samples.
+*
+* @param  e is the engine
+* @param  mix_l and mix_r are the summed slot mixes
+* @param  out receives the stereo pairs, 24 bits sign extended
+*
+****************************************************************************/
+void engineOutput(const Engine *e, const s32 *mix_l, const s32 *mix_r, s32 *out) {
+    u32 shift = e->regs.out_shift & 0x1F;
+
+    for (int f = 0; f < e->frames; f ++) {
+        u32 gain = e->ctl[f].out_amp;
+        out[2 * f]     = sext24((u32)scale(sext24(mix_l[f]), gain, 7) << shift);
+        out[2 * f + 1] = sext24((u32)scale(sext24(mix_r[f]), gain, 7) << shift);
+    }
+}
+
+/***************************************************************************/
+/**
+* This function renders a block on the calling thread.
+*
+* @param  e is the engine
+* @param  out receives frames stereo pairs
+* @param  frames is the block length, up to ENG_MAX_BLOCK
+*
+****************************************************************************/
+void engineRun(Engine *e, s32 *out, int frames) {
+    static s32 mix_l[ENG_MAX_BLOCK], mix_r[ENG_MAX_BLOCK];
+
+    engineControl(e, frames);
+    memset(mix_l, 0, e->frames * sizeof(s32));
+    memset(mix_r, 0, e->frames * sizeof(s32));
+    engineRenderSlots(e, 0, ENG_SLOTS, mix_l, mix_r);
+    engineOutput(e, mix_l, mix_r, out);
+}
+
+/***************************************************************************/
+/**
+* This function counts the slots sounding or keyed, the active bitmap.
+*
+****************************************************************************/
+int engineActiveCount(const Engine *e) {
+    int count = 0;
+
+    for (int s = 0; s < ENG_SLOTS; s ++) {
+        count += e->slots[s].active;
+    }
+    return count;
+}
@@ -0,0 +1,142 @@
+#ifndef ENGINE_MODEL_H_
+#define ENGINE_MODEL_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// engine dimensions, see synth_pkg.vhd
+#define ENG_SLOTS       128
+#define ENG_TIMBRES     8
+#define ENG_WAVES       5
+#define ENG_LFOS        4
+#define ENG_MOD_DESTS   4
+#define ENG_CLK_HZ      12288000
+#define ENG_FRAME_HZ    (ENG_CLK_HZ / ENG_SLOTS)   // one sample per frame
+
+// revision and date registers of the engine modelled
+#define ENG_REV         0x0000000C
+#define ENG_DATE        0x19102026
+
+// frames rendered per call at most
+#define ENG_MAX_BLOCK   1024
+
+// output samples are 24 bits, sign extended
+#define ENG_OUT_BITS    24
+
+/***************************************************************************
+* Type definitions
+****************************************************************************/
+
+/*
+ * Registers as synth_axi_ctrl.vhd holds them. Note amplitudes, the tuning
+ * table, pedals and glide starts are written here and copied to the
+ * engine on a frame boundary, everything else takes effect at once.
+ */
+typedef struct {
+    u8  note_amps[ENG_SLOTS];
+    u32 freq_words[ENG_SLOTS];
+    u8  note_pans[ENG_SLOTS];
+    u8  note_timbres[ENG_SLOTS];
+    u8  note_press[ENG_SLOTS];
+    u8  timbre_press[ENG_TIMBRES];
+    u8  press_depths[ENG_TIMBRES];
+    // timbre banks
+    u8  amps[ENG_TIMBRES][ENG_WAVES];
+    u16 phs[ENG_TIMBRES][ENG_WAVES];
+    u16 pw[ENG_TIMBRES];
+    u8  lvl[ENG_TIMBRES];
+    u32 attack[ENG_TIMBRES];
+    u32 decay[ENG_TIMBRES];
+    u32 sustain[ENG_TIMBRES];
+    u32 release[ENG_TIMBRES];
+    u8  mod_sel[ENG_TIMBRES][ENG_MOD_DESTS];
+    u8  mod_dep[ENG_TIMBRES][ENG_MOD_DESTS];
+    u16 lfo_rates[ENG_LFOS];
+    u8  lfo_shapes[ENG_LFOS];
+    // settings
+    u32 out_amp;
+    u32 out_shift;
+    u32 slew_rate;
+    u32 glide_rate;
+    u32 glide;
+    u8  glide_from[ENG_SLOTS];  // source note of each slot's glide start
+    u8  glide_pend[ENG_SLOTS];  // glide starts waiting for the frame
+    u32 pedal;
+    u32 gate_vel;
+    u32 note_ctrl;
+    u32 wrapback;
+    u8  release_pending;
+} EngineRegs;
+
+// per-timbre controls after the slew and the modulation matrix, one set
+// per frame
+typedef struct {
+    s16 pitch[ENG_TIMBRES];
+    u8  amps[ENG_TIMBRES][ENG_WAVES];
+    u16 pw[ENG_TIMBRES];
+    u8  lvl[ENG_TIMBRES];
+    u8  out_amp;
+} EngineFrame;
+
+// one note slot through the pipeline
+typedef struct {
+    u32 phase;
+    u32 cur_inc;        // increment after the glide
+    u32 glide_inc;      // increment to glide from, when glide_pending
+    u8  gliding;
+    u8  glide_pending;
+    u8  state;          // envelope state
+    u8  amp_q;          // velocity the envelope is playing
+    u32 acc;            // envelope amplitude, 20 bits
+    u8  active;
+    u8  sost_held;
+    u8  sost_seen;
+} EngineSlot;
+
+typedef struct {
+    EngineRegs regs;
+    // copies taken on the frame boundary
+    u8  note_amps_out[ENG_SLOTS];
+    u32 freq_out[ENG_SLOTS];
+    u32 pedal_out;
+    // slew, lfo and modulation state
+    u32 slew_amps[ENG_TIMBRES][ENG_WAVES];  // 7.16 fixed point
+    u32 slew_pw[ENG_TIMBRES];               // 16.16
+    u32 slew_out;                           // 7.16
+    u32 lfo_phase[ENG_LFOS];
+    s8  lfo_out[ENG_LFOS];
+    u16 lfsr;
+    EngineFrame mod;    // modulation matrix outputs
+    EngineSlot slots[ENG_SLOTS];
+    // controls of each frame of the block being rendered
+    int frames;
+    EngineFrame ctl[ENG_MAX_BLOCK];
+} Engine;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+void engineInit(Engine *e);
+void engineWrite(Engine *e, u32 offset, u32 value);
+u32  engineRead(const Engine *e, u32 offset);
+
+// a block in three steps, the middle one can run on several threads with
+// a slot range each
+void engineControl(Engine *e, int frames);
+void engineRenderSlots(Engine *e, int first, int last, s32 *mix_l, s32 *mix_r);
+void engineOutput(const Engine *e, const s32 *mix_l, const s32 *mix_r, s32 *out);
+
+// the three steps on one thread, out is frames stereo pairs
+void engineRun(Engine *e, s32 *out, int frames);
+
+int  engineActiveCount(const Engine *e);
+
+#endif /* ENGINE_MODEL_H_ */
@@ -0,0 +1,387 @@
+/****************************************************************************/
+/**
+* host_midi.c
+*
+* This file contains the MIDI sources of the host synth. A source thread
+* pushes timestamped bytes into a lock-free queue and the renderer feeds
+* them to the MIDI UART stand-in as they fall due, so they reach the
+* engine through the firmware handler, parser and dispatch.
+*
+* A raw source passes bytes on as they are read, from a file, a FIFO or
+* stdin. A standard MIDI file is parsed up front: tracks are merged in
+* tick order and ticks converted to engine frames through the tempo map.
+* The ramp plays every key in turn to find the polyphony the host keeps
+* up with.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "host_midi.h"
+
+#define RAMP_VELOCITY   100
+#define MIDI_CC         0xB0
+#define CC_ALL_NOTES    123
+#define SMF_TEMPO       0x51
+#define SMF_DEFAULT_US  500000  // 120 bpm
+
+// an event on the file's time base, seq keeps the order of equal ticks
+typedef struct {
+    u32 tick;
+    u32 seq;
+    HostMidiEvent ev;
+} SmfEvent;
+
+typedef struct {
+    u32 tick;
+    u32 us_per_qn;
+} SmfTempo;
+
+static void sourceInit(HostMidiSource *src, HostMidiKind kind) {
+    memset(src, 0, sizeof(*src));
+    src->kind = kind;
+    src->fd = -1;
+    spscInit(&src->queue, src->slots, HOST_MIDI_QUEUE, sizeof(HostMidiEvent));
+}
+
+/***************************************************************************/
+/**
+* This function opens a raw MIDI byte stream.
+*
+* @param  src is the source
+* @param  path is a file or FIFO, "-" is stdin
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int hostMidiOpenRaw(HostMidiSource *src, const char *path) {
+    sourceInit(src, HOST_MIDI_RAW);
+    src->fd = strcmp(path, "-") ? open(path, O_RDONLY) : STDIN_FILENO;
+    return (src->fd < 0) ? XST_FAILURE : XST_SUCCESS;
+}
+
+/***************************************************************************
+* Standard MIDI files
+****************************************************************************/
+
+typedef struct {
+    const u8 *p;
+    const u8 *end;
+} SmfReader;
+
+static u32 smfBytes(SmfReader *r, int n) {
+    u32 value = 0;
+
+    while (n-- > 0 && r->p < r->end) {
+        value = (value << 8) | *r->p++;
+    }
+    return value;
+}
+
+static u32 smfVarLen(SmfReader *r) {
+    u32 value = 0;
+
+    for (int i = 0; i < 4 && r->p < r->end; i ++) {
+        u8 b = *r->p++;
+        value = (value << 7) | (b & 0x7F);
+        if (!(b & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+// bytes of one message, split into events, growing the list as needed
+static int smfAdd(SmfEvent **list, u32 *num, u32 *cap, u32 tick, const u8 *data, u32 len) {
+    for (u32 i = 0; i < len; i += HOST_MIDI_EVENT_BYTES) {
+        if (*num == *cap) {
+            u32 grow = *cap ? 2 * *cap : 1024;
+            SmfEvent *bigger = realloc(*list, grow * sizeof(SmfEvent));
+            if (!bigger) {
+                return XST_FAILURE;
+            }
+            *list = bigger;
+            *cap = grow;
+        }
+        SmfEvent *e = &(*list)[(*num)];
+        e->tick = tick;
+        e->seq = *num;
+        e->ev.len = (len - i < HOST_MIDI_EVENT_BYTES) ? len - i : HOST_MIDI_EVENT_BYTES;
+        memcpy(e->ev.data, data + i, e->ev.len);
+        (*num)++;
+    }
+    return XST_SUCCESS;
+}
+
+static int smfTrack(SmfReader *r, SmfEvent **list, u32 *num, u32 *cap,
+                    SmfTempo *tempos, u32 *num_tempos, u32 max_tempos) {
+    u32 tick = 0;
+    u8 status = 0;
+
+    while (r->p < r->end) {
+        tick += smfVarLen(r);
+        if (r->p >= r->end) {
+            break;
+        }
+        if (*r->p & 0x80) {
+            status = *r->p++;
+        }
+
+        if (status == 0xFF) {
+            // meta events, only the tempo is used
+            u8 type = smfBytes(r, 1);
+            u32 len = smfVarLen(r);
+            if (type == SMF_TEMPO && len == 3 && *num_tempos < max_tempos) {
+                SmfReader t = { r->p, r->end };
+                tempos[*num_tempos].tick = tick;
+                tempos[*num_tempos].us_per_qn = smfBytes(&t, 3);
+                (*num_tempos)++;
+            }
+            r->p += (len < (u32)(r->end - r->p)) ? len : (u32)(r->end - r->p);
+            status = 0;
+        } else if (status == 0xF0 || status == 0xF7) {
+            // SysEx, F0 gets its status byte back, F7 escapes raw bytes
+            u32 len = smfVarLen(r);
+            if (len > (u32)(r->end - r->p)) {
+                return XST_FAILURE;
+            }
+            if (status == 0xF0 && smfAdd(list, num, cap, tick, &status, 1)) {
+                return XST_FAILURE;
+            }
+            if (smfAdd(list, num, cap, tick, r->p, len)) {
+                return XST_FAILURE;
+            }
+            r->p += len;
+            status = 0;
+        } else if (status & 0x80) {
+            u8 msg[3] = { status };
+            u8 len = ((status & 0xE0) == 0xC0) ? 2 : 3;
+            for (int i = 1; i < len; i ++) {
+                msg[i] = smfBytes(r, 1) & 0x7F;
+            }
+            if (smfAdd(list, num, cap, tick, msg, len)) {
+                return XST_FAILURE;
+            }
+        } else {
+            // data byte without a running status
+            return XST_FAILURE;
+        }
+    }
+    return XST_SUCCESS;
+}
+
+static int smfCompare(const void *a, const void *b) {
+    const SmfEvent *x = a, *y = b;
+
+    if (x->tick != y->tick) {
+        return (x->tick < y->tick) ? -1 : 1;
+    }
+    return (x->seq < y->seq) ? -1 : (x->seq > y->seq);
+}
+
+static int tempoCompare(const void *a, const void *b) {
+    const SmfTempo *x = a, *y = b;
+
+    return (x->tick < y->tick) ? -1 : (x->tick > y->tick);
+}
+
+/***************************************************************************/
+/**
+* This function reads a standard MIDI file into a sequence of events.
+*
+* @param  src is the source
+* @param  path is the file
+* @param  frame_hz is the engine frame rate the events are timed in
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+* @note   Tracks of a format 1 file play together, the tempo map comes
+*         from all of them. Meta events other than the tempo are dropped.
+*
+****************************************************************************/
+int hostMidiOpenSmf(HostMidiSource *src, const char *path, u32 frame_hz) {
+    static SmfTempo tempos[4096];
+    SmfEvent *list = NULL;
+    u32 num = 0, cap = 0, num_tempos = 0;
+    int status = XST_FAILURE;
+    u8 *file = NULL;
+    long size;
+
+    sourceInit(src, HOST_MIDI_SMF);
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        return XST_FAILURE;
+    }
+    if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) > 14 &&
+        fseek(fp, 0, SEEK_SET) == 0 && (file = malloc(size)) &&
+        fread(file, 1, size, fp) == (size_t)size) {
+        status = XST_SUCCESS;
+    }
+    fclose(fp);
+
+    SmfReader r = { file, file + ((status == XST_SUCCESS) ? size : 0) };
+    if (status != XST_SUCCESS || memcmp(r.p, "MThd", 4)) {
+        free(file);
+        return XST_FAILURE;
+    }
+    r.p += 4;
+    u32 hlen = smfBytes(&r, 4);
+    u32 format = smfBytes(&r, 2);
+    u32 tracks = smfBytes(&r, 2);
+    u32 division = smfBytes(&r, 2);
+    r.p = file + 8 + hlen;
+    if (format > 1 || division == 0) {
+        free(file);
+        return XST_FAILURE;
+    }
+
+    for (u32 t = 0; t < tracks && status == XST_SUCCESS && r.end - r.p >= 8; t ++) {
+        int is_track = !memcmp(r.p, "MTrk", 4);
+        r.p += 4;
+        u32 len = smfBytes(&r, 4);
+        if (len > (u32)(r.end - r.p)) {
+            status = XST_FAILURE;
+            break;
+        }
+        SmfReader track = { r.p, r.p + len };
+        if (is_track) {
+            status = smfTrack(&track, &list, &num, &cap, tempos, &num_tempos,
+                              sizeof(tempos) / sizeof(tempos[0]));
+        } else {
+            t--;    // unknown chunks are skipped
+        }
+        r.p += len;
+    }
+    free(file);
+    if (status != XST_SUCCESS) {
+        free(list);
+        return XST_FAILURE;
+    }
+
+    qsort(list, num, sizeof(SmfEvent), smfCompare);
+    qsort(tempos, num_tempos, sizeof(SmfTempo), tempoCompare);
+
+    // ticks to seconds a tempo segment at a time, SMPTE divisions have a
+    // fixed tick length
+    double tick_s = SMF_DEFAULT_US * 1e-6 / division;
+    if (division & 0x8000) {
+        tick_s = 1.0 / ((-(s8)(division >> 8)) * (division & 0xFF));
+        num_tempos = 0;
+    }
+    double seg_s = 0;
+    u32 seg_tick = 0, next_tempo = 0;
+
+    src->events = malloc((num ? num : 1) * sizeof(HostMidiEvent));
+    if (!src->events) {
+        free(list);
+        return XST_FAILURE;
+    }
+    for (u32 i = 0; i < num; i ++) {
+        while (next_tempo < num_tempos && tempos[next_tempo].tick <= list[i].tick) {
+            seg_s += (tempos[next_tempo].tick - seg_tick) * tick_s;
+            seg_tick = tempos[next_tempo].tick;
+            tick_s = tempos[next_tempo].us_per_qn * 1e-6 / division;
+            next_tempo++;
+        }
+        src->events[i] = list[i].ev;
+        src->events[i].frame = (u32)((seg_s + (list[i].tick - seg_tick) * tick_s) * frame_hz);
+    }
+    src->num_events = num;
+    free(list);
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function builds the polyphony ramp: a note on for every key one
+* step apart, held, then all notes off.
+*
+* @param  src is the source
+* @param  step_frames is the time between note ons
+* @param  hold_frames is the time all the keys are held
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int hostMidiOpenRamp(HostMidiSource *src, u32 step_frames, u32 hold_frames) {
+    sourceInit(src, HOST_MIDI_RAMP);
+
+    src->events = malloc(129 * sizeof(HostMidiEvent));
+    if (!src->events) {
+        return XST_FAILURE;
+    }
+    for (u32 key = 0; key < 128; key ++) {
+        HostMidiEvent *ev = &src->events[key];
+        ev->frame = 1 + key * step_frames;
+        ev->len = 3;
+        ev->data[0] = 0x90;
+        ev->data[1] = key;
+        ev->data[2] = RAMP_VELOCITY;
+    }
+    HostMidiEvent *off = &src->events[128];
+    off->frame = 1 + 128 * step_frames + hold_frames;
+    off->len = 3;
+    off->data[0] = MIDI_CC;
+    off->data[1] = CC_ALL_NOTES;
+    off->data[2] = 0;
+    src->num_events = 129;
+    return XST_SUCCESS;
+}
+
+void hostMidiClose(HostMidiSource *src) {
+    if (src->fd > STDIN_FILENO) {
+        close(src->fd);
+    }
+    free(src->events);
+    src->events = NULL;
+}
+
+/***************************************************************************
+* Source thread
+****************************************************************************/
+
+// waits for room rather than dropping, the renderer drains every block
+static void push(HostMidiSource *src, const HostMidiEvent *ev) {
+    struct timespec wait = { 0, 1000000 };
+
+    while (spscPush(&src->queue, ev) != XST_SUCCESS && !src->stop) {
+        nanosleep(&wait, NULL);
+    }
+}
+
+void *hostMidiThread(void *arg) {
+    HostMidiSource *src = arg;
+    HostMidiEvent ev;
+
+    if (src->kind == HOST_MIDI_RAW) {
+        ev.frame = 0;
+        while (!src->stop) {
+            ssize_t n = read(src->fd, ev.data, HOST_MIDI_EVENT_BYTES);
+            if (n <= 0) {
+                break;
+            }
+            ev.len = n;
+            push(src, &ev);
+        }
+    } else {
+        for (u32 i = 0; i < src->num_events && !src->stop; i ++) {
+            push(src, &src->events[i]);
+        }
+    }
+    __atomic_store_n(&src->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
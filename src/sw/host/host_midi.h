@@ -0,0 +1,67 @@
+#ifndef HOST_MIDI_H_
+#define HOST_MIDI_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include <stdio.h>
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "../amp/spsc.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// events waiting between the source thread and the renderer
+#define HOST_MIDI_QUEUE 1024
+
+// bytes carried by one event, longer messages take several
+#define HOST_MIDI_EVENT_BYTES 3
+
+/***************************************************************************
+* Type definitions
+****************************************************************************/
+
+// bytes for the MIDI UART, due on an engine frame. Frame 0 is as soon as
+// the renderer sees it.
+typedef struct {
+    u32 frame;
+    u8  len;
+    u8  data[HOST_MIDI_EVENT_BYTES];
+} HostMidiEvent;
+
+typedef enum {
+    HOST_MIDI_RAW,      // byte stream from a file, FIFO or stdin
+    HOST_MIDI_SMF,      // standard MIDI file, format 0 or 1
+    HOST_MIDI_RAMP      // note on every key in turn, then all notes off
+} HostMidiKind;
+
+typedef struct {
+    HostMidiKind kind;
+    SpscQueue    queue;
+    HostMidiEvent slots[HOST_MIDI_QUEUE];
+    volatile int done;  // set once the last event is queued
+    volatile int stop;  // set by the renderer to end the thread early
+    // raw
+    int fd;
+    // smf and ramp, the whole sequence up front
+    HostMidiEvent *events;
+    u32 num_events;
+} HostMidiSource;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+int  hostMidiOpenRaw(HostMidiSource *src, const char *path);
+int  hostMidiOpenSmf(HostMidiSource *src, const char *path, u32 frame_hz);
+int  hostMidiOpenRamp(HostMidiSource *src, u32 step_frames, u32 hold_frames);
+void hostMidiClose(HostMidiSource *src);
+
+// source thread, pushes the events into src->queue
+void *hostMidiThread(void *arg);
+
+#endif /* HOST_MIDI_H_ */
@@ -0,0 +1,120 @@
+/****************************************************************************/
+/**
+* host_sink.c
+*
+* This file contains the audio sinks of the host synth: a WAV file in the
+* codec format, 24 bit stereo at the engine frame rate, and a null sink
+* that only counts frames, for timing the renderer.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <string.h>
+
+#include "host_sink.h"
+
+#define WAV_CHANNELS  2
+#define WAV_BYTES     3
+#define WAV_HEADER    44
+
+static void putLe(u8 *p, u32 value, int bytes) {
+    for (int i = 0; i < bytes; i ++) {
+        p[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+// header for the frames written so far, sizes patched in on close
+static int wavHeader(HostSink *sink) {
+    u8 h[WAV_HEADER];
+    u32 data = (u32)(sink->frames * WAV_CHANNELS * WAV_BYTES);
+
+    memcpy(h, "RIFF", 4);
+    putLe(h + 4, 36 + data, 4);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    putLe(h + 16, 16, 4);
+    putLe(h + 20, 1, 2);                    // PCM
+    putLe(h + 22, WAV_CHANNELS, 2);
+    putLe(h + 24, sink->rate, 4);
+    putLe(h + 28, sink->rate * WAV_CHANNELS * WAV_BYTES, 4);
+    putLe(h + 32, WAV_CHANNELS * WAV_BYTES, 2);
+    putLe(h + 34, 8 * WAV_BYTES, 2);
+    memcpy(h + 36, "data", 4);
+    putLe(h + 40, data, 4);
+
+    return (fwrite(h, 1, WAV_HEADER, sink->fp) == WAV_HEADER) ? XST_SUCCESS : XST_FAILURE;
+}
+
+static int wavWrite(HostSink *sink, const s32 *stereo, int frames) {
+    u8 buf[WAV_CHANNELS * WAV_BYTES * 256];
+    int done = 0;
+
+    while (done < frames) {
+        int n = (frames - done < 256) ? frames - done : 256;
+        for (int i = 0; i < WAV_CHANNELS * n; i ++) {
+            putLe(buf + WAV_BYTES * i, (u32)stereo[WAV_CHANNELS * done + i], WAV_BYTES);
+        }
+        if (fwrite(buf, WAV_CHANNELS * WAV_BYTES, n, sink->fp) != (size_t)n) {
+            return XST_FAILURE;
+        }
+        done += n;
+    }
+    sink->frames += frames;
+    return XST_SUCCESS;
+}
+
+static void wavClose(HostSink *sink) {
+    if (sink->fp) {
+        if (fseek(sink->fp, 0, SEEK_SET) == 0) {
+            wavHeader(sink);
+        }
+        fclose(sink->fp);
+        sink->fp = NULL;
+    }
+}
+
+/***************************************************************************/
+/**
+* This function opens a WAV file sink.
+*
+* @param  sink is the sink
+* @param  path is the file, replaced if it exists
+* @param  rate is the frame rate
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int hostSinkWav(HostSink *sink, const char *path, u32 rate) {
+    memset(sink, 0, sizeof(*sink));
+    sink->write = wavWrite;
+    sink->close = wavClose;
+    sink->rate = rate;
+
+    sink->fp = fopen(path, "wb");
+    if (!sink->fp || wavHeader(sink)) {
+        return XST_FAILURE;
+    }
+    return XST_SUCCESS;
+}
+
+static int nullWrite(HostSink *sink, const s32 *stereo, int frames) {
+    (void)stereo;
+    sink->frames += frames;
+    return XST_SUCCESS;
+}
+
+static void nullClose(HostSink *sink) {
+    (void)sink;
+}
+
+void hostSinkNull(HostSink *sink, u32 rate) {
+    memset(sink, 0, sizeof(*sink));
+    sink->write = nullWrite;
+    sink->close = nullClose;
+    sink->rate = rate;
+}
@@ -0,0 +1,36 @@
+#ifndef HOST_SINK_H_
+#define HOST_SINK_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include <stdio.h>
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+/***************************************************************************
+* Type definitions
+****************************************************************************/
+
+/*
+ * Where the rendered audio goes. Blocks are stereo pairs of 24 bit
+ * samples, sign extended to 32 bits, at the engine frame rate.
+ */
+typedef struct HostSink {
+    int  (*write)(struct HostSink *sink, const s32 *stereo, int frames);
+    void (*close)(struct HostSink *sink);
+    FILE *fp;
+    u32  rate;
+    u64  frames;        // written so far
+} HostSink;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+int  hostSinkWav(HostSink *sink, const char *path, u32 rate);
+void hostSinkNull(HostSink *sink, u32 rate);
+
+#endif /* HOST_SINK_H_ */
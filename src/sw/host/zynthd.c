@@ -0,0 +1,456 @@
+/****************************************************************************/
+/**
+* zynthd.c
+*
+* This file contains the host synth daemon. It boots the firmware against
+* the C engine model, so MIDI goes through the same UART handler, parser,
+* coalescer and dispatch as on the board, and renders the engine in real
+* time.
+*
+* Each block starts by handing the MIDI events that are due to the UART
+* stand-in and running the receive path, then the engine controls for the
+* block are worked out and the note slots are split across the worker
+* threads, each adding its slots into its own mix. The mixes are summed,
+* scaled and written to the sink. Events are applied on block boundaries,
+* so they are late by up to a block.
+*
+* In real time each block has a deadline one block period after the last
+* and the renderer sleeps until it. A block finished after its deadline is
+* an xrun and the deadlines start again from then. Free running, a block
+* that took longer than its period to render is counted as an xrun.
+*
+* At the end the render time of the blocks, the xruns and the most notes
+* held without an xrun are reported.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "xil_io.h"
+#include "xil_printf.h"
+#include "xuartps.h"
+#include "engine_model.h"
+#include "host_midi.h"
+#include "host_sink.h"
+#include "../boot/boot.h"
+#include "../latency/latency.h"
+#include "../midi/midi.h"
+
+#define DEFAULT_BLOCK   256
+#define MAX_THREADS     16
+#define RAMP_STEP_S     0.05
+#define RAMP_HOLD_S     1.0
+
+// bytes handed to the UART between runs of the receive path, well short
+// of the MIDI ring
+#define UART_CHUNK      512
+
+/***************************************************************************
+* Options and state
+****************************************************************************/
+
+typedef struct {
+    const char *wav;
+    const char *raw;
+    const char *smf;
+    int   ramp;
+    int   block;
+    int   threads;
+    double seconds;
+    int   free_run;
+    int   rt_prio;
+    int   verbose;
+} Options;
+
+typedef struct {
+    int first;
+    int last;
+    pthread_t thread;
+    s32 mix_l[ENG_MAX_BLOCK];
+    s32 mix_r[ENG_MAX_BLOCK];
+} Worker;
+
+static Engine engine;
+static Worker workers[MAX_THREADS];
+static int num_workers;
+static pthread_barrier_t block_start, block_done;
+static volatile int stopping;
+
+static HostMidiSource source;
+static HostMidiEvent pending;
+static int have_pending;
+
+// results
+static LatHist render_hist;
+static u64 blocks, xruns;
+static u64 blocks_at[ENG_SLOTS + 1], xruns_at[ENG_SLOTS + 1];
+static u32 uart_bytes;
+
+/***************************************************************************
+* Engine behind the register stand-in
+****************************************************************************/
+
+static void modelWrite(void *ref, u32 offset, u32 value) {
+    engineWrite(ref, offset, value);
+}
+
+static u32 modelRead(void *ref, u32 offset) {
+    return engineRead(ref, offset);
+}
+
+static const HostSynthModel model = { modelWrite, modelRead, &engine };
+
+/***************************************************************************
+* MIDI
+****************************************************************************/
+
+static void runReceive(void) {
+    XUartPs_InterruptHandler(&MidiPs);
+    rxMidiMsg();
+    uart_bytes = 0;
+}
+
+// events due before the end of the block, through the firmware receive
+// path. One event is held back when it is not due yet.
+static void feedMidi(u32 block_end) {
+    while (have_pending || spscPop(&source.queue, &pending) == XST_SUCCESS) {
+        have_pending = 1;
+        if (pending.frame >= block_end) {
+            break;
+        }
+        host_uart_send(pending.data, pending.len);
+        uart_bytes += pending.len;
+        have_pending = 0;
+        if (uart_bytes >= UART_CHUNK) {
+            runReceive();
+        }
+    }
+    if (uart_bytes) {
+        runReceive();
+    }
+}
+
+static int sourceFinished(void) {
+    return __atomic_load_n(&source.done, __ATOMIC_ACQUIRE) &&
+           !have_pending && spscCount(&source.queue) == 0;
+}
+
+/***************************************************************************
+* Rendering
+****************************************************************************/
+
+static void renderRange(Worker *w) {
+    memset(w->mix_l, 0, engine.frames * sizeof(s32));
+    memset(w->mix_r, 0, engine.frames * sizeof(s32));
+    engineRenderSlots(&engine, w->first, w->last, w->mix_l, w->mix_r);
+}
+
+static void *workerThread(void *arg) {
+    Worker *w = arg;
+
+    while (1) {
+        pthread_barrier_wait(&block_start);
+        if (stopping) {
+            break;
+        }
+        renderRange(w);
+        pthread_barrier_wait(&block_done);
+    }
+    return NULL;
+}
+
+static void renderBlock(s32 *out, int frames) {
+    engineControl(&engine, frames);
+
+    // worker 0 is this thread
+    if (num_workers > 1) {
+        pthread_barrier_wait(&block_start);
+    }
+    renderRange(&workers[0]);
+    if (num_workers > 1) {
+        pthread_barrier_wait(&block_done);
+    }
+
+    for (int i = 1; i < num_workers; i ++) {
+        for (int f = 0; f < frames; f ++) {
+            workers[0].mix_l[f] += workers[i].mix_l[f];
+            workers[0].mix_r[f] += workers[i].mix_r[f];
+        }
+    }
+    engineOutput(&engine, workers[0].mix_l, workers[0].mix_r, out);
+}
+
+static void startWorkers(int threads) {
+    num_workers = threads;
+    for (int i = 0; i < threads; i ++) {
+        workers[i].first = i * ENG_SLOTS / threads;
+        workers[i].last = (i + 1) * ENG_SLOTS / threads;
+    }
+    if (threads > 1) {
+        pthread_barrier_init(&block_start, NULL, threads);
+        pthread_barrier_init(&block_done, NULL, threads);
+        for (int i = 1; i < threads; i ++) {
+            pthread_create(&workers[i].thread, NULL, workerThread, &workers[i]);
+        }
+    }
+}
+
+static void stopWorkers(void) {
+    if (num_workers > 1) {
+        stopping = 1;
+        pthread_barrier_wait(&block_start);
+        for (int i = 1; i < num_workers; i ++) {
+            pthread_join(workers[i].thread, NULL);
+        }
+        pthread_barrier_destroy(&block_start);
+        pthread_barrier_destroy(&block_done);
+    }
+}
+
+/***************************************************************************
+* Timing
+****************************************************************************/
+
+static u64 nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void sleepUntil(u64 ns) {
+    struct timespec ts = { ns / 1000000000ULL, ns % 1000000000ULL };
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+// SCHED_FIFO and locked memory, when the user may have them
+static void realTime(int prio) {
+    struct sched_param param = { .sched_priority = prio };
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE)) {
+        fprintf(stderr, "zynthd: could not lock memory\n");
+    }
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) {
+        fprintf(stderr, "zynthd: could not set SCHED_FIFO %d\n", prio);
+    }
+}
+
+/***************************************************************************
+* Report
+****************************************************************************/
+
+static void report(const Options *opt, u64 frames, double wall_s) {
+    double period_us = 1e6 * opt->block / ENG_FRAME_HZ;
+    int sustained = -1;
+    u64 xruns_below = 0;
+
+    printf("%llu blocks of %d frames, %.1f s of audio in %.1f s, %d thread%s\n",
+           (unsigned long long)blocks, opt->block, (double)frames / ENG_FRAME_HZ,
+           wall_s, opt->threads, (opt->threads > 1) ? "s" : "");
+    if (render_hist.count) {
+        printf("render us: min %.1f mean %.1f max %.1f, period %.1f\n",
+               render_hist.min_ns / 1e3, render_hist.sum_ns / 1e3 / render_hist.count,
+               render_hist.max_ns / 1e3, period_us);
+        for (int b = 0; b < LAT_BUCKETS; b ++) {
+            if (render_hist.buckets[b]) {
+                printf("  < %8.1f us %10u\n",
+                       (b < LAT_BUCKETS - 1) ? (LAT_BUCKET0_NS << b) / 1e3 : 1e9,
+                       render_hist.buckets[b]);
+            }
+        }
+    }
+    printf("xruns: %llu\n", (unsigned long long)xruns);
+
+    // the most notes sounding with no xrun at that many or fewer
+    for (int n = 0; n <= ENG_SLOTS; n ++) {
+        xruns_below += xruns_at[n];
+        if (xruns_below) {
+            break;
+        }
+        if (blocks_at[n]) {
+            sustained = n;
+        }
+    }
+    if (sustained >= 0) {
+        printf("polyphony sustained: %d\n", sustained);
+    }
+    if (source.queue.dropped) {
+        printf("midi queue full %u times\n", source.queue.dropped);
+    }
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: zynthd [-o out.wav | -n] [-i raw | -m file.mid | -p] [-b frames]\n"
+            "              [-j threads] [-t seconds] [-f] [-r prio] [-v]\n"
+            "  -o  write a 24 bit 96 kHz WAV file\n"
+            "  -n  discard the audio (default)\n"
+            "  -i  raw MIDI bytes from a file or FIFO, - for stdin\n"
+            "  -m  play a standard MIDI file\n"
+            "  -p  polyphony ramp, every key in turn then all notes off\n"
+            "  -b  block length in frames (%d)\n"
+            "  -j  render threads (1)\n"
+            "  -t  stop after this much audio\n"
+            "  -f  free run instead of real time\n"
+            "  -r  run at this SCHED_FIFO priority\n"
+            "  -v  show the firmware output\n", DEFAULT_BLOCK);
+}
+
+static int parseOptions(int argc, char **argv, Options *opt) {
+    int c;
+
+    memset(opt, 0, sizeof(*opt));
+    opt->block = DEFAULT_BLOCK;
+    opt->threads = 1;
+    while ((c = getopt(argc, argv, "o:ni:m:pb:j:t:fr:v")) != -1) {
+        switch (c) {
+            case 'o': opt->wav = optarg;                break;
+            case 'n': opt->wav = NULL;                  break;
+            case 'i': opt->raw = optarg;                break;
+            case 'm': opt->smf = optarg;                break;
+            case 'p': opt->ramp = 1;                    break;
+            case 'b': opt->block = atoi(optarg);        break;
+            case 'j': opt->threads = atoi(optarg);      break;
+            case 't': opt->seconds = atof(optarg);      break;
+            case 'f': opt->free_run = 1;                break;
+            case 'r': opt->rt_prio = atoi(optarg);      break;
+            case 'v': opt->verbose = 1;                 break;
+            default:  return XST_FAILURE;
+        }
+    }
+    if (opt->block < 1 || opt->block > ENG_MAX_BLOCK ||
+        opt->threads < 1 || opt->threads > MAX_THREADS ||
+        (!!opt->raw + !!opt->smf + opt->ramp) != 1) {
+        return XST_FAILURE;
+    }
+    return XST_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    static s32 out[2 * ENG_MAX_BLOCK];
+    pthread_t source_thread;
+    HostSink sink;
+    Options opt;
+    int status;
+
+    if (parseOptions(argc, argv, &opt)) {
+        usage();
+        return 1;
+    }
+
+    if (opt.raw) {
+        status = hostMidiOpenRaw(&source, opt.raw);
+    } else if (opt.smf) {
+        status = hostMidiOpenSmf(&source, opt.smf, ENG_FRAME_HZ);
+    } else {
+        status = hostMidiOpenRamp(&source, RAMP_STEP_S * ENG_FRAME_HZ, RAMP_HOLD_S * ENG_FRAME_HZ);
+    }
+    if (status) {
+        fprintf(stderr, "zynthd: could not open the MIDI source\n");
+        return 1;
+    }
+    if (opt.wav) {
+        status = hostSinkWav(&sink, opt.wav, ENG_FRAME_HZ);
+    } else {
+        hostSinkNull(&sink, ENG_FRAME_HZ);
+    }
+    if (status) {
+        fprintf(stderr, "zynthd: could not open %s\n", opt.wav);
+        return 1;
+    }
+
+    // the firmware boots against the model
+    engineInit(&engine);
+    host_synth_model = &model;
+    host_printf_mute = !opt.verbose;
+    if (bootSystem(0)) {
+        fprintf(stderr, "zynthd: boot failed\n");
+        return 1;
+    }
+
+    if (opt.rt_prio) {
+        realTime(opt.rt_prio);
+    }
+    startWorkers(opt.threads);
+    pthread_create(&source_thread, NULL, hostMidiThread, &source);
+
+    u64 max_frames = (opt.seconds > 0) ? (u64)(opt.seconds * ENG_FRAME_HZ) : ~0ULL;
+    u64 period_ns = 1000000000ULL * opt.block / ENG_FRAME_HZ;
+    u64 start = nowNs();
+    u64 deadline = start;
+    u64 frames = 0;
+
+    while (frames < max_frames) {
+        // files and the ramp end once everything has played out
+        if (!opt.raw && sourceFinished() && engineActiveCount(&engine) == 0 && frames) {
+            break;
+        }
+        if (opt.raw && sourceFinished() && opt.seconds <= 0) {
+            break;
+        }
+
+        u64 t0 = nowNs();
+        int n = (max_frames - frames < (u64)opt.block) ? (int)(max_frames - frames) : opt.block;
+        feedMidi(frames + n);
+        renderBlock(out, n);
+        sink.write(&sink, out, n);
+        u64 t1 = nowNs();
+
+        int poly = engineActiveCount(&engine);
+        int late;
+        latRecord(&render_hist, (u32)(t1 - t0));
+        if (opt.free_run) {
+            late = (t1 - t0) > period_ns;
+        } else {
+            deadline += period_ns;
+            late = t1 > deadline;
+            if (late) {
+                deadline = t1;
+            } else {
+                sleepUntil(deadline);
+            }
+        }
+        blocks++;
+        blocks_at[poly]++;
+        if (late) {
+            xruns++;
+            xruns_at[poly]++;
+        }
+        frames += n;
+    }
+    double wall_s = (nowNs() - start) / 1e9;
+
+    source.stop = 1;
+    if (!opt.raw || source.done) {
+        pthread_join(source_thread, NULL);
+    }
+    stopWorkers();
+    sink.close(&sink);
+    hostMidiClose(&source);
+
+    report(&opt, frames, wall_s);
+    return 0;
+}
@@ -2,8 +2,18 @@
 /**
 * i2c.c
 *
-* This file contains the functions for basic I2C transactions using the
-* AXI IIC module.
+* This file contains the functions for I2C transactions using the AXI IIC
+* module in dynamic controller mode.
+*
+* Transactions are queued and written into the transmit FIFO with their
+* start and stop bits, as many as fit, so a batch of register writes goes
+* out back to back without waiting on each one. i2cService keeps the FIFO
+* fed and retires finished transactions; it is called from i2cWait, and can
+* be called from the main loop to run a batch in the background. The queue
+* is not interrupt safe, it is queued and serviced from one thread. A
+* transaction that is not acknowledged is sent again up to I2C_RETRIES
+* times, and a bus that stops making progress for I2C_TIMEOUT_US resets
+* the controller instead of hanging.
 *
 *
 * REVISION HISTORY:
@@ -11,11 +21,45 @@
 * Ver   Who    Date     Changes
 * ----- ------ -------- -----------------------------------------------------
 * 0.00  tjh    03/07/25 Initial file
+* 0.01  agt    10/19/26 Queue transactions through the FIFO with timeouts
+* 0.02  agt    10/19/26 Add a batch result that does not wait
+* 0.03  agt    10/19/26 The queue is serviced from one thread, not an interrupt
 *
 ****************************************************************************/
 
 #include "i2c.h"
 #include <xiic_l.h>
+#include "xtime_l.h"
+#include "xstatus.h"
+
+/***************************************************************************
+* Variable definitions
+****************************************************************************/
+
+I2cStats i2c_stats;
+
+// transaction ring, [done, sent) are in the FIFO or on the bus and
+// [sent, tail) are waiting, the indexes run freely
+static I2cXfer queue[I2C_QUEUE_LEN];
+static u16 done_idx;
+static u16 sent_idx;
+static u16 tail_idx;
+
+// FIFO entries written and bytes to read back for the transactions in flight
+static u8  fifo_entries;
+static u8  rx_pending;
+
+// FIFO occupancy after the last service and when the bus last moved
+static u8    last_occupancy;
+static XTime last_progress;
+
+static u32 batch_failed;
+static u8  initialized;
+
+#define xferAt(i) (&queue[(u16)(i) % I2C_QUEUE_LEN])
+
+#define readIic(reg)        XIic_ReadReg(IIC_BASE_ADDRESS, (reg))
+#define writeIic(reg, data) XIic_WriteReg(IIC_BASE_ADDRESS, (reg), (data))
 
 /***************************************************************************
 * Function definitions
@@ -23,146 +67,405 @@
 
 /*****************************************************************************/
 /**
-* This function writes a number of bytes to a given register over I2C from a
-* specified buffer.
+* This function returns the transmit FIFO entries a transaction takes: the
+* address and the bytes written, then the read address and byte count.
 *
-* @param  i2c_addr contains the 7-bit I2C address to write to.
-* @param  reg contains the register address to write to.
-* @param  buf contains the address of the data buffer to send.
-* @param  byte_cnt contains the number of bytes in the buffer to be send.
+****************************************************************************/
+static u8 xferEntries(const I2cXfer *x)
+{
+  return (x->tx_len ? 1 + x->tx_len : 0) + (x->rx_len ? 2 : 0);
+}
+
+/*****************************************************************************/
+/**
+* This function empties the transmit FIFO, drops any bytes received and
+* clears the interrupt status.
 *
-* @return The number of bytes sent. A value less than the specified input
-*         value indicates an error.
+****************************************************************************/
+static void flushIic(void)
+{
+  u32 cntl_reg = readIic(XIIC_CR_REG_OFFSET);
+
+  writeIic(XIIC_CR_REG_OFFSET, cntl_reg | XIIC_CR_TX_FIFO_RESET_MASK);
+  writeIic(XIIC_CR_REG_OFFSET, XIIC_CR_ENABLE_DEVICE_MASK);
+
+  while (!(readIic(XIIC_SR_REG_OFFSET) & XIIC_SR_RX_FIFO_EMPTY_MASK)) {
+    (void)readIic(XIIC_DRR_REG_OFFSET);
+  }
+
+  // interrupt status bits toggle on write
+  writeIic(XIIC_IISR_OFFSET, readIic(XIIC_IISR_OFFSET));
+}
+
+/*****************************************************************************/
+/**
+* This function resets the AXI IIC module and empties the queue.
 *
-* @note   None.
+* @return XST_SUCCESS
 *
 ****************************************************************************/
-unsigned i2c_write_reg(AddressType i2c_addr, u8 *reg, u8 regsize, u8 *buf, u16 byte_cnt)
+int i2cInit(void)
 {
-  volatile unsigned sent_cnt;
-  volatile unsigned sent_byte_cnt;
-  u32 cntl_reg;
-  u8 write_buf[regsize + byte_cnt];
+  writeIic(XIIC_RESETR_OFFSET, XIIC_RESET_MASK);
+  writeIic(XIIC_RFD_REG_OFFSET, I2C_FIFO_DEPTH - 1);
+  flushIic();
+
+  done_idx = sent_idx = tail_idx = 0;
+  fifo_entries = rx_pending = 0;
+  last_occupancy = 0;
+  batch_failed = 0;
+  XTime_GetTime(&last_progress);
+  initialized = 1;
 
-  /*
-   * Add the register address to the beginning of the write buffer.
-   * Then place the data in the write buffer.
-   */
-  for(u8 i = 0; i < regsize; i++) {
-    write_buf[i] = (u8)(reg[i] >> 8*i);
+  return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function retires the transactions in flight that have finished,
+* copying out the bytes read.
+*
+* @param  consumed is the number of FIFO entries the controller has taken.
+* @param  idle is set when the bus is idle with the FIFO empty.
+*
+* @note   A transaction is finished once the controller has moved on to the
+*         next one, or the bus has gone idle after its last entry.
+*
+****************************************************************************/
+static void retireXfers(u8 consumed, u8 idle)
+{
+  while (done_idx != sent_idx) {
+    I2cXfer *x = xferAt(done_idx);
+    u8 n = xferEntries(x);
+
+    if (consumed < n || (consumed == n && !idle)) {
+      break;
+    }
+    for (u8 i = 0; i < x->rx_len; i ++) {
+      x->rx[i] = (u8)readIic(XIIC_DRR_REG_OFFSET);
+    }
+    consumed     -= n;
+    fifo_entries -= n;
+    rx_pending   -= x->rx_len;
+    done_idx++;
+    i2c_stats.done++;
   }
+}
 
-  for (u16 i = 0; i < byte_cnt; i++) {
-    write_buf[regsize + i] = buf[i];
+/*****************************************************************************/
+/**
+* This function puts the transactions in flight back in the queue after a
+* NACK or timeout. The first of them is the one at fault; it counts a try
+* and is given up on after I2C_RETRIES.
+*
+****************************************************************************/
+static void retryXfers(void)
+{
+  I2cXfer *x = xferAt(done_idx);
+
+  flushIic();
+
+  if (done_idx != sent_idx) {
+    if (x->tries++ >= I2C_RETRIES) {
+      i2c_stats.failed++;
+      batch_failed++;
+      done_idx++;
+    } else {
+      i2c_stats.retries++;
+    }
   }
 
-  /*
-   * Send the register address until ack received.
-   */
-  do {
-    sent_cnt = XIic_Send(IIC_BASE_ADDRESS, i2c_addr,
-            (u8 *)&reg, regsize,XIIC_STOP);
+  sent_idx = done_idx;
+  fifo_entries = 0;
+  rx_pending = 0;
+}
+
+/*****************************************************************************/
+/**
+* This function writes waiting transactions into the transmit FIFO while
+* they fit, and their read back bytes fit the receive FIFO.
+*
+* @param  occupancy is the number of entries in the transmit FIFO.
+*
+* @return the occupancy after the writes.
+*
+****************************************************************************/
+static u8 fillFifo(u8 occupancy)
+{
+  while (sent_idx != tail_idx) {
+    I2cXfer *x = xferAt(sent_idx);
+    u8 n = xferEntries(x);
 
-    if (sent_cnt != regsize) {
-      /* Send is aborted so reset Tx FIFO */
-      cntl_reg = XIic_ReadReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET);
-      XIic_WriteReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET, cntl_reg | XIIC_CR_TX_FIFO_RESET_MASK);
-      XIic_WriteReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET,  XIIC_CR_ENABLE_DEVICE_MASK);
+    if (occupancy + n > I2C_FIFO_DEPTH || rx_pending + x->rx_len > I2C_FIFO_DEPTH) {
+      break;
     }
 
-  } while (sent_cnt != regsize);
+    if (x->tx_len) {
+      writeIic(XIIC_DTR_REG_OFFSET, XIIC_TX_DYN_START_MASK | (x->addr << 1) | XIIC_WRITE_OPERATION);
+      for (u8 i = 0; i < x->tx_len; i ++) {
+        u32 stop = (i == x->tx_len - 1 && !x->rx_len) ? XIIC_TX_DYN_STOP_MASK : 0;
+        writeIic(XIIC_DTR_REG_OFFSET, stop | x->tx[i]);
+      }
+    }
+    if (x->rx_len) {
+      writeIic(XIIC_DTR_REG_OFFSET, XIIC_TX_DYN_START_MASK | (x->addr << 1) | XIIC_READ_OPERATION);
+      writeIic(XIIC_DTR_REG_OFFSET, XIIC_TX_DYN_STOP_MASK | x->rx_len);
+    }
 
-  /*
-   * Send the page buffer.
-   */
-  sent_byte_cnt = XIic_Send(IIC_BASE_ADDRESS, i2c_addr,
-          write_buf, sizeof(write_buf), XIIC_STOP);
+    occupancy    += n;
+    fifo_entries += n;
+    rx_pending   += x->rx_len;
+    sent_idx++;
+  }
 
-  do {
-    sent_cnt = XIic_Send(IIC_BASE_ADDRESS, i2c_addr,
-            (u8 *)&reg, regsize,XIIC_STOP);
+  return occupancy;
+}
+
+/*****************************************************************************/
+/**
+* This function moves the queue along: it retires finished transactions,
+* handles NACKs and timeouts, and refills the transmit FIFO.
+*
+* @note   Safe to call at any time from the thread that queues the
+*         transactions. Not from an interrupt: the queue indexes are not
+*         guarded against the code it would interrupt.
+*
+****************************************************************************/
+void i2cService(void)
+{
+  u32 isr, sr;
+  u8 occupancy, consumed;
+  u16 was_done = done_idx;
+  XTime now;
+
+  if (!initialized) {
+    return;
+  }
+
+  isr = readIic(XIIC_IISR_OFFSET);
+  sr  = readIic(XIIC_SR_REG_OFFSET);
+  occupancy = (sr & XIIC_SR_TX_FIFO_EMPTY_MASK) ? 0 : (u8)readIic(XIIC_TFO_REG_OFFSET) + 1;
+  consumed  = fifo_entries - occupancy;
+  XTime_GetTime(&now);
+
+  if (isr & (XIIC_INTR_TX_ERROR_MASK | XIIC_INTR_ARB_LOST_MASK)) {
+    // everything before the entry that failed went through
+    retireXfers(consumed, 0);
+    retryXfers();
+    occupancy = 0;
+    last_progress = now;
 
-    if (sent_cnt != regsize) {
-      /* Send is aborted so reset Tx FIFO */
-      cntl_reg = XIic_ReadReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET);
-      XIic_WriteReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET, cntl_reg | XIIC_CR_TX_FIFO_RESET_MASK);
-      XIic_WriteReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET,  XIIC_CR_ENABLE_DEVICE_MASK);
+  } else {
+    retireXfers(consumed, !(sr & XIIC_SR_BUS_BUSY_MASK) && occupancy == 0);
+
+    if (done_idx == sent_idx || done_idx != was_done || occupancy != last_occupancy) {
+      last_progress = now;
+    } else if (now - last_progress > (XTime)I2C_TIMEOUT_US * (COUNTS_PER_SECOND / 1000000)) {
+      i2c_stats.timeouts++;
+      writeIic(XIIC_RESETR_OFFSET, XIIC_RESET_MASK);
+      writeIic(XIIC_RFD_REG_OFFSET, I2C_FIFO_DEPTH - 1);
+      retryXfers();
+      occupancy = 0;
+      last_progress = now;
     }
+  }
 
-  } while (sent_cnt != regsize);
+  last_occupancy = fillFifo(occupancy);
+}
 
-  /*
-   * Return the number of bytes written to the EEPROM
-   */
-  return sent_byte_cnt;
+/*****************************************************************************/
+/**
+* This function reports whether any transaction is waiting or on the bus.
+*
+****************************************************************************/
+int i2cBusy(void)
+{
+  return done_idx != tail_idx;
 }
 
 /*****************************************************************************/
 /**
-* This function reads a number of bytes from a given register over I2C into a
-* specified buffer.
+* This function runs the queue until every transaction has finished.
+*
+* @return XST_SUCCESS, or XST_FAILURE when a transaction since the last wait
+*         was given up on.
+*
+****************************************************************************/
+int i2cWait(void)
+{
+  while (i2cBusy()) {
+    i2cService();
+  }
+
+  return i2cResult();
+}
+
+/*****************************************************************************/
+/**
+* This function returns the result of the transactions since the last wait
+* or result, for running a batch in the background.
+*
+* @return XST_SUCCESS, or XST_FAILURE when a transaction was given up on.
+*
+****************************************************************************/
+int i2cResult(void)
+{
+  u32 failed = batch_failed;
+
+  batch_failed = 0;
+
+  return failed ? XST_FAILURE : XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function adds a transaction to the queue, running the queue when it
+* is full.
+*
+****************************************************************************/
+static I2cXfer *queueXfer(AddressType i2c_addr)
+{
+  I2cXfer *x;
+
+  if (!initialized) {
+    i2cInit();
+  }
+  while ((u16)(tail_idx - done_idx) == I2C_QUEUE_LEN) {
+    i2cService();
+  }
+
+  x = xferAt(tail_idx);
+  x->addr   = i2c_addr;
+  x->tx_len = 0;
+  x->rx_len = 0;
+  x->rx     = NULL;
+  x->tries  = 0;
+
+  return x;
+}
+
+/*****************************************************************************/
+/**
+* This function queues a write of a number of bytes to a device.
+*
+* @param  i2c_addr contains the 7-bit I2C address to write to.
+* @param  buf contains the register address and data to send.
+* @param  byte_cnt contains the number of bytes in the buffer to be sent.
+*
+* @return XST_SUCCESS, or XST_FAILURE when the write does not fit a
+*         transaction.
+*
+****************************************************************************/
+int i2cQueueWrite(AddressType i2c_addr, const u8 *buf, u8 byte_cnt)
+{
+  I2cXfer *x;
+
+  if (byte_cnt == 0 || byte_cnt > I2C_MAX_TX) {
+    return XST_FAILURE;
+  }
+
+  x = queueXfer(i2c_addr);
+  for (u8 i = 0; i < byte_cnt; i ++) {
+    x->tx[i] = buf[i];
+  }
+  x->tx_len = byte_cnt;
+  tail_idx++;
+
+  i2cService();
+  return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function queues a read of a number of bytes from a given register.
 *
 * @param  i2c_addr contains the 7-bit I2C address to read from.
 * @param  reg contains the register address to read from.
-* @param  buf contains the address of the data buffer to be filled.
-* @param  byte_cnt contains the number of bytes in the buffer to be read.
+* @param  regsize contains the number of register address bytes.
+* @param  buf is filled with the bytes read once the transaction finishes.
+* @param  byte_cnt contains the number of bytes to be read.
 *
-* @return The number of bytes read. A value less than the specified input
-*         value indicates an error.
+* @return XST_SUCCESS, or XST_FAILURE when the read does not fit a
+*         transaction.
+*
+****************************************************************************/
+int i2cQueueRead(AddressType i2c_addr, const u8 *reg, u8 regsize, u8 *buf, u8 byte_cnt)
+{
+  I2cXfer *x;
+
+  if (regsize > I2C_MAX_TX || byte_cnt == 0 || byte_cnt > I2C_MAX_RX) {
+    return XST_FAILURE;
+  }
+
+  x = queueXfer(i2c_addr);
+  for (u8 i = 0; i < regsize; i ++) {
+    x->tx[i] = reg[i];
+  }
+  x->tx_len = regsize;
+  x->rx_len = byte_cnt;
+  x->rx     = buf;
+  tail_idx++;
+
+  i2cService();
+  return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function writes a number of bytes to a given register over I2C from a
+* specified buffer and waits for the queue to finish.
+*
+* @param  i2c_addr contains the 7-bit I2C address to write to.
+* @param  reg contains the register address to write to.
+* @param  buf contains the address of the data buffer to send.
+* @param  byte_cnt contains the number of bytes in the buffer to be send.
 *
-* @note   None.
+* @return The number of bytes sent. A value less than the specified input
+*         value indicates an error.
 *
 ****************************************************************************/
-unsigned i2c_read_reg(AddressType i2c_addr, u8 *reg, u8 regsize, u8 *buf, u16  byte_cnt)
+unsigned i2c_write_reg(AddressType i2c_addr, u8 *reg, u8 regsize, u8 *buf, u16 byte_cnt)
 {
-  volatile unsigned ReceivedByteCount;
-  u16 StatusReg;
-  u32 cntl_reg;
+  u8 write_buf[I2C_MAX_TX];
 
-  u8 reg_send[regsize];
+  if (regsize + byte_cnt > I2C_MAX_TX) {
+    return 0;
+  }
 
   for (u8 i = 0; i < regsize; i ++) {
-      reg_send[i] = reg[i];
-  }
-    
-  /*
-   * Set the address register to the specified address by writing
-   * the address to the device, this must be tried until it succeeds
-   * because a previous write to the device could be pending and it
-   * will not ack until that write is complete.
-   */
-  do {
-    StatusReg = XIic_ReadReg(IIC_BASE_ADDRESS, XIIC_SR_REG_OFFSET);
-
-    if (!(StatusReg & XIIC_SR_BUS_BUSY_MASK)) {
-      ReceivedByteCount = XIic_Send(
-                  IIC_BASE_ADDRESS,
-                  i2c_addr,
-                  (u8 *)&reg_send,
-                  sizeof(reg_send),
-                  XIIC_REPEATED_START);
-
-      if (ReceivedByteCount != sizeof(reg_send)) {
-
-        /* Send is aborted so reset Tx FIFO */
-        cntl_reg = XIic_ReadReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET);
-        XIic_WriteReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET, cntl_reg | XIIC_CR_TX_FIFO_RESET_MASK);
-        XIic_WriteReg(IIC_BASE_ADDRESS, XIIC_CR_REG_OFFSET, XIIC_CR_ENABLE_DEVICE_MASK);
-      }
-    }
+    write_buf[i] = reg[i];
+  }
+  for (u16 i = 0; i < byte_cnt; i ++) {
+    write_buf[regsize + i] = buf[i];
+  }
 
-  } while (ReceivedByteCount != sizeof(reg_send));
+  if (i2cQueueWrite(i2c_addr, write_buf, regsize + byte_cnt) || i2cWait()) {
+    return 0;
+  }
 
-  buf[0] = 0;
+  return regsize + byte_cnt;
+}
 
-  /*
-   * Read the number of bytes at the specified address from the EEPROM.
-   */
-  ReceivedByteCount = XIic_Recv(IIC_BASE_ADDRESS, i2c_addr,
-              buf, byte_cnt, XIIC_STOP);
+/*****************************************************************************/
+/**
+* This function reads a number of bytes from a given register over I2C into a
+* specified buffer and waits for the queue to finish.
+*
+* @param  i2c_addr contains the 7-bit I2C address to read from.
+* @param  reg contains the register address to read from.
+* @param  buf contains the address of the data buffer to be filled.
+* @param  byte_cnt contains the number of bytes in the buffer to be read.
+*
+* @return The number of bytes read. A value less than the specified input
+*         value indicates an error.
+*
+****************************************************************************/
+unsigned i2c_read_reg(AddressType i2c_addr, u8 *reg, u8 regsize, u8 *buf, u16 byte_cnt)
+{
+  if (byte_cnt > I2C_MAX_RX ||
+      i2cQueueRead(i2c_addr, reg, regsize, buf, (u8)byte_cnt) || i2cWait()) {
+    return 0;
+  }
 
-  /*
-   * Return the number of bytes read from the EEPROM.
-   */
-  return ReceivedByteCount;
+  return byte_cnt;
 }
@@ -14,6 +14,19 @@
 
 #define IIC_BASE_ADDRESS	XPAR_AXI_IIC_0_BASEADDR
 
+// AXI IIC transmit and receive FIFO depths
+#define I2C_FIFO_DEPTH   16
+
+// transactions waiting or on the bus
+#define I2C_QUEUE_LEN    32
+// bytes written after the address, and bytes read back, per transaction
+#define I2C_MAX_TX       3
+#define I2C_MAX_RX       4
+
+// a transaction that is not acknowledged is sent this many more times
+#define I2C_RETRIES      2
+// with no progress on the bus for this long the controller is reset
+#define I2C_TIMEOUT_US   5000
 
 /**************************** Type Definitions *******************************/
 
@@ -25,10 +38,46 @@
  */
 typedef u8 AddressType;
 
+/*
+ * A queued transaction: the tx bytes are written to the device and, when
+ * rx_len is set, rx_len bytes are read back after a repeated start.
+ */
+typedef struct {
+  AddressType addr;
+  u8  tx_len;
+  u8  tx[I2C_MAX_TX];
+  u8  rx_len;
+  u8 *rx;
+  u8  tries;
+} I2cXfer;
+
+typedef struct {
+  u32 done;      // transactions completed
+  u32 retries;   // transactions sent again after a NACK or timeout
+  u32 timeouts;  // controller resets after the bus stopped making progress
+  u32 failed;    // transactions given up on
+} I2cStats;
+
+extern I2cStats i2c_stats;
+
 /************************** Function Prototypes ******************************/
 
+int  i2cInit(void);
+
+int  i2cQueueWrite(AddressType i2c_addr, const u8 *buf, u8 byte_cnt);
+
+int  i2cQueueRead(AddressType i2c_addr, const u8 *reg, u8 regsize, u8 *buf, u8 byte_cnt);
+
+void i2cService(void);
+
+int  i2cBusy(void);
+
+int  i2cWait(void);
+
+int  i2cResult(void);
+
 unsigned i2c_write_reg(AddressType i2c_addr, u8 *reg, u8 regsize, u8 *buf, u16 byte_cnt);
 
 unsigned i2c_read_reg(AddressType i2c_addr, u8 *reg, u8 regsize, u8 *BufferPtr, u16 ByteCount);
 
-#endif /* I2C_H */
\ No newline at end of file
+#endif /* I2C_H */
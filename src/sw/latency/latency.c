@@ -0,0 +1,222 @@
+/****************************************************************************/
+/**
+* latency.c
+*
+* This file contains the control path latency histograms. The UART
+* interrupt, the MIDI ring, the parser, the dispatcher and the note commit
+* stamp the global timer as a batch of MIDI bytes passes them, and each
+* finished batch adds its spans to fixed-bucket histograms that can be
+* printed on request.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <string.h>
+
+#include "latency.h"
+
+#ifdef LATENCY
+
+LatHist lat_hists[NUM_LAT_POINTS];
+
+static const char *lat_hist_names[NUM_LAT_POINTS] = {
+    "total",
+    "isr to push",
+    "push to parse",
+    "parse to dispatch",
+    "dispatch to write"
+};
+
+/*
+ * Stamps are the low word of the global timer, which wraps every 12.9 s,
+ * with bit 0 set so that 0 means not stamped.
+ *
+ * The interrupt keeps the entry time of the latest interrupt and, for the
+ * first byte it pushes after the main loop took the last ones, that entry
+ * time and the push time. The push stamp is written last and cleared first
+ * so the main loop never takes half of a pair.
+ */
+static volatile u32 isr_entry;
+static volatile u32 arrival_isr;
+static volatile u32 arrival_push;
+
+// stamps of the batch the main loop is working on
+static u32 batch[NUM_LAT_POINTS];
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+static u32 latNow(void) {
+    XTime now;
+
+    XTime_GetTime(&now);
+    return (u32)now | 1;
+}
+
+static u32 ticksToNs(u32 ticks) {
+    return (u32)((u64)ticks * 1000000000ULL / COUNTS_PER_SECOND);
+}
+
+/***************************************************************************
+* Add a finished batch to the histograms
+****************************************************************************/
+
+static void finishBatch(void) {
+    u32 spans[NUM_LAT_POINTS];
+
+    // a message still being received keeps the arrival of its first byte
+    if (batch[LAT_PARSED] == 0) {
+        batch[LAT_DISPATCH] = 0;
+        batch[LAT_WRITE] = 0;
+        return;
+    }
+
+    for (int p = LAT_PUSH; p < NUM_LAT_POINTS; p ++) {
+        // a byte that raced the last take can be stamped after its parse
+        if (batch[p] == 0 || batch[p - 1] == 0 || (s32)(batch[p] - batch[p - 1]) < 0) {
+            memset(batch, 0, sizeof(batch));
+            return;
+        }
+        spans[p] = batch[p] - batch[p - 1];
+    }
+    spans[LAT_TOTAL] = batch[LAT_WRITE] - batch[LAT_ISR];
+
+    for (int p = 0; p < NUM_LAT_POINTS; p ++) {
+        latRecord(&lat_hists[p], ticksToNs(spans[p]));
+    }
+    memset(batch, 0, sizeof(batch));
+}
+
+/***************************************************************************/
+/**
+* This function stamps a point on the control path.
+*
+* @param  p is the point reached
+*
+* @note   LAT_ISR and LAT_PUSH are called from the UART interrupt, the
+*         other points from the main loop. LAT_WRITE finishes the batch.
+*
+****************************************************************************/
+void latStampPoint(LatPoint p) {
+
+    switch (p) {
+        case LAT_ISR:
+            isr_entry = latNow();
+            break;
+
+        case LAT_PUSH:
+            if (arrival_push == 0) {
+                arrival_isr = isr_entry;
+                arrival_push = latNow();
+            }
+            break;
+
+        case LAT_WRITE:
+            batch[LAT_WRITE] = latNow();
+            finishBatch();
+            break;
+
+        default:
+            if (batch[p] == 0) {
+                batch[p] = latNow();
+            }
+            break;
+    }
+}
+
+/***************************************************************************/
+/**
+* This function takes the arrival stamps of the bytes the main loop has
+* just drained from the MIDI ring into the batch.
+*
+* @note   Called once the ring is empty, so a later byte stamps the next
+*         batch.
+*
+****************************************************************************/
+void latTakeArrivalStamps(void) {
+    u32 push = arrival_push;
+    u32 isr = arrival_isr;
+
+    if (push == 0) {
+        return;
+    }
+    arrival_push = 0;
+
+    // the oldest byte of an unfinished message is already in the batch
+    if (batch[LAT_PUSH] == 0) {
+        batch[LAT_ISR] = isr;
+        batch[LAT_PUSH] = push;
+    }
+}
+
+/***************************************************************************
+* Add a span to a histogram
+****************************************************************************/
+
+void latRecord(LatHist *h, u32 ns) {
+    if (h->count == 0 || ns < h->min_ns) {
+        h->min_ns = ns;
+    }
+    if (ns > h->max_ns) {
+        h->max_ns = ns;
+    }
+    h->count++;
+    h->sum_ns += ns;
+    h->buckets[latBucket(ns)]++;
+}
+
+/***************************************************************************
+* Bucket of a span, see LAT_BUCKETS
+****************************************************************************/
+
+u8 latBucket(u32 ns) {
+    u8 b = 0;
+
+    for (u32 edge = LAT_BUCKET0_NS; ns >= edge && b < LAT_BUCKETS - 1; edge <<= 1) {
+        b++;
+    }
+    return b;
+}
+
+/***************************************************************************
+* Empty the histograms
+****************************************************************************/
+
+void latClear(void) {
+    memset(lat_hists, 0, sizeof(lat_hists));
+}
+
+/***************************************************************************
+* Print the histograms, the spans and each non-empty bucket
+****************************************************************************/
+
+void printLatency(void) {
+
+    debug_print("latency              count   min (ns)  mean (ns)   max (ns)\r\n");
+    for (int p = 0; p < NUM_LAT_POINTS; p ++) {
+        const LatHist *h = &lat_hists[p];
+        u32 mean = h->count ? (u32)(h->sum_ns / h->count) : 0;
+
+        debug_print("%-18s %7u %10u %10u %10u\r\n", lat_hist_names[p],
+                    (unsigned)h->count, (unsigned)h->min_ns, (unsigned)mean, (unsigned)h->max_ns);
+        for (int b = 0; b < LAT_BUCKETS; b ++) {
+            if (h->buckets[b] == 0) {
+                continue;
+            }
+            if (b == LAT_BUCKETS - 1) {
+                debug_print("  >= %8u ns %7u\r\n", LAT_BUCKET0_NS << (b - 1), (unsigned)h->buckets[b]);
+            } else {
+                debug_print("  <  %8u ns %7u\r\n", LAT_BUCKET0_NS << b, (unsigned)h->buckets[b]);
+            }
+        }
+    }
+}
+
+#endif /* LATENCY */
@@ -0,0 +1,89 @@
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xtime_l.h"
+#include "../utils/utils.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// the control path is instrumented in debug builds, release builds compile
+// the points out
+#ifdef DEBUG
+#define LATENCY
+#endif
+
+/*
+ * Histogram buckets. Bucket 0 counts spans under LAT_BUCKET0_NS, each
+ * bucket after it is twice as wide as the one before, and the last one
+ * counts everything from 128 ns << (LAT_BUCKETS - 2), about 33 ms, up.
+ */
+#define LAT_BUCKETS     20
+#define LAT_BUCKET0_NS  128
+
+/*
+ * Points on the path from the UART to the engine, in the order a MIDI
+ * byte passes them. Each batch the main loop drains is stamped at the
+ * first time it reaches each point, so the spans are those of its
+ * oldest byte.
+ */
+typedef enum {
+    LAT_ISR,       // UART receive interrupt entered
+    LAT_PUSH,      // byte in the MIDI ring
+    LAT_PARSED,    // message complete from the parser
+    LAT_DISPATCH,  // message handed to its handler
+    LAT_WRITE,     // note commit written to the engine
+    NUM_LAT_POINTS
+} LatPoint;
+
+// histogram 0 is the whole path, histogram p the span from point p-1 to p
+#define LAT_TOTAL LAT_ISR
+
+/***************************************************************************
+* Type definitions
+****************************************************************************/
+
+typedef struct {
+    u32 count;
+    u32 min_ns;
+    u32 max_ns;
+    u64 sum_ns;
+    u32 buckets[LAT_BUCKETS];
+} LatHist;
+
+/***************************************************************************
+* Global variable definitions
+****************************************************************************/
+
+extern LatHist lat_hists[NUM_LAT_POINTS];
+
+/***************************************************************************
+* Macro functions
+****************************************************************************/
+
+#ifdef LATENCY
+  #define latStamp(p)        latStampPoint(p)
+  #define latTakeArrival()   latTakeArrivalStamps()
+#else
+  #define latStamp(p)        // Expands to nothing
+  #define latTakeArrival()   // Expands to nothing
+#endif
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+void latStampPoint(LatPoint p);
+void latTakeArrivalStamps(void);
+void latRecord(LatHist *h, u32 ns);
+u8   latBucket(u32 ns);
+void latClear(void);
+void printLatency(void);
+
+#endif /* LATENCY_H_ */
@@ -10,6 +10,11 @@
 * Ver   Who    Date     Changes
 * ----- ------ -------- -----------------------------------------------------
 * 0.00  tjh    08/09/22 Initial file
+* 0.01  agt    10/19/26 Initialize the preset bank
+* 0.02  agt    10/19/26 Load and save the SD card library
+* 0.03  agt    10/19/26 Boot through the overlapped boot sequencer
+* 0.04  agt    10/19/26 Service the binary console when idle
+* 0.05  agt    10/19/26 Split MIDI and service work across the cores
 *
 ****************************************************************************/
 
@@ -29,29 +34,50 @@
 #include "i2c/i2c.h"
 #include "ssm2603/ssm2603.h"
 #include "synth_ctrl/synth_ctrl.h"
+#include "synth_ctrl/synth_preset.h"
+#include "storage/storage.h"
+#include "boot/boot.h"
+#include "console/console.h"
+#include "amp/amp.h"
 
 /***************************************************************************
 * Main function
 ****************************************************************************/
 
-int main(void) {
+#ifdef AMP_VOICE
 
+// voice core, started by the service core once it has queued the library
+int main(void) {
 
-	// Initialize synthesizer
-	if (initSynth() || checkSynthCtrl()) {
-		xil_printf("Synthesizer initialization error occurred!\r\n");
+	if (ampVoiceInit()) {
+		return XST_FAILURE;
 	}
 
-	// Configure audio codec
-	if (configCodec()) { 
-		xil_printf("Config codec error occurred!\r\n");
+	// MIDI first, messages from the service core only when idle
+	while (1) {
+		if (!rb_is_empty(&midi_rb)) {
+			rxMidiMsg();
+		} else {
+			ampVoiceService();
+		}
 	}
 
-	// Configure MIDI UART peripheral
-	if (configMidi(MIDI_BASEADDR)) {
-		xil_printf("Failed to configure midi interface\r\n");
+}
+
+#else
+
+int main(void) {
+
+
+	// Bring up the synth, codec, MIDI and library, stamping each phase
+	if (bootSystem(BOOT_FLAGS)) {
 		return XST_FAILURE;
 	}
+	xil_printf("Ready in %u us\r\n", (unsigned)bootElapsedUs(BOOT_READY));
+	if (BOOT_FLAGS & BOOT_DIAG) {
+		printBootTimes();
+	}
+	consoleInit();
 
     u32 count = 0;
 	// Poll for midi messages received
@@ -60,10 +86,22 @@ int main(void) {
             xil_printf("ALIVE\r\n");
             count = 0;
         }
+#ifdef AMP_SERVICE
+		// MIDI is on the voice core, this one only services
+		ampServiceDrain();
+		serviceStorage();
+		consoleService();
+#else
 		// Wait until there is data then process received message
 		if (!rb_is_empty(&midi_rb)) {
 			rxMidiMsg();
+		} else {
+			serviceStorage();
+			consoleService();
 		}
+#endif
 	}
 
 }
+
+#endif /* AMP_VOICE */
@@ -13,6 +13,21 @@
 * Ver   Who    Date     Changes
 * ----- ------ -------- -----------------------------------------------------
 * 0.00  tjh    03/13/25 Initial file
+* 0.01  agt    10/19/26 Add pan and pan spread controllers
+* 0.02  agt    10/19/26 Frame-align note batches, handle all notes off
+* 0.03  agt    10/19/26 Move parsing to midi_parser.c, add SysEx patch dumps
+* 0.04  agt    10/19/26 Play each channel on its own timbre
+* 0.05  agt    10/19/26 Recall presets on program change
+* 0.06  agt    10/19/26 Bend from a loadable tuning table
+* 0.07  agt    10/19/26 Retune from MIDI Tuning Standard messages
+* 0.08  agt    10/19/26 Fixed-point exponential pitch bend
+* 0.09  agt    10/19/26 Modulation depth and vibrato rate controllers
+* 0.10  agt    10/19/26 Portamento time and switch controllers
+* 0.11  agt    10/19/26 Coalesce controller data, route key pressure
+* 0.12  agt    10/19/26 Sustain and sostenuto pedals
+* 0.13  agt    10/19/26 UART self-test on request, stamp the first note
+* 0.14  agt    10/19/26 Stamp the control path for the latency histograms
+* 0.15  agt    10/19/26 Send stored presets and tuning to the service core
 *
 ****************************************************************************/
 
@@ -20,6 +35,10 @@
 
 #include "midi.h"
 #include "pitch.h"
+#include "../storage/storage.h"
+#include "../boot/boot.h"
+#include "../latency/latency.h"
+#include "../amp/amp.h"
 #include <xstatus.h>
 #include <xuartps.h>
 
@@ -27,9 +46,14 @@ XUartPs MidiPs; /* The instance of the UART Driver */
 u8 MidiBuffer[MIDI_BUFFER_SIZE];	/* MIDI receive buffer */
 const char *midi_note_names[] = MIDI_NOTE_NAMES;
 u32 FreqWords[128];
+u32 FreqWordBase[128];	/* tuning table, pitch bend is applied to this */
 
 RingBuffer midi_rb = { .head = 0, .tail = 0 };
-MidiParser midi_parser = {0};
+MidiParser midi_parser;
+MidiCoalescer midi_coalescer;
+
+static void queueMidiMessage(u8 *msg, u8 len);
+static void queueSysEx(u8 *data, u16 len);
 
 /***************************************************************************
 * Reset frequency word array back to defaults
@@ -37,6 +61,7 @@ MidiParser midi_parser = {0};
 
 void initFreqWords(void) {
     for (u8 i = 0; i < 128; i ++) {
+        FreqWordBase[i] = FreqWordDefaults[i];
         FreqWords[i] = FreqWordDefaults[i];
     }
     return;
@@ -49,6 +74,17 @@ void writeFreqWords(void) {
   return;    
 }
 
+/***************************************************************************
+* Play from the tuning table after it has been loaded or edited
+****************************************************************************/
+
+void applyFreqWordBase(void) {
+  for (u8 i = 0; i < 128; i ++) {
+    FreqWords[i] = FreqWordBase[i];
+  }
+  writeFreqWords();
+}
+
 /***************************************************************************
 * MIDI ring buffer
 ****************************************************************************/
@@ -99,13 +135,14 @@ u8 rb_pop(RingBuffer *rb) {
 * This function writes a number configures the UART interface to the MIDI standard.
 *
 * @param  BaseAddress contains the UART periphal's DMA address.
+* @param  self_test runs the UART loopback self-test when set.
 *
 * @return XST_SUCCESS or XST_FAILURE
 *
 * @note   None.
 *
 ****************************************************************************/
-int configMidi(u32 BaseAddress)
+int configMidi(u32 BaseAddress, u8 self_test)
 {
 	XUartPs_Config *Config;
 
@@ -114,6 +151,8 @@ int configMidi(u32 BaseAddress)
 #endif
 
     initFreqWords();
+    midiCoalesceInit(&midi_coalescer, dispatchMidiMessage);
+    midiParserInit(&midi_parser, queueMidiMessage, queueSysEx);
 
 	/*
 	 * Initialize the UART driver so that it's ready to use.
@@ -136,8 +175,8 @@ int configMidi(u32 BaseAddress)
     // Reset FIFOs immediately after init
     XUartPs_SetOptions(&MidiPs, XUARTPS_OPTION_RESET_RX | XUARTPS_OPTION_RESET_TX);
 
-    // Self test (optional, can remove in final system)
-    if (XUartPs_SelfTest(&MidiPs) != XST_SUCCESS) {
+    // Self test, diagnostic boots only
+    if (self_test && XUartPs_SelfTest(&MidiPs) != XST_SUCCESS) {
         return XST_FAILURE;
     }
 
@@ -190,6 +229,8 @@ void Handler(void *CallBackRef, u32 Event, unsigned int EventData)
 {
     (void)CallBackRef; // not used
 
+    latStamp(LAT_ISR);
+
 	/* All of the data has been sent */
 	if (Event == XUARTPS_EVENT_SENT_DATA) {
 	}
@@ -201,6 +242,7 @@ void Handler(void *CallBackRef, u32 Event, unsigned int EventData)
         XUartPs_Recv(&MidiPs, &byte, 1);
         if (byte != SYS_CMD+SYS_CLK) {
           rb_push(&midi_rb, byte);
+          latStamp(LAT_PUSH);
         }
       }
 	}
@@ -257,65 +299,40 @@ void Handler(void *CallBackRef, u32 Event, unsigned int EventData)
 *
 ****************************************************************************/
 int rxMidiMsg(void) {
-  while (!rb_is_empty(&midi_rb)) {
-    u8 byte = rb_pop(&midi_rb);
+  if (rb_is_empty(&midi_rb)) {
+    return XST_SUCCESS;
+  }
 
-    // Real-time system messages (0xF8–0xFF) can appear any time
-    if (byte >= 0xF8) {
-      // Optionally: handle or ignore
-      continue;
-    }
+  // hold note changes so a chord received together starts in the same frame
+  holdNotes();
 
-    // Status byte
-    if (byte & 0x80) {
-      midi_parser.status = byte;
-      midi_parser.msg[0] = byte;
-      midi_parser.count = 1;
-
-      // Determine expected message length
-      switch (byte & 0xF0) {
-        case NOTE_OFF:
-        case NOTE_ON:
-        case POLY_PRESSURE:
-        case CONTROL_CHANGE:
-        case PITCH_BEND:
-          midi_parser.expected = 3;
-          break;
-        case PROG_CHANGE:
-        case CH_PRESSURE:
-          midi_parser.expected = 2;
-          break;
-        case SYS_CMD:
-          // Let the system handler figure it out
-          midi_parser.expected = 2;
-          break;
-        default:
-          midi_parser.expected = 1;
-          break;
-        }
-    } else {
-      // Data byte, running status
-      if (midi_parser.count == 0 && midi_parser.status == 0) {
-        // No running status available
-        continue;
-      }
+  // notes are applied first, then the latest value of each controller
+  while (!rb_is_empty(&midi_rb)) {
+    midiParseByte(&midi_parser, rb_pop(&midi_rb));
+  }
+  latTakeArrival();
+  midiCoalesceFlush(&midi_coalescer);
 
-      if (midi_parser.count == 0) {
-        midi_parser.msg[0] = midi_parser.status;
-        midi_parser.count = 1;
-      }
+  commitNotes();
+  latStamp(LAT_WRITE);
 
-      midi_parser.msg[midi_parser.count++] = byte;
+  return XST_SUCCESS;
+}
 
-      // Full message received
-      if (midi_parser.count >= midi_parser.expected) {
-        dispatchMidiMessage(midi_parser.msg, midi_parser.count);
-        midi_parser.count = 0;
-      }
-    }
-  }
+/***************************************************************************
+* Parser handlers, messages go through the coalescer and SysEx applies
+* everything received before it first
+****************************************************************************/
 
-  return XST_SUCCESS;
+static void queueMidiMessage(u8 *msg, u8 len) {
+  latStamp(LAT_PARSED);
+  midiCoalesceMsg(&midi_coalescer, msg, len);
+}
+
+static void queueSysEx(u8 *data, u16 len) {
+  latStamp(LAT_PARSED);
+  midiCoalesceFlush(&midi_coalescer);
+  dispatchSysEx(data, len);
 }
 
 /***************************************************************************/
@@ -331,10 +348,18 @@ void dispatchMidiMessage(u8 *msg, u8 len) {
   u8 cmd = msg[0] & 0xF0;
   u8 ch = (msg[0] & 0x0F) + 1;
 
+  latStamp(LAT_DISPATCH);
+
   switch (cmd) {
     case NOTE_ON:
       if (len >= 3) {
         debug_print("NOTE ON: ch %d, key %d, vel %d\r\n", ch, msg[1], msg[2]);
+        safeSetNoteTimbre(msg[1], timbreForChannel(ch));
+        if (msg[2] != 0) {
+          bootStampOnce(BOOT_FIRST_NOTE);
+          safeGlideNote(msg[1], timbreForChannel(ch));
+          safeSetNotePressure(msg[1], 0);
+        }
         safePlayNote(msg[1], msg[2]);
       }
       break;
@@ -347,7 +372,7 @@ void dispatchMidiMessage(u8 *msg, u8 len) {
       break;
 
 	case POLY_PRESSURE:
-      if (len >= 2) {
+      if (len >= 3) {
         MidiPolyPressure(ch, msg[1], msg[2]);
       }
 	  break;
@@ -376,6 +401,10 @@ void dispatchMidiMessage(u8 *msg, u8 len) {
       }
       break;
 
+    case SYS_CMD:
+      // system common and real-time messages are not used
+      break;
+
       // Handle other message types...
       default:
         debug_print("Unknown MIDI: %02X [%d bytes]\r\n", msg[0], len);
@@ -383,6 +412,85 @@ void dispatchMidiMessage(u8 *msg, u8 len) {
     }
 }
 
+/***************************************************************************/
+/**
+* This function processes a received System Exclusive message.
+*
+* @param  data is the message without the F0 and F7 bytes
+* @param  len is the message length
+*
+* @return None.
+*
+* @note   Messages for other devices are ignored. A retune is written
+*         while notes are held so the whole table changes in one frame.
+*
+****************************************************************************/
+void dispatchSysEx(u8 *data, u16 len) {
+  SynthPatch patch;
+  u8 program;
+
+  latStamp(LAT_DISPATCH);
+
+  if (mtsIsTuning(data, len)) {
+    if (mtsDecode(data, len, FreqWordBase) == XST_SUCCESS) {
+      applyFreqWordBase();
+#ifdef AMP_VOICE
+      ampSendTuning(FreqWordBase);
+#else
+      saveLibrary();
+#endif
+      debug_print("SYSEX: tuning applied\r\n");
+    } else {
+      debug_print("SYSEX: invalid tuning message [%d bytes]\r\n", len);
+    }
+    return;
+  }
+
+  if (!sysexIsOurs(data, len)) {
+    return;
+  }
+
+  switch (data[2]) {
+    case SYSEX_CMD_PATCH_DUMP:
+      if (sysexDecodePatch(data, len, &patch) == XST_SUCCESS) {
+        applySynthPatch(&patch);
+        debug_print("SYSEX: patch dump applied\r\n");
+      } else {
+        debug_print("SYSEX: invalid patch dump [%d bytes]\r\n", len);
+      }
+      break;
+
+    case SYSEX_CMD_PRESET_STORE:
+      if (sysexDecodePreset(data, len, &program, &patch) == XST_SUCCESS) {
+        storePreset(program, &patch);
+#ifdef AMP_VOICE
+        ampSendPreset(program);
+#endif
+        debug_print("SYSEX: preset %d stored\r\n", program);
+      } else {
+        debug_print("SYSEX: invalid preset store [%d bytes]\r\n", len);
+      }
+      break;
+
+#ifdef LATENCY
+    case SYSEX_CMD_LATENCY: {
+      u8 flags;
+      if (sysexDecodeLatency(data, len, &flags) == XST_SUCCESS) {
+        printLatency();
+        if (flags & SYSEX_LATENCY_CLEAR) {
+          latClear();
+        }
+      }
+      break;
+    }
+#endif
+
+    default:
+      debug_print("SYSEX: unknown command %02X [%d bytes]\r\n", data[2], len);
+      break;
+  }
+}
+
 /***************************************************************************/
 /**
 * This function processes the MIDI Poly Pressure message.
@@ -398,6 +506,8 @@ void dispatchMidiMessage(u8 *msg, u8 len) {
 ****************************************************************************/
 int MidiPolyPressure(u8 Ch, u8 key, u8 value) {
 
+  safeSetNotePressure(key, value);
+
   debug_print("midi %i polyphonic pressure: %s %03i \n\r", Ch, midi_note_names[key], value);
 
   return XST_SUCCESS;
@@ -425,6 +535,10 @@ int MidiControlChange(u8 Ch, u8 control, u8 value) {
       * will turn off, and their volume envelopes are set to zero as 
       * soon as possible. c = 120, v = 0: All Sound Off
       */
+      for (u8 t = 0; t < NUM_TIMBRES; t ++) {
+        clearPedals(t);
+      }
+      releaseAllNotes();
       change = "ALL SOUND OFF";
       break;
 
@@ -435,6 +549,7 @@ int MidiControlChange(u8 Ch, u8 control, u8 value) {
       * Value must only be zero unless otherwise allowed in a specific
       * Recommended Practice.
       */
+      clearPedals(timbreForChannel(Ch));
       change = "RESET ALL CONTROLLERS";
       break;
         
@@ -453,6 +568,7 @@ int MidiControlChange(u8 Ch, u8 control, u8 value) {
       /* All Notes Off. When an All Notes Off is received, all oscillators will turn off.
        * c = 123, v = 0: All Notes Off (See text for description of actual mode commands.)
        */
+      releaseAllNotes();
       change = "ALL NOTES OFF";
       break;
 
@@ -490,73 +606,157 @@ int MidiControlChange(u8 Ch, u8 control, u8 value) {
     case CC_SINE_AMT:
      /* Set sine wave amplitude
       */
-      setWaveAmp(SINE_WAVE, value >> 2);
+      setTimbreWaveAmp(timbreForChannel(Ch), SINE_WAVE, value >> 2);
       change = "SINE AMT";
       break;
 
     case CC_TRI_AMT:
      /* Set triangle wave amplitude
       */
-      setWaveAmp(TRI_WAVE, value >> 2);
+      setTimbreWaveAmp(timbreForChannel(Ch), TRI_WAVE, value >> 2);
       change = "TRI AMT";
       break;
 
     case CC_SAW_AMT:
      /* Set saw wave amplitude
       */
-      setWaveAmp(SAW_WAVE, value >> 2);
+      setTimbreWaveAmp(timbreForChannel(Ch), SAW_WAVE, value >> 2);
       change = "SAW AMT";
       break;
 
     case CC_RAMP_AMT:
      /* Set ramp wave amplitude
       */
-      setWaveAmp(RAMP_WAVE, value >> 2);
+      setTimbreWaveAmp(timbreForChannel(Ch), RAMP_WAVE, value >> 2);
       change = "RAMP AMT";
       break;
 
     case CC_PWM_AMT:
      /* Set pulse wave amplitude
       */
-      setWaveAmp(PULSE_WAVE, value >> 2);
+      setTimbreWaveAmp(timbreForChannel(Ch), PULSE_WAVE, value >> 2);
       change = "PULSE AMT";
       break;
 
     case CC_PWM_WIDTH:
      /* Set pulse wave width
       */
-      setPulseWidth(value << 9);
+      setTimbrePulseWidth(timbreForChannel(Ch), value << 9);
       change = "PULSE WIDTH";
       break;
 
+    case CC_PAN:
+     /* Set stereo pan position
+      */
+      setPanPosition(value);
+      change = "PAN";
+      break;
+
+    case CC_PAN_SPREAD:
+     /* Set key-tracked pan spread
+      */
+      setPanSpread(value);
+      change = "PAN SPREAD";
+      break;
+
     case CC_ATTACK_AMT:
      /* Set attack length
       */
-      setAttack(calcADSRamt(value));
+      setTimbreAttack(timbreForChannel(Ch), calcADSRamt(value));
       change = "ATTACK AMT";
       break;
 
     case CC_DECAY_AMT:
       /* Set decay length
       */
-      setDecay(calcADSRamt(value));
+      setTimbreDecay(timbreForChannel(Ch), calcADSRamt(value));
       change = "DECAY AMT";
       break;
 
     case CC_SUSTAIN_AMT:
       /* Set sustain amount
       */
-      setSustain(value << 13);
+      setTimbreSustain(timbreForChannel(Ch), value << 13);
       change = "SUSTAIN AMT";
       break;
 
     case CC_RELEASE_AMT:
       /* Set release length
       */
-      setRelease(calcADSRamt(value));
+      setTimbreRelease(timbreForChannel(Ch), calcADSRamt(value));
       change = "RELEASE AMT";
       break;
 
+    case CC_MOD_WHEEL:
+      /* Set vibrato depth
+      */
+      setTimbreModDepth(timbreForChannel(Ch), MOD_PITCH, value);
+      change = "MOD WHEEL";
+      break;
+
+    case CC_PRESSURE_AMT:
+      /* Set how far the level follows key pressure
+      */
+      setPressureDepth(timbreForChannel(Ch), value);
+      change = "PRESSURE AMT";
+      break;
+
+    case CC_GLIDE_TIME:
+      /* Set portamento time
+      */
+      setGlideTime(timbreForChannel(Ch), glideRateForCC(value));
+      change = "GLIDE TIME";
+      break;
+
+    case CC_PORTAMENTO:
+      /* Switch portamento on or off
+      */
+      setPortamento(timbreForChannel(Ch), value >= 64);
+      change = "PORTAMENTO";
+      break;
+
+    case CC_SUSTAIN:
+      /* Hold released notes of the channel while the pedal is down
+      */
+      setSustainPedal(timbreForChannel(Ch), value >= 64);
+      change = "SUSTAIN";
+      break;
+
+    case CC_SOSTENUTO:
+      /* Hold the notes sounding when the pedal went down
+      */
+      setSostenutoPedal(timbreForChannel(Ch), value >= 64);
+      change = "SOSTENUTO";
+      break;
+
+    case CC_TREMOLO_AMT:
+      /* Set tremolo depth
+      */
+      setTimbreModDepth(timbreForChannel(Ch), MOD_AMP, value);
+      change = "TREMOLO AMT";
+      break;
+
+    case CC_PW_MOD_AMT:
+      /* Set pulse width modulation depth
+      */
+      setTimbreModDepth(timbreForChannel(Ch), MOD_PW, value);
+      change = "PW MOD AMT";
+      break;
+
+    case CC_WFRM_MOD_AMT:
+      /* Set waveform mix modulation depth
+      */
+      setTimbreModDepth(timbreForChannel(Ch), MOD_WFRM, value);
+      change = "WAVE MOD AMT";
+      break;
+
+    case CC_VIBRATO_RATE:
+      /* Set vibrato lfo rate
+      */
+      setLfo(MOD_PITCH, lfoRateForCC(value), LFO_SINE);
+      change = "VIBRATO RATE";
+      break;
+
     default:
       debug_print("midi %i controller %i: %i.\r\n", Ch, control, value);
       break;
@@ -583,7 +783,7 @@ int MidiProgChange(u8 Ch, u8 value) {
 
   debug_print("midi %i program change: 0x%02X \n\r", Ch, value);
 
-  return XST_SUCCESS;
+  return recallPreset(timbreForChannel(Ch), value);
 }
 
 /***************************************************************************/
@@ -603,6 +803,8 @@ int MidiProgChange(u8 Ch, u8 value) {
 ****************************************************************************/
 int MidiChannelPressure(u8 Ch, u8 value) {
 
+  setChannelPressure(timbreForChannel(Ch), value);
+
   debug_print("midi %i channel pressure: %03i \n\r", Ch, value);
 
   return XST_SUCCESS;
@@ -627,15 +829,11 @@ int MidiChannelPressure(u8 Ch, u8 value) {
 int MidiPitchBend(u8 Ch, int lsb, int msb) {
     
   int pitchBend = ((msb << 7) + lsb);
-  double scale = get_pitch_bend_scale(pitchBend);
-
-  for (u8 i = 116; i < 128; i ++) {
-    FreqWords[i] = (u32)((double)(FreqWordDefaults[i]) * scale);
-  }
 
+  scaleFreqWords(FreqWordBase, FreqWords, pitchBendRatio(pitchBend));
   writeFreqWords();
 
-  xil_printf("midi %i pitch bend: %i\n\r", Ch, pitchBend-8192);
+  debug_print("midi %i pitch bend: %i\n\r", Ch, pitchBend-PITCH_BEND_CENTER);
 
   return XST_SUCCESS;
 }
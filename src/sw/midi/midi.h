@@ -9,6 +9,11 @@
 #include "../utils/utils.h"
 
 #include "../synth_ctrl/synth_ctrl.h"
+#include "../synth_ctrl/synth_preset.h"
+#include "midi_parser.h"
+#include "midi_coalesce.h"
+#include "midi_sysex.h"
+#include "midi_tuning.h"
 
 /***************************************************************************
 * Constant definitions
@@ -89,20 +94,15 @@ typedef struct {
     int tail;
 } RingBuffer;
 
-typedef struct {
-    u8 status;
-    u8 msg[3];
-    u8 count;
-    u8 expected;
-} MidiParser;
-
 extern RingBuffer midi_rb;
 extern MidiParser midi_parser;
+extern MidiCoalescer midi_coalescer;
+extern u32 FreqWordBase[128];
 
 /***************************************************************************
 * Function definitions
 ****************************************************************************/
-int configMidi(u32 BaseAddress);
+int configMidi(u32 BaseAddress, u8 self_test);
 int rb_is_empty(RingBuffer *rb);
 int rb_is_full(RingBuffer *rb);
 int rb_free_space(RingBuffer *rb);
@@ -110,8 +110,10 @@ void rb_push(RingBuffer *rb, u8 byte);
 u8 rb_pop(RingBuffer *rb);
 void Handler(void *CallBackRef, u32 Event, unsigned int EventData);
 void initFreqWords(void);
+void applyFreqWordBase(void);
 int rxMidiMsg(void);
 void dispatchMidiMessage(u8 *msg, u8 len);
+void dispatchSysEx(u8 *data, u16 len);
 int MidiPolyPressure(u8 Ch, u8 key, u8 value);
 int MidiControlChange(u8 Ch, u8 control, u8 value);
 int MidiProgChange(u8 Ch, u8 value);
@@ -0,0 +1,252 @@
+/****************************************************************************/
+/**
+* midi_coalesce.c
+*
+* This file contains the MIDI event coalescer. Pressure, pitch bend and
+* continuous controller messages that are superseded before they are
+* applied are dropped, and note events are dispatched ahead of those held
+* for other channels, so a backlog of controller data cannot delay the
+* notes behind it by more than one value per control. See midi_coalesce.h
+* for how messages are sorted.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Note events flush the values held for their channel
+*
+****************************************************************************/
+
+#include <string.h>
+
+#include "midi_coalesce.h"
+
+/***************************************************************************/
+/**
+* This function resets a coalescer and sets its message handler.
+*
+* @param  c is the coalescer to reset
+* @param  dispatch is called for every message that is applied
+*
+* @return None.
+*
+****************************************************************************/
+void midiCoalesceInit(MidiCoalescer *c, MidiMsgHandler dispatch) {
+    memset(c, 0, sizeof(*c));
+    c->dispatch = dispatch;
+}
+
+/***************************************************************************/
+/**
+* This function checks whether a message only sets a continuous value, so
+* a later message for the same channel and key or controller replaces it.
+*
+* @param  msg is the message
+* @param  len is the message length
+*
+* @return 1 for pressure, pitch bend and continuous controllers, 0 otherwise
+*
+* @note   Bank select, data entry, parameter numbers, switches and channel
+*         mode controllers depend on their order and are not coalesced.
+*
+****************************************************************************/
+int midiCoalescable(const u8 *msg, u8 len) {
+    switch (msg[0] & 0xF0) {
+        case 0xA0:  // polyphonic pressure
+        case 0xE0:  // pitch bend
+            return len == 3;
+        case 0xD0:  // channel pressure
+            return len == 2;
+        case 0xB0:  // control change
+            if (len != 3) {
+                return 0;
+            }
+            return !(msg[1] == 0 || msg[1] == 32 ||     // bank select
+                     msg[1] == 6 || msg[1] == 38 ||     // data entry
+                     (msg[1] >= 64 && msg[1] <= 69) ||  // switches
+                     (msg[1] >= 96 && msg[1] <= 101) || // parameter numbers
+                     msg[1] >= 120);                    // channel mode
+        default:
+            return 0;
+    }
+}
+
+/***************************************************************************/
+/**
+* This function returns the coalescing key and value of a message.
+*
+* @param  msg is a message that midiCoalescable accepts
+* @param  value receives the value carried by the message
+*
+* @return the key
+*
+****************************************************************************/
+static u16 coalesceKeyOf(const u8 *msg, u16 *value) {
+    u8 ch = msg[0] & 0x0F;
+
+    switch (msg[0] & 0xF0) {
+        case 0xA0:
+            *value = msg[2];
+            return coalesceKey(COALESCE_POLY_PRESSURE, ch, msg[1]);
+        case 0xB0:
+            *value = msg[2];
+            return coalesceKey(COALESCE_CONTROL, ch, msg[1]);
+        case 0xD0:
+            *value = msg[1];
+            return coalesceKey(COALESCE_CH_PRESSURE, ch, 0);
+        default:
+            *value = msg[1] | (msg[2] << 7);
+            return coalesceKey(COALESCE_PITCH_BEND, ch, 0);
+    }
+}
+
+/***************************************************************************/
+/**
+* This function rebuilds the message for a pending key and dispatches it.
+*
+* @param  c is the coalescer
+* @param  key is the pending key
+*
+* @return None.
+*
+****************************************************************************/
+static void dispatchKey(MidiCoalescer *c, u16 key) {
+    u8 ch = (key >> 7) & 0x0F;
+    u8 num = key & 0x7F;
+    u16 value = c->values[key];
+    u8 msg[3];
+
+    switch (key >> 11) {
+        case COALESCE_POLY_PRESSURE:
+            msg[0] = 0xA0 | ch; msg[1] = num; msg[2] = value & 0x7F;
+            c->dispatch(msg, 3);
+            break;
+        case COALESCE_CONTROL:
+            msg[0] = 0xB0 | ch; msg[1] = num; msg[2] = value & 0x7F;
+            c->dispatch(msg, 3);
+            break;
+        case COALESCE_CH_PRESSURE:
+            msg[0] = 0xD0 | ch; msg[1] = value & 0x7F; msg[2] = 0;
+            c->dispatch(msg, 2);
+            break;
+        default:
+            msg[0] = 0xE0 | ch; msg[1] = value & 0x7F; msg[2] = (value >> 7) & 0x7F;
+            c->dispatch(msg, 3);
+            break;
+    }
+}
+
+/***************************************************************************/
+/**
+* This function dispatches the held note events in order, then the latest
+* value of each continuous control that changed.
+*
+* @param  c is the coalescer
+*
+* @return None.
+*
+****************************************************************************/
+void midiCoalesceFlush(MidiCoalescer *c) {
+    for (u16 i = 0; i < c->num_events; i ++) {
+        c->dispatch(c->events[i], 3);
+    }
+    c->num_events = 0;
+
+    for (u16 i = 0; i < c->num_pending; i ++) {
+        u16 key = c->pending[i];
+        c->is_pending[key >> 3] &= ~(1 << (key & 7));
+        dispatchKey(c, key);
+    }
+    c->num_pending = 0;
+    memset(c->ch_pending, 0, sizeof(c->ch_pending));
+}
+
+/***************************************************************************/
+/**
+* This function dispatches the held note events, then the values held for
+* one channel, keeping the rest held.
+*
+* @param  c is the coalescer
+* @param  ch is the channel
+*
+* @return None.
+*
+* @note   A channel's values are all newer than its held note events, as a
+*         note event flushes the values before it, so the order within the
+*         channel is kept.
+*
+****************************************************************************/
+static void flushChannel(MidiCoalescer *c, u8 ch) {
+    u16 kept = 0;
+
+    for (u16 i = 0; i < c->num_events; i ++) {
+        c->dispatch(c->events[i], 3);
+    }
+    c->num_events = 0;
+
+    for (u16 i = 0; i < c->num_pending; i ++) {
+        u16 key = c->pending[i];
+        if (((key >> 7) & 0x0F) == ch) {
+            c->is_pending[key >> 3] &= ~(1 << (key & 7));
+            dispatchKey(c, key);
+        } else {
+            c->pending[kept++] = key;
+        }
+    }
+    c->num_pending = kept;
+    c->ch_pending[ch] = 0;
+}
+
+/***************************************************************************/
+/**
+* This function takes a complete message from the parser.
+*
+* @param  c is the coalescer
+* @param  msg is the message
+* @param  len is the message length
+*
+* @return None.
+*
+* @note   Nothing is dispatched until the next flush, except for barrier
+*         messages and when the event or pending list is full.
+*
+****************************************************************************/
+void midiCoalesceMsg(MidiCoalescer *c, u8 *msg, u8 len) {
+    u8 cmd = msg[0] & 0xF0;
+
+    if ((cmd == 0x80 || cmd == 0x90) && len == 3) {
+        // note off and on keep their order and go first, after the values
+        // held for their own channel
+        if (c->ch_pending[msg[0] & 0x0F]) {
+            flushChannel(c, msg[0] & 0x0F);
+        } else if (c->num_events == COALESCE_MAX_EVENTS) {
+            c->early_flushes++;
+            midiCoalesceFlush(c);
+        }
+        memcpy(c->events[c->num_events++], msg, 3);
+
+    } else if (midiCoalescable(msg, len)) {
+        u16 value;
+        u16 key = coalesceKeyOf(msg, &value);
+
+        if (c->is_pending[key >> 3] & (1 << (key & 7))) {
+            c->superseded++;
+        } else {
+            if (c->num_pending == COALESCE_MAX_PENDING) {
+                c->early_flushes++;
+                midiCoalesceFlush(c);
+            }
+            c->is_pending[key >> 3] |= 1 << (key & 7);
+            c->pending[c->num_pending++] = key;
+            c->ch_pending[msg[0] & 0x0F]++;
+        }
+        c->values[key] = value;
+
+    } else {
+        // everything held happened before this message
+        midiCoalesceFlush(c);
+        c->dispatch(msg, len);
+    }
+}
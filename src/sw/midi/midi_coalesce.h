@@ -0,0 +1,73 @@
+#ifndef MIDI_COALESCE_H_
+#define MIDI_COALESCE_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "midi_parser.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// note events held in order until the next flush
+#define COALESCE_MAX_EVENTS  64
+// distinct continuous controls held until the next flush
+#define COALESCE_MAX_PENDING 256
+
+// continuous control kinds, a key is kind, channel and key or controller
+#define COALESCE_POLY_PRESSURE 0
+#define COALESCE_CONTROL       1
+#define COALESCE_CH_PRESSURE   2
+#define COALESCE_PITCH_BEND    3
+#define COALESCE_KEYS          (4 << 11)
+
+#define coalesceKey(kind, ch, num) (((kind) << 11) | (((ch) & 0x0F) << 7) | ((num) & 0x7F))
+
+/***************************************************************************
+* Global variable definitions
+****************************************************************************/
+
+/*
+ * Messages between flushes are sorted three ways:
+ *
+ *    note on and off      queued in order, dispatched first at the flush
+ *    pressure, bend and   only the latest value per channel and key or
+ *    continuous CCs       controller is kept, dispatched after the notes
+ *    everything else      a barrier, the held messages are flushed and it
+ *                         is dispatched straight away, so switches such as
+ *                         the sustain pedal keep their place among the notes
+ *
+ * A note event is a barrier for its own channel: the values held for that
+ * channel go out ahead of it, so a re-strike lands after the pressure and
+ * a note-on after the glide time sent before it. Notes still overtake the
+ * values held for other channels.
+ */
+typedef struct {
+    MidiMsgHandler dispatch;
+    // note events in arrival order
+    u8  events[COALESCE_MAX_EVENTS][3];
+    u16 num_events;
+    // latest continuous values and the keys waiting, in first arrival order
+    u16 values[COALESCE_KEYS];
+    u8  is_pending[COALESCE_KEYS / 8];
+    u16 pending[COALESCE_MAX_PENDING];
+    u16 num_pending;
+    u16 ch_pending[16];  // keys waiting per channel
+    // counters
+    u32 superseded;  // continuous values replaced before they were applied
+    u32 early_flushes; // flushes forced by a full event or pending list
+} MidiCoalescer;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+void midiCoalesceInit(MidiCoalescer *c, MidiMsgHandler dispatch);
+void midiCoalesceMsg(MidiCoalescer *c, u8 *msg, u8 len);
+void midiCoalesceFlush(MidiCoalescer *c);
+int  midiCoalescable(const u8 *msg, u8 len);
+
+#endif /* MIDI_COALESCE_H_ */
@@ -0,0 +1,190 @@
+/****************************************************************************/
+/**
+* midi_parser.c
+*
+* This file contains the MIDI byte stream parser. Message lengths come from
+* status byte tables, running status follows the MIDI 1.0 rules and System
+* Exclusive messages stream into a bounded buffer.
+*
+* REFERENCES:
+* - https://www.midi.org/specifications-old/item/table-1-summary-of-midi-message
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file, split from midi.c
+*
+****************************************************************************/
+
+#include <string.h>
+
+#include "midi_parser.h"
+
+/***************************************************************************
+* Message length tables, including the status byte, 0 for variable length
+****************************************************************************/
+
+// channel voice messages, by status high nibble 0x8 to 0xE
+static const u8 midi_channel_len[7] = {
+    3,  // 0x80 note off
+    3,  // 0x90 note on
+    3,  // 0xA0 polyphonic pressure
+    3,  // 0xB0 control change
+    2,  // 0xC0 program change
+    2,  // 0xD0 channel pressure
+    3   // 0xE0 pitch bend
+};
+
+// system messages, by status low nibble 0xF0 to 0xFF
+static const u8 midi_system_len[16] = {
+    0,  // 0xF0 system exclusive start
+    2,  // 0xF1 MTC quarter frame
+    3,  // 0xF2 song position pointer
+    2,  // 0xF3 song select
+    1,  // 0xF4 undefined
+    1,  // 0xF5 undefined
+    1,  // 0xF6 tune request
+    1,  // 0xF7 system exclusive end
+    1, 1, 1, 1, 1, 1, 1, 1  // 0xF8 to 0xFF real-time
+};
+
+/***************************************************************************/
+/**
+* This function returns the full length of a MIDI message.
+*
+* @param  status is the message status byte
+*
+* @return message length in bytes, or 0 for System Exclusive and data bytes
+*
+****************************************************************************/
+u8 midiMsgLength(u8 status) {
+    if (status < 0x80) {
+        return 0;
+    } else if (status < 0xF0) {
+        return midi_channel_len[(status >> 4) - 0x8];
+    } else {
+        return midi_system_len[status & 0x0F];
+    }
+}
+
+/***************************************************************************/
+/**
+* This function resets a parser and sets its message handlers.
+*
+* @param  p is the parser to reset
+* @param  on_msg is called for every complete short message
+* @param  on_sysex is called for every complete System Exclusive message
+*
+* @return None.
+*
+****************************************************************************/
+void midiParserInit(MidiParser *p, MidiMsgHandler on_msg, MidiSysExHandler on_sysex) {
+    memset(p, 0, sizeof(*p));
+    p->on_msg = on_msg;
+    p->on_sysex = on_sysex;
+}
+
+/***************************************************************************/
+/**
+* This function finishes the System Exclusive message in progress.
+*
+* @param  p is the parser
+* @param  complete is 1 when ended by F7, 0 when cut off by another status
+*
+****************************************************************************/
+static void midiEndSysEx(MidiParser *p, u8 complete) {
+    if (!complete) {
+        p->sysex_aborts++;
+    } else if (p->sysex_overflow) {
+        p->sysex_overflows++;
+    } else if (p->on_sysex) {
+        p->on_sysex(p->sysex, p->sysex_len);
+    }
+    p->in_sysex = 0;
+}
+
+/***************************************************************************/
+/**
+* This function parses one received MIDI byte.
+*
+* @param  p is the parser
+* @param  byte is the received byte
+*
+* @return None.
+*
+* @note   Real-time messages are passed on immediately and may appear
+*         anywhere, including inside other messages. System common
+*         messages and System Exclusive cancel running status.
+*
+****************************************************************************/
+void midiParseByte(MidiParser *p, u8 byte) {
+
+    // real-time messages, single byte and transparent to everything else
+    if (byte >= 0xF8) {
+        if (p->on_msg) {
+            p->on_msg(&byte, 1);
+        }
+        return;
+    }
+
+    // status byte
+    if (byte & 0x80) {
+        if (p->in_sysex) {
+            midiEndSysEx(p, byte == 0xF7);
+            if (byte == 0xF7) {
+                return;
+            }
+        } else if (byte == 0xF7) {
+            // end of exclusive without a start
+            p->stray_bytes++;
+            return;
+        }
+
+        p->count = 0;
+
+        if (byte == 0xF0) {
+            p->status = 0;
+            p->in_sysex = 1;
+            p->sysex_overflow = 0;
+            p->sysex_len = 0;
+            return;
+        }
+
+        // only channel messages set running status
+        p->status = (byte < 0xF0) ? byte : 0;
+        p->expected = midiMsgLength(byte);
+        p->msg[0] = byte;
+        p->count = 1;
+    } else if (p->in_sysex) {
+        // system exclusive data
+        if (p->sysex_len < MIDI_SYSEX_SIZE) {
+            p->sysex[p->sysex_len++] = byte;
+        } else {
+            p->sysex_overflow = 1;
+        }
+        return;
+    } else {
+        // data byte
+        if (p->count == 0) {
+            if (p->status == 0) {
+                // no running status available
+                p->stray_bytes++;
+                return;
+            }
+            p->expected = midiMsgLength(p->status);
+            p->msg[0] = p->status;
+            p->count = 1;
+        }
+        p->msg[p->count++] = byte;
+    }
+
+    // full message received
+    if (p->count >= p->expected) {
+        if (p->on_msg) {
+            p->on_msg(p->msg, p->count);
+        }
+        p->count = 0;
+    }
+}
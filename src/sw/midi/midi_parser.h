@@ -0,0 +1,54 @@
+#ifndef MIDI_PARSER_H_
+#define MIDI_PARSER_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// largest System Exclusive message kept, excluding the F0 and F7 bytes
+#define MIDI_SYSEX_SIZE 512
+
+/***************************************************************************
+* Global variable definitions
+****************************************************************************/
+
+// complete short message: channel voice/mode, system common or real-time
+typedef void (*MidiMsgHandler)(u8 *msg, u8 len);
+// complete System Exclusive message, without the F0 and F7 bytes
+typedef void (*MidiSysExHandler)(u8 *data, u16 len);
+
+typedef struct {
+    // short message state
+    u8 status;      // running status, 0 when none
+    u8 msg[3];
+    u8 count;
+    u8 expected;
+    // system exclusive state
+    u8 in_sysex;
+    u8 sysex_overflow;
+    u16 sysex_len;
+    u8 sysex[MIDI_SYSEX_SIZE];
+    // message handlers
+    MidiMsgHandler on_msg;
+    MidiSysExHandler on_sysex;
+    // error counters
+    u32 stray_bytes;     // data bytes with no status to apply to
+    u32 sysex_overflows; // SysEx longer than MIDI_SYSEX_SIZE, dropped
+    u32 sysex_aborts;    // SysEx ended by a status byte other than F7
+} MidiParser;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+void midiParserInit(MidiParser *p, MidiMsgHandler on_msg, MidiSysExHandler on_sysex);
+void midiParseByte(MidiParser *p, u8 byte);
+u8   midiMsgLength(u8 status);
+
+#endif /* MIDI_PARSER_H_ */
@@ -0,0 +1,256 @@
+/****************************************************************************/
+/**
+* midi_sysex.c
+*
+* This file contains the encoding and decoding of the synth System
+* Exclusive messages. See midi_sysex.h for the message formats.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Add preset store message
+* 0.02  agt    10/19/26 Add latency request message
+*
+****************************************************************************/
+
+#include "midi_sysex.h"
+
+/***************************************************************************/
+/**
+* This function calculates the checksum for a SysEx payload.
+*
+* @param  data is the payload
+* @param  len is the payload length
+*
+* @return the 7-bit value that makes the payload sum to zero
+*
+****************************************************************************/
+u8 sysexChecksum(const u8 *data, u16 len) {
+    u8 sum = 0;
+    for (u16 i = 0; i < len; i ++) {
+        sum += data[i];
+    }
+    return (u8)(-sum) & 0x7F;
+}
+
+/***************************************************************************/
+/**
+* This function checks a SysEx message is addressed to this synth.
+*
+* @param  data is the message without the F0 and F7 bytes
+* @param  len is the message length
+*
+* @return 1 if the header matches, 0 otherwise
+*
+****************************************************************************/
+int sysexIsOurs(const u8 *data, u16 len) {
+    return (len >= SYSEX_HEADER_LEN &&
+            data[0] == SYSEX_MANUFACTURER_ID &&
+            data[1] == SYSEX_DEVICE_ID);
+}
+
+/***************************************************************************/
+/**
+* This function decodes the patch fields of a payload.
+*
+* @param  payload is the patch dump payload
+* @param  patch receives the fields
+*
+* @return None
+*
+****************************************************************************/
+static void decodePatchFields(const u8 *payload, SynthPatch *patch) {
+    for (u8 i = 0; i < NUM_WAVES; i ++) {
+        patch->wave_amps[i] = payload[i];
+    }
+    patch->pulse_width  = payload[5] | (payload[6] << 7) | ((payload[7] & 0x03) << 14);
+    patch->out_amp      = payload[8];
+    patch->out_shift    = payload[9];
+    patch->attack       = payload[10];
+    patch->decay        = payload[11];
+    patch->sustain      = payload[12];
+    patch->release      = payload[13];
+    patch->pan_position = payload[14];
+    patch->pan_spread   = payload[15];
+    patch->slew_wfrm    = payload[16];
+    patch->slew_out     = payload[17];
+    patch->slew_pw      = payload[18];
+}
+
+/***************************************************************************/
+/**
+* This function encodes the patch fields of a payload.
+*
+* @param  patch is the patch to encode
+* @param  payload receives SYSEX_PATCH_LEN bytes
+*
+* @return None
+*
+****************************************************************************/
+static void encodePatchFields(const SynthPatch *patch, u8 *payload) {
+    for (u8 i = 0; i < NUM_WAVES; i ++) {
+        payload[i] = patch->wave_amps[i] & 0x7F;
+    }
+    payload[5]  = patch->pulse_width & 0x7F;
+    payload[6]  = (patch->pulse_width >> 7) & 0x7F;
+    payload[7]  = (patch->pulse_width >> 14) & 0x03;
+    payload[8]  = patch->out_amp & 0x7F;
+    payload[9]  = patch->out_shift & 0x7F;
+    payload[10] = patch->attack & 0x7F;
+    payload[11] = patch->decay & 0x7F;
+    payload[12] = patch->sustain & 0x7F;
+    payload[13] = patch->release & 0x7F;
+    payload[14] = patch->pan_position & 0x7F;
+    payload[15] = patch->pan_spread & 0x7F;
+    payload[16] = patch->slew_wfrm & 0x7F;
+    payload[17] = patch->slew_out & 0x7F;
+    payload[18] = patch->slew_pw & 0x7F;
+}
+
+/***************************************************************************/
+/**
+* This function decodes a patch dump message.
+*
+* @param  data is the message without the F0 and F7 bytes
+* @param  len is the message length
+* @param  patch is filled in when the message is valid
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+* @note   The patch is left untouched unless the header, length and
+*         checksum are all valid.
+*
+****************************************************************************/
+int sysexDecodePatch(const u8 *data, u16 len, SynthPatch *patch) {
+
+    if (!sysexIsOurs(data, len) || data[2] != SYSEX_CMD_PATCH_DUMP) {
+        return XST_FAILURE;
+    }
+    if (len != SYSEX_PATCH_MSG_LEN) {
+        return XST_FAILURE;
+    }
+
+    const u8 *payload = &data[SYSEX_HEADER_LEN];
+    if (sysexChecksum(payload, SYSEX_PATCH_LEN) != payload[SYSEX_PATCH_LEN]) {
+        return XST_FAILURE;
+    }
+
+    decodePatchFields(payload, patch);
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function encodes a patch dump message.
+*
+* @param  patch is the patch to encode
+* @param  data receives SYSEX_PATCH_MSG_LEN bytes, without F0 and F7
+*
+* @return the message length
+*
+****************************************************************************/
+u16 sysexEncodePatch(const SynthPatch *patch, u8 *data) {
+
+    u8 *payload = &data[SYSEX_HEADER_LEN];
+
+    data[0] = SYSEX_MANUFACTURER_ID;
+    data[1] = SYSEX_DEVICE_ID;
+    data[2] = SYSEX_CMD_PATCH_DUMP;
+
+    encodePatchFields(patch, payload);
+    payload[SYSEX_PATCH_LEN] = sysexChecksum(payload, SYSEX_PATCH_LEN);
+
+    return SYSEX_PATCH_MSG_LEN;
+}
+
+/***************************************************************************/
+/**
+* This function decodes a preset store message.
+*
+* @param  data is the message without the F0 and F7 bytes
+* @param  len is the message length
+* @param  program receives the preset number
+* @param  patch is filled in when the message is valid
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int sysexDecodePreset(const u8 *data, u16 len, u8 *program, SynthPatch *patch) {
+
+    if (!sysexIsOurs(data, len) || data[2] != SYSEX_CMD_PRESET_STORE) {
+        return XST_FAILURE;
+    }
+    if (len != SYSEX_PRESET_MSG_LEN) {
+        return XST_FAILURE;
+    }
+
+    const u8 *payload = &data[SYSEX_HEADER_LEN];
+    if (sysexChecksum(payload, SYSEX_PRESET_LEN) != payload[SYSEX_PRESET_LEN]) {
+        return XST_FAILURE;
+    }
+
+    *program = payload[0];
+    decodePatchFields(&payload[1], patch);
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function encodes a preset store message.
+*
+* @param  program is the preset number
+* @param  patch is the patch to encode
+* @param  data receives SYSEX_PRESET_MSG_LEN bytes, without F0 and F7
+*
+* @return the message length
+*
+****************************************************************************/
+u16 sysexEncodePreset(u8 program, const SynthPatch *patch, u8 *data) {
+
+    u8 *payload = &data[SYSEX_HEADER_LEN];
+
+    data[0] = SYSEX_MANUFACTURER_ID;
+    data[1] = SYSEX_DEVICE_ID;
+    data[2] = SYSEX_CMD_PRESET_STORE;
+
+    payload[0] = program & 0x7F;
+    encodePatchFields(patch, &payload[1]);
+    payload[SYSEX_PRESET_LEN] = sysexChecksum(payload, SYSEX_PRESET_LEN);
+
+    return SYSEX_PRESET_MSG_LEN;
+}
+
+/***************************************************************************/
+/**
+* This function decodes a latency request message.
+*
+* @param  data is the message without the F0 and F7 bytes
+* @param  len is the message length
+* @param  flags receives the request flags
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int sysexDecodeLatency(const u8 *data, u16 len, u8 *flags) {
+
+    if (!sysexIsOurs(data, len) || data[2] != SYSEX_CMD_LATENCY) {
+        return XST_FAILURE;
+    }
+    if (len != SYSEX_LATENCY_MSG_LEN) {
+        return XST_FAILURE;
+    }
+
+    const u8 *payload = &data[SYSEX_HEADER_LEN];
+    if (sysexChecksum(payload, SYSEX_LATENCY_LEN) != payload[SYSEX_LATENCY_LEN]) {
+        return XST_FAILURE;
+    }
+
+    *flags = payload[0];
+
+    return XST_SUCCESS;
+}
@@ -0,0 +1,76 @@
+#ifndef MIDI_SYSEX_H_
+#define MIDI_SYSEX_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#include "../synth_ctrl/synth_ctrl.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+/*
+ * Synth System Exclusive messages, shown without the F0 and F7 bytes:
+ *
+ *   7D 5A <command> <payload ...> <checksum>
+ *
+ * 7D is the non-commercial manufacturer ID and 5A identifies this synth.
+ * The checksum makes the 7-bit sum of the payload and checksum zero.
+ */
+#define SYSEX_MANUFACTURER_ID 0x7D
+#define SYSEX_DEVICE_ID       0x5A
+#define SYSEX_HEADER_LEN      3
+
+// commands
+#define SYSEX_CMD_PATCH_DUMP   0x01
+#define SYSEX_CMD_PRESET_STORE 0x02
+#define SYSEX_CMD_LATENCY      0x03
+
+/*
+ * Patch dump payload, one 7-bit byte per field unless noted:
+ *
+ *    0- 4  pulse, ramp, saw, tri and sine amps
+ *    5- 7  pulse width, 16 bits sent 7 bits at a time LSB first
+ *    8     output amp
+ *    9     output shift
+ *   10-13  attack, decay, sustain and release (MIDI CC values)
+ *   14-15  pan position and pan spread
+ *   16-18  waveform amp, output amp and pulse width slew rates
+ */
+#define SYSEX_PATCH_LEN       19
+#define SYSEX_PATCH_MSG_LEN   (SYSEX_HEADER_LEN + SYSEX_PATCH_LEN + 1)
+
+/*
+ * Preset store payload, the program number followed by a patch dump
+ * payload. The checksum covers the program number too.
+ */
+#define SYSEX_PRESET_LEN      (SYSEX_PATCH_LEN + 1)
+#define SYSEX_PRESET_MSG_LEN  (SYSEX_HEADER_LEN + SYSEX_PRESET_LEN + 1)
+
+/*
+ * Latency request payload, one flags byte. The control path latency
+ * histograms are printed on the debug UART, then emptied when
+ * SYSEX_LATENCY_CLEAR is set. Only debug builds answer.
+ */
+#define SYSEX_LATENCY_CLEAR   0x01
+#define SYSEX_LATENCY_LEN     1
+#define SYSEX_LATENCY_MSG_LEN (SYSEX_HEADER_LEN + SYSEX_LATENCY_LEN + 1)
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+u8   sysexChecksum(const u8 *data, u16 len);
+int  sysexIsOurs(const u8 *data, u16 len);
+int  sysexDecodePatch(const u8 *data, u16 len, SynthPatch *patch);
+u16  sysexEncodePatch(const SynthPatch *patch, u8 *data);
+int  sysexDecodePreset(const u8 *data, u16 len, u8 *program, SynthPatch *patch);
+u16  sysexEncodePreset(u8 program, const SynthPatch *patch, u8 *data);
+int  sysexDecodeLatency(const u8 *data, u16 len, u8 *flags);
+
+#endif /* MIDI_SYSEX_H_ */
@@ -0,0 +1,202 @@
+/****************************************************************************/
+/**
+* midi_tuning.c
+*
+* This file contains the decoding of MIDI Tuning Standard messages into
+* the synth frequency words, and the fixed-point pitch bend. See
+* midi_tuning.h for the message formats.
+*
+* Ratios come from the Q30 tables in pitch.h, so a retune or bend is only
+* integer multiplies. Whole table updates use NEON when it is enabled.
+*
+* REFERENCES:
+* - https://midi.org/midi-tuning-updated-specification
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Fixed-point tuning and pitch bend from Q30 tables
+*
+****************************************************************************/
+
+#include "midi_tuning.h"
+#include "pitch.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/***************************************************************************/
+/**
+* This function multiplies a value by a Q30 ratio.
+*
+* @param  value is the value to scale
+* @param  ratio is the Q30 ratio
+*
+* @return the scaled value, truncated
+*
+****************************************************************************/
+static inline u32 ratioScale(u32 value, u32 ratio) {
+    return (u32)(((u64)value * ratio) >> PITCH_RATIO_Q);
+}
+
+/***************************************************************************/
+/**
+* This function looks up the ratio of a 14-bit value from a coarse and a
+* fine table.
+*
+* @param  coarse is indexed by the upper 7 bits
+* @param  fine is indexed by the lower 7 bits
+* @param  value is the 14-bit value
+*
+* @return the Q30 ratio, rounded
+*
+****************************************************************************/
+static inline u32 ratioLookup(const u32 *coarse, const u32 *fine, u16 value) {
+    u64 ratio = (u64)coarse[(value >> 7) & 0x7F] * fine[value & 0x7F];
+    return (u32)((ratio + (1ULL << (PITCH_RATIO_Q - 1))) >> PITCH_RATIO_Q);
+}
+
+/***************************************************************************/
+/**
+* This function checks a SysEx message is a tuning message for this synth.
+*
+* @param  data is the message without the F0 and F7 bytes
+* @param  len is the message length
+*
+* @return 1 if the message is a tuning message, 0 otherwise
+*
+****************************************************************************/
+int mtsIsTuning(const u8 *data, u16 len) {
+    return (len >= 4 &&
+            (data[0] == MTS_NON_REALTIME || data[0] == MTS_REALTIME) &&
+            (data[1] == MTS_DEVICE_ALL || data[1] == MTS_DEVICE_ID) &&
+            data[2] == MTS_SUB_ID);
+}
+
+/***************************************************************************/
+/**
+* This function calculates the frequency word for a tuning.
+*
+* @param  semitone is the MIDI note number
+* @param  fraction is the 14-bit fraction of a semitone above it
+*
+* @return the frequency word
+*
+****************************************************************************/
+u32 tuningWord(u8 semitone, u16 fraction) {
+    u32 ratio = ratioLookup(TuneRatioCoarse, TuneRatioFine, fraction);
+    return ratioScale(FreqWordDefaults[semitone & 0x7F], ratio);
+}
+
+/***************************************************************************/
+/**
+* This function looks up the frequency ratio of a pitch bend.
+*
+* @param  bend is the 14-bit pitch bend, PITCH_BEND_CENTER is no change
+*
+* @return the Q30 ratio
+*
+****************************************************************************/
+u32 pitchBendRatio(u16 bend) {
+    return ratioLookup(BendRatioCoarse, BendRatioFine, bend);
+}
+
+/***************************************************************************/
+/**
+* This function scales a whole frequency word table by a ratio.
+*
+* @param  base is the 128 entry table to scale
+* @param  words receives the 128 scaled words
+* @param  ratio is the Q30 ratio
+*
+* @return None
+*
+* @note   The NEON and scalar paths give identical words.
+*
+****************************************************************************/
+void scaleFreqWords(const u32 *base, u32 *words, u32 ratio) {
+#if defined(__ARM_NEON)
+    for (u16 i = 0; i < 128; i += 4) {
+        uint32x4_t w = vld1q_u32(&base[i]);
+        uint64x2_t lo = vmull_n_u32(vget_low_u32(w), ratio);
+        uint64x2_t hi = vmull_n_u32(vget_high_u32(w), ratio);
+        vst1q_u32(&words[i], vcombine_u32(vshrn_n_u64(lo, PITCH_RATIO_Q),
+                                          vshrn_n_u64(hi, PITCH_RATIO_Q)));
+    }
+#else
+    for (u16 i = 0; i < 128; i ++) {
+        words[i] = ratioScale(base[i], ratio);
+    }
+#endif
+}
+
+/***************************************************************************/
+/**
+* This function calculates the frequency word of a three byte tuning.
+*
+* @param  tuning points to the xx yy zz bytes
+* @param  word receives the frequency word unless the tuning is 7F 7F 7F
+*
+* @return None
+*
+****************************************************************************/
+static void decodeNote(const u8 *tuning, u32 *word) {
+    if (tuning[0] == MTS_NO_CHANGE && tuning[1] == MTS_NO_CHANGE && tuning[2] == MTS_NO_CHANGE) {
+        return;
+    }
+    *word = tuningWord(tuning[0] & 0x7F, ((tuning[1] & 0x7F) << 7) | (tuning[2] & 0x7F));
+}
+
+/***************************************************************************/
+/**
+* This function decodes a tuning bulk dump or single note change.
+*
+* @param  data is the message without the F0 and F7 bytes
+* @param  len is the message length
+* @param  freq_words is the 128 entry table to retune
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+* @note   The table is left untouched unless the whole message is valid.
+*
+****************************************************************************/
+int mtsDecode(const u8 *data, u16 len, u32 *freq_words) {
+
+    if (!mtsIsTuning(data, len)) {
+        return XST_FAILURE;
+    }
+
+    if (data[0] == MTS_NON_REALTIME && data[3] == MTS_BULK_DUMP) {
+        if (len != MTS_BULK_DUMP_LEN) {
+            return XST_FAILURE;
+        }
+        u8 sum = 0;
+        for (u16 i = 0; i < MTS_BULK_DUMP_LEN - 1; i ++) {
+            sum ^= data[i];
+        }
+        if ((sum & 0x7F) != data[MTS_BULK_DUMP_LEN - 1]) {
+            return XST_FAILURE;
+        }
+        const u8 *tuning = &data[5 + MTS_NAME_LEN];
+        for (u16 i = 0; i < 128; i ++) {
+            decodeNote(&tuning[MTS_NOTE_LEN*i], &freq_words[i]);
+        }
+        return XST_SUCCESS;
+    }
+
+    if (data[0] == MTS_REALTIME && data[3] == MTS_NOTE_CHANGE) {
+        if (len < MTS_NOTE_CHANGE_HDR || len != MTS_NOTE_CHANGE_HDR + 4*data[5]) {
+            return XST_FAILURE;
+        }
+        for (u16 i = MTS_NOTE_CHANGE_HDR; i < len; i += 4) {
+            decodeNote(&data[i + 1], &freq_words[data[i] & 0x7F]);
+        }
+        return XST_SUCCESS;
+    }
+
+    return XST_FAILURE;
+}
@@ -0,0 +1,52 @@
+#ifndef MIDI_TUNING_H_
+#define MIDI_TUNING_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+/*
+ * MIDI Tuning Standard universal System Exclusive messages, shown without
+ * the F0 and F7 bytes. Each note is tuned by three bytes, xx yy zz, giving
+ * the semitone xx plus a 14-bit fraction yyzz of a semitone above it. The
+ * value 7F 7F 7F leaves the note unchanged.
+ *
+ * Bulk dump, non-real-time:
+ *   7E <dev> 08 01 <program> <name x16> (xx yy zz)x128 <checksum>
+ * The checksum is the XOR of every byte from 7E to the last tuning byte.
+ *
+ * Single note change, real-time:
+ *   7F <dev> 08 02 <program> <count> (<key> xx yy zz)x<count>
+ */
+#define MTS_NON_REALTIME      0x7E
+#define MTS_REALTIME          0x7F
+#define MTS_DEVICE_ALL        0x7F
+#define MTS_DEVICE_ID         0x00
+#define MTS_SUB_ID            0x08
+#define MTS_BULK_DUMP         0x01
+#define MTS_NOTE_CHANGE       0x02
+
+#define MTS_NAME_LEN          16
+#define MTS_NOTE_LEN          3
+#define MTS_BULK_DUMP_LEN     (5 + MTS_NAME_LEN + 128*MTS_NOTE_LEN + 1)
+#define MTS_NOTE_CHANGE_HDR   6
+#define MTS_NO_CHANGE         0x7F
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+int  mtsIsTuning(const u8 *data, u16 len);
+u32  tuningWord(u8 semitone, u16 fraction);
+u32  pitchBendRatio(u16 bend);
+void scaleFreqWords(const u32 *base, u32 *words, u32 ratio);
+int  mtsDecode(const u8 *data, u16 len, u32 *freq_words);
+
+#endif /* MIDI_TUNING_H_ */
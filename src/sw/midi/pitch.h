@@ -1,20 +1,34 @@
 #ifndef PITCH_H
 #define PITCH_H
 
+/*
+ * GENERATED by src/tools/gen_tuning.py, do not edit. The engine
+ * music_note_pkg.vhd is generated from the same parameters.
+ */
+
 /***************************************************************************
 * Include files
 ****************************************************************************/
 
 #include "xil_types.h"
-#include <math.h>
 
 /***************************************************************************
 * Constant definitions
 ****************************************************************************/
 
-#define PITCH_BEND_RANGE 2.0  // ±2 semitones
+#define PITCH_BEND_RANGE 2  // ±2 semitones
+#define PITCH_BEND_CENTER 0x2000
+
+// ratio tables are unsigned Q30, 1.0 is 1 << PITCH_RATIO_Q
+#define PITCH_RATIO_Q    30
+
+// engine clock, note slots and reference pitch the tables are built for
+#define TUNING_CLK_HZ    12288000
+#define TUNING_NUM_NOTES 128
+#define TUNING_A4_HZ     440.0
+#define TUNING_FRAME_HZ  ((double)TUNING_CLK_HZ / TUNING_NUM_NOTES)
 
-// pre-computed frequency words for 128-note 25 MHz time-multiplexed synthesizer
+// pre-computed frequency words, one per MIDI note
 static const u32 FreqWordDefaults[128] = { \
   0x000594d3, \
   0x0005e9c9, \
@@ -145,14 +159,80 @@ static const u32 FreqWordDefaults[128] = { \
   0x1f92a6c8, \
   0x2173455d};
 
-/***************************************************************************
-* Helper macros
-****************************************************************************/
+// pitch bend ratio by bend MSB, centered on 0x40
+static const u32 BendRatioCoarse[128] = { \
+  0x39047c0f, 0x391edb28, 0x39394674, 0x3953bdf8, 0x396e41ba, 0x3988d1bf, 0x39a36e0e, 0x39be16ab, \
+  0x39d8cb9c, 0x39f38ce8, 0x3a0e5a94, 0x3a2934a5, 0x3a441b22, 0x3a5f0e10, 0x3a7a0d75, 0x3a951956, \
+  0x3ab031ba, 0x3acb56a6, 0x3ae68820, 0x3b01c62e, 0x3b1d10d5, 0x3b38681c, 0x3b53cc08, 0x3b6f3c9f, \
+  0x3b8ab9e7, 0x3ba643e6, 0x3bc1daa2, 0x3bdd7e20, 0x3bf92e67, 0x3c14eb7c, 0x3c30b566, 0x3c4c8c2a, \
+  0x3c686fce, 0x3c846059, 0x3ca05dcf, 0x3cbc6838, 0x3cd87f99, 0x3cf4a3f8, 0x3d10d55b, 0x3d2d13c8, \
+  0x3d495f45, 0x3d65b7d9, 0x3d821d89, 0x3d9e905b, 0x3dbb1056, 0x3dd79d7f, 0x3df437dd, 0x3e10df75, \
+  0x3e2d944f, 0x3e4a566f, 0x3e6725dc, 0x3e84029d, 0x3ea0ecb7, 0x3ebde430, 0x3edae910, 0x3ef7fb5b, \
+  0x3f151b19, 0x3f32484f, 0x3f4f8303, 0x3f6ccb3d, 0x3f8a2101, 0x3fa78457, 0x3fc4f545, 0x3fe273d0, \
+  0x40000000, 0x401d99da, 0x403b4166, 0x4058f6a8, 0x4076b9a8, 0x40948a6c, 0x40b268fa, 0x40d05559, \
+  0x40ee4f8e, 0x410c57a2, 0x412a6d99, 0x4148917a, 0x4166c34c, 0x41850316, 0x41a350dc, 0x41c1aca7, \
+  0x41e0167d, 0x41fe8e64, 0x421d1462, 0x423ba87e, 0x425a4abf, 0x4278fb2b, 0x4297b9c9, 0x42b6869f, \
+  0x42d561b4, 0x42f44b0e, 0x431342b5, 0x433248ae, 0x43515d00, 0x43707fb2, 0x438fb0cb, 0x43aef051, \
+  0x43ce3e4b, 0x43ed9ac0, 0x440d05b6, 0x442c7f34, 0x444c0740, 0x446b9de2, 0x448b4321, 0x44aaf702, \
+  0x44cab98d, 0x44ea8ac8, 0x450a6abb, 0x452a596b, 0x454a56e1, 0x456a6323, 0x458a7e37, 0x45aaa824, \
+  0x45cae0f2, 0x45eb28a7, 0x460b7f4a, 0x462be4e2, 0x464c5976, 0x466cdd0d, 0x468d6fae, 0x46ae115f, \
+  0x46cec228, 0x46ef8210, 0x4710511e, 0x47312f58, 0x47521cc6, 0x4773196e, 0x47942559, 0x47b5408c};
+
+// pitch bend ratio by bend LSB
+static const u32 BendRatioFine[128] = { \
+  0x40000000, 0x40003b26, 0x4000764c, 0x4000b173, 0x4000ec9a, 0x400127c1, 0x400162e8, 0x40019e0f, \
+  0x4001d937, 0x4002145f, 0x40024f87, 0x40028aaf, 0x4002c5d8, 0x40030100, 0x40033c29, 0x40037752, \
+  0x4003b27c, 0x4003eda5, 0x400428cf, 0x400463f9, 0x40049f23, 0x4004da4e, 0x40051578, 0x400550a3, \
+  0x40058bce, 0x4005c6fa, 0x40060225, 0x40063d51, 0x4006787d, 0x4006b3a9, 0x4006eed5, 0x40072a02, \
+  0x4007652e, 0x4007a05b, 0x4007db89, 0x400816b6, 0x400851e4, 0x40088d11, 0x4008c83f, 0x4009036e, \
+  0x40093e9c, 0x400979cb, 0x4009b4fa, 0x4009f029, 0x400a2b58, 0x400a6688, 0x400aa1b7, 0x400adce7, \
+  0x400b1818, 0x400b5348, 0x400b8e79, 0x400bc9a9, 0x400c04da, 0x400c400c, 0x400c7b3d, 0x400cb66f, \
+  0x400cf1a1, 0x400d2cd3, 0x400d6805, 0x400da338, 0x400dde6a, 0x400e199d, 0x400e54d0, 0x400e9004, \
+  0x400ecb37, 0x400f066b, 0x400f419f, 0x400f7cd4, 0x400fb808, 0x400ff33d, 0x40102e72, 0x401069a7, \
+  0x4010a4dc, 0x4010e011, 0x40111b47, 0x4011567d, 0x401191b3, 0x4011ccea, 0x40120820, 0x40124357, \
+  0x40127e8e, 0x4012b9c5, 0x4012f4fd, 0x40133034, 0x40136b6c, 0x4013a6a4, 0x4013e1dd, 0x40141d15, \
+  0x4014584e, 0x40149387, 0x4014cec0, 0x401509f9, 0x40154533, 0x4015806d, 0x4015bba7, 0x4015f6e1, \
+  0x4016321b, 0x40166d56, 0x4016a891, 0x4016e3cc, 0x40171f07, 0x40175a43, 0x4017957f, 0x4017d0ba, \
+  0x40180bf7, 0x40184733, 0x40188270, 0x4018bdac, 0x4018f8e9, 0x40193427, 0x40196f64, 0x4019aaa2, \
+  0x4019e5df, 0x401a211e, 0x401a5c5c, 0x401a979a, 0x401ad2d9, 0x401b0e18, 0x401b4957, 0x401b8496, \
+  0x401bbfd6, 0x401bfb16, 0x401c3656, 0x401c7196, 0x401cacd6, 0x401ce817, 0x401d2358, 0x401d5e99};
 
-// pitch-bend linear approximation
-#define get_pitch_bend_scale(pitch_bend) (1.0 + ((pitch_bend - 8192) / 8192.0 * PITCH_BEND_RANGE) / 12.0)
+// tuning fraction ratio by the MSB of a 14-bit semitone fraction
+static const u32 TuneRatioCoarse[128] = { \
+  0x40000000, 0x4007652e, 0x400ecb37, 0x4016321b, 0x401d99da, 0x40250274, 0x402c6be9, 0x4033d63a, \
+  0x403b4166, 0x4042ad6d, 0x404a1a4f, 0x4051880e, 0x4058f6a8, 0x4060661e, 0x4067d670, 0x406f479e, \
+  0x4076b9a8, 0x407e2c8e, 0x4085a051, 0x408d14f0, 0x40948a6c, 0x409c00c4, 0x40a377f9, 0x40aaf00b, \
+  0x40b268fa, 0x40b9e2c6, 0x40c15d6f, 0x40c8d8f5, 0x40d05559, 0x40d7d29a, 0x40df50b8, 0x40e6cfb5, \
+  0x40ee4f8e, 0x40f5d046, 0x40fd51dc, 0x4104d450, 0x410c57a2, 0x4113dbd2, 0x411b60e0, 0x4122e6cd, \
+  0x412a6d99, 0x4131f543, 0x41397dcc, 0x41410734, 0x4148917a, 0x41501ca0, 0x4157a8a5, 0x415f3589, \
+  0x4166c34c, 0x416e51ef, 0x4175e172, 0x417d71d4, 0x41850316, 0x418c9537, 0x41942839, 0x419bbc1b, \
+  0x41a350dc, 0x41aae67f, 0x41b27d01, 0x41ba1464, 0x41c1aca7, 0x41c945cc, 0x41d0dfd1, 0x41d87ab6, \
+  0x41e0167d, 0x41e7b325, 0x41ef50ae, 0x41f6ef18, 0x41fe8e64, 0x42062e91, 0x420dcf9f, 0x42157190, \
+  0x421d1462, 0x4224b816, 0x422c5cac, 0x42340224, 0x423ba87e, 0x42434fbb, 0x424af7da, 0x4252a0db, \
+  0x425a4abf, 0x4261f586, 0x4269a12f, 0x42714dbc, 0x4278fb2b, 0x4280a97e, 0x428858b3, 0x429008cc, \
+  0x4297b9c9, 0x429f6ba9, 0x42a71e6c, 0x42aed214, 0x42b6869f, 0x42be3c0e, 0x42c5f261, 0x42cda998, \
+  0x42d561b4, 0x42dd1ab4, 0x42e4d498, 0x42ec8f61, 0x42f44b0e, 0x42fc07a0, 0x4303c518, 0x430b8374, \
+  0x431342b5, 0x431b02db, 0x4322c3e6, 0x432a85d7, 0x433248ae, 0x433a0c6a, 0x4341d10b, 0x43499693, \
+  0x43515d00, 0x43592453, 0x4360ec8d, 0x4368b5ad, 0x43707fb2, 0x43784a9f, 0x43801672, 0x4387e32b, \
+  0x438fb0cb, 0x43977f52, 0x439f4ec0, 0x43a71f15, 0x43aef051, 0x43b6c275, 0x43be957f, 0x43c66972};
 
-// pitch-bend exponential equation
-//#define get_pitch_bend_scale(pitch_bend) pow(2.0, (((pitch_bend - 8192)/ 8192.0 * PITCH_BEND_RANGE) / 12.0))
+// tuning fraction ratio by the LSB
+static const u32 TuneRatioFine[128] = { \
+  0x40000000, 0x40000eca, 0x40001d93, 0x40002c5d, 0x40003b26, 0x400049f0, 0x400058b9, 0x40006783, \
+  0x4000764c, 0x40008516, 0x400093e0, 0x4000a2a9, 0x4000b173, 0x4000c03d, 0x4000cf06, 0x4000ddd0, \
+  0x4000ec9a, 0x4000fb64, 0x40010a2d, 0x400118f7, 0x400127c1, 0x4001368b, 0x40014554, 0x4001541e, \
+  0x400162e8, 0x400171b2, 0x4001807c, 0x40018f46, 0x40019e0f, 0x4001acd9, 0x4001bba3, 0x4001ca6d, \
+  0x4001d937, 0x4001e801, 0x4001f6cb, 0x40020595, 0x4002145f, 0x40022329, 0x400231f3, 0x400240bd, \
+  0x40024f87, 0x40025e51, 0x40026d1b, 0x40027be5, 0x40028aaf, 0x40029979, 0x4002a843, 0x4002b70e, \
+  0x4002c5d8, 0x4002d4a2, 0x4002e36c, 0x4002f236, 0x40030100, 0x40030fcb, 0x40031e95, 0x40032d5f, \
+  0x40033c29, 0x40034af4, 0x400359be, 0x40036888, 0x40037752, 0x4003861d, 0x400394e7, 0x4003a3b1, \
+  0x4003b27c, 0x4003c146, 0x4003d011, 0x4003dedb, 0x4003eda5, 0x4003fc70, 0x40040b3a, 0x40041a05, \
+  0x400428cf, 0x4004379a, 0x40044664, 0x4004552f, 0x400463f9, 0x400472c4, 0x4004818e, 0x40049059, \
+  0x40049f23, 0x4004adee, 0x4004bcb9, 0x4004cb83, 0x4004da4e, 0x4004e918, 0x4004f7e3, 0x400506ae, \
+  0x40051578, 0x40052443, 0x4005330e, 0x400541d8, 0x400550a3, 0x40055f6e, 0x40056e39, 0x40057d03, \
+  0x40058bce, 0x40059a99, 0x4005a964, 0x4005b82f, 0x4005c6fa, 0x4005d5c4, 0x4005e48f, 0x4005f35a, \
+  0x40060225, 0x400610f0, 0x40061fbb, 0x40062e86, 0x40063d51, 0x40064c1c, 0x40065ae7, 0x400669b2, \
+  0x4006787d, 0x40068748, 0x40069613, 0x4006a4de, 0x4006b3a9, 0x4006c274, 0x4006d13f, 0x4006e00a, \
+  0x4006eed5, 0x4006fda0, 0x40070c6b, 0x40071b36, 0x40072a02, 0x400738cd, 0x40074798, 0x40075663};
 
-#endif /* PITCH_H */
\ No newline at end of file
+#endif /* PITCH_H */
@@ -11,29 +11,131 @@
 * Ver   Who    Date     Changes
 * ----- ------ -------- -----------------------------------------------------
 * 0.00  tjh    08/19/22 Initial file
+* 0.01  agt    10/19/26 Power up from a register table in queued batches
+* 0.02  agt    10/19/26 Run the power-up in the background, readback optional
+* 0.03  agt    10/19/26 Queued register reads for the console
 *
 ****************************************************************************/
 
 #include "ssm2603.h"
 #include <xil_types.h>
 #include <xstatus.h>
+#include "xtime_l.h"
 
 codecSSM2603_t codecSSM2603;
 
 
 /***************************************************************************
-* Codec write
+* Power-up sequence, see the SSM2603 data sheet
 ****************************************************************************/
 
-int codec_write(AddressType reg, u16 data)
+static const CodecRegWrite codec_init_seq[] = {
+ /* 1. Enable all of the necessary power management bits of
+  *    Register R6 with the exception of the out bit (Bit D4). The
+  *    out bit should not be set to 1 until the final step of the
+  *    control register sequence.
+  */
+  { CODEC_PWR_MGMT,       PM_PB_ONLY_EXT },
+
+ /* 2. After the power management bits are set, program all other
+  *    necessary registers with the exception of the active bit
+  *    [Register R9, Bit D0] and the out bit of the power manage-
+  *    ment register.
+  */
+  // enable dac at output mixer
+  { CODEC_AN_AUDIO_PATH,  M_DACSEL | M_MUTEMIC },
+  // set clock condition for MCLK=12.288 MHz and 96 kHz sample rate
+  { CODEC_SAMPLE_RATE,    0x7 << B_SR },
+  // unmute the DAC output
+  { CODEC_DIG_AUDIO_PATH, 0 },
+
+ /* 3. As described in the Digital Core Clock section of the
+  *    Theory of Operation, insert enough delay time to charge
+  *    the VMID decoupling capacitor before setting the active
+  *    bit [Register R9, Bit D0].
+  *
+  *    Delay time t = C x 25,000 / 3.5
+  *    where C is the capcitance at the VMID pin
+  *
+  *    t = 10.1 uF x 25,000 / 3.5 = 73 ms
+  */
+  { CODEC_DELAY_MS,       73 },
+  { CODEC_ACTIVE,         M_ACTIVE },
+
+ /* 4. Finally, to enable the DAC output path of the SSM2603, set
+  *    the out bit of Register R6 to 0.
+  */
+  { CODEC_PWR_MGMT,       PM_PB_ONLY_EXT & (~M_OUT) }
+};
+
+// registers read back by get_codec_config
+static const u8 codec_read_regs[] = {
+  CODEC_L_ADC_VOL, CODEC_R_ADC_VOL, CODEC_L_DAC_VOL, CODEC_R_DAC_VOL,
+  CODEC_AN_AUDIO_PATH, CODEC_DIG_AUDIO_PATH, CODEC_PWR_MGMT,
+  CODEC_DIG_AUDIO_IF, CODEC_SAMPLE_RATE, CODEC_ACTIVE,
+  CODEC_ALC_CTRL1, CODEC_ALC_CTRL2, CODEC_NOISE_GATE
+};
+
+#define NUM_READ_REGS (sizeof(codec_read_regs) / sizeof(codec_read_regs[0]))
+
+// sequence in progress
+enum {
+  CODEC_IDLE,
+  CODEC_WRITING,
+  CODEC_DELAY,
+  CODEC_READBACK,
+  CODEC_DONE,
+  CODEC_FAILED
+};
+
+static u8 codec_state = CODEC_IDLE;
+static const CodecRegWrite *codec_seq;
+static u16 codec_seq_len;
+static u16 codec_seq_pos;
+static u8  codec_readback;
+static XTime codec_wake;
+
+// readback register pointers and data
+static u8 read_ptrs[NUM_READ_REGS];
+static u8 read_bufs[NUM_READ_REGS][2];
+
+static void queueCodecWrites(void);
+static void decodeCodecConfig(void);
+
+/***************************************************************************
+* Codec write, queued without waiting
+****************************************************************************/
+
+int codecQueueWrite(AddressType reg, u16 data)
 {
   u8 write_buf[2] = {
     (reg << 1) + ((data >> 8) & 1),
     data & 0xFF
   };
 
-  if (i2c_write_reg(SSM2603_I2C_ADDR, &write_buf[0], 1, &write_buf[1], 1) != 2) {
-      return XST_FAILURE;
+  return i2cQueueWrite(SSM2603_I2C_ADDR, write_buf, 2);
+}
+
+/***************************************************************************
+* Codec read, queued without waiting, buf holds the two bytes for
+* codecReadValue once the queue has run
+****************************************************************************/
+
+int codecQueueRead(AddressType reg, u8 *buf)
+{
+  u8 read_reg = reg << 1;
+
+  return i2cQueueRead(SSM2603_I2C_ADDR, &read_reg, 1, buf, 2);
+}
+
+/***************************************************************************
+* Codec write
+****************************************************************************/
+
+int codec_write(AddressType reg, u16 data)
+{
+  if (codecQueueWrite(reg, data) || i2cWait()) {
+    return XST_FAILURE;
   }
 
   return XST_SUCCESS;
@@ -52,69 +154,146 @@ int codec_read(AddressType reg, u16 *data)
     return XST_FAILURE;
   }
 
-  *data = ((u16)read_buf[1] << 8) | read_buf[0];
+  *data = codecReadValue(read_buf);
 
-return XST_SUCCESS;  
+  return XST_SUCCESS;
 }
 
 /***************************************************************************
-* Configure Codec
+* Start a register sequence, optionally followed by reading the
+* configuration back. Each run of writes between delays is queued as one
+* batch and codecService moves the sequence along, so other start-up work
+* can run during the delays.
 ****************************************************************************/
-int configCodec()
+
+int codecStartSeq(const CodecRegWrite *seq, u16 len, u8 readback)
 {
- /* 1. Enable all of the necessary power management bits of
-  *    Register R6 with the exception of the out bit (Bit D4). The
-  *    out bit should not be set to 1 until the final step of the
-  *    control register sequence.
-  */
-  if (codec_write(CODEC_PWR_MGMT, PM_PB_ONLY_EXT)) {
+  codec_seq     = seq;
+  codec_seq_len = len;
+  codec_seq_pos = 0;
+  codec_readback = readback;
+
+  if (i2cInit()) {
+    codec_state = CODEC_FAILED;
     return XST_FAILURE;
   }
+  queueCodecWrites();
 
- /* 2. After the power management bits are set, program all other
-  *    necessary registers with the exception of the active bit
-  *    [Register R9, Bit D0] and the out bit of the power manage-
-  *    ment register.
-  */
-  // enable dac at output mixer
-  if (codec_write(CODEC_AN_AUDIO_PATH, M_DACSEL | M_MUTEMIC)) {
-    return XST_FAILURE;
+  // the writes before the first delay go out now, so the delay is timed
+  // from when they land
+  while (codec_state == CODEC_WRITING && codecService() == CODEC_BUSY) {
   }
 
-  // set clock condition for MCLK=12.288 MHz and 96 kHz sample rate
-  if (codec_write(CODEC_SAMPLE_RATE, 0x7 << B_SR)) {
-    return XST_FAILURE;
+  return (codec_state == CODEC_FAILED) ? XST_FAILURE : XST_SUCCESS;
+}
+
+/***************************************************************************
+* Queue sequence writes up to the next delay or the end
+****************************************************************************/
+
+static void queueCodecWrites(void)
+{
+  codec_state = CODEC_WRITING;
+
+  while (codec_seq_pos < codec_seq_len && codec_seq[codec_seq_pos].reg != CODEC_DELAY_MS) {
+    if (codecQueueWrite(codec_seq[codec_seq_pos].reg, codec_seq[codec_seq_pos].data)) {
+      codec_state = CODEC_FAILED;
+      return;
+    }
+    codec_seq_pos++;
   }
+}
 
-  // unmute the DAC output
-  if (codec_write(CODEC_DIG_AUDIO_PATH, 0)) {
-    return XST_FAILURE;
+/***************************************************************************
+* Queue the configuration readback
+****************************************************************************/
+
+static void queueCodecReadback(void)
+{
+  codec_state = CODEC_READBACK;
+
+  for (u8 i = 0; i < NUM_READ_REGS; i ++) {
+    read_ptrs[i] = codec_read_regs[i] << 1;
+    if (i2cQueueRead(SSM2603_I2C_ADDR, &read_ptrs[i], 1, read_bufs[i], 2)) {
+      codec_state = CODEC_FAILED;
+      return;
+    }
   }
+}
 
- /* 3. As described in the Digital Core Clock section of the
-  *    Theory of Operation, insert enough delay time to charge
-  *    the VMID decoupling capacitor before setting the active
-  *    bit [Register R9, Bit D0].
-  *
-  *    Delay time t = C x 25,000 / 3.5
-  *    where C is the capcitance at the VMID pin
-  *
-  *    t = 10.1 uF x 25,000 / 3.5 = 73 ms
-  */
-  usleep(73000);
-  if (codec_write(CODEC_ACTIVE, M_ACTIVE)) {
-    return XST_FAILURE;
+/***************************************************************************
+* Move the codec sequence along, returns CODEC_BUSY until it has finished
+* and then XST_SUCCESS or XST_FAILURE
+****************************************************************************/
+
+int codecService(void)
+{
+  XTime now;
+
+  switch (codec_state) {
+    case CODEC_WRITING:
+    case CODEC_READBACK:
+      i2cService();
+      if (i2cBusy()) {
+        break;
+      }
+      if (i2cResult()) {
+        codec_state = CODEC_FAILED;
+      } else if (codec_state == CODEC_READBACK) {
+        decodeCodecConfig();
+        codec_state = CODEC_DONE;
+      } else if (codec_seq_pos < codec_seq_len) {
+        XTime_GetTime(&now);
+        codec_wake = now + (XTime)codec_seq[codec_seq_pos].data * (COUNTS_PER_SECOND / 1000);
+        codec_seq_pos++;
+        codec_state = CODEC_DELAY;
+      } else if (codec_readback) {
+        queueCodecReadback();
+      } else {
+        codec_state = CODEC_DONE;
+      }
+      break;
+
+    case CODEC_DELAY:
+      XTime_GetTime(&now);
+      if (now >= codec_wake) {
+        queueCodecWrites();
+      }
+      break;
+
+    default:
+      break;
   }
 
- /* 4. Finally, to enable the DAC output path of the SSM2603, set
-  *    the out bit of Register R6 to 0.
-  */
-  if (codec_write(CODEC_PWR_MGMT, PM_PB_ONLY_EXT & (~M_OUT))) {
-    return XST_FAILURE;
+  switch (codec_state) {
+    case CODEC_DONE:   return XST_SUCCESS;
+    case CODEC_FAILED: return XST_FAILURE;
+    default:           return CODEC_BUSY;
   }
+}
+
+/***************************************************************************
+* Start the power-up sequence
+****************************************************************************/
 
-  if (get_codec_config()) {
-      return XST_FAILURE;
+int codecStart(u8 readback)
+{
+  return codecStartSeq(codec_init_seq, sizeof(codec_init_seq) / sizeof(codec_init_seq[0]), readback);
+}
+
+/***************************************************************************
+* Configure Codec
+****************************************************************************/
+int configCodec()
+{
+  int status;
+
+  // a failed start leaves the sequence failed, so the service reports it
+  codecStart(1);
+  while ((status = codecService()) == CODEC_BUSY) {
+  }
+  if (status != XST_SUCCESS) {
+    return XST_FAILURE;
   }
 #ifdef DEBUG
   print_codec_config();
@@ -124,46 +303,57 @@ int configCodec()
 }
 
 /***************************************************************************
-* Read configuration registers from codec
+* Read configuration registers from codec, all in one batch
 ****************************************************************************/
 int get_codec_config()
 {
+  queueCodecReadback();
+  if (codec_state == CODEC_FAILED || i2cWait()) {
+    codec_state = CODEC_FAILED;
+    return XST_FAILURE;
+  }
+  decodeCodecConfig();
+  codec_state = CODEC_DONE;
+
+  return XST_SUCCESS;
+}
+
+/***************************************************************************
+* Decode the registers read back into codecSSM2603
+****************************************************************************/
+static void decodeCodecConfig(void)
+{
+  u16 regs[CODEC_R18+1] = {0};
   u16 rd_data;
 
-  // read left ADC input volume
-  if (codec_read(CODEC_L_ADC_VOL, &rd_data)) {
-    return XST_FAILURE;
+  for (u8 i = 0; i < NUM_READ_REGS; i ++) {
+    regs[codec_read_regs[i]] = codecReadValue(read_bufs[i]);
   }
+
+  // left ADC input volume
+  rd_data = regs[CODEC_L_ADC_VOL];
   codecSSM2603.lrinboth = GET_BIT(rd_data, B_LRINBOTH);
   codecSSM2603.linmute  = GET_BIT(rd_data, B_LINMUTE);
   codecSSM2603.linvol   = GET_BITS(rd_data, B_LINVOL, B_LINVOL+W_INVOL-1);
 
-  // read right ADC input volume
-  if (codec_read(CODEC_R_ADC_VOL, &rd_data)) {
-      return XST_FAILURE;
-  }
+  // right ADC input volume
+  rd_data = regs[CODEC_R_ADC_VOL];
   codecSSM2603.rlinboth = GET_BIT(rd_data, B_RLINBOTH);
   codecSSM2603.rinmute  = GET_BIT(rd_data, B_RINMUTE);
   codecSSM2603.rinvol   = GET_BITS(rd_data, B_RINVOL, B_RINVOL+W_INVOL-1);
 
-  // read left DAC output volume
-  if (codec_read(CODEC_L_DAC_VOL, &rd_data)) {
-      return XST_FAILURE;
-  }
+  // left DAC output volume
+  rd_data = regs[CODEC_L_DAC_VOL];
   codecSSM2603.lrhpboth = GET_BIT(rd_data, B_LRHPBOTH);
   codecSSM2603.lhpvol   = GET_BITS(rd_data, B_LHPVOL, B_LHPVOL+W_HPVOL-1);
 
-  // read right DAC output volume
-  if (codec_read(CODEC_R_DAC_VOL, &rd_data)) {
-      return XST_FAILURE;
-  }
+  // right DAC output volume
+  rd_data = regs[CODEC_R_DAC_VOL];
   codecSSM2603.rlhpboth = GET_BIT(rd_data, B_RLHPBOTH);
   codecSSM2603.rhpvol   = GET_BITS(rd_data, B_RHPVOL, B_RHPVOL+W_HPVOL-1);
 
-  // read analog audio path
-  if (codec_read(CODEC_AN_AUDIO_PATH, &rd_data)) {
-      return XST_FAILURE;
-  }
+  // analog audio path
+  rd_data = regs[CODEC_AN_AUDIO_PATH];
   codecSSM2603.sidetone_attn = GET_BITS(rd_data, B_SIDETONE_ATT, B_SIDETONE_ATT+W_SIDETONE_ATT-1);
   codecSSM2603.sidetone_en   = GET_BIT(rd_data, B_SIDETONE_EN);
   codecSSM2603.dacsel        = GET_BIT(rd_data, B_DACSEL);
@@ -172,19 +362,15 @@ int get_codec_config()
   codecSSM2603.mutemic       = GET_BIT(rd_data, B_MUTEMIC);
   codecSSM2603.micboost      = GET_BIT(rd_data, B_MICBOOST);
 
-  // read digital audio path
-  if (codec_read(CODEC_DIG_AUDIO_PATH, &rd_data)) {
-      return XST_FAILURE;
-  }
+  // digital audio path
+  rd_data = regs[CODEC_DIG_AUDIO_PATH];
   codecSSM2603.hpor   = GET_BIT(rd_data, B_HPOR);
   codecSSM2603.dacmu  = GET_BIT(rd_data, B_DACMU);
   codecSSM2603.deemph = GET_BITS(rd_data, B_DEEMPH, B_DEEMPH+W_DEEMPH-1);
   codecSSM2603.adchpf = GET_BIT(rd_data, B_ADCHPF);
 
   // power management
-  if (codec_read(CODEC_PWR_MGMT, &rd_data)) {
-      return XST_FAILURE;
-  }
+  rd_data = regs[CODEC_PWR_MGMT];
   codecSSM2603.pwroff = GET_BIT(rd_data, B_PWROFF);
   codecSSM2603.clkout = GET_BIT(rd_data, B_CLKOUT);
   codecSSM2603.osc    = GET_BIT(rd_data, B_OSC);
@@ -195,9 +381,7 @@ int get_codec_config()
   codecSSM2603.linein = GET_BIT(rd_data, B_LINEIN);
 
   // digital audio i/f
-  if (codec_read(CODEC_DIG_AUDIO_IF, &rd_data)) {
-      return XST_FAILURE;
-  }
+  rd_data = regs[CODEC_DIG_AUDIO_IF];
   codecSSM2603.bclkinv = GET_BIT(rd_data, B_BCLKINV);
   codecSSM2603.ms      = GET_BIT(rd_data, B_MS);
   codecSSM2603.lrswap  = GET_BIT(rd_data, B_LRSWAP);
@@ -206,9 +390,7 @@ int get_codec_config()
   codecSSM2603.format  = GET_BITS(rd_data, B_FORMAT, B_FORMAT+W_FORMAT-1);
 
   // sampling rate
-  if (codec_read(CODEC_SAMPLE_RATE, &rd_data)) {
-      return XST_FAILURE;
-  }
+  rd_data = regs[CODEC_SAMPLE_RATE];
   codecSSM2603.clkodiv2 = GET_BIT(rd_data, B_CLKODIV2);
   codecSSM2603.clkdiv2  = GET_BIT(rd_data, B_CLKDIV2);
   codecSSM2603.sr       = GET_BITS(rd_data, B_SR, B_SR+W_SR-1);
@@ -216,35 +398,25 @@ int get_codec_config()
   codecSSM2603.usb      = GET_BIT(rd_data, B_USB);
 
   // active
-  if (codec_read(CODEC_ACTIVE, &rd_data)) {
-      return XST_FAILURE;
-  }
+  rd_data = regs[CODEC_ACTIVE];
   codecSSM2603.active = GET_BIT(rd_data, B_ACTIVE);
 
   // ALC control 1
-  if (codec_read(CODEC_ALC_CTRL1, &rd_data)) {
-      return XST_FAILURE;
-  }
+  rd_data = regs[CODEC_ALC_CTRL1];
   codecSSM2603.alcsel  = GET_BITS(rd_data, B_ALCSEL, B_ALCSEL+W_ALSEL-1);
   codecSSM2603.maxgain = GET_BITS(rd_data, B_MAXGAIN, B_MAXGAIN+W_MAXGAIN-1);
   codecSSM2603.alcl    = GET_BITS(rd_data, B_ALCL, B_ALCL+W_ALCL-1);
 
   // ALC control 2
-  if (codec_read(CODEC_ALC_CTRL2, &rd_data)) {
-      return XST_FAILURE;
-  }
+  rd_data = regs[CODEC_ALC_CTRL2];
   codecSSM2603.dcy = GET_BITS(rd_data, B_DCY, B_DCY+W_DCY-1);
   codecSSM2603.atk = GET_BITS(rd_data, B_ATK, B_ATK+W_ATK-1);
 
   // noise gate
-  if (codec_read(CODEC_NOISE_GATE, &rd_data)) {
-      return XST_FAILURE;
-  }
+  rd_data = regs[CODEC_NOISE_GATE];
   codecSSM2603.ngth = GET_BITS(rd_data, B_NGTH, B_NGTH+W_NGTH-1);
   codecSSM2603.ngg  = GET_BITS(rd_data, B_NGG, B_NGG+W_NGG-1);
   codecSSM2603.ngat = GET_BIT(rd_data, B_NGAT);
-
-  return XST_SUCCESS;
 }
 
 /***************************************************************************
@@ -45,6 +45,13 @@
 #define CODEC_ALC_CTRL1      CODEC_R16
 #define CODEC_ALC_CTRL2      CODEC_R17
 #define CODEC_NOISE_GATE     CODEC_R18
+// register sequence row that waits data milliseconds instead of writing
+#define CODEC_DELAY_MS       0xFF
+// codecService result while the sequence runs
+#define CODEC_BUSY           2
+
+// register value from the two bytes of a queued read
+#define codecReadValue(buf)  (((u16)(buf)[1] << 8) | (buf)[0])
 // bit positions within registers
 #define B_LRINBOTH     8
 #define B_LINMUTE      7
@@ -240,6 +247,12 @@ typedef struct {
 	u8 ngat;
 } codecSSM2603_t;
 
+// a register write, or a wait when reg is CODEC_DELAY_MS
+typedef struct {
+	u8  reg;
+	u16 data;
+} CodecRegWrite;
+
 extern codecSSM2603_t codecSSM2603;
 
 /***************************************************************************
@@ -256,4 +269,14 @@ int  codec_write(AddressType reg, u16 data);
 
 int  codec_read(AddressType reg, u16 *data);
 
+int  codecQueueWrite(AddressType reg, u16 data);
+
+int  codecQueueRead(AddressType reg, u8 *buf);
+
+int  codecStartSeq(const CodecRegWrite *seq, u16 len, u8 readback);
+
+int  codecStart(u8 readback);
+
+int  codecService(void);
+
 #endif /* SSM2603_H_ */
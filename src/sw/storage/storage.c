@@ -0,0 +1,262 @@
+/****************************************************************************/
+/**
+* storage.c
+*
+* This file contains the preset and tuning library kept on the SD card.
+*
+* The library is one file holding the preset bank and the tuning table as
+* they are laid out in memory, so loading is a single read and a checksum
+* with no per-field parsing. Saves run from the main loop a chunk at a
+* time so MIDI processing is never blocked behind the card.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <string.h>
+
+#include "storage.h"
+#include "../utils/utils.h"
+
+// save states
+typedef enum {
+    SAVE_IDLE,
+    SAVE_WRITE
+} SaveState;
+
+static FATFS fat_fs;
+static FIL lib_file;
+static int mounted;
+
+// library image, loaded into and snapshotted from for saves
+static SynthLibrary library;
+
+// tuning table saved with the presets
+static u32 *tuning;
+
+// save progress
+static SaveState save_state = SAVE_IDLE;
+static u32 save_offset;
+static u32 save_edits;
+static u32 saved_edits;
+static int save_requested;
+
+/***************************************************************************/
+/**
+* This function calculates the checksum of the library contents.
+*
+* @param  lib is the library image
+*
+* @return the checksum of everything after the header
+*
+****************************************************************************/
+static u32 libraryChecksum(const SynthLibrary *lib) {
+    const u8 *data = (const u8 *)lib + sizeof(LibraryHeader);
+    u32 len = sizeof(SynthLibrary) - sizeof(LibraryHeader);
+    u32 sum = 0x811C9DC5;
+
+    for (u32 i = 0; i < len; i ++) {
+        sum = (sum ^ data[i]) * 0x01000193;
+    }
+    return sum;
+}
+
+/***************************************************************************/
+/**
+* This function mounts the SD card.
+*
+* @param  freq_words is the tuning table to load into and save from
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int initStorage(u32 *freq_words) {
+
+    tuning = freq_words;
+    saved_edits = presetEdits();
+
+    if (f_mount(&fat_fs, LIBRARY_DRIVE, 1) != FR_OK) {
+        debug_print("Storage: no SD card\r\n");
+        return XST_FAILURE;
+    }
+    mounted = 1;
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function loads the preset bank and tuning table from the library.
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+* @note   Nothing is changed unless the whole file is valid, so a missing
+*         or damaged library leaves the compiled in defaults.
+*
+****************************************************************************/
+int loadLibrary(void) {
+    UINT len = 0;
+
+    if (!mounted || save_state != SAVE_IDLE) {
+        return XST_FAILURE;
+    }
+
+    if (f_open(&lib_file, LIBRARY_PATH, FA_READ) != FR_OK) {
+        debug_print("Storage: no library\r\n");
+        return XST_FAILURE;
+    }
+    FRESULT res = f_read(&lib_file, &library, sizeof(library), &len);
+    f_close(&lib_file);
+
+    const LibraryHeader *hdr = &library.header;
+    if (res != FR_OK || len != sizeof(library) ||
+        hdr->magic != LIBRARY_MAGIC || hdr->version != LIBRARY_VERSION ||
+        hdr->num_presets != NUM_PRESETS || hdr->preset_regs != PRESET_REGS ||
+        hdr->num_notes != MAX_NOTE+1 || hdr->checksum != libraryChecksum(&library)) {
+        debug_print("Storage: invalid library\r\n");
+        return XST_FAILURE;
+    }
+
+    loadPresets(library.presets);
+    if (tuning) {
+        memcpy(tuning, library.freq_words, sizeof(library.freq_words));
+    }
+    saved_edits = presetEdits();
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function requests a library save, for tuning changes which the
+* storage cannot see.
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+* @note   Preset edits are saved without a request.
+*
+****************************************************************************/
+int saveLibrary(void) {
+    if (!mounted) {
+        return XST_FAILURE;
+    }
+    save_requested = 1;
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function starts a save from a snapshot of the current settings.
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+static int startSave(void) {
+
+    save_edits = presetEdits();
+    save_requested = 0;
+
+    memcpy(library.presets, getPreset(0), sizeof(library.presets));
+    if (tuning) {
+        memcpy(library.freq_words, tuning, sizeof(library.freq_words));
+    }
+    library.header.magic       = LIBRARY_MAGIC;
+    library.header.version     = LIBRARY_VERSION;
+    library.header.num_presets = NUM_PRESETS;
+    library.header.preset_regs = PRESET_REGS;
+    library.header.num_notes   = MAX_NOTE+1;
+    library.header.checksum    = libraryChecksum(&library);
+
+    if (f_open(&lib_file, LIBRARY_TMP_PATH, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+        return XST_FAILURE;
+    }
+    save_offset = 0;
+    save_state = SAVE_WRITE;
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function writes the next chunk of a save, replacing the library
+* once the whole file is written.
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+static int writeSaveChunk(void) {
+    UINT len = 0;
+    u32 remaining = sizeof(library) - save_offset;
+    UINT chunk = (remaining < LIBRARY_SAVE_CHUNK) ? remaining : LIBRARY_SAVE_CHUNK;
+
+    if (f_write(&lib_file, (const u8 *)&library + save_offset, chunk, &len) != FR_OK ||
+        len != chunk) {
+        f_close(&lib_file);
+        return XST_FAILURE;
+    }
+    save_offset += chunk;
+
+    if (save_offset == sizeof(library)) {
+        save_state = SAVE_IDLE;
+        if (f_close(&lib_file) != FR_OK) {
+            return XST_FAILURE;
+        }
+        f_unlink(LIBRARY_PATH);
+        if (f_rename(LIBRARY_TMP_PATH, LIBRARY_PATH) != FR_OK) {
+            return XST_FAILURE;
+        }
+        saved_edits = save_edits;
+    }
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function runs the background save, call it from the main loop when
+* there is no MIDI input waiting.
+*
+* @return None
+*
+* @note   Edits made during a save are picked up by the next one. A failed
+*         save is not retried until the settings change again.
+*
+****************************************************************************/
+void serviceStorage(void) {
+    int status = XST_SUCCESS;
+
+    if (!mounted) {
+        return;
+    }
+
+    if (save_state == SAVE_IDLE) {
+        if (presetEdits() != saved_edits || save_requested) {
+            status = startSave();
+        }
+    } else {
+        status = writeSaveChunk();
+    }
+
+    if (status != XST_SUCCESS) {
+        debug_print("Storage: save failed\r\n");
+        save_state = SAVE_IDLE;
+        saved_edits = save_edits;
+    }
+}
+
+/***************************************************************************/
+/**
+* This function checks for a save in progress or pending.
+*
+* @return 1 while settings are not yet on the card, 0 otherwise
+*
+****************************************************************************/
+int storageBusy(void) {
+    return mounted && (save_state != SAVE_IDLE ||
+                       presetEdits() != saved_edits || save_requested);
+}
@@ -0,0 +1,63 @@
+#ifndef STORAGE_H_
+#define STORAGE_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "ff.h"
+
+#include "../synth_ctrl/synth_ctrl.h"
+#include "../synth_ctrl/synth_preset.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+// library file on the SD card, saves go to the temporary file first
+#define LIBRARY_DRIVE     "0:/"
+#define LIBRARY_PATH      "0:/ZYNTH.LIB"
+#define LIBRARY_TMP_PATH  "0:/ZYNTH.TMP"
+
+#define LIBRARY_MAGIC     0x4C4E595A  // "ZYNL"
+#define LIBRARY_VERSION   1
+
+// bytes written per storage service call while saving
+#define LIBRARY_SAVE_CHUNK 512
+
+/***************************************************************************
+* Global variable definitions
+****************************************************************************/
+
+/*
+ * Library file layout, the in-memory image written as is. The checksum
+ * covers everything after the header.
+ */
+typedef struct {
+    u32 magic;
+    u16 version;
+    u16 num_presets;
+    u16 preset_regs;
+    u16 num_notes;
+    u32 checksum;
+} LibraryHeader;
+
+typedef struct {
+    LibraryHeader header;
+    SynthPreset   presets[NUM_PRESETS];
+    u32           freq_words[MAX_NOTE+1];
+} SynthLibrary;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+int  initStorage(u32 *freq_words);
+int  loadLibrary(void);
+int  saveLibrary(void);
+void serviceStorage(void);
+int  storageBusy(void);
+
+#endif /* STORAGE_H_ */
@@ -10,6 +10,14 @@
 * Ver   Who    Date     Changes
 * ----- ------ -------- -----------------------------------------------------
 * 0.00  tjh    03/24/25 Initial file
+* 0.01  agt    10/19/26 Add key-tracked stereo pan
+* 0.02  agt    10/19/26 Enable hardware control smoothing
+* 0.03  agt    10/19/26 Add patch apply for SysEx parameter dumps
+* 0.04  agt    10/19/26 Add timbre banks and per-note timbre select
+* 0.05  agt    10/19/26 Set up the lfos and modulation routing
+* 0.06  agt    10/19/26 Add per-timbre portamento
+* 0.07  agt    10/19/26 Route key pressure to the note level
+* 0.08  agt    10/19/26 Add sustain and sostenuto pedals
 *
 ****************************************************************************/
 
@@ -20,16 +28,76 @@
 #include "synth_ctrl.h"
 #include "../utils/utils.h"
 
+// stereo pan state and the pan last written to each note
+static u8 pan_position = PAN_CENTER;
+static u8 pan_spread = 0;
+static u8 note_pans[MAX_NOTE+1];
+
+// timbre last written to each note
+static u8 note_timbres[MAX_NOTE+1];
+
+// glide time and portamento switch of each timbre, and the last note
+// played on it to glide from
+static u8 glide_times[NUM_TIMBRES];
+static u8 glide_on[NUM_TIMBRES];
+static u8 last_notes[NUM_TIMBRES];
+
+// polyphonic pressure of each note, channel pressure and pressure depth of
+// each timbre
+static u8 note_pressures[MAX_NOTE+1];
+static u8 timbre_pressures[NUM_TIMBRES];
+static u8 press_depths[NUM_TIMBRES];
+
+// sustain and sostenuto pedal bits of every timbre
+static u32 pedals;
+
+static void writeNotePans(void);
+static void writeGlideRates(void);
+
 /***************************************************************************
 * Initialize synthesizer controller
 ****************************************************************************/
 
 int initSynth(void) {
 
-  setWaveAmp(SINE_WAVE, 0x1F);
+  // smooth CC steps in hardware so each CC is a single register write
+  setSlewRates(SLEW_RATE_DEFAULT, SLEW_RATE_DEFAULT, SLEW_RATE_DEFAULT);
   setOutAmp(0x3F);
   setOutShift(0x8);
-  setPulseWidth(0x8000);
+
+  // vibrato, tremolo, pulse width and waveform lfos, all depths start at 0
+  setLfo(MOD_PITCH, lfoRate(5.5),  LFO_SINE);
+  setLfo(MOD_AMP,   lfoRate(4.0),  LFO_TRI);
+  setLfo(MOD_PW,    lfoRate(0.5),  LFO_TRI);
+  setLfo(MOD_WFRM,  lfoRate(0.25), LFO_SINE);
+
+  for (u8 t = 0; t < NUM_TIMBRES; t ++) {
+    setTimbreWaveAmp(t, SINE_WAVE, 0x1F);
+    setTimbrePulseWidth(t, 0x8000);
+    setTimbreLevel(t, TIMBRE_LEVEL_MAX);
+    setTimbreModSources(t, MOD_SRC_DEFAULT);
+    for (u8 d = 0; d < NUM_MOD_DESTS; d ++) {
+      setTimbreModDepth(t, d, 0);
+    }
+    glide_times[t] = 0;
+    glide_on[t] = 1;
+    last_notes[t] = NO_NOTE;
+    timbre_pressures[t] = 0;
+    press_depths[t] = 0;
+    setTimbrePressure(t, 0, 0);
+  }
+  writeGlideRates();
+  pedals = 0;
+  setPedals(0);
+
+  for (u8 i = 0; i <= MAX_NOTE; i ++) {
+    note_pans[i] = PAN_CENTER;
+    setPan(i, PAN_CENTER);
+    note_timbres[i] = 0;
+    setNoteTimbre(i, 0);
+    note_pressures[i] = 0;
+    setNotePressure(i, 0);
+  }
 
   return initADSR();
 }
@@ -63,22 +131,232 @@ void safeStopNote(u8 note) {
 ****************************************************************************/
 
 void safeSynthWrite(u32 addr, u32 data) {
-    if (addr <= 511*4) {
+    if (addr < SYNTH_ADDR_SPAN) {
         synthWrite(addr, data);
     } else {
         debug_print("AXI write skipped — invalid addr: %d\r\n", addr);
     }
 }
 
+/***************************************************************************
+* Select the timbre of a note, only written when it changes
+****************************************************************************/
+
+void safeSetNoteTimbre(u8 note, u8 timbre) {
+    if (note > MAX_NOTE || timbre >= NUM_TIMBRES) {
+        debug_print("Invalid note %d timbre %d\r\n", note, timbre);
+    } else if (note_timbres[note] != timbre) {
+        note_timbres[note] = timbre;
+        setNoteTimbre(note, timbre);
+    }
+}
+
+/***************************************************************************
+* Apply a complete sound setting, the voice settings go to timbre 0
+****************************************************************************/
+
+int applySynthPatch(const SynthPatch *patch) {
+
+  setSlewRates(patch->slew_wfrm, patch->slew_out, patch->slew_pw);
+
+  setOutAmp(patch->out_amp);
+  setOutShift(patch->out_shift);
+
+  applyTimbrePatch(0, patch);
+
+  pan_position = patch->pan_position & 0x7F;
+  pan_spread = patch->pan_spread & 0x7F;
+  writeNotePans();
+
+  return XST_SUCCESS;
+}
+
+/***************************************************************************
+* Apply the waveform, pulse width and adsr settings of a patch to a timbre
+****************************************************************************/
+
+int applyTimbrePatch(u8 timbre, const SynthPatch *patch) {
+
+  if (timbre >= NUM_TIMBRES) {
+    return XST_FAILURE;
+  }
+
+  for (u8 i = 0; i < NUM_WAVES; i ++) {
+    setTimbreWaveAmp(timbre, i, patch->wave_amps[i]);
+  }
+  setTimbrePulseWidth(timbre, patch->pulse_width);
+
+  setTimbreAttack(timbre, calcADSRamt(patch->attack));
+  setTimbreDecay(timbre, calcADSRamt(patch->decay));
+  setTimbreSustain(timbre, patch->sustain << 13);
+  setTimbreRelease(timbre, calcADSRamt(patch->release));
+
+  return XST_SUCCESS;
+}
+
+/***************************************************************************
+* Set the stereo pan position, 0 is hard left and 127 is hard right
+****************************************************************************/
+
+void setPanPosition(u8 pan) {
+  pan_position = pan & 0x7F;
+  writeNotePans();
+}
+
+/***************************************************************************
+* Set the key-tracked pan spread, low notes pan left and high notes right
+****************************************************************************/
+
+void setPanSpread(u8 spread) {
+  pan_spread = spread & 0x7F;
+  writeNotePans();
+}
+
+/***************************************************************************
+* Write the pan of every note that changed since the last update
+****************************************************************************/
+
+static void writeNotePans(void) {
+  for (u8 i = 0; i <= MAX_NOTE; i ++) {
+    int pan = pan_position + (((int)i - 64) * pan_spread) / 64;
+
+    if (pan < PAN_LEFT) {
+      pan = PAN_LEFT;
+    } else if (pan > PAN_RIGHT) {
+      pan = PAN_RIGHT;
+    }
+
+    if (note_pans[i] != pan) {
+      note_pans[i] = (u8)pan;
+      setPan(i, pan);
+    }
+  }
+}
+
+/***************************************************************************
+* Set the glide time of a timbre, 0 turns portamento off
+****************************************************************************/
+
+void setGlideTime(u8 timbre, u8 rate) {
+  if (timbre < NUM_TIMBRES) {
+    glide_times[timbre] = (rate > GLIDE_RATE_MAX) ? GLIDE_RATE_MAX : rate;
+    writeGlideRates();
+  }
+}
+
+/***************************************************************************
+* Switch portamento of a timbre on or off, keeping its glide time
+****************************************************************************/
+
+void setPortamento(u8 timbre, u8 on) {
+  if (timbre < NUM_TIMBRES) {
+    glide_on[timbre] = (on != 0);
+    writeGlideRates();
+  }
+}
+
+/***************************************************************************
+* Glide a new note from the last note on its timbre, call before playing it
+****************************************************************************/
+
+void safeGlideNote(u8 note, u8 timbre) {
+  if (note > MAX_NOTE || timbre >= NUM_TIMBRES) {
+    debug_print("Invalid note %d timbre %d\r\n", note, timbre);
+    return;
+  }
+  if (glide_on[timbre] && glide_times[timbre] != 0 &&
+      last_notes[timbre] != NO_NOTE && last_notes[timbre] != note) {
+    startGlide(last_notes[timbre], note);
+  }
+  last_notes[timbre] = note;
+}
+
+/***************************************************************************
+* Set the polyphonic pressure of a note, only written when it changes
+****************************************************************************/
+
+void safeSetNotePressure(u8 note, u8 pressure) {
+  if (note > MAX_NOTE) {
+    debug_print("Invalid note %d\r\n", note);
+  } else if (note_pressures[note] != (pressure & 0x7F)) {
+    note_pressures[note] = pressure & 0x7F;
+    setNotePressure(note, note_pressures[note]);
+  }
+}
+
+/***************************************************************************
+* Set the channel pressure of a timbre
+****************************************************************************/
+
+void setChannelPressure(u8 timbre, u8 pressure) {
+  if (timbre < NUM_TIMBRES) {
+    timbre_pressures[timbre] = pressure & 0x7F;
+    setTimbrePressure(timbre, timbre_pressures[timbre], press_depths[timbre]);
+  }
+}
+
+/***************************************************************************
+* Set how far the level of a timbre follows key pressure
+****************************************************************************/
+
+void setPressureDepth(u8 timbre, u8 depth) {
+  if (timbre < NUM_TIMBRES) {
+    press_depths[timbre] = depth & 0x7F;
+    setTimbrePressure(timbre, timbre_pressures[timbre], press_depths[timbre]);
+  }
+}
+
+/***************************************************************************
+* Press or lift a pedal of a timbre, one write however many notes it holds
+****************************************************************************/
+
+static void setPedal(u8 timbre, u8 shift, u8 down) {
+  u32 bit = 1 << (shift + timbre);
+
+  if (timbre < NUM_TIMBRES && ((pedals & bit) != 0) != (down != 0)) {
+    pedals ^= bit;
+    setPedals(pedals);
+  }
+}
+
+void setSustainPedal(u8 timbre, u8 down) {
+  setPedal(timbre, PEDAL_SUSTAIN_SHIFT, down);
+}
+
+void setSostenutoPedal(u8 timbre, u8 down) {
+  setPedal(timbre, PEDAL_SOSTENUTO_SHIFT, down);
+}
+
+void clearPedals(u8 timbre) {
+  setPedal(timbre, PEDAL_SUSTAIN_SHIFT, 0);
+  setPedal(timbre, PEDAL_SOSTENUTO_SHIFT, 0);
+}
+
+/***************************************************************************
+* Write the packed glide rates of all timbres
+****************************************************************************/
+
+static void writeGlideRates(void) {
+  u32 rates = 0;
+  for (u8 t = 0; t < NUM_TIMBRES; t ++) {
+    if (glide_on[t]) {
+      rates |= (u32)(glide_times[t] & GLIDE_RATE_MASK) << (GLIDE_RATE_BITS*t);
+    }
+  }
+  setGlideRates(rates);
+}
+
 /***************************************************************************
 * Initialize adsr settings
 ****************************************************************************/
 
 int initADSR(void) {
-  setAttack(calcADSRamt(0));
-  setDecay(calcADSRamt(0));
-  setSustain(0xFFFFF);
-  setRelease(calcADSRamt(0));
+  for (u8 t = 0; t < NUM_TIMBRES; t ++) {
+    setTimbreAttack(t, calcADSRamt(0));
+    setTimbreDecay(t, calcADSRamt(0));
+    setTimbreSustain(t, 0xFFFFF);
+    setTimbreRelease(t, calcADSRamt(0));
+  }
 
   return XST_SUCCESS;
 }
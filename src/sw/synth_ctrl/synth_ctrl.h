@@ -1,171 +1,300 @@
-/****************************************************************************/
-/**
-* synth_ctrl.c
-*
-* This file contains the functions for controlling the synthesizer.
-*
-*
-* REVISION HISTORY:
-*
-* Ver   Who    Date     Changes
-* ----- ------ -------- -----------------------------------------------------
-* 0.00  tjh    03/24/25 Initial file
-*
+#ifndef SYNTH_CTRL_H_
+#define SYNTH_CTRL_H_
+
+/***************************************************************************
+* Include files
 ****************************************************************************/
 
-#include <stdint.h>
-#include <stdio.h>
-#include <math.h>
-#include <stdlib.h>
-#include "synth_ctrl.h"
-#include "../utils/utils.h"
+#include "xparameters.h"
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
 
 /***************************************************************************
-* Initialize synthesizer controller
+* Constant definitions
 ****************************************************************************/
 
-int initSynth(void) {
+// synth engine AXI-lite instance
+#define SYNTH_BASEADDR XPAR_M03_AXI_0_BASEADDR
 
-  setWaveAmp(SINE_WAVE, 0x1F);
-  setOutAmp(0x3F);
-  setOutShift(0x8);
-  setPulseWidth(0x8000);
+// memory-mapped regions (byte offsets), 128 words each
+#define SYNTH_NOTE_AMP_OFFSET    0x000
+#define SYNTH_REG_OFFSET         0x200
+#define SYNTH_FREQ_WORD_OFFSET   0x400
+#define SYNTH_NOTE_PAN_OFFSET    0x600
+#define SYNTH_NOTE_TIMBRE_OFFSET 0x800
+#define SYNTH_TIMBRE_OFFSET      0xA00
+#define SYNTH_NOTE_PRESS_OFFSET  0xC00
+#define SYNTH_TRACE_OFFSET       0xE00  // a page of the trace buffer, read only
+#define SYNTH_ADDR_SPAN          0x1000
 
-  return initADSR();
-}
+// register word offsets within the settings region (see synth_pkg.vhd)
+#define REG_PULSE_WIDTH 0
+#define REG_PULSE       1
+#define REG_RAMP        2
+#define REG_SAW         3
+#define REG_TRI         4
+#define REG_SINE        5
+#define REG_GAIN_SHIFT  8
+#define REG_GAIN_SCALE  9
+#define REG_ATTACK_AMT  32
+#define REG_DECAY_AMT   33
+#define REG_SUSTAIN_AMT 34
+#define REG_RELEASE_AMT 35
+#define REG_SLEW_RATE   40
+#define REG_GLIDE_RATE  41
+#define REG_GLIDE       42
+#define REG_LFO         48
+#define REG_PRESSURE    56
+#define REG_NOTE_PACK   64
+#define REG_NOTE_GATE   96
+#define REG_GATE_VEL    100
+#define REG_NOTE_CTRL   101
+#define REG_PEDAL       102
+#define REG_ACTIVE      104
+#define REG_TRACE_CTRL  112
+#define REG_TRACE_STAT  113
+#define REG_TRACE_PAGE  114
+#define REG_REV         120
+#define REG_DATE        121
+#define REG_WRAPBACK    127
 
-/***************************************************************************
-* Play a note and ensure AXI bounds are not exceeded
-****************************************************************************/
+// waveform indexes, in register order from REG_PULSE
+#define PULSE_WAVE 0
+#define RAMP_WAVE  1
+#define SAW_WAVE   2
+#define TRI_WAVE   3
+#define SINE_WAVE  4
+#define NUM_WAVES  5
 
-void safePlayNote(u8 note, u8 amp) {
-    if (note <= MAX_NOTE) {
-        playNote(note, amp);
-    } else {
-        debug_print("Invalid note %d\r\n", note);
-    }
-}
+#define MAX_NOTE   127
 
-/***************************************************************************
-* Stop a note and ensure AXI bounds are not exceeded
-****************************************************************************/
+// timbre banks, 16 words each from SYNTH_TIMBRE_OFFSET (see synth_pkg.vhd)
+#define NUM_TIMBRES        8
+#define TIMBRE_REGS        16
+#define TIMBRE_PULSE_WIDTH 0
+#define TIMBRE_PULSE       1
+#define TIMBRE_LEVEL       6
+#define TIMBRE_MOD_SRC     7
+#define TIMBRE_ATTACK_AMT  8
+#define TIMBRE_DECAY_AMT   9
+#define TIMBRE_SUSTAIN_AMT 10
+#define TIMBRE_RELEASE_AMT 11
+#define TIMBRE_MOD_DEPTH   12
+#define TIMBRE_LEVEL_MAX   127
 
-void safeStopNote(u8 note) {
-    if (note <= MAX_NOTE) {
-        stopNote(note);
-    } else {
-        debug_print("Invalid note %d\r\n", note);
-    }
-}
+// midi channels 1 to 16 share the timbre banks
+#define timbreForChannel(ch)   (((ch) - 1) & (NUM_TIMBRES - 1))
 
-/***************************************************************************
-* Perform AXI write and ensure bounds are not exceeded
-****************************************************************************/
+// lfos, rate in steps of frame rate / 2^24 (about 5.7 mHz) and a shape
+#define NUM_LFOS         4
+#define LFO_SINE         0
+#define LFO_TRI          1
+#define LFO_SAH          2
+#define LFO_SQUARE       3
+#define LFO_RATE_MASK    0xFFFF
+#define LFO_SHAPE_SHIFT  16
+#define LFO_FRAME_HZ     96000
 
-void safeSynthWrite(u32 addr, u32 data) {
-    if (addr <= 511*4) {
-        synthWrite(addr, data);
-    } else {
-        debug_print("AXI write skipped — invalid addr: %d\r\n", addr);
-    }
-}
+// modulation destinations, each timbre picks an lfo and a depth per
+// destination; the depth is 0 to 127 and 0 turns the modulation off
+#define MOD_PITCH        0
+#define MOD_AMP          1
+#define MOD_PW           2
+#define MOD_WFRM         3
+#define NUM_MOD_DESTS    4
+#define MOD_SRC_DEFAULT  modSources(0, 1, 2, 3)
 
-/***************************************************************************
-* Initialize adsr settings
-****************************************************************************/
+// control slew rates, time constant of 2^rate frames, 0 disables smoothing
+#define SLEW_WFRM_SHIFT  0
+#define SLEW_OUT_SHIFT   8
+#define SLEW_PW_SHIFT    16
+#define SLEW_RATE_MASK   0xF
+#define SLEW_RATE_DEFAULT 6
 
-int initADSR(void) {
-  setAttack(calcADSRamt(0));
-  setDecay(calcADSRamt(0));
-  setSustain(0xFFFFF);
-  setRelease(calcADSRamt(0));
+// portamento, a rate per timbre where 0 is off, 1 slides an octave in
+// about 2 ms and each step up doubles the time
+#define GLIDE_RATE_BITS   4
+#define GLIDE_RATE_MASK   0xF
+#define GLIDE_RATE_MAX    15
+#define GLIDE_TO_SHIFT    0
+#define GLIDE_FROM_SHIFT  8
+#define GLIDE_START       0x8000
+#define NO_NOTE           0xFF
 
-  return XST_SUCCESS;
-}
+// key pressure, the level drops by depth/128 with no pressure and full
+// pressure restores it, a depth of 0 turns pressure off
+#define PRESS_SHIFT       0
+#define PRESS_DEPTH_SHIFT 8
 
-/***************************************************************************
-* Calculate adsr exponential settings
-****************************************************************************/
+// pedals, a bit per timbre, held notes keep sounding while the pedal is
+// down and release together on the frame the pedal comes up
+#define PEDAL_SUSTAIN_SHIFT   0
+#define PEDAL_SOSTENUTO_SHIFT 8
+
+// note control register bits
+#define NOTE_CTRL_HOLD        0x1
+#define NOTE_CTRL_RELEASE_ALL 0x2
 
-u32 calcADSRamt(u8 midi_cc) {
-  float scaler = 1.0;
-  if (midi_cc < 4) {
-    scaler = 8.0;
-  } else if (midi_cc < 8) {
-    scaler = 4.0;
-  } else if (midi_cc < 16) {
-    scaler = 2.0;
-  } else if (midi_cc < 32) {
-    scaler = 1.0;
-  } else if (midi_cc < 64) {
-    scaler = 0.5;
-  } else if (midi_cc < 96) {
-    scaler = 0.25;
-  } else {
-    scaler = 0.125;
-  }
-  return (u32)(scaler * (128 - midi_cc)); // round to nearest
-}
+// pan positions, 0 is hard left and 127 is hard right
+#define PAN_LEFT   0
+#define PAN_CENTER 64
+#define PAN_RIGHT  127
+
+// midi control change assignments
+#define CC_MOD_WHEEL    1
+#define CC_GLIDE_TIME   5
+#define CC_PAN          10
+#define CC_PWM_AMT      20
+#define CC_RAMP_AMT     21
+#define CC_SAW_AMT      22
+#define CC_TRI_AMT      23
+#define CC_SINE_AMT     24
+#define CC_PWM_WIDTH    25
+#define CC_PAN_SPREAD   26
+#define CC_PW_MOD_AMT   27
+#define CC_WFRM_MOD_AMT 28
+#define CC_PRESSURE_AMT 29
+#define CC_RELEASE_AMT  72
+#define CC_ATTACK_AMT   73
+#define CC_SUSTAIN      64
+#define CC_PORTAMENTO   65
+#define CC_SOSTENUTO    66
+#define CC_DECAY_AMT    75
+#define CC_VIBRATO_RATE 76
+#define CC_SUSTAIN_AMT  79
+#define CC_TREMOLO_AMT  92
 
 /***************************************************************************
-* Check synthesizer controller
+* Register access macros
 ****************************************************************************/
 
-int checkSynthCtrl(void) {
-
-  u32 data;
-
-  debug_print("-----------------------------------------------------\r\n");
-  debug_print("Synthesizer Controller Test\r\n");
-  debug_print("-----------------------------------------------------\r\n");
-
-  // read revision register
-  data = readRev();
-  u16 rev_major = data >> 16;
-  u16 rev_minor = data & 0xFFFF;
-  debug_print("Revision: %X.%X ", rev_major, rev_minor);
-
-  // read date code register
-  data = readDateCode();
-  u16 year = data & 0xFFFF;
-  u8 month = data >> 16;
-  u8 day = data >> 24;
-  debug_print("Date: %02X-%02X-%04X\r\n", day, month, year);
-
-  // verify wrapback register
-  u32 testdata = 0xABCD1234;
-  debug_print("Synth controller wrapback test\r\n");
-  data = readWrapback();
-  debug_print("- Wrapback reg read:  0x%08X\r\n", data);
-  setWrapback(testdata);
-  debug_print("- Wrapback reg write: 0x%08X\r\n", testdata);
-  data = readWrapback();
-  debug_print("- Wrapback reg read:  0x%08X\r\n", data);
-
-  if (data == testdata) {
-    debug_print("PASS\r\n");
-  } else {
-    debug_print("FAIL\r\n");
-    return XST_FAILURE;
-  }
-
-  return XST_SUCCESS;
-}
+#define synthWrite(addr, data) Xil_Out32(SYNTH_BASEADDR + (addr), (data))
+#define synthRead(addr)        Xil_In32(SYNTH_BASEADDR + (addr))
+
+#define setReg(reg, data)      synthWrite(SYNTH_REG_OFFSET + 4*(reg), (data))
+#define getReg(reg)            synthRead(SYNTH_REG_OFFSET + 4*(reg))
+
+#define playNote(note, amp)    synthWrite(SYNTH_NOTE_AMP_OFFSET + 4*(note), (amp))
+#define stopNote(note)         playNote(note, 0)
+#define setPitch(note, word)   synthWrite(SYNTH_FREQ_WORD_OFFSET + 4*(note), (word))
+#define setPan(note, pan)      synthWrite(SYNTH_NOTE_PAN_OFFSET + 4*(note), (pan))
+#define setNoteTimbre(note, t) synthWrite(SYNTH_NOTE_TIMBRE_OFFSET + 4*(note), (t))
+#define setNotePressure(note, p) synthWrite(SYNTH_NOTE_PRESS_OFFSET + 4*(note), (p))
+#define setTimbrePressure(t, p, depth) setReg(REG_PRESSURE + (t), \
+          ((p) << PRESS_SHIFT) | ((depth) << PRESS_DEPTH_SHIFT))
+
+// four notes per write, note 4*word+i in byte i
+#define playNotesPacked(word, amps) setReg(REG_NOTE_PACK + (word), (amps))
+// 32 notes per write, note 32*word+i on at the gate velocity when bit i is set
+#define setNoteGates(word, gates)   setReg(REG_NOTE_GATE + (word), (gates))
+#define readNoteGates(word)         getReg(REG_NOTE_GATE + (word))
+#define setGateVelocity(vel)        setReg(REG_GATE_VEL, (vel))
+// hold note and tuning changes and release them together on the next frame
+#define holdNotes()                 setReg(REG_NOTE_CTRL, NOTE_CTRL_HOLD)
+#define commitNotes()               setReg(REG_NOTE_CTRL, 0)
+#define releaseAllNotes()           setReg(REG_NOTE_CTRL, NOTE_CTRL_RELEASE_ALL)
+#define setPedals(pedals)           setReg(REG_PEDAL, (pedals))
+// 32 notes per read, bit set while the note is keyed or its envelope sounds
+#define readActiveNotes(word)       getReg(REG_ACTIVE + (word))
+#define isNoteActive(note)          ((readActiveNotes((note) >> 5) >> ((note) & 0x1F)) & 1)
+
+#define setWaveAmp(wave, amp)  setReg(REG_PULSE + (wave), (amp))
+#define setPulseWidth(width)   setReg(REG_PULSE_WIDTH, (width))
+#define setOutAmp(amp)         setReg(REG_GAIN_SCALE, (amp))
+#define setOutShift(shift)     setReg(REG_GAIN_SHIFT, (shift))
+#define setAttack(amt)         setReg(REG_ATTACK_AMT, (amt))
+#define setDecay(amt)          setReg(REG_DECAY_AMT, (amt))
+#define setSustain(amt)        setReg(REG_SUSTAIN_AMT, (amt))
+#define setRelease(amt)        setReg(REG_RELEASE_AMT, (amt))
+#define setWrapback(data)      setReg(REG_WRAPBACK, (data))
+#define setSlewRates(wfrm, out, pw) setReg(REG_SLEW_RATE, \
+          (((wfrm) & SLEW_RATE_MASK) << SLEW_WFRM_SHIFT) | \
+          (((out)  & SLEW_RATE_MASK) << SLEW_OUT_SHIFT)  | \
+          (((pw)   & SLEW_RATE_MASK) << SLEW_PW_SHIFT))
+
+// lfo rate for a frequency in hertz, and a squared curve for cc values
+// that reaches about 23 Hz at 127
+#define lfoRate(hz)            ((u32)((hz) * (1 << 24) / LFO_FRAME_HZ))
+#define lfoRateForCC(value)    ((((value) + 1) * ((value) + 1)) >> 2)
+#define setLfo(lfo, rate, shape) setReg(REG_LFO + (lfo), \
+          ((rate) & LFO_RATE_MASK) | ((u32)(shape) << LFO_SHAPE_SHIFT))
+
+// glide rates packed per timbre, and a glide into a note from the current
+// pitch of another, taken on the next frame like the note amplitudes
+#define glideRateForCC(value)  (((value) + 8) / 9)
+#define setGlideRates(rates)   setReg(REG_GLIDE_RATE, (rates))
+#define startGlide(from, to)   setReg(REG_GLIDE, GLIDE_START | \
+          ((u32)(from) << GLIDE_FROM_SHIFT) | ((to) << GLIDE_TO_SHIFT))
+
+#define readRev()              getReg(REG_REV)
+#define readDateCode()         getReg(REG_DATE)
+#define readWrapback()         getReg(REG_WRAPBACK)
+
+// timbre bank settings, the settings region waveform and adsr registers
+// above are timbre 0
+#define setTimbreReg(t, reg, data)      synthWrite(SYNTH_TIMBRE_OFFSET + 4*(TIMBRE_REGS*(t) + (reg)), (data))
+#define getTimbreReg(t, reg)            synthRead(SYNTH_TIMBRE_OFFSET + 4*(TIMBRE_REGS*(t) + (reg)))
+#define setTimbreWaveAmp(t, wave, amp)  setTimbreReg((t), TIMBRE_PULSE + (wave), (amp))
+#define setTimbrePulseWidth(t, width)   setTimbreReg((t), TIMBRE_PULSE_WIDTH, (width))
+#define setTimbreLevel(t, level)        setTimbreReg((t), TIMBRE_LEVEL, (level))
+#define setTimbreAttack(t, amt)         setTimbreReg((t), TIMBRE_ATTACK_AMT, (amt))
+#define setTimbreDecay(t, amt)          setTimbreReg((t), TIMBRE_DECAY_AMT, (amt))
+#define setTimbreSustain(t, amt)        setTimbreReg((t), TIMBRE_SUSTAIN_AMT, (amt))
+#define setTimbreRelease(t, amt)        setTimbreReg((t), TIMBRE_RELEASE_AMT, (amt))
+
+// modulation routing, one lfo number per destination byte
+#define modSources(pitch, amp, pw, wfrm) \
+          ((pitch) | ((amp) << 8) | ((pw) << 16) | ((u32)(wfrm) << 24))
+#define setTimbreModSources(t, srcs)     setTimbreReg((t), TIMBRE_MOD_SRC, (srcs))
+#define setTimbreModDepth(t, dest, depth) setTimbreReg((t), TIMBRE_MOD_DEPTH + (dest), (depth))
 
 /***************************************************************************
-* Read synthesizer controller memory map
+* Global variable definitions
 ****************************************************************************/
 
-int readSynthCtrl(void) {
+// complete sound setting, ADSR and pan fields use MIDI CC values
+typedef struct {
+    u8  wave_amps[NUM_WAVES];
+    u16 pulse_width;
+    u8  out_amp;
+    u8  out_shift;
+    u8  attack;
+    u8  decay;
+    u8  sustain;
+    u8  release;
+    u8  pan_position;
+    u8  pan_spread;
+    u8  slew_wfrm;
+    u8  slew_out;
+    u8  slew_pw;
+} SynthPatch;
 
-  u32 data;
-
-  for (int i = 0; i < 256; i ++) {
+/***************************************************************************
+* Function definitions
+****************************************************************************/
 
-    data = synthRead(i*4);
-    debug_print("%d: 0x%08X\r\n", i, data);
-    
-  }
+int  initSynth(void);
+void safePlayNote(u8 note, u8 amp);
+void safeStopNote(u8 note);
+void safeSynthWrite(u32 addr, u32 data);
+void safeSetNoteTimbre(u8 note, u8 timbre);
+void setPanPosition(u8 pan);
+void setPanSpread(u8 spread);
+void setGlideTime(u8 timbre, u8 rate);
+void setPortamento(u8 timbre, u8 on);
+void safeGlideNote(u8 note, u8 timbre);
+void safeSetNotePressure(u8 note, u8 pressure);
+void setChannelPressure(u8 timbre, u8 pressure);
+void setPressureDepth(u8 timbre, u8 depth);
+void setSustainPedal(u8 timbre, u8 down);
+void setSostenutoPedal(u8 timbre, u8 down);
+void clearPedals(u8 timbre);
+int  applySynthPatch(const SynthPatch *patch);
+int  applyTimbrePatch(u8 timbre, const SynthPatch *patch);
+int  initADSR(void);
+u32  calcADSRamt(u8 midi_cc);
+int  checkSynthCtrl(void);
+int  readSynthCtrl(void);
 
-  return XST_SUCCESS;
-}
\ No newline at end of file
+#endif /* SYNTH_CTRL_H_ */
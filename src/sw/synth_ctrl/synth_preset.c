@@ -0,0 +1,175 @@
+/****************************************************************************/
+/**
+* synth_preset.c
+*
+* This file contains the preset bank recalled by MIDI program changes.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Add bank load and edit count for storage
+* 0.02  agt    10/19/26 Keep the default modulation routing in word 7
+* 0.03  agt    10/19/26 Load single register images from the other core
+*
+****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "synth_preset.h"
+
+// preset bank, register images ready to write
+static SynthPreset presets[NUM_PRESETS];
+
+// bumped on every change so storage can tell when to save
+static u32 preset_edits;
+
+// sound of every preset until it is stored over
+static const SynthPatch default_patch = {
+    .wave_amps = { 0, 0, 0, 0, 0x1F },
+    .pulse_width = 0x8000,
+    .sustain = 127
+};
+
+/***************************************************************************/
+/**
+* This function fills every preset with the default sound.
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int initPresets(void) {
+    for (u8 i = 0; i < NUM_PRESETS; i ++) {
+        storePreset(i, &default_patch);
+    }
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function converts a patch to a preset register image.
+*
+* @param  program is the preset number
+* @param  patch is the sound setting, only the waveform, pulse width and
+*         ADSR fields are used
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int storePreset(u8 program, const SynthPatch *patch) {
+
+    if (program >= NUM_PRESETS) {
+        return XST_FAILURE;
+    }
+
+    u32 *regs = presets[program].regs;
+
+    regs[TIMBRE_PULSE_WIDTH] = patch->pulse_width;
+    for (u8 i = 0; i < NUM_WAVES; i ++) {
+        regs[TIMBRE_PULSE + i] = patch->wave_amps[i] & 0x7F;
+    }
+    regs[TIMBRE_LEVEL] = TIMBRE_LEVEL_MAX;
+    regs[TIMBRE_MOD_SRC] = MOD_SRC_DEFAULT;
+    regs[TIMBRE_ATTACK_AMT]  = calcADSRamt(patch->attack);
+    regs[TIMBRE_DECAY_AMT]   = calcADSRamt(patch->decay);
+    regs[TIMBRE_SUSTAIN_AMT] = (patch->sustain & 0x7F) << 13;
+    regs[TIMBRE_RELEASE_AMT] = calcADSRamt(patch->release);
+
+    preset_edits++;
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function loads a preset into a timbre bank.
+*
+* @param  timbre is the timbre bank to load
+* @param  program is the preset number
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+* @note   The image is written to consecutive registers in one pass, well
+*         within an audio frame. Notes already playing on the timbre pick
+*         up the new sound smoothed by the engine slew.
+*
+****************************************************************************/
+int recallPreset(u8 timbre, u8 program) {
+
+    if (timbre >= NUM_TIMBRES || program >= NUM_PRESETS) {
+        return XST_FAILURE;
+    }
+
+    const u32 *regs = presets[program].regs;
+    UINTPTR addr = SYNTH_BASEADDR + SYNTH_TIMBRE_OFFSET + 4*TIMBRE_REGS*timbre;
+
+    for (u8 i = 0; i < PRESET_REGS; i ++) {
+        Xil_Out32(addr + 4*i, regs[i]);
+    }
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function returns a stored preset.
+*
+* @param  program is the preset number
+*
+* @return the preset, or NULL for an invalid program
+*
+****************************************************************************/
+const SynthPreset *getPreset(u8 program) {
+    return (program < NUM_PRESETS) ? &presets[program] : NULL;
+}
+
+/***************************************************************************/
+/**
+* This function replaces the whole preset bank.
+*
+* @param  bank is NUM_PRESETS register images, as saved by storage
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int loadPresets(const SynthPreset *bank) {
+    memcpy(presets, bank, sizeof(presets));
+    preset_edits++;
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function replaces one preset with a register image.
+*
+* @param  program is the preset number
+* @param  preset is the register image, as sent by the other core
+*
+* @return XST_SUCCESS or XST_FAILURE
+*
+****************************************************************************/
+int loadPreset(u8 program, const SynthPreset *preset) {
+
+    if (program >= NUM_PRESETS) {
+        return XST_FAILURE;
+    }
+
+    presets[program] = *preset;
+    preset_edits++;
+
+    return XST_SUCCESS;
+}
+
+/***************************************************************************/
+/**
+* This function returns the preset edit count.
+*
+* @return a count that changes whenever any preset changes
+*
+****************************************************************************/
+u32 presetEdits(void) {
+    return preset_edits;
+}
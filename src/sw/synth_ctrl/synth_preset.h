@@ -0,0 +1,52 @@
+#ifndef SYNTH_PRESET_H_
+#define SYNTH_PRESET_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#include "synth_ctrl.h"
+
+/***************************************************************************
+* Constant definitions
+****************************************************************************/
+
+#define NUM_PRESETS 128
+
+/*
+ * A preset is stored as the timbre bank register image it loads, words 0
+ * to 11 of a timbre, so recalling one is a run of consecutive register
+ * writes with no conversion:
+ *
+ *    0     pulse width
+ *    1- 5  pulse, ramp, saw, tri and sine amps
+ *    6     timbre level
+ *    7     modulation sources, the default routing
+ *    8-11  attack, decay, sustain and release amounts
+ */
+#define PRESET_REGS (TIMBRE_RELEASE_AMT + 1)
+
+/***************************************************************************
+* Global variable definitions
+****************************************************************************/
+
+typedef struct {
+    u32 regs[PRESET_REGS];
+} SynthPreset;
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+int  initPresets(void);
+int  storePreset(u8 program, const SynthPatch *patch);
+int  recallPreset(u8 timbre, u8 program);
+const SynthPreset *getPreset(u8 program);
+int  loadPresets(const SynthPreset *bank);
+int  loadPreset(u8 program, const SynthPreset *preset);
+u32  presetEdits(void);
+
+#endif /* SYNTH_PRESET_H_ */
@@ -0,0 +1,60 @@
+/*
+ * Host stand-in for the FatFs API, backed by plain files.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ff.h"
+
+static const char *hostPath(const TCHAR *path, char *buf, size_t size) {
+    const char *dir = getenv("HOST_SD_DIR");
+
+    if (strncmp(path, "0:/", 3) == 0) {
+        path += 3;
+    }
+    snprintf(buf, size, "%s/%s", dir ? dir : ".", path);
+    return buf;
+}
+
+FRESULT f_mount(FATFS *fs, const TCHAR *path, BYTE opt) {
+    (void)path;
+    (void)opt;
+    fs->mounted = 1;
+    return FR_OK;
+}
+
+FRESULT f_open(FIL *fp, const TCHAR *path, BYTE mode) {
+    char buf[512];
+
+    fp->fp = fopen(hostPath(path, buf, sizeof(buf)), (mode & FA_WRITE) ? "wb" : "rb");
+    return fp->fp ? FR_OK : FR_NO_FILE;
+}
+
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br) {
+    *br = (UINT)fread(buff, 1, btr, fp->fp);
+    return ferror(fp->fp) ? FR_DISK_ERR : FR_OK;
+}
+
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw) {
+    *bw = (UINT)fwrite(buff, 1, btw, fp->fp);
+    return (*bw == btw) ? FR_OK : FR_DISK_ERR;
+}
+
+FRESULT f_close(FIL *fp) {
+    int err = fclose(fp->fp);
+    fp->fp = NULL;
+    return err ? FR_DISK_ERR : FR_OK;
+}
+
+FRESULT f_unlink(const TCHAR *path) {
+    char buf[512];
+    return remove(hostPath(path, buf, sizeof(buf))) ? FR_NO_FILE : FR_OK;
+}
+
+FRESULT f_rename(const TCHAR *path_old, const TCHAR *path_new) {
+    char buf_old[512], buf_new[512];
+    return rename(hostPath(path_old, buf_old, sizeof(buf_old)),
+                  hostPath(path_new, buf_new, sizeof(buf_new))) ? FR_DENIED : FR_OK;
+}
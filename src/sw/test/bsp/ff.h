@@ -0,0 +1,49 @@
+#ifndef FF_H_
+#define FF_H_
+
+/*
+ * Host stand-in for the FatFs API from the Xilinx xilffs library. Drive
+ * "0:/" maps to the directory in HOST_SD_DIR, or the current directory.
+ */
+
+#include <stdio.h>
+
+typedef unsigned int  UINT;
+typedef unsigned char BYTE;
+typedef char          TCHAR;
+
+typedef enum {
+    FR_OK = 0,
+    FR_DISK_ERR,
+    FR_INT_ERR,
+    FR_NOT_READY,
+    FR_NO_FILE,
+    FR_NO_PATH,
+    FR_INVALID_NAME,
+    FR_DENIED
+} FRESULT;
+
+#define FA_READ          0x01
+#define FA_WRITE         0x02
+#define FA_OPEN_EXISTING 0x00
+#define FA_CREATE_NEW    0x04
+#define FA_CREATE_ALWAYS 0x08
+#define FA_OPEN_ALWAYS   0x10
+
+typedef struct {
+    int mounted;
+} FATFS;
+
+typedef struct {
+    FILE *fp;
+} FIL;
+
+FRESULT f_mount(FATFS *fs, const TCHAR *path, BYTE opt);
+FRESULT f_open(FIL *fp, const TCHAR *path, BYTE mode);
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br);
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw);
+FRESULT f_close(FIL *fp);
+FRESULT f_unlink(const TCHAR *path);
+FRESULT f_rename(const TCHAR *path_old, const TCHAR *path_new);
+
+#endif /* FF_H_ */
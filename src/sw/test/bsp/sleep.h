@@ -0,0 +1,13 @@
+#ifndef SLEEP_H_
+#define SLEEP_H_
+
+/*
+ * Host stand-in for the Xilinx standalone BSP sleep, on the simulated
+ * clock of xtime_l.h.
+ */
+
+#include "xtime_l.h"
+
+#define usleep(us) host_usleep(us)
+
+#endif /* SLEEP_H_ */
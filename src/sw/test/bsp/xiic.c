@@ -0,0 +1,286 @@
+/*
+ * Host stand-in for the AXI IIC controller in dynamic mode and an SSM2603
+ * on a 100 kHz bus. The bus runs on the simulated clock of xtime_l.h and
+ * catches up whenever a register is touched.
+ */
+
+#include "xiic.h"
+#include "xtime_l.h"
+
+#define FIFO_DEPTH 16
+
+// 100 kHz, a byte is eight bits and the acknowledge
+#define BIT_NS   10000ULL
+#define START_NS BIT_NS
+#define BYTE_NS  (9 * BIT_NS)
+#define STOP_NS  (BIT_NS + 4700)    // stop and the bus free time
+
+static const u16 codec_defaults[HOST_CODEC_REGS] = {
+    0x097, 0x097, 0x079, 0x079, 0x00A, 0x008, 0x09F, 0x00A, 0x000, 0x000,
+    0, 0, 0, 0, 0, 0, 0x07B, 0x032, 0x000
+};
+
+u16 host_codec_regs[HOST_CODEC_REGS];
+u32 host_codec_writes;
+int host_codec_present = 1;
+int host_iic_nacks;
+int host_iic_stuck;
+
+u32 host_iic_xfers;
+u32 host_iic_bytes;
+u64 host_iic_busy_ns;
+
+// controller
+static u16 tx_fifo[FIFO_DEPTH];
+static int tx_head, tx_count;
+static u8  rx_fifo[FIFO_DEPTH];
+static int rx_head, rx_count;
+static u32 cr, isr, rfd;
+
+// bus, simulated up to bus_time
+static u64 bus_time;
+static int in_xfer;     // between a start and a stop
+static int halted;      // after a NACK, until the transmit FIFO is reset
+
+// codec side of the current write and its register pointer
+static u8  wr_bytes[4];
+static int wr_len;
+static u8  codec_ptr;
+
+static void codecReset(void) {
+    for (int i = 0; i < HOST_CODEC_REGS; i++) {
+        host_codec_regs[i] = codec_defaults[i];
+    }
+}
+
+static void controllerReset(void) {
+    tx_head = tx_count = 0;
+    rx_head = rx_count = 0;
+    cr = isr = rfd = 0;
+    in_xfer = halted = 0;
+    wr_len = 0;
+}
+
+void host_iic_reset(void) {
+    controllerReset();
+    codecReset();
+    codec_ptr = 0;
+    host_codec_writes = 0;
+    host_codec_present = 1;
+    host_iic_nacks = 0;
+    host_iic_stuck = 0;
+    host_iic_xfers = 0;
+    host_iic_bytes = 0;
+    host_iic_busy_ns = 0;
+    bus_time = host_time_ns;
+}
+
+static void commitWrite(void) {
+    if (wr_len == 1) {
+        codec_ptr = wr_bytes[0] >> 1;
+    } else if (wr_len >= 2) {
+        u8 reg = wr_bytes[0] >> 1;
+        u16 data = ((wr_bytes[0] & 1) << 8) | wr_bytes[1];
+        if (reg == 15) {
+            codecReset();
+        } else if (reg < HOST_CODEC_REGS) {
+            host_codec_regs[reg] = data;
+        }
+        codec_ptr = reg;
+        host_codec_writes++;
+    }
+    wr_len = 0;
+}
+
+static u8 codecReadByte(int i) {
+    u16 data = (codec_ptr < HOST_CODEC_REGS) ? host_codec_regs[codec_ptr] : 0;
+    return (i & 1) ? (data >> 8) : (data & 0xFF);
+}
+
+static u16 txAt(int i) {
+    return tx_fifo[(tx_head + i) % FIFO_DEPTH];
+}
+
+static void txPop(int n) {
+    tx_head = (tx_head + n) % FIFO_DEPTH;
+    tx_count -= n;
+}
+
+static void rxPush(u8 data) {
+    if (rx_count < FIFO_DEPTH) {
+        rx_fifo[(rx_head + rx_count) % FIFO_DEPTH] = data;
+        rx_count++;
+    }
+}
+
+// run the bus up to the present, an entry goes once its bits are on the wire
+static void busRun(void) {
+    u64 now = host_time_ns;
+
+    while (bus_time < now) {
+        if (!(cr & XIIC_CR_ENABLE_DEVICE_MASK) || halted || host_iic_stuck || tx_count == 0) {
+            // a transaction left open stretches the clock
+            if (in_xfer || host_iic_stuck) {
+                host_iic_busy_ns += now - bus_time;
+            }
+            bus_time = now;
+            break;
+        }
+
+        u16 e = txAt(0);
+        u64 cost;
+
+        if (e & XIIC_TX_DYN_START_MASK) {
+            u8 addr = (e >> 1) & 0x7F;
+            int read = e & XIIC_READ_OPERATION;
+            int ack = host_codec_present && addr == HOST_CODEC_ADDR && host_iic_nacks == 0;
+            int n = 0;
+            u16 count = 0;
+
+            cost = START_NS + BYTE_NS;
+            if (!ack) {
+                cost += STOP_NS;
+            } else if (read) {
+                if (tx_count < 2) {
+                    host_iic_busy_ns += now - bus_time;
+                    bus_time = now;
+                    break;
+                }
+                count = txAt(1);
+                n = count & 0xFF;
+                cost += n * BYTE_NS + ((count & XIIC_TX_DYN_STOP_MASK) ? STOP_NS : 0);
+            }
+            if (bus_time + cost > now) {
+                break;
+            }
+
+            bus_time += cost;
+            host_iic_busy_ns += cost;
+            host_iic_xfers++;
+            host_iic_bytes += 1 + n;
+            if (in_xfer) {
+                // repeated start, the bytes so far set the register pointer
+                commitWrite();
+            }
+
+            if (!ack) {
+                if (host_iic_nacks > 0 && host_codec_present && addr == HOST_CODEC_ADDR) {
+                    host_iic_nacks--;
+                }
+                txPop(1);
+                isr |= XIIC_INTR_TX_ERROR_MASK;
+                halted = 1;
+                in_xfer = 0;
+                wr_len = 0;
+            } else if (read) {
+                txPop(2);
+                for (int i = 0; i < n; i++) {
+                    rxPush(codecReadByte(i));
+                }
+                in_xfer = !(count & XIIC_TX_DYN_STOP_MASK);
+            } else {
+                txPop(1);
+                in_xfer = 1;
+                wr_len = 0;
+            }
+
+        } else {
+            cost = BYTE_NS + ((e & XIIC_TX_DYN_STOP_MASK) ? STOP_NS : 0);
+            if (bus_time + cost > now) {
+                break;
+            }
+            bus_time += cost;
+            host_iic_busy_ns += cost;
+            host_iic_bytes++;
+            txPop(1);
+            if (wr_len < (int)sizeof(wr_bytes)) {
+                wr_bytes[wr_len++] = e & 0xFF;
+            }
+            if (e & XIIC_TX_DYN_STOP_MASK) {
+                commitWrite();
+                in_xfer = 0;
+            }
+        }
+    }
+}
+
+u32 XIic_ReadReg(UINTPTR BaseAddress, u32 RegOffset) {
+    u32 value = 0;
+
+    (void)BaseAddress;
+    host_time_ns += HOST_ACCESS_NS;
+    busRun();
+
+    switch (RegOffset) {
+        case XIIC_IISR_OFFSET:
+            value = isr | (tx_count == 0 ? XIIC_INTR_TX_EMPTY_MASK : 0);
+            break;
+        case XIIC_CR_REG_OFFSET:
+            value = cr;
+            break;
+        case XIIC_SR_REG_OFFSET:
+            value = ((in_xfer || host_iic_stuck) ? XIIC_SR_BUS_BUSY_MASK : 0) |
+                    (tx_count == FIFO_DEPTH ? XIIC_SR_TX_FIFO_FULL_MASK : 0) |
+                    (rx_count == FIFO_DEPTH ? XIIC_SR_RX_FIFO_FULL_MASK : 0) |
+                    (rx_count == 0 ? XIIC_SR_RX_FIFO_EMPTY_MASK : 0) |
+                    (tx_count == 0 ? XIIC_SR_TX_FIFO_EMPTY_MASK : 0);
+            break;
+        case XIIC_DRR_REG_OFFSET:
+            if (rx_count > 0) {
+                value = rx_fifo[rx_head];
+                rx_head = (rx_head + 1) % FIFO_DEPTH;
+                rx_count--;
+            }
+            break;
+        case XIIC_TFO_REG_OFFSET:
+            value = tx_count ? tx_count - 1 : 0;
+            break;
+        case XIIC_RFO_REG_OFFSET:
+            value = rx_count ? rx_count - 1 : 0;
+            break;
+        case XIIC_RFD_REG_OFFSET:
+            value = rfd;
+            break;
+        default:
+            break;
+    }
+
+    return value;
+}
+
+void XIic_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 RegisterValue) {
+    (void)BaseAddress;
+    host_time_ns += HOST_ACCESS_NS;
+    busRun();
+
+    switch (RegOffset) {
+        case XIIC_IISR_OFFSET:
+            isr ^= RegisterValue & (XIIC_INTR_ARB_LOST_MASK | XIIC_INTR_TX_ERROR_MASK);
+            break;
+        case XIIC_RESETR_OFFSET:
+            if (RegisterValue == XIIC_RESET_MASK) {
+                controllerReset();
+            }
+            break;
+        case XIIC_CR_REG_OFFSET:
+            cr = RegisterValue;
+            if (cr & XIIC_CR_TX_FIFO_RESET_MASK) {
+                tx_head = tx_count = 0;
+                halted = 0;
+                in_xfer = 0;
+                wr_len = 0;
+            }
+            break;
+        case XIIC_DTR_REG_OFFSET:
+            if (tx_count < FIFO_DEPTH) {
+                tx_fifo[(tx_head + tx_count) % FIFO_DEPTH] = RegisterValue & 0x3FF;
+                tx_count++;
+            }
+            break;
+        case XIIC_RFD_REG_OFFSET:
+            rfd = RegisterValue;
+            break;
+        default:
+            break;
+    }
+}
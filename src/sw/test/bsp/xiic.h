@@ -0,0 +1,35 @@
+#ifndef XIIC_H_
+#define XIIC_H_
+
+/*
+ * Host stand-in for the Xilinx AXI IIC driver: the low-level register
+ * interface, in dynamic controller mode, on a simulated 100 kHz bus with
+ * an SSM2603 codec at address 0x1A.
+ */
+
+#include "xil_types.h"
+#include "xparameters.h"
+#include "xiic_l.h"
+
+typedef struct {
+    UINTPTR BaseAddress;
+} XIic;
+
+// SSM2603 stand-in
+#define HOST_CODEC_ADDR 0x1A
+#define HOST_CODEC_REGS 19
+
+extern u16 host_codec_regs[HOST_CODEC_REGS];
+extern u32 host_codec_writes;
+extern int host_codec_present;  // acknowledge the codec address
+extern int host_iic_nacks;      // NACK this many of the next addresses
+extern int host_iic_stuck;      // hold the bus busy, nothing moves
+
+// bus traffic
+extern u32 host_iic_xfers;      // start conditions
+extern u32 host_iic_bytes;      // bytes on the bus, addresses included
+extern u64 host_iic_busy_ns;    // time the bus was not idle
+
+void host_iic_reset(void);
+
+#endif /* XIIC_H_ */
@@ -0,0 +1,57 @@
+#ifndef XIIC_L_H_
+#define XIIC_L_H_
+
+/*
+ * Host stand-in for the Xilinx AXI IIC low-level register interface, with
+ * the register offsets and bits of the real driver.
+ */
+
+#include "xil_types.h"
+
+#define XIIC_DGIER_OFFSET   0x1C
+#define XIIC_IISR_OFFSET    0x20
+#define XIIC_IIER_OFFSET    0x28
+#define XIIC_RESETR_OFFSET  0x40
+#define XIIC_CR_REG_OFFSET  0x100
+#define XIIC_SR_REG_OFFSET  0x104
+#define XIIC_DTR_REG_OFFSET 0x108
+#define XIIC_DRR_REG_OFFSET 0x10C
+#define XIIC_ADR_REG_OFFSET 0x110
+#define XIIC_TFO_REG_OFFSET 0x114
+#define XIIC_RFO_REG_OFFSET 0x118
+#define XIIC_RFD_REG_OFFSET 0x120
+
+#define XIIC_RESET_MASK 0xA
+
+#define XIIC_CR_ENABLE_DEVICE_MASK  0x01
+#define XIIC_CR_TX_FIFO_RESET_MASK  0x02
+#define XIIC_CR_MSMS_MASK           0x04
+#define XIIC_CR_DIR_IS_TX_MASK      0x08
+#define XIIC_CR_NO_ACK_MASK         0x10
+#define XIIC_CR_REPEATED_START_MASK 0x20
+
+#define XIIC_SR_BUS_BUSY_MASK      0x04
+#define XIIC_SR_TX_FIFO_FULL_MASK  0x10
+#define XIIC_SR_RX_FIFO_FULL_MASK  0x20
+#define XIIC_SR_RX_FIFO_EMPTY_MASK 0x40
+#define XIIC_SR_TX_FIFO_EMPTY_MASK 0x80
+
+#define XIIC_INTR_ARB_LOST_MASK 0x01
+#define XIIC_INTR_TX_ERROR_MASK 0x02
+#define XIIC_INTR_TX_EMPTY_MASK 0x04
+#define XIIC_INTR_RX_FULL_MASK  0x08
+#define XIIC_INTR_BNB_MASK      0x10
+
+#define XIIC_TX_DYN_START_MASK 0x100
+#define XIIC_TX_DYN_STOP_MASK  0x200
+
+#define XIIC_READ_OPERATION  1
+#define XIIC_WRITE_OPERATION 0
+
+#define XIIC_STOP           0
+#define XIIC_REPEATED_START 1
+
+u32  XIic_ReadReg(UINTPTR BaseAddress, u32 RegOffset);
+void XIic_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 RegisterValue);
+
+#endif /* XIIC_L_H_ */
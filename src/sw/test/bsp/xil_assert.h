@@ -0,0 +1,11 @@
+#ifndef XIL_ASSERT_H_
+#define XIL_ASSERT_H_
+
+/*
+ * Host stand-in for the Xilinx standalone BSP assertions, nothing in the
+ * firmware calls them.
+ */
+
+#include "xil_types.h"
+
+#endif /* XIL_ASSERT_H_ */
@@ -0,0 +1,33 @@
+/*
+ * Host stand-in for the Xilinx standalone BSP register access.
+ */
+
+#include "xil_io.h"
+
+u32 host_synth_regs[HOST_SYNTH_REGS];
+u32 host_synth_writes;
+const HostSynthModel *host_synth_model;
+
+static u32 *host_reg(UINTPTR Addr) {
+    UINTPTR word = (Addr - XPAR_M03_AXI_0_BASEADDR) / 4;
+    return (word < HOST_SYNTH_REGS) ? &host_synth_regs[word] : NULL;
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value) {
+    u32 *reg = host_reg(Addr);
+    if (reg) {
+        *reg = Value;
+        host_synth_writes++;
+        if (host_synth_model) {
+            host_synth_model->write(host_synth_model->ref, Addr - XPAR_M03_AXI_0_BASEADDR, Value);
+        }
+    }
+}
+
+u32 Xil_In32(UINTPTR Addr) {
+    u32 *reg = host_reg(Addr);
+    if (reg && host_synth_model) {
+        return host_synth_model->read(host_synth_model->ref, Addr - XPAR_M03_AXI_0_BASEADDR);
+    }
+    return reg ? *reg : 0;
+}
@@ -0,0 +1,31 @@
+#ifndef XIL_IO_H_
+#define XIL_IO_H_
+
+/*
+ * Host stand-in for the Xilinx standalone BSP register access. Writes to
+ * the synth engine land in host_synth_regs so tests can inspect them, and
+ * are passed on to an engine model when one is attached.
+ */
+
+#include "xil_types.h"
+#include "xparameters.h"
+
+#define HOST_SYNTH_REGS 1024
+
+extern u32 host_synth_regs[HOST_SYNTH_REGS];
+extern u32 host_synth_writes;
+
+// engine model behind the registers, byte offsets from the engine base.
+// With a model attached reads come from it instead of host_synth_regs.
+typedef struct {
+    void (*write)(void *ref, u32 offset, u32 value);
+    u32  (*read)(void *ref, u32 offset);
+    void *ref;
+} HostSynthModel;
+
+extern const HostSynthModel *host_synth_model;
+
+void Xil_Out32(UINTPTR Addr, u32 Value);
+u32  Xil_In32(UINTPTR Addr);
+
+#endif /* XIL_IO_H_ */
@@ -0,0 +1,16 @@
+#ifndef XIL_MMU_H_
+#define XIL_MMU_H_
+
+/*
+ * Host stand-in for the Xilinx standalone BSP MMU calls. The host has no
+ * translation table, memory attributes are left as they are.
+ */
+
+#include "xil_types.h"
+
+static inline void Xil_SetTlbAttributes(UINTPTR Addr, u32 attrib) {
+    (void)Addr;
+    (void)attrib;
+}
+
+#endif /* XIL_MMU_H_ */
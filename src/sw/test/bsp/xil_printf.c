@@ -0,0 +1,24 @@
+/*
+ * Host stand-in for the Xilinx standalone BSP printf.
+ */
+
+#include <stdarg.h>
+
+#include "xil_printf.h"
+#include "xtime_l.h"
+
+int host_printf_mute;
+
+int host_printf(const char *fmt, ...) {
+    va_list args;
+    int n;
+
+    va_start(args, fmt);
+    n = host_printf_mute ? vsnprintf(NULL, 0, fmt, args) : vprintf(fmt, args);
+    va_end(args);
+
+    if (n > 0) {
+        host_time_ns += (u64)n * HOST_UART_CHAR_NS;
+    }
+    return n;
+}
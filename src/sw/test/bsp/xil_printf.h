@@ -0,0 +1,22 @@
+#ifndef XIL_PRINTF_H_
+#define XIL_PRINTF_H_
+
+/*
+ * Host stand-in for the Xilinx standalone BSP printf. Output goes to
+ * stdout, and the simulated clock moves on by the time the characters
+ * take on the 115200 baud debug UART. Setting host_printf_mute drops the
+ * text, the clock still moves on.
+ */
+
+#include <stdio.h>
+
+// ten bits a character at 115200 baud
+#define HOST_UART_CHAR_NS 86806
+
+extern int host_printf_mute;
+
+int host_printf(const char *fmt, ...);
+
+#define xil_printf host_printf
+
+#endif /* XIL_PRINTF_H_ */
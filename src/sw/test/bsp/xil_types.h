@@ -0,0 +1,21 @@
+#ifndef XIL_TYPES_H_
+#define XIL_TYPES_H_
+
+/*
+ * Host stand-in for the Xilinx standalone BSP types.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t   u8;
+typedef uint16_t  u16;
+typedef uint32_t  u32;
+typedef uint64_t  u64;
+typedef int8_t    s8;
+typedef int16_t   s16;
+typedef int32_t   s32;
+typedef int64_t   s64;
+typedef uintptr_t UINTPTR;
+
+#endif /* XIL_TYPES_H_ */
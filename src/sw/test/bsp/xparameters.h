@@ -0,0 +1,16 @@
+#ifndef XPARAMETERS_H_
+#define XPARAMETERS_H_
+
+/*
+ * Host stand-in for the Vivado generated hardware parameters.
+ */
+
+#define XPAR_M03_AXI_0_BASEADDR 0x43C00000
+#define XPAR_AXI_IIC_0_BASEADDR 0x41600000
+#define XPAR_XUARTPS_0_BASEADDR 0xE0000000
+#define XPAR_XUARTPS_0_DEVICE_ID 0
+#define STDOUT_BASEADDRESS 0xE0001000
+
+#define XPAR_CPU_CORE_CLOCK_FREQ_HZ 666666687
+
+#endif /* XPARAMETERS_H_ */
@@ -0,0 +1,13 @@
+#ifndef XPSEUDO_ASM_H_
+#define XPSEUDO_ASM_H_
+
+/*
+ * Host stand-in for the Cortex-A9 barrier and event instructions of the
+ * Xilinx standalone BSP. The barrier is a full fence, there is no other
+ * core waiting for an event.
+ */
+
+#define dsb() __sync_synchronize()
+#define sev() do { } while (0)
+
+#endif /* XPSEUDO_ASM_H_ */
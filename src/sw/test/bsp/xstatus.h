@@ -0,0 +1,11 @@
+#ifndef XSTATUS_H_
+#define XSTATUS_H_
+
+/*
+ * Host stand-in for the Xilinx standalone BSP status codes.
+ */
+
+#define XST_SUCCESS 0L
+#define XST_FAILURE 1L
+
+#endif /* XSTATUS_H_ */
@@ -0,0 +1,17 @@
+/*
+ * Host stand-in for the Xilinx standalone BSP global timer.
+ */
+
+#include "xtime_l.h"
+
+u64 host_time_ns;
+
+void XTime_GetTime(XTime *Xtime_Global) {
+    host_time_ns += HOST_ACCESS_NS;
+    *Xtime_Global = (host_time_ns / 1000000000ULL) * COUNTS_PER_SECOND +
+                    (host_time_ns % 1000000000ULL) * COUNTS_PER_SECOND / 1000000000ULL;
+}
+
+void host_usleep(unsigned long useconds) {
+    host_time_ns += 1000ULL * useconds;
+}
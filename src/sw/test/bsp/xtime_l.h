@@ -0,0 +1,25 @@
+#ifndef XTIME_L_H_
+#define XTIME_L_H_
+
+/*
+ * Host stand-in for the Xilinx standalone BSP global timer. Time is
+ * simulated: it moves on when the firmware sleeps, reads the timer or
+ * touches a stand-in peripheral, so timing results are repeatable.
+ */
+
+#include "xil_types.h"
+#include "xparameters.h"
+
+typedef u64 XTime;
+
+#define COUNTS_PER_SECOND (XPAR_CPU_CORE_CLOCK_FREQ_HZ / 2)
+
+// cost of a timer or peripheral register read
+#define HOST_ACCESS_NS 100
+
+extern u64 host_time_ns;
+
+void XTime_GetTime(XTime *Xtime_Global);
+void host_usleep(unsigned long useconds);
+
+#endif /* XTIME_L_H_ */
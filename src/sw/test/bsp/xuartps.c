@@ -0,0 +1,170 @@
+/*
+ * Host stand-in for a PS UART at 115200 baud on the simulated clock.
+ */
+
+#include "xuartps.h"
+#include "xil_printf.h"
+#include "xtime_l.h"
+#include "xstatus.h"
+
+#define HOST_UART_LINE 8192
+
+// received bytes waiting in the receive FIFO and on the line behind it
+static u8  rx_buf[HOST_UART_LINE];
+static int rx_head, rx_count;
+
+// transmit FIFO, and bytes that have gone out on the line
+static u8  tx_fifo[HOST_UART_FIFO];
+static int tx_head, tx_count;
+static u64 tx_time;
+static u8  line_buf[HOST_UART_LINE];
+static int line_head, line_count;
+
+void host_uart_reset(void) {
+    rx_head = rx_count = 0;
+    tx_head = tx_count = 0;
+    line_head = line_count = 0;
+    tx_time = host_time_ns;
+}
+
+// move the transmit FIFO along to the present
+static void txRun(void) {
+    if (tx_count == 0) {
+        tx_time = host_time_ns;
+        return;
+    }
+    while (tx_count > 0 && tx_time + HOST_UART_CHAR_NS <= host_time_ns) {
+        tx_time += HOST_UART_CHAR_NS;
+        if (line_count < HOST_UART_LINE) {
+            line_buf[(line_head + line_count) % HOST_UART_LINE] = tx_fifo[tx_head];
+            line_count++;
+        }
+        tx_head = (tx_head + 1) % HOST_UART_FIFO;
+        tx_count--;
+    }
+}
+
+int XUartPs_IsReceiveData(UINTPTR BaseAddress) {
+    (void)BaseAddress;
+    host_time_ns += HOST_ACCESS_NS;
+    return rx_count > 0;
+}
+
+int XUartPs_IsTransmitFull(UINTPTR BaseAddress) {
+    (void)BaseAddress;
+    host_time_ns += HOST_ACCESS_NS;
+    txRun();
+    return tx_count == HOST_UART_FIFO;
+}
+
+u8 XUartPs_RecvByte(UINTPTR BaseAddress) {
+    u8 byte = 0;
+
+    (void)BaseAddress;
+    host_time_ns += HOST_ACCESS_NS;
+    if (rx_count > 0) {
+        byte = rx_buf[rx_head];
+        rx_head = (rx_head + 1) % HOST_UART_LINE;
+        rx_count--;
+    }
+    return byte;
+}
+
+void XUartPs_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 RegisterValue) {
+    (void)BaseAddress;
+    host_time_ns += HOST_ACCESS_NS;
+    txRun();
+    if (RegOffset == XUARTPS_FIFO_OFFSET && tx_count < HOST_UART_FIFO) {
+        tx_fifo[(tx_head + tx_count) % HOST_UART_FIFO] = RegisterValue & 0xFF;
+        tx_count++;
+    }
+}
+
+int host_uart_send(const u8 *data, int len) {
+    int n = 0;
+
+    while (n < len && rx_count < HOST_UART_LINE) {
+        rx_buf[(rx_head + rx_count) % HOST_UART_LINE] = data[n++];
+        rx_count++;
+    }
+    return n;
+}
+
+int host_uart_recv(u8 *data, int max) {
+    int n = 0;
+
+    txRun();
+    while (n < max && line_count > 0) {
+        data[n++] = line_buf[line_head];
+        line_head = (line_head + 1) % HOST_UART_LINE;
+        line_count--;
+    }
+    return n;
+}
+
+/***************************************************************************
+* Interrupt driver
+****************************************************************************/
+
+static XUartPs_Config host_uart_config;
+
+XUartPs_Config *XUartPs_LookupConfig(UINTPTR BaseAddress) {
+    host_uart_config.BaseAddress = BaseAddress;
+    return &host_uart_config;
+}
+
+int XUartPs_CfgInitialize(XUartPs *InstancePtr, XUartPs_Config *Config, UINTPTR EffectiveAddr) {
+    (void)Config;
+    InstancePtr->BaseAddress = EffectiveAddr;
+    InstancePtr->Handler = NULL;
+    InstancePtr->CallBackRef = NULL;
+    return XST_SUCCESS;
+}
+
+void XUartPs_SetOptions(XUartPs *InstancePtr, u16 Options) {
+    (void)InstancePtr;
+    if (Options & XUARTPS_OPTION_RESET_RX) {
+        rx_head = rx_count = 0;
+    }
+}
+
+int XUartPs_SelfTest(XUartPs *InstancePtr) {
+    (void)InstancePtr;
+    return XST_SUCCESS;
+}
+
+int XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate) {
+    (void)InstancePtr;
+    (void)BaudRate;
+    return XST_SUCCESS;
+}
+
+void XUartPs_SetFifoThreshold(XUartPs *InstancePtr, u8 TriggerLevel) {
+    (void)InstancePtr;
+    (void)TriggerLevel;
+}
+
+void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr, void *CallBackRef) {
+    InstancePtr->Handler = FuncPtr;
+    InstancePtr->CallBackRef = CallBackRef;
+}
+
+void XUartPs_SetInterruptMask(XUartPs *InstancePtr, u32 Mask) {
+    (void)InstancePtr;
+    (void)Mask;
+}
+
+void XUartPs_InterruptHandler(XUartPs *InstancePtr) {
+    if (rx_count > 0 && InstancePtr->Handler) {
+        InstancePtr->Handler(InstancePtr->CallBackRef, XUARTPS_EVENT_RECV_DATA, rx_count);
+    }
+}
+
+u32 XUartPs_Recv(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes) {
+    u32 n = 0;
+
+    while (n < NumBytes && rx_count > 0) {
+        BufferPtr[n++] = XUartPs_RecvByte(InstancePtr->BaseAddress);
+    }
+    return n;
+}
@@ -0,0 +1,74 @@
+#ifndef XUARTPS_H_
+#define XUARTPS_H_
+
+/*
+ * Host stand-in for the Xilinx PS UART driver types and the polled
+ * register access of xuartps_hw.h. The UART runs at 115200 baud on the
+ * simulated clock of xtime_l.h: the host feeds received bytes in, and
+ * transmitted bytes leave the 64 byte FIFO a character time apart.
+ *
+ * The interrupt driver calls are there for the MIDI UART set-up: they
+ * keep the handler, and XUartPs_InterruptHandler, called by the host in
+ * place of the interrupt, hands it whatever has been received.
+ */
+
+#include "xil_types.h"
+#include "xparameters.h"
+
+#define XUARTPS_FIFO_OFFSET 0x30
+#define HOST_UART_FIFO      64
+
+// interrupt driver options, mask bits and handler events
+#define XUARTPS_OPTION_RESET_TX     0x0400
+#define XUARTPS_OPTION_RESET_RX     0x0800
+#define XUARTPS_IXR_RXOVR           0x0001
+#define XUARTPS_IXR_RXFULL          0x0004
+#define XUARTPS_IXR_RXEMPTY         0x0002
+#define XUARTPS_IXR_FRAMING         0x0040
+#define XUARTPS_IXR_PARITY          0x0080
+#define XUARTPS_IXR_TOUT            0x0100
+#define XUARTPS_EVENT_RECV_DATA     1
+#define XUARTPS_EVENT_RECV_TOUT     2
+#define XUARTPS_EVENT_SENT_DATA     3
+#define XUARTPS_EVENT_RECV_ERROR    4
+#define XUARTPS_EVENT_MODEM         5
+#define XUARTPS_EVENT_PARE_FRAME_BRKE 6
+#define XUARTPS_EVENT_RECV_ORERR    7
+
+typedef void (*XUartPs_Handler)(void *CallBackRef, u32 Event, u32 EventData);
+
+typedef struct {
+    UINTPTR BaseAddress;
+    u32     IntrId;
+    UINTPTR IntrParent;
+} XUartPs_Config;
+
+typedef struct {
+    UINTPTR         BaseAddress;
+    XUartPs_Handler Handler;
+    void           *CallBackRef;
+} XUartPs;
+
+int  XUartPs_IsReceiveData(UINTPTR BaseAddress);
+int  XUartPs_IsTransmitFull(UINTPTR BaseAddress);
+u8   XUartPs_RecvByte(UINTPTR BaseAddress);
+void XUartPs_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 RegisterValue);
+
+// interrupt driver
+XUartPs_Config *XUartPs_LookupConfig(UINTPTR BaseAddress);
+int  XUartPs_CfgInitialize(XUartPs *InstancePtr, XUartPs_Config *Config, UINTPTR EffectiveAddr);
+void XUartPs_SetOptions(XUartPs *InstancePtr, u16 Options);
+int  XUartPs_SelfTest(XUartPs *InstancePtr);
+int  XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate);
+void XUartPs_SetFifoThreshold(XUartPs *InstancePtr, u8 TriggerLevel);
+void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr, void *CallBackRef);
+void XUartPs_SetInterruptMask(XUartPs *InstancePtr, u32 Mask);
+void XUartPs_InterruptHandler(XUartPs *InstancePtr);
+u32  XUartPs_Recv(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes);
+
+// host side of the line
+void host_uart_reset(void);
+int  host_uart_send(const u8 *data, int len);
+int  host_uart_recv(u8 *data, int max);
+
+#endif /* XUARTPS_H_ */
@@ -0,0 +1,47 @@
+#ifndef CHECK_H_
+#define CHECK_H_
+
+/***************************************************************************
+* Include files
+****************************************************************************/
+
+#include <stdio.h>
+
+/*
+ * Checks shared by the host tests. Each test program is one translation
+ * unit that includes this once: a failed CHECK prints where and carries
+ * on, and main ends with checkResult() for the exit status.
+ */
+
+/***************************************************************************
+* Global variable definitions
+****************************************************************************/
+
+static int failures;
+
+/***************************************************************************
+* Macros
+****************************************************************************/
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("  %s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/***************************************************************************
+* Function definitions
+****************************************************************************/
+
+// PASS or FAIL with the count, the exit status of the test
+static inline int checkResult(void) {
+    if (failures) {
+        printf("FAIL: %d checks failed\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
+
+#endif /* CHECK_H_ */
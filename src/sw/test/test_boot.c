@@ -0,0 +1,208 @@
+/****************************************************************************/
+/**
+* test_boot.c
+*
+* Host tests for the boot sequencer on the stand-in codec bus and simulated
+* clock: the phase order and time budget, the diagnostic boot, a missing
+* codec, the first note stamp, and the phase breakdown compared with the
+* previous boot that ran every step back to back.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../boot/boot.h"
+#include "../midi/midi.h"
+#include "../ssm2603/ssm2603.h"
+#include "../synth_ctrl/synth_ctrl.h"
+#include "../synth_ctrl/synth_preset.h"
+#include "../storage/storage.h"
+#include "xtime_l.h"
+#include "check.h"
+
+/***************************************************************************
+* MIDI stand-ins
+*
+* The UART setup is register writes and the interrupt controller, the
+* self-test is a 32 character local loopback at 115200 baud.
+****************************************************************************/
+
+#define MIDI_SETUP_US     20
+#define MIDI_SELF_TEST_US (32 * HOST_UART_CHAR_NS / 1000)
+
+u32 FreqWordBase[128];
+static int midi_self_tests;
+
+int configMidi(u32 BaseAddress, u8 self_test) {
+    (void)BaseAddress;
+    host_usleep(MIDI_SETUP_US);
+    if (self_test) {
+        host_usleep(MIDI_SELF_TEST_US);
+        midi_self_tests++;
+    }
+    return XST_SUCCESS;
+}
+
+void applyFreqWordBase(void) {
+}
+
+static void reset(void) {
+    host_iic_reset();
+    memset(&i2c_stats, 0, sizeof(i2c_stats));
+    midi_self_tests = 0;
+}
+
+static int codecActive(void) {
+    return host_codec_regs[CODEC_ACTIVE] == M_ACTIVE &&
+           host_codec_regs[CODEC_PWR_MGMT] == (PM_PB_ONLY_EXT & ~M_OUT);
+}
+
+static int stampsInOrder(void) {
+    XTime last = boot_stamps[BOOT_START];
+
+    for (int s = BOOT_START + 1; s < NUM_BOOT_STAMPS; s ++) {
+        if (boot_stamps[s] == 0) {
+            continue;
+        }
+        if (boot_stamps[s] < last) {
+            return 0;
+        }
+        last = boot_stamps[s];
+    }
+    return 1;
+}
+
+/***************************************************************************
+* Boot tests
+****************************************************************************/
+
+static void testBoot(void) {
+    reset();
+    CHECK(bootSystem(0) == XST_SUCCESS);
+    CHECK(stampsInOrder());
+    CHECK(codecActive());
+    CHECK(midi_self_tests == 0);
+    CHECK(boot_stamps[BOOT_SELF_TEST] == 0);
+    CHECK(boot_stamps[BOOT_FIRST_NOTE] == 0);
+
+    // everything else is done inside the VMID delay
+    CHECK(bootElapsedUs(BOOT_LIBRARY) < 73000);
+    CHECK(bootElapsedUs(BOOT_CODEC) - bootElapsedUs(BOOT_CODEC_QUEUED) >= 73000);
+    CHECK(bootElapsedUs(BOOT_READY) < BOOT_BUDGET_US);
+}
+
+static void testDiag(void) {
+    reset();
+    CHECK(bootSystem(BOOT_DIAG) == XST_SUCCESS);
+    CHECK(stampsInOrder());
+    CHECK(codecActive());
+    CHECK(midi_self_tests == 1);
+    CHECK(boot_stamps[BOOT_SELF_TEST] != 0);
+
+    // the readback decodes what was written
+    CHECK(codecSSM2603.active == 1);
+    CHECK(codecSSM2603.out == 0);
+    CHECK(codecSSM2603.sr == 7);
+}
+
+static void testNoCodec(void) {
+    // the synth still comes up, and sooner, without the codec
+    reset();
+    host_codec_present = 0;
+    CHECK(bootSystem(0) == XST_SUCCESS);
+    CHECK(stampsInOrder());
+    CHECK(i2c_stats.failed > 0);
+    CHECK(bootElapsedUs(BOOT_READY) < 73000);
+    CHECK(!i2cBusy());
+}
+
+static void testFirstNote(void) {
+    reset();
+    CHECK(bootSystem(0) == XST_SUCCESS);
+    host_usleep(1000);
+    bootStampOnce(BOOT_FIRST_NOTE);
+    u32 first = bootElapsedUs(BOOT_FIRST_NOTE);
+    CHECK(first >= bootElapsedUs(BOOT_READY) + 1000);
+
+    // later notes leave it alone
+    host_usleep(1000);
+    bootStampOnce(BOOT_FIRST_NOTE);
+    CHECK(bootElapsedUs(BOOT_FIRST_NOTE) == first);
+    CHECK(stampsInOrder());
+}
+
+/***************************************************************************
+* Boot time against the previous sequence
+*
+* The previous boot ran the synth self-test, the whole codec power-up with
+* its readback and print, the UART self-test and then the library, one
+* after the other.
+****************************************************************************/
+
+static u64 serialBoot(void) {
+    u64 start = host_time_ns;
+
+    initSynth();
+    initPresets();
+    checkSynthCtrl();
+    configCodec();
+    configMidi(MIDI_BASEADDR, 1);
+    if (initStorage(FreqWordBase) == XST_SUCCESS && loadLibrary() == XST_SUCCESS) {
+        applyFreqWordBase();
+        for (u8 t = 0; t < NUM_TIMBRES; t ++) {
+            recallPreset(t, 0);
+        }
+    }
+    return host_time_ns - start;
+}
+
+static void testBreakdown(void) {
+    reset();
+    u64 serial = serialBoot();
+    CHECK(codecActive());
+
+    reset();
+    CHECK(bootSystem(BOOT_DIAG) == XST_SUCCESS);
+    u32 diag = bootElapsedUs(BOOT_READY);
+
+    reset();
+    CHECK(bootSystem(0) == XST_SUCCESS);
+    u32 ready = bootElapsedUs(BOOT_READY);
+
+    printf("  phase breakdown\n");
+    printBootTimes();
+    printf("  boot              ready (us)\n");
+    printf("  previous          %10u\n", (unsigned)(serial / 1000));
+    printf("  overlapped, diag  %10u\n", (unsigned)diag);
+    printf("  overlapped        %10u\n", (unsigned)ready);
+
+    CHECK(ready < diag);
+    CHECK(diag < serial / 1000);
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+    printf("boot\n");
+    testBoot();
+    printf("diagnostic boot\n");
+    testDiag();
+    printf("missing codec\n");
+    testNoCodec();
+    printf("first note\n");
+    testFirstNote();
+    printf("boot time\n");
+    testBreakdown();
+
+    return checkResult();
+}
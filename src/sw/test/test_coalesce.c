@@ -0,0 +1,339 @@
+/****************************************************************************/
+/**
+* test_coalesce.c
+*
+* Host tests for the MIDI event coalescer: superseded values, note priority,
+* barrier ordering, notes after the values held for their channel, full
+* lists, and the note latency under a saturating pressure and pitch bend
+* stream compared with dispatching every message.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Notes after the values held for their channel
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../midi/midi_parser.h"
+#include "../midi/midi_coalesce.h"
+#include "check.h"
+
+#define MAX_EVENTS 8192
+
+// register writes each message costs in the firmware handlers, a pitch bend
+// rewrites the whole tuning table
+#define BEND_WRITES 128
+
+/***************************************************************************
+* Captured dispatch output
+****************************************************************************/
+
+typedef struct {
+    u8 msg[3];
+    u8 len;
+} Event;
+
+static Event events[MAX_EVENTS];
+static int num_events;
+
+// register writes dispatched so far, and when the watched note went out
+static u32 writes;
+static u8  watch_note;
+static long note_writes;
+
+static void onDispatch(u8 *msg, u8 len) {
+    if (num_events < MAX_EVENTS) {
+        memcpy(events[num_events].msg, msg, len);
+        events[num_events].len = len;
+    }
+    num_events++;
+    if ((msg[0] & 0xF0) == 0x90 && msg[1] == watch_note && note_writes < 0) {
+        note_writes = writes;
+    }
+    writes += ((msg[0] & 0xF0) == 0xE0) ? BEND_WRITES : 1;
+}
+
+static MidiParser parser;
+static MidiCoalescer coalescer;
+
+static void onMsg(u8 *msg, u8 len) {
+    midiCoalesceMsg(&coalescer, msg, len);
+}
+
+static void onSysEx(u8 *data, u16 len) {
+    (void)data;
+    (void)len;
+    midiCoalesceFlush(&coalescer);
+}
+
+static void reset(void) {
+    num_events = 0;
+    midiCoalesceInit(&coalescer, onDispatch);
+    midiParserInit(&parser, onMsg, onSysEx);
+}
+
+static void feed(const u8 *bytes, int len) {
+    for (int i = 0; i < len; i ++) {
+        midiParseByte(&parser, bytes[i]);
+    }
+}
+
+static int expectMsg(int i, u8 b0, u8 b1, u8 b2, u8 len) {
+    const u8 want[3] = { b0, b1, b2 };
+    return i < num_events && events[i].len == len && memcmp(events[i].msg, want, len) == 0;
+}
+
+/***************************************************************************
+* Small deterministic random source so runs are repeatable
+****************************************************************************/
+
+static u32 rng_state = 0x1234567;
+
+static u32 rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/***************************************************************************
+* Ordering tests
+****************************************************************************/
+
+static void testSuperseded(void) {
+    reset();
+    for (int v = 0; v < 100; v ++) {
+        const u8 in[] = { 0xA0, 60, v, 0xD1, v, 0xE2, v, 0x40 };
+        feed(in, sizeof(in));
+    }
+    midiCoalesceFlush(&coalescer);
+    CHECK(num_events == 3);
+    CHECK(expectMsg(0, 0xA0, 60, 99, 3));
+    CHECK(expectMsg(1, 0xD1, 99, 0, 2));
+    CHECK(expectMsg(2, 0xE2, 99, 0x40, 3));
+    CHECK(coalescer.superseded == 3 * 99);
+}
+
+static void testDistinctKeys(void) {
+    const u8 in[] = {
+        0xA0, 60, 1,    // pressure key 60
+        0xA0, 61, 2,    // pressure key 61
+        0xA1, 60, 3,    // same key, another channel
+        0xB0, 1, 4,     // mod wheel
+        0xB0, 7, 5,     // volume
+        0xA0, 60, 6,    // key 60 again, keeps its place
+        0xB0, 1, 7
+    };
+    reset();
+    feed(in, sizeof(in));
+    midiCoalesceFlush(&coalescer);
+    CHECK(num_events == 5);
+    CHECK(expectMsg(0, 0xA0, 60, 6, 3));
+    CHECK(expectMsg(1, 0xA0, 61, 2, 3));
+    CHECK(expectMsg(2, 0xA1, 60, 3, 3));
+    CHECK(expectMsg(3, 0xB0, 1, 7, 3));
+    CHECK(expectMsg(4, 0xB0, 7, 5, 3));
+}
+
+static void testNotesFirst(void) {
+    // the values are for another channel than the notes
+    const u8 in[] = {
+        0xA1, 60, 10,
+        0x90, 62, 100,
+        0xE1, 0, 0x50,
+        0x80, 60, 0,
+        0x90, 64, 90
+    };
+    reset();
+    feed(in, sizeof(in));
+    CHECK(num_events == 0);
+    midiCoalesceFlush(&coalescer);
+    CHECK(num_events == 5);
+    CHECK(expectMsg(0, 0x90, 62, 100, 3));
+    CHECK(expectMsg(1, 0x80, 60, 0, 3));
+    CHECK(expectMsg(2, 0x90, 64, 90, 3));
+    CHECK(expectMsg(3, 0xA1, 60, 10, 3));
+    CHECK(expectMsg(4, 0xE1, 0, 0x50, 3));
+}
+
+static void testChannelValuesFirst(void) {
+    const u8 in[] = {
+        0x90, 60, 100,
+        0xA0, 60, 10,   // pressure on the key before its re-strike
+        0xB0, 5, 40,    // glide time before the note it glides into
+        0xA1, 60, 20,   // another channel, stays held
+        0x90, 60, 90,
+        0xA0, 60, 30,
+        0x91, 62, 80
+    };
+    reset();
+    feed(in, sizeof(in));
+    CHECK(num_events == 5);
+    midiCoalesceFlush(&coalescer);
+    CHECK(num_events == 7);
+    CHECK(expectMsg(0, 0x90, 60, 100, 3));
+    CHECK(expectMsg(1, 0xA0, 60, 10, 3));
+    CHECK(expectMsg(2, 0xB0, 5, 40, 3));
+    CHECK(expectMsg(3, 0x90, 60, 90, 3));
+    CHECK(expectMsg(4, 0xA1, 60, 20, 3));
+    CHECK(expectMsg(5, 0x91, 62, 80, 3));
+    CHECK(expectMsg(6, 0xA0, 60, 30, 3));
+}
+
+static void testBarriers(void) {
+    const u8 in[] = {
+        0x90, 60, 100,
+        0xB0, 20, 5,    // continuous, held
+        0xB0, 64, 127,  // sustain pedal, keeps its place
+        0x80, 60, 0,
+        0xB0, 20, 6,
+        0xC0, 3,        // program change, after the CC before it
+        0xB0, 20, 7
+    };
+    reset();
+    feed(in, sizeof(in));
+    midiCoalesceFlush(&coalescer);
+    CHECK(num_events == 7);
+    CHECK(expectMsg(0, 0x90, 60, 100, 3));
+    CHECK(expectMsg(1, 0xB0, 20, 5, 3));
+    CHECK(expectMsg(2, 0xB0, 64, 127, 3));
+    CHECK(expectMsg(3, 0x80, 60, 0, 3));
+    CHECK(expectMsg(4, 0xB0, 20, 6, 3));
+    CHECK(expectMsg(5, 0xC0, 3, 0, 2));
+    CHECK(expectMsg(6, 0xB0, 20, 7, 3));
+
+    // SysEx applies what came before it
+    const u8 sx[] = { 0xB0, 21, 9, 0xF0, 0x7D, 0x00, 0xF7 };
+    reset();
+    feed(sx, sizeof(sx));
+    CHECK(num_events == 1);
+    CHECK(expectMsg(0, 0xB0, 21, 9, 3));
+}
+
+static void testFullLists(void) {
+    // more notes than the event list holds all go out, in order
+    reset();
+    for (int i = 0; i < 3 * COALESCE_MAX_EVENTS; i ++) {
+        const u8 in[] = { 0x90, i & 0x7F, 1 + (i >> 7) };
+        feed(in, sizeof(in));
+    }
+    midiCoalesceFlush(&coalescer);
+    CHECK(num_events == 3 * COALESCE_MAX_EVENTS);
+    int ordered = 1;
+    for (int i = 0; i < 3 * COALESCE_MAX_EVENTS && i < MAX_EVENTS; i ++) {
+        ordered &= expectMsg(i, 0x90, i & 0x7F, 1 + (i >> 7), 3);
+    }
+    CHECK(ordered);
+    CHECK(coalescer.early_flushes == 2);
+
+    // every distinct key gets its latest value
+    reset();
+    for (int round = 0; round < 2; round ++) {
+        for (int ch = 0; ch < 16; ch ++) {
+            for (int k = 0; k < 128; k ++) {
+                const u8 in[] = { 0xA0 | ch, k, (k + round) & 0x7F };
+                feed(in, sizeof(in));
+            }
+        }
+    }
+    midiCoalesceFlush(&coalescer);
+    static u8 last[16][128];
+    memset(last, 0xFF, sizeof(last));
+    for (int i = 0; i < num_events && i < MAX_EVENTS; i ++) {
+        last[events[i].msg[0] & 0x0F][events[i].msg[1]] = events[i].msg[2];
+    }
+    int latest = 1;
+    for (int ch = 0; ch < 16; ch ++) {
+        for (int k = 0; k < 128; k ++) {
+            latest &= (last[ch][k] == ((k + 1) & 0x7F));
+        }
+    }
+    CHECK(latest);
+    CHECK(num_events <= 2 * 16 * 128);
+}
+
+/***************************************************************************
+* Note latency under a saturating controller stream
+*
+* A backlog of n pressure and bend messages from ten held keys arrives
+* with one note-on at the end. The latency is the register writes the
+* handlers make before the note goes out, with and without coalescing,
+* and with the note on another channel than the backlog.
+****************************************************************************/
+
+static long noteLatency(int n, int coalesce, u8 note_ch) {
+    static u8 stream[3 * 200001];
+    int len = 0;
+
+    for (int i = 0; i < n; i ++) {
+        u32 r = rng();
+        if (r % 20 == 0) {
+            stream[len++] = 0xE0;
+            stream[len++] = r & 0x7F;
+            stream[len++] = (r >> 7) & 0x7F;
+        } else {
+            stream[len++] = 0xA0;
+            stream[len++] = 48 + (r >> 8) % 10;
+            stream[len++] = (r >> 16) & 0x7F;
+        }
+    }
+    stream[len++] = 0x90 | note_ch;
+    stream[len++] = 72;
+    stream[len++] = 100;
+
+    num_events = 0;
+    writes = 0;
+    watch_note = 72;
+    note_writes = -1;
+    midiCoalesceInit(&coalescer, onDispatch);
+    midiParserInit(&parser, coalesce ? onMsg : onDispatch, onSysEx);
+    feed(stream, len);
+    midiCoalesceFlush(&coalescer);
+    return note_writes;
+}
+
+static void testNoteLatency(void) {
+    const int sizes[] = { 10, 100, 682, 10000, 200000 };
+
+    printf("  backlog msgs   direct writes   coalesced writes   other channel\n");
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i ++) {
+        long direct = noteLatency(sizes[i], 0, 0);
+        long coalesced = noteLatency(sizes[i], 1, 0);
+        // the values ahead of the note are bounded by the distinct keys
+        CHECK(coalesced >= 0 && coalesced <= 10 + BEND_WRITES);
+        CHECK(num_events <= 1 + 10 + 1);
+        long other = noteLatency(sizes[i], 1, 1);
+        printf("  %12d   %13ld   %16ld   %13ld\n", sizes[i], direct, coalesced, other);
+        CHECK(other == 0);
+        CHECK(num_events <= 1 + 10 + 1);
+    }
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+    printf("superseded values\n");
+    testSuperseded();
+    printf("distinct keys\n");
+    testDistinctKeys();
+    printf("notes first\n");
+    testNotesFirst();
+    printf("channel values first\n");
+    testChannelValuesFirst();
+    printf("barriers\n");
+    testBarriers();
+    printf("full lists\n");
+    testFullLists();
+    printf("note latency\n");
+    testNoteLatency();
+
+    return checkResult();
+}
@@ -0,0 +1,360 @@
+/****************************************************************************/
+/**
+* test_console.c
+*
+* Host tests for the binary console on the stand-in debug UART: the CRC and
+* COBS framing, dropped frames, each command against the stand-in engine
+* registers and codec, and the time each service call takes while a large
+* response goes out.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../console/console.h"
+#include "../boot/boot.h"
+#include "../latency/latency.h"
+#include "../midi/midi.h"
+#include "../midi/midi_sysex.h"
+#include "../ssm2603/ssm2603.h"
+#include "../synth_ctrl/synth_ctrl.h"
+#include "../synth_ctrl/synth_preset.h"
+#include "xtime_l.h"
+#include "xuartps.h"
+#include "check.h"
+
+/***************************************************************************
+* Stand-ins for the MIDI side
+****************************************************************************/
+
+u32 FreqWordBase[128];
+MidiParser midi_parser;
+MidiCoalescer midi_coalescer;
+
+int configMidi(u32 BaseAddress, u8 self_test) {
+    (void)BaseAddress;
+    (void)self_test;
+    return XST_SUCCESS;
+}
+
+void applyFreqWordBase(void) {
+}
+
+/***************************************************************************
+* Host side of the console
+****************************************************************************/
+
+static u8  resp[CON_MAX_FRAME];
+static u16 resp_len;
+static u64 slowest_call_ns;
+static u8  seq;
+
+static u32 get32(const u8 *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32)p[3] << 24);
+}
+
+static void sendMsg(const u8 *msg, u16 len) {
+    u8 m[CON_MAX_MSG + 2];
+    u8 frame[CON_MAX_FRAME];
+
+    memcpy(m, msg, len);
+    host_uart_send(frame, conFrame(m, len, frame));
+}
+
+// service the console until a response frame is back, 0 when none came
+static int serviceUntilResponse(int max_calls) {
+    static ConsoleRx rx;
+    u8 byte;
+
+    resp_len = 0;
+    for (int i = 0; i < max_calls; i ++) {
+        u64 start = host_time_ns;
+        consoleService();
+        if (host_time_ns - start > slowest_call_ns) {
+            slowest_call_ns = host_time_ns - start;
+        }
+        host_usleep(10);
+        while (host_uart_recv(&byte, 1)) {
+            resp_len = conRxByte(&rx, byte, resp);
+            if (resp_len) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// send a request and return the response status, or -1 for no response
+static int request(u8 cmd, const u8 *payload, u16 len) {
+    u8 msg[CON_MAX_MSG];
+
+    msg[0] = cmd;
+    msg[1] = ++seq;
+    // requests without a payload pass NULL
+    if (len) {
+        memcpy(&msg[2], payload, len);
+    }
+    sendMsg(msg, len + 2);
+
+    if (!serviceUntilResponse(20000)) {
+        return -1;
+    }
+    if (resp_len < 3 || resp[0] != (cmd | CON_RESPONSE) || resp[1] != seq) {
+        return -1;
+    }
+    return resp[2];
+}
+
+static int readRegs(u16 offset, u8 words) {
+    const u8 req[] = { offset & 0xFF, offset >> 8, words };
+    return request(CON_CMD_READ, req, sizeof(req));
+}
+
+static void reset(void) {
+    host_uart_reset();
+    host_iic_reset();
+    consoleInit();
+}
+
+/***************************************************************************
+* Framing tests
+****************************************************************************/
+
+static void testFraming(void) {
+    // CRC-16/CCITT-FALSE check value
+    CHECK(conCrc16((const u8 *)"123456789", 9) == 0x29B1);
+
+    u8 out[CON_MAX_FRAME], back[CON_MAX_FRAME];
+    const u8 zero[] = { 0x00 };
+    CHECK(conCobsEncode(zero, 1, out) == 2 && out[0] == 1 && out[1] == 1);
+    const u8 mixed[] = { 0x11, 0x22, 0x00, 0x33 };
+    CHECK(conCobsEncode(mixed, 4, out) == 5);
+    CHECK(out[0] == 3 && out[1] == 0x11 && out[2] == 0x22 && out[3] == 2 && out[4] == 0x33);
+
+    // round trips of every length up to the largest message, with runs
+    // of non-zero bytes past the 254 byte block size
+    u8 in[CON_MAX_MSG + 2];
+    for (u16 len = 0; len <= sizeof(in); len ++) {
+        for (u16 i = 0; i < len; i ++) {
+            in[i] = (len % 3 == 0) ? (u8)(i | 1) : (u8)(i * 7);
+        }
+        u16 n = conCobsEncode(in, len, out);
+        int ok = n <= len + len / 254 + 1 && memchr(out, 0, n) == NULL;
+        ok &= conCobsDecode(out, n, back) == len && memcmp(in, back, len) == 0;
+        if (!ok) {
+            CHECK(ok);
+            break;
+        }
+    }
+
+    // malformed blocks
+    const u8 short_block[] = { 0x05, 0x11 };
+    CHECK(conCobsDecode(short_block, 2, back) == -1);
+    const u8 inner_zero[] = { 0x03, 0x11, 0x00 };
+    CHECK(conCobsDecode(inner_zero, 3, back) == -1);
+}
+
+static void testRx(void) {
+    ConsoleRx rx;
+    u8 msg[CON_MAX_MSG + 2] = { CON_CMD_PING, 7 };
+    u8 frame[CON_MAX_FRAME];
+    u8 got[CON_MAX_FRAME];
+    u16 n = conFrame(msg, 2, frame);
+    u16 len = 0;
+
+    // text before the frame is dropped
+    memset(&rx, 0, sizeof(rx));
+    const char *text = "ALIVE\r\n";
+    for (const char *c = text; *c; c ++) {
+        conRxByte(&rx, *c, got);
+    }
+    for (u16 i = 0; i < n; i ++) {
+        len = conRxByte(&rx, frame[i], got);
+    }
+    CHECK(len == 2 && got[0] == CON_CMD_PING && got[1] == 7);
+    CHECK(rx.frames == 1 && rx.bad_frames == 1);
+
+    // a corrupted frame is dropped and the next one is taken
+    frame[2] ^= 0x40;
+    for (u16 i = 0; i < n; i ++) {
+        len = conRxByte(&rx, frame[i], got);
+    }
+    CHECK(len == 0 && rx.bad_frames == 2);
+    frame[2] ^= 0x40;
+    for (u16 i = 0; i < n; i ++) {
+        len = conRxByte(&rx, frame[i], got);
+    }
+    CHECK(len == 2 && rx.frames == 2);
+
+    // an overlong frame does not overrun the buffer
+    for (int i = 0; i < 2 * CON_MAX_FRAME; i ++) {
+        conRxByte(&rx, 0x55, got);
+    }
+    CHECK(conRxByte(&rx, 0, got) == 0 && rx.bad_frames == 3);
+}
+
+/***************************************************************************
+* Command tests
+****************************************************************************/
+
+static void testPeekPoke(void) {
+    reset();
+    setReg(REG_REV, 0x0000000C);
+    setReg(REG_DATE, 0x19102026);
+    CHECK(request(CON_CMD_PING, NULL, 0) == CON_OK);
+    CHECK(resp_len == 13 && get32(&resp[3]) == 0x0000000C && get32(&resp[7]) == 0x19102026);
+
+    // write four registers and read them back
+    const u16 off = SYNTH_REG_OFFSET + 4 * REG_WRAPBACK - 12;
+    u8 wr[2 + 16] = { off & 0xFF, off >> 8 };
+    for (int i = 0; i < 16; i ++) {
+        wr[2 + i] = 0xA0 + i;
+    }
+    CHECK(request(CON_CMD_WRITE, wr, sizeof(wr)) == CON_OK);
+    CHECK(readWrapback() == 0xAFAEADAC);
+    CHECK(readRegs(off, 4) == CON_OK);
+    CHECK(resp_len == 3 + 16 && memcmp(&resp[3], &wr[2], 16) == 0);
+
+    // a snapshot of the whole register bank
+    CHECK(readRegs(SYNTH_REG_OFFSET, CON_MAX_WORDS) == CON_OK);
+    CHECK(resp_len == 3 + 4 * CON_MAX_WORDS);
+    CHECK(get32(&resp[3 + 4 * REG_REV]) == 0x0000000C);
+
+    // out of range, unaligned, empty and too long
+    CHECK(readRegs(SYNTH_ADDR_SPAN - 4, 2) == CON_ERR_RANGE);
+    CHECK(readRegs(SYNTH_REG_OFFSET + 2, 1) == CON_ERR_RANGE);
+    CHECK(readRegs(0, 0) == CON_ERR_RANGE);
+    CHECK(readRegs(0, CON_MAX_WORDS + 1) == CON_ERR_RANGE);
+    CHECK(request(CON_CMD_WRITE, wr, 5) == CON_ERR_LEN);
+    CHECK(request(0x7E, NULL, 0) == CON_ERR_CMD);
+}
+
+static void testCodec(void) {
+    reset();
+    CHECK(configCodec() == XST_SUCCESS);
+    CHECK(request(CON_CMD_CODEC, NULL, 0) == CON_OK);
+    CHECK(resp_len == 3 + 3 * 13);
+    int match = 1;
+    for (int i = 0; i < 13; i ++) {
+        u8 reg = resp[3 + 3 * i];
+        u16 value = resp[4 + 3 * i] | (resp[5 + 3 * i] << 8);
+        match &= reg < HOST_CODEC_REGS && value == host_codec_regs[reg];
+    }
+    CHECK(match);
+
+    reset();
+    host_codec_present = 0;
+    CHECK(request(CON_CMD_CODEC, NULL, 0) == CON_ERR_IO);
+}
+
+static void testCounters(void) {
+    reset();
+    memset(&i2c_stats, 0, sizeof(i2c_stats));
+    i2c_stats.retries = 3;
+    midi_parser.sysex_aborts = 5;
+    midi_coalescer.superseded = 1234;
+    CHECK(request(CON_CMD_COUNTERS, NULL, 0) == CON_OK);
+    CHECK(resp_len == 3 + 4 * NUM_CON_COUNTERS);
+    CHECK(get32(&resp[3 + 4 * CON_CNT_I2C_RETRIES]) == 3);
+    CHECK(get32(&resp[3 + 4 * CON_CNT_SYSEX_ABORTS]) == 5);
+    CHECK(get32(&resp[3 + 4 * CON_CNT_SUPERSEDED]) == 1234);
+    CHECK(get32(&resp[3 + 4 * CON_CNT_FRAMES]) == 1);
+}
+
+static void testLatency(void) {
+    reset();
+    latClear();
+    latRecord(&lat_hists[LAT_TOTAL], 5000);
+    latRecord(&lat_hists[LAT_TOTAL], 300);
+
+    const u8 keep[] = { 0 };
+    const u8 clear[] = { CON_LATENCY_CLEAR };
+    const u16 hist_len = 4 * (4 + LAT_BUCKETS);
+    CHECK(request(CON_CMD_LATENCY, keep, 1) == CON_OK);
+    CHECK(resp_len == 3 + NUM_LAT_POINTS * hist_len);
+    CHECK(get32(&resp[3]) == 2 && get32(&resp[7]) == 300 && get32(&resp[11]) == 5000);
+    CHECK(get32(&resp[15]) == 2650);
+    CHECK(get32(&resp[19 + 4 * latBucket(300)]) == 1);
+
+    CHECK(request(CON_CMD_LATENCY, clear, 1) == CON_OK);
+    CHECK(get32(&resp[3]) == 2);
+    CHECK(lat_hists[LAT_TOTAL].count == 0);
+}
+
+static void testPreset(void) {
+    SynthPatch patch = {
+        .wave_amps = { 10, 20, 30, 40, 50 },
+        .pulse_width = 0x4000,
+        .out_amp = 0x3F, .out_shift = 8,
+        .attack = 10, .decay = 20, .sustain = 100, .release = 30,
+        .pan_position = 64, .pan_spread = 0,
+        .slew_wfrm = 1, .slew_out = 1, .slew_pw = 1
+    };
+    u8 msg[SYSEX_PRESET_MSG_LEN];
+
+    reset();
+    initPresets();
+    u32 edits = presetEdits();
+    u16 len = sysexEncodePreset(42, &patch, msg);
+    CHECK(request(CON_CMD_PRESET, msg, len) == CON_OK);
+    CHECK(presetEdits() == edits + 1);
+    CHECK(getPreset(42)->regs[TIMBRE_PULSE + 4] != getPreset(41)->regs[TIMBRE_PULSE + 4]);
+
+    msg[len - 1] ^= 1;
+    CHECK(request(CON_CMD_PRESET, msg, len) == CON_ERR_LEN);
+    CHECK(presetEdits() == edits + 1);
+}
+
+/***************************************************************************
+* Service time
+*
+* A snapshot response is a 519 byte frame, 45 ms on the line. The service
+* calls while it goes out must each stay short so the MIDI ring is drained
+* between them.
+****************************************************************************/
+
+static void testServiceTime(void) {
+    reset();
+    slowest_call_ns = 0;
+    u64 start = host_time_ns;
+    CHECK(readRegs(SYNTH_REG_OFFSET, CON_MAX_WORDS) == CON_OK);
+    u64 elapsed = host_time_ns - start;
+
+    printf("  snapshot: %u bytes back in %.1f ms, slowest service call %.1f us\n",
+           (unsigned)(3 + 4 * CON_MAX_WORDS), elapsed / 1e6, slowest_call_ns / 1e3);
+    CHECK(elapsed > 40000000ULL);
+    CHECK(slowest_call_ns < 60000);
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+    printf("framing\n");
+    testFraming();
+    printf("receive\n");
+    testRx();
+    printf("peek and poke\n");
+    testPeekPoke();
+    printf("codec dump\n");
+    testCodec();
+    printf("counters\n");
+    testCounters();
+    printf("latency\n");
+    testLatency();
+    printf("preset upload\n");
+    testPreset();
+    printf("service time\n");
+    testServiceTime();
+
+    return checkResult();
+}
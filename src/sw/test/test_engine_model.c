@@ -0,0 +1,225 @@
+/****************************************************************************/
+/**
+* test_engine_model.c
+*
+* Host tests for the C engine model behind the host synth: register
+* readback and the packed note writes, a note through attack and release,
+* held notes committed together, glides of a chord started together, and
+* the slot ranges of a threaded render adding up to the single thread
+* render.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Glides of a chord
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../host/engine_model.h"
+#include "../synth_ctrl/synth_ctrl.h"
+#include "check.h"
+
+#define BLOCK 256
+#define NOTE  69
+
+#define REG(r)         (SYNTH_REG_OFFSET + 4 * (r))
+#define TIMBRE(t, r)   (SYNTH_TIMBRE_OFFSET + 4 * ((t) * TIMBRE_REGS + (r)))
+
+static Engine engine, other;
+static s32 out[2 * BLOCK], ref[2 * BLOCK];
+
+// a sine with a short attack and release at full output
+static void patch(Engine *e) {
+    engineInit(e);
+    engineWrite(e, REG(REG_SINE), 127);
+    engineWrite(e, REG(REG_ATTACK_AMT), 0x8000);
+    engineWrite(e, REG(REG_DECAY_AMT), 0x100);
+    engineWrite(e, REG(REG_SUSTAIN_AMT), 0xC0000);
+    engineWrite(e, REG(REG_RELEASE_AMT), 0x8000);
+    engineWrite(e, REG(REG_GAIN_SCALE), 127);
+    engineWrite(e, REG(REG_GAIN_SHIFT), 4);
+}
+
+static s32 peak(const s32 *stereo, int frames) {
+    s32 max = 0;
+
+    for (int i = 0; i < 2 * frames; i ++) {
+        s32 v = (stereo[i] < 0) ? -stereo[i] : stereo[i];
+        max = (v > max) ? v : max;
+    }
+    return max;
+}
+
+static int active(const Engine *e, int note) {
+    return (engineRead(e, REG(REG_ACTIVE + note / 32)) >> (note % 32)) & 1;
+}
+
+/***************************************************************************
+* Registers
+****************************************************************************/
+
+static void testRegisters(void) {
+    engineInit(&engine);
+    CHECK(engineRead(&engine, REG(REG_REV)) == ENG_REV);
+    CHECK(engineRead(&engine, REG(REG_DATE)) == ENG_DATE);
+    CHECK(engineRead(&engine, SYNTH_NOTE_PAN_OFFSET + 4 * 5) == 64);
+    CHECK(engineRead(&engine, TIMBRE(3, TIMBRE_LEVEL)) == 127);
+    CHECK(engineRead(&engine, TIMBRE(3, TIMBRE_MOD_SRC)) == 0x03020100);
+
+    // the settings waves and envelope are timbre 0
+    engineWrite(&engine, REG(REG_SAW), 0x12340055);
+    CHECK(engineRead(&engine, TIMBRE(0, TIMBRE_PULSE + SAW_WAVE)) == 0x12340055);
+    engineWrite(&engine, TIMBRE(0, TIMBRE_RELEASE_AMT), 0xFFFFFFFF);
+    CHECK(engineRead(&engine, REG(REG_RELEASE_AMT)) == 0xFFFFF);
+
+    // four notes a word, and a bit per note at the gate velocity
+    engineWrite(&engine, REG(REG_NOTE_PACK + 1), 0x7F010002);
+    CHECK(engineRead(&engine, 4 * 4) == 2);
+    CHECK(engineRead(&engine, 4 * 5) == 0);
+    CHECK(engineRead(&engine, 4 * 7) == 0x7F);
+    engineWrite(&engine, REG(REG_GATE_VEL), 90);
+    engineWrite(&engine, REG(REG_NOTE_GATE + 1), 0x80000001);
+    CHECK(engineRead(&engine, 4 * 32) == 90);
+    CHECK(engineRead(&engine, 4 * 63) == 90);
+    CHECK(engineRead(&engine, 4 * 40) == 0);
+    CHECK(engineRead(&engine, REG(REG_NOTE_GATE + 1)) == 0x80000001);
+
+    // release all is a command, it does not read back
+    engineWrite(&engine, REG(REG_NOTE_CTRL), NOTE_CTRL_HOLD | NOTE_CTRL_RELEASE_ALL);
+    CHECK(engineRead(&engine, REG(REG_NOTE_CTRL)) == NOTE_CTRL_HOLD);
+    CHECK(engineRead(&engine, 4 * 32) == 0);
+
+    // the model has no trace buffer, region 7 is not decoded
+    engineWrite(&engine, SYNTH_TRACE_OFFSET, 1);
+    CHECK(engineRead(&engine, SYNTH_TRACE_OFFSET) == 0);
+}
+
+/***************************************************************************
+* Notes
+****************************************************************************/
+
+static void testNote(void) {
+    patch(&engine);
+    engineRun(&engine, out, BLOCK);
+    CHECK(peak(out, BLOCK) == 0);
+    CHECK(engineActiveCount(&engine) == 0);
+
+    engineWrite(&engine, SYNTH_NOTE_AMP_OFFSET + 4 * NOTE, 100);
+    for (int i = 0; i < 40; i ++) {
+        engineRun(&engine, out, BLOCK);
+    }
+    CHECK(peak(out, BLOCK) > 100000);
+    CHECK(active(&engine, NOTE));
+    CHECK(engineActiveCount(&engine) == 1);
+
+    // released, it dies away and the slot goes idle
+    engineWrite(&engine, SYNTH_NOTE_AMP_OFFSET + 4 * NOTE, 0);
+    for (int i = 0; i < 100 && active(&engine, NOTE); i ++) {
+        engineRun(&engine, out, BLOCK);
+    }
+    CHECK(!active(&engine, NOTE));
+    engineRun(&engine, out, BLOCK);
+    CHECK(peak(out, BLOCK) == 0);
+}
+
+static void testHold(void) {
+    patch(&engine);
+    engineWrite(&engine, REG(REG_NOTE_CTRL), NOTE_CTRL_HOLD);
+    engineWrite(&engine, SYNTH_NOTE_AMP_OFFSET + 4 * NOTE, 100);
+    engineWrite(&engine, SYNTH_NOTE_AMP_OFFSET + 4 * (NOTE + 4), 100);
+    for (int i = 0; i < 4; i ++) {
+        engineRun(&engine, out, BLOCK);
+    }
+    CHECK(peak(out, BLOCK) == 0);
+    CHECK(engineActiveCount(&engine) == 0);
+
+    // both start on the frame the hold is let go
+    engineWrite(&engine, REG(REG_NOTE_CTRL), 0);
+    engineRun(&engine, out, BLOCK);
+    CHECK(engineActiveCount(&engine) == 2);
+    CHECK(peak(out, BLOCK) > 0);
+}
+
+// every glide written in a frame starts, not only the last
+static void testGlide(void) {
+    static const int from[] = { 48, 53, 57 }, to[] = { 60, 65, 69 };
+
+    patch(&engine);
+    engineWrite(&engine, REG(REG_GLIDE_RATE), 4);
+    engineRun(&engine, out, BLOCK);
+
+    for (int i = 0; i < 3; i ++) {
+        engineWrite(&engine, SYNTH_NOTE_AMP_OFFSET + 4 * to[i], 100);
+        engineWrite(&engine, REG(REG_GLIDE), GLIDE_START |
+                    ((u32)from[i] << GLIDE_FROM_SHIFT) | ((u32)to[i] << GLIDE_TO_SHIFT));
+    }
+    CHECK(engineRead(&engine, REG(REG_GLIDE)) & GLIDE_START);
+    engineRun(&engine, out, BLOCK);
+    CHECK(!(engineRead(&engine, REG(REG_GLIDE)) & GLIDE_START));
+    for (int i = 0; i < 3; i ++) {
+        const EngineSlot *sl = &engine.slots[to[i]];
+        CHECK(sl->gliding);
+        CHECK(sl->cur_inc > engine.freq_out[from[i]]);
+        CHECK(sl->cur_inc < engine.freq_out[to[i]]);
+    }
+}
+
+/***************************************************************************
+* Threaded render
+****************************************************************************/
+
+static void testSplit(void) {
+    static s32 mix_l[2][BLOCK], mix_r[2][BLOCK];
+    int same = 1;
+
+    patch(&engine);
+    patch(&other);
+    for (int n = 40; n < 100; n += 7) {
+        engineWrite(&engine, SYNTH_NOTE_AMP_OFFSET + 4 * n, n);
+        engineWrite(&other, SYNTH_NOTE_AMP_OFFSET + 4 * n, n);
+    }
+
+    for (int b = 0; b < 30; b ++) {
+        engineRun(&engine, ref, BLOCK);
+
+        // two ranges into their own mixes, summed
+        engineControl(&other, BLOCK);
+        memset(mix_l, 0, sizeof(mix_l));
+        memset(mix_r, 0, sizeof(mix_r));
+        engineRenderSlots(&other, 0, 64, mix_l[0], mix_r[0]);
+        engineRenderSlots(&other, 64, ENG_SLOTS, mix_l[1], mix_r[1]);
+        for (int f = 0; f < BLOCK; f ++) {
+            mix_l[0][f] += mix_l[1][f];
+            mix_r[0][f] += mix_r[1][f];
+        }
+        engineOutput(&other, mix_l[0], mix_r[0], out);
+        same &= !memcmp(out, ref, sizeof(out));
+    }
+    CHECK(same);
+    CHECK(peak(ref, BLOCK) > 0);
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+    printf("registers\n");
+    testRegisters();
+    printf("note\n");
+    testNote();
+    printf("hold\n");
+    testHold();
+    printf("glide\n");
+    testGlide();
+    printf("split render\n");
+    testSplit();
+
+    return checkResult();
+}
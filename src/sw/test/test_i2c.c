@@ -0,0 +1,250 @@
+/****************************************************************************/
+/**
+* test_i2c.c
+*
+* Host tests for the queued I2C transport and the SSM2603 power-up on the
+* stand-in AXI IIC bus: batch order, NACK retries, a missing device and a
+* stuck bus, and the codec configuration time compared with the bus
+* traffic of the previous one-transaction-at-a-time transport.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../i2c/i2c.h"
+#include "../ssm2603/ssm2603.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "check.h"
+
+static void reset(void) {
+    host_iic_reset();
+    memset(&i2c_stats, 0, sizeof(i2c_stats));
+    i2cInit();
+}
+
+/***************************************************************************
+* Transport tests
+****************************************************************************/
+
+static void testConfig(void) {
+    reset();
+    CHECK(configCodec() == XST_SUCCESS);
+    CHECK(host_codec_regs[CODEC_PWR_MGMT] == (PM_PB_ONLY_EXT & ~M_OUT));
+    CHECK(host_codec_regs[CODEC_AN_AUDIO_PATH] == (M_DACSEL | M_MUTEMIC));
+    CHECK(host_codec_regs[CODEC_SAMPLE_RATE] == (0x7 << B_SR));
+    CHECK(host_codec_regs[CODEC_DIG_AUDIO_PATH] == 0);
+    CHECK(host_codec_regs[CODEC_ACTIVE] == M_ACTIVE);
+    CHECK(host_codec_writes == 6);
+
+    // the readback decodes what was written and the untouched defaults
+    CHECK(codecSSM2603.active == 1);
+    CHECK(codecSSM2603.out == 0);
+    CHECK(codecSSM2603.dac == 0);
+    CHECK(codecSSM2603.dacsel == 1);
+    CHECK(codecSSM2603.sr == 7);
+    CHECK(codecSSM2603.lhpvol == 0x79);
+    CHECK(codecSSM2603.maxgain == 7);
+    CHECK(i2c_stats.retries == 0 && i2c_stats.failed == 0);
+}
+
+static void testBatchOrder(void) {
+    // more writes than the queue holds keep their order
+    reset();
+    for (int i = 0; i < 3 * I2C_QUEUE_LEN; i ++) {
+        CHECK(codecQueueWrite(CODEC_L_DAC_VOL, i) == XST_SUCCESS);
+        CHECK(codecQueueWrite(CODEC_R_DAC_VOL, 0x1FF - i) == XST_SUCCESS);
+    }
+    CHECK(i2cWait() == XST_SUCCESS);
+    CHECK(host_codec_writes == 6 * I2C_QUEUE_LEN);
+    CHECK(host_codec_regs[CODEC_L_DAC_VOL] == 3 * I2C_QUEUE_LEN - 1);
+    CHECK(host_codec_regs[CODEC_R_DAC_VOL] == 0x1FF - (3 * I2C_QUEUE_LEN - 1));
+
+    // reads queued behind writes see them
+    u16 data = 0;
+    CHECK(codec_read(CODEC_L_DAC_VOL, &data) == XST_SUCCESS);
+    CHECK(data == 3 * I2C_QUEUE_LEN - 1);
+}
+
+static void testNack(void) {
+    // one NACK is retried
+    reset();
+    host_iic_nacks = 1;
+    CHECK(codec_write(CODEC_L_DAC_VOL, 0x55) == XST_SUCCESS);
+    CHECK(host_codec_regs[CODEC_L_DAC_VOL] == 0x55);
+    CHECK(i2c_stats.retries == 1);
+
+    // a NACK in the middle of a batch resends from the failed write on
+    reset();
+    for (int i = 0; i < 4; i ++) {
+        codecQueueWrite(CODEC_L_DAC_VOL + i, 0x40 + i);
+        if (i == 1) {
+            // land on a write that is already in the FIFO
+            host_iic_nacks = 1;
+        }
+    }
+    CHECK(i2cWait() == XST_SUCCESS);
+    for (int i = 0; i < 4; i ++) {
+        CHECK(host_codec_regs[CODEC_L_DAC_VOL + i] == 0x40 + i);
+    }
+    CHECK(host_codec_writes == 4);
+    CHECK(i2c_stats.retries == 1);
+
+    // NACKs that do not stop are given up on after the retries
+    reset();
+    host_iic_nacks = 1000;
+    u32 xfers = host_iic_xfers;
+    CHECK(codec_write(CODEC_L_DAC_VOL, 0x12) == XST_FAILURE);
+    CHECK(host_iic_xfers - xfers == 1 + I2C_RETRIES);
+    CHECK(i2c_stats.failed == 1);
+
+    // and the transport carries on afterwards
+    host_iic_nacks = 0;
+    CHECK(codec_write(CODEC_L_DAC_VOL, 0x34) == XST_SUCCESS);
+    CHECK(host_codec_regs[CODEC_L_DAC_VOL] == 0x34);
+}
+
+static void testNoDevice(void) {
+    reset();
+    host_codec_present = 0;
+    u64 start = host_time_ns;
+    CHECK(configCodec() == XST_FAILURE);
+    CHECK(i2c_stats.failed > 0);
+    // fails before the VMID delay rather than retrying forever
+    CHECK(host_time_ns - start < 20000000ULL);
+    CHECK(!i2cBusy());
+}
+
+static void testStuckBus(void) {
+    reset();
+    host_iic_stuck = 1;
+    u64 start = host_time_ns;
+    CHECK(codec_write(CODEC_L_DAC_VOL, 0x12) == XST_FAILURE);
+    CHECK(i2c_stats.timeouts == 1 + I2C_RETRIES);
+    CHECK(host_time_ns - start < 2000ULL * I2C_TIMEOUT_US * (1 + I2C_RETRIES));
+    CHECK(!i2cBusy());
+
+    host_iic_stuck = 0;
+    CHECK(codec_write(CODEC_L_DAC_VOL, 0x12) == XST_SUCCESS);
+}
+
+/***************************************************************************
+* Configuration time against the previous transport
+*
+* The previous transport sent every register write as three blocking
+* transactions, the register address alone before and after the data, and
+* read the registers back one blocking transaction at a time. Its bus
+* traffic is replayed here through the same stand-in controller.
+****************************************************************************/
+
+static void legacySend(const u16 *entries, int n, int hold) {
+    for (int i = 0; i < n; i ++) {
+        XIic_WriteReg(IIC_BASE_ADDRESS, XIIC_DTR_REG_OFFSET, entries[i]);
+    }
+    // wait for the FIFO to empty and, unless the bus is held, the stop
+    for (;;) {
+        u32 sr = XIic_ReadReg(IIC_BASE_ADDRESS, XIIC_SR_REG_OFFSET);
+        if ((sr & XIIC_SR_TX_FIFO_EMPTY_MASK) && (hold || !(sr & XIIC_SR_BUS_BUSY_MASK))) {
+            break;
+        }
+    }
+}
+
+static void legacyWrite(u8 reg, u16 data) {
+    const u16 addr = XIIC_TX_DYN_START_MASK | (SSM2603_I2C_ADDR << 1);
+    const u8 b0 = (reg << 1) | ((data >> 8) & 1);
+    const u16 reg_only[] = { addr, XIIC_TX_DYN_STOP_MASK | b0 };
+    const u16 write[] = { addr, b0, XIIC_TX_DYN_STOP_MASK | (data & 0xFF) };
+
+    legacySend(reg_only, 2, 0);
+    legacySend(write, 3, 0);
+    legacySend(reg_only, 2, 0);
+}
+
+static void legacyRead(u8 reg) {
+    const u16 addr = XIIC_TX_DYN_START_MASK | (SSM2603_I2C_ADDR << 1);
+    const u16 ptr[] = { addr, reg << 1 };
+    const u16 read[] = { addr | XIIC_READ_OPERATION, XIIC_TX_DYN_STOP_MASK | 2 };
+
+    legacySend(ptr, 2, 1);
+    legacySend(read, 2, 0);
+    XIic_ReadReg(IIC_BASE_ADDRESS, XIIC_DRR_REG_OFFSET);
+    XIic_ReadReg(IIC_BASE_ADDRESS, XIIC_DRR_REG_OFFSET);
+}
+
+static void legacyConfig(void) {
+    const u8 regs[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 17, 18 };
+
+    legacyWrite(CODEC_PWR_MGMT, PM_PB_ONLY_EXT);
+    legacyWrite(CODEC_AN_AUDIO_PATH, M_DACSEL | M_MUTEMIC);
+    legacyWrite(CODEC_SAMPLE_RATE, 0x7 << B_SR);
+    legacyWrite(CODEC_DIG_AUDIO_PATH, 0);
+    usleep(73000);
+    legacyWrite(CODEC_ACTIVE, M_ACTIVE);
+    legacyWrite(CODEC_PWR_MGMT, PM_PB_ONLY_EXT & (~M_OUT));
+    for (unsigned i = 0; i < sizeof(regs); i ++) {
+        legacyRead(regs[i]);
+    }
+}
+
+static void report(const char *name, u64 elapsed) {
+    printf("  %-10s %6u %7u %9.2f %9.2f %9.2f\n", name,
+           (unsigned)host_iic_xfers, (unsigned)host_iic_bytes,
+           host_iic_busy_ns / 1e6, (elapsed - 73000000ULL) / 1e6, elapsed / 1e6);
+}
+
+static void testConfigTime(void) {
+    u64 start, queued, legacy;
+
+    printf("  transport   xfers   bytes   bus (ms) i2c (ms) boot (ms)\n");
+
+    reset();
+    start = host_time_ns;
+    legacyConfig();
+    legacy = host_time_ns - start;
+    report("previous", legacy);
+    u32 legacy_xfers = host_iic_xfers;
+
+    // the power-up and readback alone, without printing the configuration
+    reset();
+    start = host_time_ns;
+    codecStart(1);
+    int status;
+    while ((status = codecService()) == CODEC_BUSY) {
+    }
+    CHECK(status == XST_SUCCESS);
+    queued = host_time_ns - start;
+    report("queued", queued);
+
+    CHECK(host_iic_xfers < legacy_xfers);
+    CHECK(queued < legacy);
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+    printf("codec configuration\n");
+    testConfig();
+    printf("batch order\n");
+    testBatchOrder();
+    printf("nack retries\n");
+    testNack();
+    printf("missing device\n");
+    testNoDevice();
+    printf("stuck bus\n");
+    testStuckBus();
+    printf("configuration time\n");
+    testConfigTime();
+
+    return checkResult();
+}
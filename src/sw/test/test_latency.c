@@ -0,0 +1,186 @@
+/****************************************************************************/
+/**
+* test_latency.c
+*
+* Host tests for the control path latency histograms on the simulated
+* clock: bucket edges, the spans of a batch, bytes that arrive while a
+* batch is dispatched, messages split across batches, and a dump of a
+* batch stream with a slow dispatch now and then.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../latency/latency.h"
+#include "xtime_l.h"
+#include "check.h"
+
+// a span is within a few timer reads and a tick of what was slept
+#define NEAR(ns, us) ((ns) + 10 >= 1000 * (us) && (ns) <= 1000 * (us) + 1000)
+
+static void wait(unsigned long us) {
+    host_usleep(us);
+}
+
+/***************************************************************************
+* A batch: an interrupt pushes bytes, then the main loop drains, parses,
+* dispatches and commits
+****************************************************************************/
+
+static void arrive(unsigned long isr_us) {
+    latStamp(LAT_ISR);
+    wait(isr_us);
+    latStamp(LAT_PUSH);
+}
+
+static void drain(unsigned long wait_us, int parsed) {
+    wait(wait_us);
+    if (parsed) {
+        latStamp(LAT_PARSED);
+    }
+    latTakeArrival();
+}
+
+static void dispatch(unsigned long dispatch_us, unsigned long write_us) {
+    wait(dispatch_us);
+    latStamp(LAT_DISPATCH);
+    wait(write_us);
+    latStamp(LAT_WRITE);
+}
+
+/***************************************************************************
+* Tests
+****************************************************************************/
+
+static void testBuckets(void) {
+    CHECK(latBucket(0) == 0);
+    CHECK(latBucket(LAT_BUCKET0_NS - 1) == 0);
+    CHECK(latBucket(LAT_BUCKET0_NS) == 1);
+    CHECK(latBucket(2 * LAT_BUCKET0_NS - 1) == 1);
+    CHECK(latBucket(2 * LAT_BUCKET0_NS) == 2);
+    CHECK(latBucket((u32)LAT_BUCKET0_NS << (LAT_BUCKETS - 2)) == LAT_BUCKETS - 1);
+    CHECK(latBucket(0xFFFFFFFF) == LAT_BUCKETS - 1);
+
+    LatHist h;
+    memset(&h, 0, sizeof(h));
+    latRecord(&h, 500);
+    latRecord(&h, 100);
+    latRecord(&h, 9000);
+    CHECK(h.count == 3 && h.min_ns == 100 && h.max_ns == 9000 && h.sum_ns == 9600);
+    CHECK(h.buckets[0] == 1 && h.buckets[latBucket(500)] == 1 && h.buckets[latBucket(9000)] == 1);
+}
+
+static void testSpans(void) {
+    latClear();
+    arrive(2);
+    drain(30, 1);
+    dispatch(5, 400);
+
+    for (int p = 0; p < NUM_LAT_POINTS; p ++) {
+        CHECK(lat_hists[p].count == 1);
+    }
+    CHECK(NEAR(lat_hists[LAT_PUSH].max_ns, 2));
+    CHECK(NEAR(lat_hists[LAT_PARSED].max_ns, 30));
+    CHECK(NEAR(lat_hists[LAT_DISPATCH].max_ns, 5));
+    CHECK(NEAR(lat_hists[LAT_WRITE].max_ns, 400));
+    CHECK(NEAR(lat_hists[LAT_TOTAL].max_ns, 437));
+
+    // only the first byte of a batch is stamped
+    latClear();
+    arrive(1);
+    wait(100);
+    arrive(1);
+    drain(10, 1);
+    dispatch(1, 1);
+    CHECK(lat_hists[LAT_TOTAL].count == 1);
+    CHECK(NEAR(lat_hists[LAT_TOTAL].max_ns, 114));
+}
+
+static void testLateArrival(void) {
+    // a byte that arrives while the batch before it is dispatched is
+    // stamped for the batch that drains it
+    latClear();
+    arrive(1);
+    drain(10, 1);
+    wait(50);
+    arrive(1);
+    dispatch(100, 10);
+    CHECK(lat_hists[LAT_TOTAL].count == 1);
+    CHECK(NEAR(lat_hists[LAT_TOTAL].max_ns, 172));
+
+    drain(5, 1);
+    dispatch(1, 1);
+    CHECK(lat_hists[LAT_TOTAL].count == 2);
+    CHECK(NEAR(lat_hists[LAT_PARSED].max_ns, 100 + 10 + 5));
+}
+
+static void testSplitMessage(void) {
+    // the first bytes of a message are drained before the rest arrive,
+    // the span runs from the first of them
+    latClear();
+    arrive(1);
+    drain(10, 0);
+    dispatch(0, 0);
+    CHECK(lat_hists[LAT_TOTAL].count == 0);
+
+    wait(300);
+    arrive(1);
+    drain(10, 1);
+    dispatch(1, 1);
+    CHECK(lat_hists[LAT_TOTAL].count == 1);
+    CHECK(NEAR(lat_hists[LAT_TOTAL].max_ns, 1 + 10 + 300 + 1 + 10 + 1 + 1));
+}
+
+static void testStream(void) {
+    u32 rng_state = 0x1234567;
+
+    latClear();
+    for (int i = 0; i < 10000; i ++) {
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 17;
+        rng_state ^= rng_state << 5;
+
+        arrive(1);
+        drain(rng_state % 50, 1);
+        // a debug print of a note every so often holds the dispatch up
+        dispatch(1, (rng_state >> 8) % 16 == 0 ? 2600 : 3);
+        wait(500);
+    }
+
+    printLatency();
+    CHECK(lat_hists[LAT_TOTAL].count == 10000);
+    u32 sum = 0;
+    for (int b = 0; b < LAT_BUCKETS; b ++) {
+        sum += lat_hists[LAT_WRITE].buckets[b];
+    }
+    CHECK(sum == 10000);
+    CHECK(lat_hists[LAT_WRITE].max_ns >= 2600000);
+    CHECK(lat_hists[LAT_WRITE].min_ns < 4000);
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+    printf("buckets\n");
+    testBuckets();
+    printf("batch spans\n");
+    testSpans();
+    printf("late arrival\n");
+    testLateArrival();
+    printf("split message\n");
+    testSplitMessage();
+    printf("batch stream\n");
+    testStream();
+
+    return checkResult();
+}
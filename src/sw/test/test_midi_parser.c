@@ -0,0 +1,409 @@
+/****************************************************************************/
+/**
+* test_midi_parser.c
+*
+* Host tests for the MIDI parser and synth SysEx messages: message framing,
+* running status, real-time interleaving, SysEx bounds, a random stream
+* fuzz and a parser throughput measurement.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../midi/midi_parser.h"
+#include "../midi/midi_sysex.h"
+#include "check.h"
+
+#define MAX_EVENTS  4096
+#define FUZZ_BYTES  2000000
+#define BENCH_BYTES 20000000
+
+/***************************************************************************
+* Captured parser output
+****************************************************************************/
+
+typedef struct {
+    u8  msg[3];
+    u8  len;
+    u16 sysex_len;  // non-zero for a SysEx event
+} Event;
+
+static Event events[MAX_EVENTS];
+static int num_events;
+static u8 last_sysex[MIDI_SYSEX_SIZE];
+
+static void onMsg(u8 *msg, u8 len) {
+    if (len == 0 || len > 3 || !(msg[0] & 0x80)) {
+        printf("  bad message callback, len %d\n", len);
+        failures++;
+    }
+    if (num_events < MAX_EVENTS) {
+        memcpy(events[num_events].msg, msg, len);
+        events[num_events].len = len;
+        events[num_events].sysex_len = 0;
+    }
+    num_events++;
+}
+
+static void onSysEx(u8 *data, u16 len) {
+    if (len > MIDI_SYSEX_SIZE) {
+        printf("  SysEx callback over buffer size, len %d\n", len);
+        failures++;
+    }
+    for (u16 i = 0; i < len; i ++) {
+        if (data[i] & 0x80) {
+            printf("  status byte inside SysEx data\n");
+            failures++;
+            break;
+        }
+    }
+    memcpy(last_sysex, data, len);
+    if (num_events < MAX_EVENTS) {
+        events[num_events].len = 0;
+        events[num_events].sysex_len = len;
+    }
+    num_events++;
+}
+
+static void countMsg(u8 *msg, u8 len) {
+    (void)msg;
+    (void)len;
+    num_events++;
+}
+
+static void countSysEx(u8 *data, u16 len) {
+    (void)data;
+    (void)len;
+    num_events++;
+}
+
+static void feed(MidiParser *p, const u8 *bytes, int len) {
+    num_events = 0;
+    for (int i = 0; i < len; i ++) {
+        midiParseByte(p, bytes[i]);
+    }
+}
+
+static int expectMsg(int i, u8 b0, u8 b1, u8 b2, u8 len) {
+    const u8 want[3] = { b0, b1, b2 };
+    return i < num_events && events[i].len == len && memcmp(events[i].msg, want, len) == 0;
+}
+
+/***************************************************************************
+* Small deterministic random source so fuzz runs are repeatable
+****************************************************************************/
+
+static u32 rng_state = 0x1234567;
+
+static u32 rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/***************************************************************************
+* Framing tests
+****************************************************************************/
+
+static void testChannelMessages(MidiParser *p) {
+    const u8 in[] = {
+        0x90, 60, 100,      // note on
+        62, 101,            // running status note on
+        0xC3, 5,            // program change, 2 bytes
+        7,                  // running status program change
+        0xE1, 0x00, 0x40,   // pitch bend
+        0xD2, 99            // channel pressure
+    };
+    feed(p, in, sizeof(in));
+    CHECK(num_events == 6);
+    CHECK(expectMsg(0, 0x90, 60, 100, 3));
+    CHECK(expectMsg(1, 0x90, 62, 101, 3));
+    CHECK(expectMsg(2, 0xC3, 5, 0, 2));
+    CHECK(expectMsg(3, 0xC3, 7, 0, 2));
+    CHECK(expectMsg(4, 0xE1, 0x00, 0x40, 3));
+    CHECK(expectMsg(5, 0xD2, 99, 0, 2));
+}
+
+static void testRealTimeInterleave(MidiParser *p) {
+    const u8 in[] = { 0x90, 0xF8, 60, 0xFE, 100, 0xFA, 64, 0xFC, 90 };
+    feed(p, in, sizeof(in));
+    CHECK(num_events == 6);
+    CHECK(expectMsg(0, 0xF8, 0, 0, 1));
+    CHECK(expectMsg(1, 0xFE, 0, 0, 1));
+    CHECK(expectMsg(2, 0x90, 60, 100, 3));
+    CHECK(expectMsg(3, 0xFA, 0, 0, 1));
+    CHECK(expectMsg(4, 0xFC, 0, 0, 1));
+    CHECK(expectMsg(5, 0x90, 64, 90, 3));
+}
+
+static void testSystemCommon(MidiParser *p) {
+    const u8 in[] = {
+        0x90, 60, 100,
+        0xF2, 0x10, 0x20,   // song position, 3 bytes
+        61, 100,            // running status was cancelled, dropped
+        0xF1, 0x33,         // quarter frame, 2 bytes
+        0xF3, 0x02,         // song select, 2 bytes
+        0xF6,               // tune request, 1 byte
+        0xF7,               // stray end of exclusive
+        0x80, 60, 0
+    };
+    u32 stray = p->stray_bytes;
+    feed(p, in, sizeof(in));
+    CHECK(num_events == 6);
+    CHECK(expectMsg(0, 0x90, 60, 100, 3));
+    CHECK(expectMsg(1, 0xF2, 0x10, 0x20, 3));
+    CHECK(expectMsg(2, 0xF1, 0x33, 0, 2));
+    CHECK(expectMsg(3, 0xF3, 0x02, 0, 2));
+    CHECK(expectMsg(4, 0xF6, 0, 0, 1));
+    CHECK(expectMsg(5, 0x80, 60, 0, 3));
+    CHECK(p->stray_bytes == stray + 3);
+}
+
+static void testSysEx(MidiParser *p) {
+    u8 in[MIDI_SYSEX_SIZE + 16];
+    int n = 0;
+
+    // complete message with a real-time byte inside, then running status lost
+    const u8 msg[] = { 0x90, 60, 100, 0xF0, 0x7D, 0x01, 0xF8, 0x02, 0xF7, 62, 100 };
+    u32 stray = p->stray_bytes;
+    feed(p, msg, sizeof(msg));
+    CHECK(num_events == 3);
+    CHECK(expectMsg(0, 0x90, 60, 100, 3));
+    CHECK(expectMsg(1, 0xF8, 0, 0, 1));
+    CHECK(num_events >= 3 && events[2].sysex_len == 3);
+    CHECK(last_sysex[0] == 0x7D && last_sysex[1] == 0x01 && last_sysex[2] == 0x02);
+    CHECK(p->stray_bytes == stray + 2);
+
+    // exactly the buffer size is kept
+    in[n++] = 0xF0;
+    for (int i = 0; i < MIDI_SYSEX_SIZE; i ++) {
+        in[n++] = i & 0x7F;
+    }
+    in[n++] = 0xF7;
+    feed(p, in, n);
+    CHECK(num_events == 1 && events[0].sysex_len == MIDI_SYSEX_SIZE);
+
+    // one byte over is dropped and counted
+    u32 overflows = p->sysex_overflows;
+    n = 0;
+    in[n++] = 0xF0;
+    for (int i = 0; i < MIDI_SYSEX_SIZE + 1; i ++) {
+        in[n++] = i & 0x7F;
+    }
+    in[n++] = 0xF7;
+    feed(p, in, n);
+    CHECK(num_events == 0);
+    CHECK(p->sysex_overflows == overflows + 1);
+
+    // a status byte aborts the SysEx and starts its own message
+    u32 aborts = p->sysex_aborts;
+    const u8 cut[] = { 0xF0, 0x7D, 0x01, 0x90, 60, 100 };
+    feed(p, cut, sizeof(cut));
+    CHECK(num_events == 1);
+    CHECK(expectMsg(0, 0x90, 60, 100, 3));
+    CHECK(p->sysex_aborts == aborts + 1);
+}
+
+static void testPatchDump(MidiParser *p) {
+    SynthPatch patch = {
+        .wave_amps = { 1, 2, 3, 4, 127 },
+        .pulse_width = 0xBEEF,
+        .out_amp = 0x3F, .out_shift = 8,
+        .attack = 10, .decay = 20, .sustain = 100, .release = 30,
+        .pan_position = 64, .pan_spread = 32,
+        .slew_wfrm = 6, .slew_out = 7, .slew_pw = 8
+    };
+    SynthPatch decoded;
+    u8 in[SYSEX_PATCH_MSG_LEN + 2];
+
+    in[0] = 0xF0;
+    u16 len = sysexEncodePatch(&patch, &in[1]);
+    in[len + 1] = 0xF7;
+    CHECK(len == SYSEX_PATCH_MSG_LEN);
+
+    feed(p, in, len + 2);
+    CHECK(num_events == 1 && events[0].sysex_len == len);
+    CHECK(sysexDecodePatch(last_sysex, len, &decoded) == XST_SUCCESS);
+    CHECK(memcmp(&patch, &decoded, sizeof(patch)) == 0);
+
+    // any corrupted payload byte fails the checksum
+    for (u16 i = SYSEX_HEADER_LEN; i < len; i ++) {
+        last_sysex[i] ^= 0x01;
+        CHECK(sysexDecodePatch(last_sysex, len, &decoded) == XST_FAILURE);
+        last_sysex[i] ^= 0x01;
+    }
+
+    // wrong length, device or command
+    CHECK(sysexDecodePatch(last_sysex, len - 1, &decoded) == XST_FAILURE);
+    last_sysex[1] ^= 0x01;
+    CHECK(sysexDecodePatch(last_sysex, len, &decoded) == XST_FAILURE);
+    last_sysex[1] ^= 0x01;
+    last_sysex[2] = 0x7F;
+    CHECK(sysexDecodePatch(last_sysex, len, &decoded) == XST_FAILURE);
+
+    // latency request
+    u8 flags = 0;
+    u8 lat[SYSEX_LATENCY_MSG_LEN] = { SYSEX_MANUFACTURER_ID, SYSEX_DEVICE_ID, SYSEX_CMD_LATENCY,
+                                      SYSEX_LATENCY_CLEAR, 0 };
+    lat[SYSEX_HEADER_LEN + SYSEX_LATENCY_LEN] = sysexChecksum(&lat[SYSEX_HEADER_LEN], SYSEX_LATENCY_LEN);
+    CHECK(sysexDecodeLatency(lat, sizeof(lat), &flags) == XST_SUCCESS);
+    CHECK(flags == SYSEX_LATENCY_CLEAR);
+    CHECK(sysexDecodeLatency(lat, sizeof(lat) - 1, &flags) == XST_FAILURE);
+    lat[SYSEX_HEADER_LEN] ^= 0x01;
+    CHECK(sysexDecodeLatency(lat, sizeof(lat), &flags) == XST_FAILURE);
+}
+
+/***************************************************************************
+* Fuzz tests
+****************************************************************************/
+
+// random bytes must never produce a malformed callback
+static void fuzzRandomBytes(MidiParser *p) {
+    num_events = 0;
+    for (int i = 0; i < FUZZ_BYTES; i ++) {
+        u32 r = rng();
+        u8 byte = (r & 0x300) ? (r & 0x7F) : (r & 0xFF);
+        midiParseByte(p, byte);
+        CHECK(p->count <= 3);
+        CHECK(p->sysex_len <= MIDI_SYSEX_SIZE);
+        if (failures > 10) {
+            return;
+        }
+    }
+}
+
+// random valid streams with interleaved real-time bytes decode exactly
+static void fuzzValidStream(MidiParser *p) {
+    static const u8 lens[7] = { 3, 3, 3, 3, 2, 2, 3 };
+    Event want[MAX_EVENTS];
+    u8 in[MAX_EVENTS * 4];
+
+    for (int round = 0; round < 200; round ++) {
+        int n = 0, nw = 0;
+        u8 running = 0;
+
+        while (nw < MAX_EVENTS / 2 && n < (int)sizeof(in) - 8) {
+            u8 status = 0x80 | ((rng() % 7) << 4) | (rng() & 0x0F);
+            u8 len = lens[(status >> 4) - 8];
+
+            want[nw].msg[0] = status;
+            want[nw].len = len;
+            want[nw].sysex_len = 0;
+            if (status != running || (rng() & 3) == 0) {
+                in[n++] = status;
+            }
+            running = status;
+            for (u8 i = 1; i < len; i ++) {
+                if ((rng() & 7) == 0) {
+                    in[n++] = 0xF8;
+                }
+                want[nw].msg[i] = rng() & 0x7F;
+                in[n++] = want[nw].msg[i];
+            }
+            nw++;
+        }
+
+        feed(p, in, n);
+
+        int j = 0;
+        for (int i = 0; i < num_events && i < MAX_EVENTS; i ++) {
+            if (events[i].len == 1 && events[i].msg[0] == 0xF8) {
+                continue;
+            }
+            if (j >= nw || events[i].len != want[j].len ||
+                memcmp(events[i].msg, want[j].msg, want[j].len) != 0) {
+                printf("  stream mismatch at message %d, round %d\n", j, round);
+                failures++;
+                return;
+            }
+            j++;
+        }
+        CHECK(j == nw);
+    }
+}
+
+/***************************************************************************
+* Throughput
+****************************************************************************/
+
+static void benchParser(void) {
+    static MidiParser p;
+    static u8 stream[65536];
+    int n = 0;
+
+    // note on/off pairs with running status, real-time clocks and SysEx
+    while (n < (int)sizeof(stream) - 32) {
+        if ((rng() & 63) == 0) {
+            stream[n++] = 0xF0;
+            for (int i = 0; i < 20; i ++) {
+                stream[n++] = rng() & 0x7F;
+            }
+            stream[n++] = 0xF7;
+        }
+        stream[n++] = 0x90;
+        stream[n++] = rng() & 0x7F;
+        stream[n++] = rng() & 0x7F;
+        stream[n++] = rng() & 0x7F;
+        stream[n++] = 0;
+        stream[n++] = 0xF8;
+    }
+
+    midiParserInit(&p, countMsg, countSysEx);
+    num_events = 0;
+
+    clock_t start = clock();
+    u32 total = 0;
+    while (total < BENCH_BYTES) {
+        for (int i = 0; i < n; i ++) {
+            midiParseByte(&p, stream[i]);
+        }
+        total += n;
+    }
+    double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    if (secs > 0) {
+        double rate = total / secs;
+        printf("  %u bytes, %d messages in %.3f s: %.1f MB/s, %.0fx MIDI wire rate\n",
+               total, num_events, secs, rate / 1e6, rate / 3125.0);
+    }
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+    static MidiParser p;
+
+    midiParserInit(&p, onMsg, onSysEx);
+
+    printf("channel messages\n");
+    testChannelMessages(&p);
+    printf("real-time interleave\n");
+    testRealTimeInterleave(&p);
+    printf("system common\n");
+    testSystemCommon(&p);
+    printf("system exclusive\n");
+    testSysEx(&p);
+    printf("patch dump\n");
+    testPatchDump(&p);
+    printf("fuzz random bytes\n");
+    fuzzRandomBytes(&p);
+    printf("fuzz valid streams\n");
+    midiParserInit(&p, onMsg, onSysEx);
+    fuzzValidStream(&p);
+    printf("throughput\n");
+    benchParser();
+
+    return checkResult();
+}
@@ -0,0 +1,161 @@
+/****************************************************************************/
+/**
+* test_presets.c
+*
+* Host tests for the preset bank: register images, recall into a timbre,
+* the SysEx preset store message and a program change apply benchmark.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../synth_ctrl/synth_preset.h"
+#include "../midi/midi_sysex.h"
+#include "check.h"
+
+#define BENCH_APPLIES 2000000
+
+// one audio frame at 96 kHz
+#define FRAME_NS 10417
+
+static const SynthPatch test_patch = {
+    .wave_amps = { 1, 2, 3, 4, 127 },
+    .pulse_width = 0xBEEF,
+    .attack = 10, .decay = 20, .sustain = 100, .release = 30
+};
+
+static u32 *timbreRegs(u8 timbre) {
+    return &host_synth_regs[(SYNTH_TIMBRE_OFFSET / 4) + TIMBRE_REGS*timbre];
+}
+
+/***************************************************************************
+* Preset tests
+****************************************************************************/
+
+// a recalled preset matches the per-parameter writes of the same patch
+static void testRecallMatchesPatch(void) {
+    memset(host_synth_regs, 0, sizeof(host_synth_regs));
+
+    applyTimbrePatch(2, &test_patch);
+    CHECK(storePreset(5, &test_patch) == XST_SUCCESS);
+
+    u32 before = host_synth_writes;
+    CHECK(recallPreset(4, 5) == XST_SUCCESS);
+    CHECK(host_synth_writes - before == PRESET_REGS);
+
+    const u32 *want = timbreRegs(2);
+    const u32 *got = timbreRegs(4);
+    for (u8 i = 0; i < PRESET_REGS; i ++) {
+        if (i != TIMBRE_LEVEL && i != TIMBRE_LEVEL + 1) {
+            CHECK(got[i] == want[i]);
+        }
+    }
+    CHECK(got[TIMBRE_LEVEL] == TIMBRE_LEVEL_MAX);
+
+    // neighbouring timbres are untouched
+    CHECK(timbreRegs(3)[TIMBRE_REGS-1] == 0);
+    CHECK(timbreRegs(5)[0] == 0);
+}
+
+static void testBounds(void) {
+    u32 before = host_synth_writes;
+    CHECK(recallPreset(NUM_TIMBRES, 0) == XST_FAILURE);
+    CHECK(recallPreset(0, NUM_PRESETS) == XST_FAILURE);
+    CHECK(storePreset(NUM_PRESETS, &test_patch) == XST_FAILURE);
+    CHECK(getPreset(NUM_PRESETS) == NULL);
+    CHECK(host_synth_writes == before);
+}
+
+static void testDefaults(void) {
+    CHECK(initPresets() == XST_SUCCESS);
+    for (u8 i = 0; i < NUM_PRESETS; i ++) {
+        const SynthPreset *p = getPreset(i);
+        CHECK(p->regs[TIMBRE_PULSE + SINE_WAVE] != 0);
+        CHECK(p->regs[TIMBRE_LEVEL] == TIMBRE_LEVEL_MAX);
+    }
+}
+
+static void testSysExStore(void) {
+    u8 msg[SYSEX_PRESET_MSG_LEN];
+    SynthPatch decoded;
+    u8 program = 0;
+
+    u16 len = sysexEncodePreset(42, &test_patch, msg);
+    CHECK(len == SYSEX_PRESET_MSG_LEN);
+    CHECK(sysexDecodePreset(msg, len, &program, &decoded) == XST_SUCCESS);
+    CHECK(program == 42);
+    CHECK(memcmp(&decoded.wave_amps, &test_patch.wave_amps, NUM_WAVES) == 0);
+    CHECK(decoded.pulse_width == test_patch.pulse_width);
+    CHECK(decoded.release == test_patch.release);
+
+    // the checksum covers the program number
+    msg[SYSEX_HEADER_LEN] ^= 0x01;
+    CHECK(sysexDecodePreset(msg, len, &program, &decoded) == XST_FAILURE);
+    msg[SYSEX_HEADER_LEN] ^= 0x01;
+
+    // a patch dump is not a preset store
+    CHECK(sysexDecodePreset(msg, SYSEX_PATCH_MSG_LEN, &program, &decoded) == XST_FAILURE);
+}
+
+/***************************************************************************
+* Program change apply time, host CPU with register writes to memory
+****************************************************************************/
+
+static double benchNs(int recall) {
+    clock_t start = clock();
+    for (u32 i = 0; i < BENCH_APPLIES; i ++) {
+        if (recall) {
+            recallPreset(i & (NUM_TIMBRES-1), i & (NUM_PRESETS-1));
+        } else {
+            applyTimbrePatch(i & (NUM_TIMBRES-1), &test_patch);
+        }
+    }
+    return 1e9 * (double)(clock() - start) / CLOCKS_PER_SEC / BENCH_APPLIES;
+}
+
+static void benchApply(void) {
+    u32 before = host_synth_writes;
+    recallPreset(0, 0);
+    u32 recall_writes = host_synth_writes - before;
+
+    before = host_synth_writes;
+    applyTimbrePatch(0, &test_patch);
+    u32 patch_writes = host_synth_writes - before;
+
+    double recall_ns = benchNs(1);
+    double patch_ns = benchNs(0);
+
+    printf("  preset recall: %u writes, %.1f ns\n", recall_writes, recall_ns);
+    printf("  patch apply:   %u writes, %.1f ns\n", patch_writes, patch_ns);
+    printf("  frame budget:  %d ns\n", FRAME_NS);
+    CHECK(recall_writes <= PRESET_REGS);
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+
+    printf("recall matches patch\n");
+    testRecallMatchesPatch();
+    printf("bounds\n");
+    testBounds();
+    printf("defaults\n");
+    testDefaults();
+    printf("sysex preset store\n");
+    testSysExStore();
+    printf("apply time\n");
+    benchApply();
+
+    return checkResult();
+}
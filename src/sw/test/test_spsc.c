@@ -0,0 +1,203 @@
+/****************************************************************************/
+/**
+* test_spsc.c
+*
+* Host tests for the queues between the cores: fill and drain, index wrap
+* at 2^32, and a stress run with a producer and a consumer thread passing
+* messages the size of a core message, checked for order and contents.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../amp/spsc.h"
+#include "check.h"
+
+#define SLOTS       256
+#define STRESS_MSGS 4000000
+
+// the size of a core message
+typedef struct {
+    u32 seq;
+    u32 words[15];
+} TestMsg;
+
+static SpscQueue queue;
+static TestMsg slots[SLOTS];
+
+static void fill(TestMsg *msg, u32 seq) {
+    msg->seq = seq;
+    for (int i = 0; i < 15; i ++) {
+        msg->words[i] = seq * 2654435761u + i;
+    }
+}
+
+static int intact(const TestMsg *msg) {
+    for (int i = 0; i < 15; i ++) {
+        if (msg->words[i] != msg->seq * 2654435761u + i) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/***************************************************************************
+* One thread
+****************************************************************************/
+
+static void testInit(void) {
+    CHECK(spscInit(&queue, slots, 0, sizeof(TestMsg)) == XST_FAILURE);
+    CHECK(spscInit(&queue, slots, 100, sizeof(TestMsg)) == XST_FAILURE);
+    CHECK(spscInit(&queue, slots, SLOTS, sizeof(TestMsg)) == XST_SUCCESS);
+
+    // producer and consumer indices on their own lines
+    CHECK((u8 *)&queue.tail - (u8 *)&queue.head >= SPSC_LINE);
+    CHECK((u8 *)&queue.mask - (u8 *)&queue.tail >= SPSC_LINE);
+}
+
+static void testFillDrain(void) {
+    TestMsg msg;
+
+    spscInit(&queue, slots, SLOTS, sizeof(TestMsg));
+    CHECK(spscPop(&queue, &msg) == XST_FAILURE);
+
+    for (u32 i = 0; i < SLOTS; i ++) {
+        fill(&msg, i);
+        CHECK(spscPush(&queue, &msg) == XST_SUCCESS);
+    }
+    CHECK(spscCount(&queue) == SLOTS);
+    CHECK(spscPush(&queue, &msg) == XST_FAILURE);
+    CHECK(queue.dropped == 1);
+
+    for (u32 i = 0; i < SLOTS; i ++) {
+        CHECK(spscPop(&queue, &msg) == XST_SUCCESS);
+        CHECK(msg.seq == i && intact(&msg));
+    }
+    CHECK(spscPop(&queue, &msg) == XST_FAILURE);
+    CHECK(spscCount(&queue) == 0);
+}
+
+static void testWrap(void) {
+    TestMsg msg;
+
+    // indices just short of wrapping
+    spscInit(&queue, slots, SLOTS, sizeof(TestMsg));
+    queue.head = queue.tail = queue.tail_cache = queue.head_cache = 0xFFFFFFF0;
+
+    // two in, one out, until it is full
+    u32 expect = 0;
+    for (u32 i = 0; i < 2 * SLOTS; i ++) {
+        if (i % 2) {
+            CHECK(spscPop(&queue, &msg) == XST_SUCCESS);
+            CHECK(msg.seq == expect && intact(&msg));
+            expect++;
+        }
+        fill(&msg, i);
+        CHECK(spscPush(&queue, &msg) == XST_SUCCESS);
+    }
+    CHECK(queue.head < 0x1000);
+    CHECK(spscCount(&queue) == SLOTS);
+    CHECK(spscPush(&queue, &msg) == XST_FAILURE);
+
+    while (spscPop(&queue, &msg) == XST_SUCCESS) {
+        CHECK(msg.seq == expect && intact(&msg));
+        expect++;
+    }
+    CHECK(expect == 2 * SLOTS);
+}
+
+/***************************************************************************
+* Two threads
+****************************************************************************/
+
+static u32 producer_full;
+static u32 consumer_empty;
+static u32 bad_order;
+static u32 bad_contents;
+
+static void *producer(void *arg) {
+    TestMsg msg;
+
+    (void)arg;
+    for (u32 i = 0; i < STRESS_MSGS; i ++) {
+        fill(&msg, i);
+        while (spscPush(&queue, &msg) != XST_SUCCESS) {
+            producer_full++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    TestMsg msg;
+
+    (void)arg;
+    for (u32 i = 0; i < STRESS_MSGS; i ++) {
+        while (spscPop(&queue, &msg) != XST_SUCCESS) {
+            consumer_empty++;
+            sched_yield();
+        }
+        if (msg.seq != i) {
+            bad_order++;
+        }
+        if (!intact(&msg)) {
+            bad_contents++;
+        }
+    }
+    return NULL;
+}
+
+static void testThreads(void) {
+    pthread_t prod, cons;
+    struct timespec t0, t1;
+
+    spscInit(&queue, slots, SLOTS, sizeof(TestMsg));
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    CHECK(pthread_create(&cons, NULL, consumer, NULL) == 0);
+    CHECK(pthread_create(&prod, NULL, producer, NULL) == 0);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double s = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    printf("  %d messages in %.2f s, %.1f M/s, %u full and %u empty polls\n",
+           STRESS_MSGS, s, STRESS_MSGS / s / 1e6, producer_full, consumer_empty);
+
+    CHECK(bad_order == 0);
+    CHECK(bad_contents == 0);
+    CHECK(spscCount(&queue) == 0);
+    // the producer spins instead of dropping
+    CHECK(queue.dropped == producer_full);
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+    printf("init\n");
+    testInit();
+    printf("fill and drain\n");
+    testFillDrain();
+    printf("index wrap\n");
+    testWrap();
+    printf("two threads\n");
+    testThreads();
+
+    return checkResult();
+}
@@ -0,0 +1,197 @@
+/****************************************************************************/
+/**
+* test_storage.c
+*
+* Host tests for the SD card library with the file-backed FatFs stand-in:
+* missing and damaged files, background saves, edits during a save and a
+* library load time measurement.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+*
+****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../storage/storage.h"
+#include "check.h"
+
+#define BENCH_LOADS 2000
+
+static u32 tuning[MAX_NOTE+1];
+
+static const SynthPatch patch_a = {
+    .wave_amps = { 1, 2, 3, 4, 5 },
+    .pulse_width = 0x1234,
+    .attack = 10, .decay = 20, .sustain = 100, .release = 30
+};
+
+static const SynthPatch patch_b = {
+    .wave_amps = { 0, 0, 0, 127, 0 },
+    .pulse_width = 0x4321,
+    .attack = 1, .decay = 2, .sustain = 3, .release = 4
+};
+
+// run background saves until the library is on the card
+static int flush(void) {
+    int calls = 0;
+    while (storageBusy() && calls < 100000) {
+        serviceStorage();
+        calls++;
+    }
+    return calls;
+}
+
+// register image of a patch, built in the last preset slot
+static SynthPreset imageOf(const SynthPatch *patch) {
+    storePreset(NUM_PRESETS-1, patch);
+    return *getPreset(NUM_PRESETS-1);
+}
+
+static int samePreset(u8 program, const SynthPatch *patch) {
+    SynthPreset want = imageOf(patch);
+    return memcmp(getPreset(program), &want, sizeof(want)) == 0;
+}
+
+/***************************************************************************
+* Library tests
+****************************************************************************/
+
+static void testMissingLibrary(void) {
+    f_unlink(LIBRARY_PATH);
+    f_unlink(LIBRARY_TMP_PATH);
+
+    initPresets();
+    for (u8 i = 0; i <= MAX_NOTE; i ++) {
+        tuning[i] = 1000 + i;
+    }
+    CHECK(initStorage(tuning) == XST_SUCCESS);
+    CHECK(loadLibrary() == XST_FAILURE);
+    CHECK(tuning[5] == 1005);
+    CHECK(!storageBusy());
+}
+
+static void testSaveAndLoad(void) {
+    storePreset(7, &patch_a);
+    CHECK(storageBusy());
+
+    int calls = flush();
+    CHECK(!storageBusy());
+    CHECK(calls > (int)(sizeof(SynthLibrary) / LIBRARY_SAVE_CHUNK));
+
+    // clobber the settings, then load them back
+    storePreset(7, &patch_b);
+    initPresets();
+    memset(tuning, 0, sizeof(tuning));
+    CHECK(loadLibrary() == XST_SUCCESS);
+    CHECK(samePreset(7, &patch_a));
+    CHECK(tuning[5] == 1005);
+    flush();
+}
+
+static void testEditDuringSave(void) {
+    storePreset(9, &patch_a);
+    serviceStorage();  // snapshot and open
+    serviceStorage();  // first chunk
+    storePreset(9, &patch_b);
+    flush();
+
+    initPresets();
+    CHECK(loadLibrary() == XST_SUCCESS);
+    CHECK(samePreset(9, &patch_b));
+    flush();
+}
+
+static void testTuningSave(void) {
+    tuning[60] = 0xABCDEF;
+    CHECK(saveLibrary() == XST_SUCCESS);
+    CHECK(storageBusy());
+    flush();
+
+    tuning[60] = 0;
+    CHECK(loadLibrary() == XST_SUCCESS);
+    CHECK(tuning[60] == 0xABCDEF);
+    flush();
+}
+
+static void writeLibrary(const SynthLibrary *lib, UINT size) {
+    FIL f;
+    UINT len;
+    CHECK(f_open(&f, LIBRARY_PATH, FA_CREATE_ALWAYS | FA_WRITE) == FR_OK);
+    f_write(&f, lib, size, &len);
+    f_close(&f);
+}
+
+static void testDamagedLibrary(void) {
+    FIL f;
+    UINT len = 0;
+    static SynthLibrary lib;
+
+    CHECK(f_open(&f, LIBRARY_PATH, FA_READ) == FR_OK);
+    f_read(&f, &lib, sizeof(lib), &len);
+    f_close(&f);
+    CHECK(len == sizeof(lib));
+
+    storePreset(3, &patch_b);
+    SynthPreset before = *getPreset(3);
+
+    // a flipped byte in the preset bank leaves the presets alone
+    ((u8 *)&lib.presets)[100] ^= 0x10;
+    writeLibrary(&lib, sizeof(lib));
+    CHECK(loadLibrary() == XST_FAILURE);
+    CHECK(memcmp(getPreset(3), &before, sizeof(before)) == 0);
+
+    // truncated file
+    ((u8 *)&lib.presets)[100] ^= 0x10;
+    writeLibrary(&lib, sizeof(lib) / 2);
+    CHECK(loadLibrary() == XST_FAILURE);
+
+    // the next save replaces the damaged file
+    flush();
+    CHECK(loadLibrary() == XST_SUCCESS);
+    CHECK(memcmp(getPreset(3), &before, sizeof(before)) == 0);
+}
+
+/***************************************************************************
+* Load time
+****************************************************************************/
+
+static void benchLoad(void) {
+    clock_t start = clock();
+    for (int i = 0; i < BENCH_LOADS; i ++) {
+        if (loadLibrary() != XST_SUCCESS) {
+            failures++;
+            break;
+        }
+    }
+    double us = 1e6 * (double)(clock() - start) / CLOCKS_PER_SEC / BENCH_LOADS;
+    printf("  %u byte library, %.1f us per load\n", (unsigned)sizeof(SynthLibrary), us);
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+
+    printf("missing library\n");
+    testMissingLibrary();
+    printf("save and load\n");
+    testSaveAndLoad();
+    printf("edit during save\n");
+    testEditDuringSave();
+    printf("tuning save\n");
+    testTuningSave();
+    printf("damaged library\n");
+    testDamagedLibrary();
+    printf("load time\n");
+    benchLoad();
+
+    return checkResult();
+}
@@ -0,0 +1,293 @@
+/****************************************************************************/
+/**
+* test_tuning.c
+*
+* Host tests for the MIDI Tuning Standard decoder, the generated tuning
+* table and the fixed-point pitch bend, with a benchmark against the
+* floating point paths they replace.
+*
+*
+* REVISION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ------ -------- -----------------------------------------------------
+* 0.00  agt    10/19/26 Initial file
+* 0.01  agt    10/19/26 Check fixed-point tuning against floating point
+*
+****************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../midi/midi_tuning.h"
+#include "../midi/pitch.h"
+#include "check.h"
+
+#define BENCH_UPDATES 20000
+
+static u32 words[128];
+
+static void resetWords(void) {
+    memcpy(words, FreqWordDefaults, sizeof(words));
+}
+
+static int closeTo(u32 a, u32 b) {
+    return (a > b ? a - b : b - a) <= 1;
+}
+
+static u32 wordDiff(u32 a, u32 b) {
+    return a > b ? a - b : b - a;
+}
+
+/***************************************************************************
+* Floating point references, the firmware paths before fixed point
+****************************************************************************/
+
+static double refFrameHz(void) {
+    return (double)TUNING_CLK_HZ / TUNING_NUM_NOTES;
+}
+
+static u32 refTuningWord(u8 semitone, u16 fraction) {
+    double note = semitone + fraction / 16384.0;
+    double freq = TUNING_A4_HZ * pow(2.0, (note - 69.0) / 12.0);
+    return (u32)(freq * 4294967296.0 / refFrameHz());
+}
+
+// the previous linear approximation
+static double refBendLinear(int bend) {
+    return 1.0 + ((bend - 8192) / 8192.0 * PITCH_BEND_RANGE) / 12.0;
+}
+
+static double refBendExp(int bend) {
+    return pow(2.0, (((bend - 8192) / 8192.0 * PITCH_BEND_RANGE) / 12.0));
+}
+
+static void refScaleFreqWords(const u32 *base, u32 *out, double scale) {
+    for (u8 i = 0; i < 128; i ++) {
+        out[i] = (u32)((double)(base[i]) * scale);
+    }
+}
+
+// builds a bulk dump tuning every note up by the given semitone fraction
+static u16 buildBulkDump(u8 *msg, u16 fraction) {
+    u16 n = 0;
+    msg[n++] = MTS_NON_REALTIME;
+    msg[n++] = MTS_DEVICE_ALL;
+    msg[n++] = MTS_SUB_ID;
+    msg[n++] = MTS_BULK_DUMP;
+    msg[n++] = 3;
+    for (u8 i = 0; i < MTS_NAME_LEN; i ++) {
+        msg[n++] = ' ';
+    }
+    for (u8 i = 0; i < 128; i ++) {
+        msg[n++] = i;
+        msg[n++] = (fraction >> 7) & 0x7F;
+        msg[n++] = fraction & 0x7F;
+    }
+    u8 sum = 0;
+    for (u16 i = 0; i < n; i ++) {
+        sum ^= msg[i];
+    }
+    msg[n++] = sum & 0x7F;
+    return n;
+}
+
+/***************************************************************************
+* Tuning tests
+****************************************************************************/
+
+// equal temperament words match the generated table
+static void testDefaultTable(void) {
+    for (u8 i = 0; i < 128; i ++) {
+        CHECK(tuningWord(i, 0) == FreqWordDefaults[i]);
+        CHECK(closeTo(refTuningWord(i, 0), FreqWordDefaults[i]));
+    }
+    // one octave up doubles the word
+    CHECK(closeTo(tuningWord(81, 0), 2*tuningWord(69, 0)));
+}
+
+// a bulk dump retunes the whole table
+static void testBulkDump(void) {
+    u8 msg[MTS_BULK_DUMP_LEN];
+    resetWords();
+
+    u16 len = buildBulkDump(msg, 0x2000);
+    CHECK(len == MTS_BULK_DUMP_LEN);
+    CHECK(mtsIsTuning(msg, len));
+    CHECK(mtsDecode(msg, len, words) == XST_SUCCESS);
+    for (u8 i = 0; i < 128; i ++) {
+        CHECK(words[i] == tuningWord(i, 0x2000));
+    }
+    // half a semitone sits between the two neighbours
+    CHECK(words[60] > FreqWordDefaults[60] && words[60] < FreqWordDefaults[61]);
+}
+
+// a dump with a bad checksum or length changes nothing
+static void testBulkDumpRejected(void) {
+    u8 msg[MTS_BULK_DUMP_LEN];
+    resetWords();
+
+    u16 len = buildBulkDump(msg, 0x1000);
+    msg[len - 1] ^= 0x01;
+    CHECK(mtsDecode(msg, len, words) == XST_FAILURE);
+    CHECK(memcmp(words, FreqWordDefaults, sizeof(words)) == 0);
+
+    len = buildBulkDump(msg, 0x1000);
+    CHECK(mtsDecode(msg, len - 1, words) == XST_FAILURE);
+    CHECK(memcmp(words, FreqWordDefaults, sizeof(words)) == 0);
+
+    // another device
+    len = buildBulkDump(msg, 0x1000);
+    msg[1] = 0x05;
+    CHECK(!mtsIsTuning(msg, len));
+    CHECK(mtsDecode(msg, len, words) == XST_FAILURE);
+}
+
+// 7F 7F 7F leaves a note alone
+static void testNoChange(void) {
+    u8 msg[MTS_BULK_DUMP_LEN];
+    resetWords();
+
+    u16 len = buildBulkDump(msg, 0);
+    u8 *tuning = &msg[5 + MTS_NAME_LEN];
+    // tune A4 to 7F 7F 7F and play middle C a semitone sharp
+    memset(&tuning[MTS_NOTE_LEN*69], MTS_NO_CHANGE, MTS_NOTE_LEN);
+    tuning[MTS_NOTE_LEN*60] = 61;
+    u8 sum = 0;
+    for (u16 i = 0; i < len - 1; i ++) {
+        sum ^= msg[i];
+    }
+    msg[len - 1] = sum & 0x7F;
+
+    words[69] = 0x12345678;
+    CHECK(mtsDecode(msg, len, words) == XST_SUCCESS);
+    CHECK(words[69] == 0x12345678);
+    CHECK(closeTo(words[60], FreqWordDefaults[61]));
+    CHECK(closeTo(words[61], FreqWordDefaults[61]));
+}
+
+// a single note change only touches the notes it names
+static void testNoteChange(void) {
+    const u8 msg[] = { MTS_REALTIME, MTS_DEVICE_ID, MTS_SUB_ID, MTS_NOTE_CHANGE, 0, 2,
+                       60, 62, 0, 0,
+                       64, 0x7F, 0x7F, 0x7F };
+    resetWords();
+
+    CHECK(mtsDecode(msg, sizeof(msg), words) == XST_SUCCESS);
+    CHECK(closeTo(words[60], FreqWordDefaults[62]));
+    CHECK(words[64] == FreqWordDefaults[64]);
+    words[60] = FreqWordDefaults[60];
+    CHECK(memcmp(words, FreqWordDefaults, sizeof(words)) == 0);
+
+    // count does not match the length
+    CHECK(mtsDecode(msg, sizeof(msg) - 4, words) == XST_FAILURE);
+}
+
+// fixed-point tuning fractions follow the floating point equation
+static void testFixedTuning(void) {
+    u32 worst = 0;
+    for (u16 n = 0; n < 128; n ++) {
+        for (u32 f = 0; f < 16384; f += 7) {
+            u32 diff = wordDiff(tuningWord(n, f), refTuningWord(n, f));
+            worst = diff > worst ? diff : worst;
+        }
+    }
+    printf("  worst tuning error: %u LSB\n", worst);
+    CHECK(worst <= 2);
+}
+
+// fixed-point pitch bend follows the exponential bend equation
+static void testFixedBend(void) {
+    u32 fixed[128], ref[128];
+
+    // no bend leaves the table untouched
+    CHECK(pitchBendRatio(PITCH_BEND_CENTER) == (1u << PITCH_RATIO_Q));
+    scaleFreqWords(FreqWordDefaults, fixed, pitchBendRatio(PITCH_BEND_CENTER));
+    CHECK(memcmp(fixed, FreqWordDefaults, sizeof(fixed)) == 0);
+
+    u32 worst = 0;
+    for (u32 bend = 0; bend < 16384; bend ++) {
+        scaleFreqWords(FreqWordDefaults, fixed, pitchBendRatio(bend));
+        refScaleFreqWords(FreqWordDefaults, ref, refBendExp(bend));
+        for (u8 i = 0; i < 128; i ++) {
+            u32 diff = wordDiff(fixed[i], ref[i]);
+            worst = diff > worst ? diff : worst;
+        }
+    }
+    printf("  worst bend error: %u LSB\n", worst);
+    CHECK(worst <= 2);
+
+    // full bend up is the whole bend range in semitones
+    scaleFreqWords(FreqWordDefaults, fixed, pitchBendRatio(0x3FFF));
+    CHECK(fixed[60] > FreqWordDefaults[61] && fixed[60] < FreqWordDefaults[60 + PITCH_BEND_RANGE]);
+    scaleFreqWords(FreqWordDefaults, fixed, pitchBendRatio(0));
+    CHECK(wordDiff(fixed[60], FreqWordDefaults[60 - PITCH_BEND_RANGE]) <= 2);
+}
+
+/***************************************************************************
+* Benchmark
+****************************************************************************/
+
+static volatile u32 sink;
+
+// ns per 128 word table update
+static double benchNs(int path) {
+    u32 out[128];
+    clock_t start = clock();
+    for (u32 i = 0; i < BENCH_UPDATES; i ++) {
+        int bend = i & 0x3FFF;
+        switch (path) {
+            case 0: refScaleFreqWords(FreqWordDefaults, out, refBendLinear(bend)); break;
+            case 1: refScaleFreqWords(FreqWordDefaults, out, refBendExp(bend)); break;
+            case 2: scaleFreqWords(FreqWordDefaults, out, pitchBendRatio(bend)); break;
+            case 3:
+                for (u8 n = 0; n < 128; n ++) {
+                    out[n] = refTuningWord(n, bend);
+                }
+                break;
+            default:
+                for (u8 n = 0; n < 128; n ++) {
+                    out[n] = tuningWord(n, bend);
+                }
+                break;
+        }
+        sink += out[i & 0x7F];
+    }
+    return 1e9 * (double)(clock() - start) / CLOCKS_PER_SEC / BENCH_UPDATES;
+}
+
+static void benchUpdates(void) {
+    printf("  bend, linear double: %8.1f ns\n", benchNs(0));
+    printf("  bend, pow double:    %8.1f ns\n", benchNs(1));
+    printf("  bend, Q30 tables:    %8.1f ns\n", benchNs(2));
+    printf("  retune, pow double:  %8.1f ns\n", benchNs(3));
+    printf("  retune, Q30 tables:  %8.1f ns\n", benchNs(4));
+}
+
+/***************************************************************************
+* Main
+****************************************************************************/
+
+int main(void) {
+
+    printf("default table\n");
+    testDefaultTable();
+    printf("bulk dump\n");
+    testBulkDump();
+    printf("bulk dump rejected\n");
+    testBulkDumpRejected();
+    printf("no change\n");
+    testNoChange();
+    printf("single note change\n");
+    testNoteChange();
+    printf("fixed-point tuning\n");
+    testFixedTuning();
+    printf("fixed-point bend\n");
+    testFixedBend();
+    printf("table update time\n");
+    benchUpdates();
+
+    return checkResult();
+}
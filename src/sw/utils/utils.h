@@ -2,6 +2,7 @@
 #define UTILS_H_
 
 #include <stdio.h>
+#include "xil_printf.h"
 
 /***************************************************************************
 * Constant definitions
@@ -13,7 +14,11 @@
 * Macro functions
 ****************************************************************************/
 
-#ifdef DEBUG
+#if defined(DEBUG) && defined(AMP_VOICE)
+  // the voice core queues its text for the service core to print
+  void ampLog(const char *fmt, ...);
+  #define debug_print(fmt, ...) ampLog(fmt, ##__VA_ARGS__)
+#elif defined(DEBUG)
   #define debug_print(fmt, ...) xil_printf(fmt, ##__VA_ARGS__)
 #else
   #define debug_print(fmt, ...)  // Expands to nothing
@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""
+gen_tuning.py
+
+Generates the default 12-tone equal temperament phase increment tables for
+the synthesizer engine, as the VHDL music note package and the firmware
+pitch header, so both always match the engine clock.
+
+Each note slot is updated once per frame of NUM_NOTES clocks, so a note of
+frequency f needs a phase increment of f * 2**32 / (clk / slots).
+
+The firmware header also gets Q30 ratio tables for pitch bend and MIDI
+Tuning Standard fractions. A 14-bit value v is split into its two 7-bit
+MIDI bytes and scales a word by coarse[v >> 7] * fine[v & 0x7F], so the
+control path needs no floating point.
+
+The engine clock and slot count are read from synth_pkg.vhd unless given
+on the command line. Run from anywhere:
+
+    python3 src/tools/gen_tuning.py [--clk HZ] [--slots N] [--a4 HZ] [--bend N]
+
+REVISION HISTORY:
+
+Ver   Who    Date     Changes
+----- ------ -------- -----------------------------------------------------
+0.00  agt    10/19/26 Initial file
+0.01  agt    10/19/26 Add Q30 pitch bend and tuning fraction tables
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SYNTH_PKG = os.path.join(ROOT, "hdl", "modules", "synth_engine", "synth_pkg.vhd")
+VHDL_OUT = os.path.join(ROOT, "hdl", "modules", "synth_engine", "music_note_pkg.vhd")
+C_OUT = os.path.join(ROOT, "sw", "midi", "pitch.h")
+
+PHASE_BITS = 32
+RATIO_Q = 30
+NUM_MIDI_NOTES = 128
+NOTE_NAMES = ["C", "Db", "D", "Eb", "E", "F", "Gb", "G", "Ab", "A", "Bb", "B"]
+
+
+def pkg_constant(text, name):
+    """Returns the value of a natural constant in synth_pkg.vhd."""
+    m = re.search(r"constant\s+%s\s*:\s*natural\s*:=\s*(\d+)\s*;" % name, text)
+    if not m:
+        sys.exit("gen_tuning: %s not found in %s" % (name, SYNTH_PKG))
+    return int(m.group(1))
+
+
+def note_word(note, clk_hz, slots, a4_hz):
+    """Phase increment of a MIDI note, truncated like the original tables."""
+    freq = a4_hz * 2.0 ** ((note - 69) / 12.0)
+    word = int(math.floor(freq * 2 ** PHASE_BITS * slots / clk_hz))
+    if word >= 2 ** PHASE_BITS:
+        sys.exit("gen_tuning: note %d is above the frame rate Nyquist limit" % note)
+    return word
+
+
+def ratio_tables(cents_per_step, offset):
+    """Q30 coarse and fine tables of 2**((v + offset) * cents_per_step / 1200)."""
+    def q(cents):
+        return int(round(2 ** (cents / 1200.0) * 2 ** RATIO_Q))
+    coarse = [q(((hi << 7) + offset) * cents_per_step) for hi in range(128)]
+    fine = [q(lo * cents_per_step) for lo in range(128)]
+    return coarse, fine
+
+
+def c_table(out, comment, name, values):
+    out.append("// " + comment)
+    out.append("static const u32 %s[128] = { \\" % name)
+    for row in range(0, 128, 8):
+        sep = ", \\" if row < 120 else "};"
+        out.append("  " + ", ".join("0x%08x" % v for v in values[row:row + 8]) + sep)
+    out.append("")
+
+
+def note_name(note):
+    return "%s_%d" % (NOTE_NAMES[note % 12], note // 12)
+
+
+def write_vhdl(words, clk_hz, slots, a4_hz):
+    names = [note_name(n) for n in range(NUM_MIDI_NOTES)]
+    width = max(len(n) for n in names)
+    out = []
+    out.append("----------------------------------------------------------------------------------")
+    out.append("-- Company: beepboop")
+    out.append("-- Engineer: Tyler Huddleston")
+    out.append("-- ")
+    out.append("-- Create Date: 02/28/2025")
+    out.append("-- Design Name: Synthesizer Engine")
+    out.append("-- Module Name: Music Note Package")
+    out.append("-- Description: ")
+    out.append("--   Contains constant and type definitions for music notes.")
+    out.append("--")
+    out.append("--   GENERATED by src/tools/gen_tuning.py, do not edit. The firmware pitch.h")
+    out.append("--   is generated from the same parameters.")
+    out.append("-- ")
+    out.append("----------------------------------------------------------------------------------")
+    out.append("")
+    out.append("library IEEE;")
+    out.append("  use IEEE.STD_LOGIC_1164.ALL;")
+    out.append("  use IEEE.NUMERIC_STD.ALL;")
+    out.append("")
+    out.append("library xil_defaultlib;")
+    out.append("  use xil_defaultlib.synth_pkg.all;")
+    out.append("")
+    out.append("package music_note_pkg is")
+    out.append("")
+    out.append("  -- parameters the tables were generated for, checked against synth_pkg")
+    out.append("  constant TUNING_CLK_HZ    : natural := %d;" % clk_hz)
+    out.append("  constant TUNING_NUM_NOTES : natural := %d;" % slots)
+    out.append("  constant TUNING_A4_MHZ    : natural := %d;" % round(a4_hz * 1000))
+    out.append("")
+    out.append("  -- note frequency word definitions")
+    for n in range(NUM_MIDI_NOTES):
+        out.append("  constant NOTE_WORD_%s : unsigned := x\"%08x\";" % (names[n].ljust(width), words[n]))
+    out.append("")
+    out.append("  -- phase increment lookup table array")
+    out.append("  constant ph_inc_lut : t_ph_inc_lut := (")
+    for n in range(NUM_MIDI_NOTES):
+        sep = "," if n < NUM_MIDI_NOTES - 1 else ""
+        out.append("    NOTE_WORD_%s%s" % (names[n], sep))
+    out.append("  );")
+    out.append("end music_note_pkg;")
+    out.append("")
+    out.append("package body music_note_pkg is")
+    out.append("    -- No implementation needed for a package with only constants")
+    out.append("end music_note_pkg;")
+    out.append("")
+    return "\n".join(out)
+
+
+def write_c(words, clk_hz, slots, a4_hz, bend_range):
+    out = []
+    out.append("#ifndef PITCH_H")
+    out.append("#define PITCH_H")
+    out.append("")
+    out.append("/*")
+    out.append(" * GENERATED by src/tools/gen_tuning.py, do not edit. The engine")
+    out.append(" * music_note_pkg.vhd is generated from the same parameters.")
+    out.append(" */")
+    out.append("")
+    out.append("/***************************************************************************")
+    out.append("* Include files")
+    out.append("****************************************************************************/")
+    out.append("")
+    out.append("#include \"xil_types.h\"")
+    out.append("")
+    out.append("/***************************************************************************")
+    out.append("* Constant definitions")
+    out.append("****************************************************************************/")
+    out.append("")
+    out.append("#define PITCH_BEND_RANGE %d  // ±%d semitones" % (bend_range, bend_range))
+    out.append("#define PITCH_BEND_CENTER 0x2000")
+    out.append("")
+    out.append("// ratio tables are unsigned Q%d, 1.0 is 1 << PITCH_RATIO_Q" % RATIO_Q)
+    out.append("#define PITCH_RATIO_Q    %d" % RATIO_Q)
+    out.append("")
+    out.append("// engine clock, note slots and reference pitch the tables are built for")
+    out.append("#define TUNING_CLK_HZ    %d" % clk_hz)
+    out.append("#define TUNING_NUM_NOTES %d" % slots)
+    out.append("#define TUNING_A4_HZ     %s" % repr(float(a4_hz)))
+    out.append("#define TUNING_FRAME_HZ  ((double)TUNING_CLK_HZ / TUNING_NUM_NOTES)")
+    out.append("")
+    out.append("// pre-computed frequency words, one per MIDI note")
+    out.append("static const u32 FreqWordDefaults[128] = { \\")
+    for n in range(NUM_MIDI_NOTES):
+        sep = ", \\" if n < NUM_MIDI_NOTES - 1 else "};"
+        out.append("  0x%08x%s" % (words[n], sep))
+    out.append("")
+    bend_coarse, bend_fine = ratio_tables(bend_range * 100.0 / 8192, -8192)
+    tune_coarse, tune_fine = ratio_tables(100.0 / 16384, 0)
+    c_table(out, "pitch bend ratio by bend MSB, centered on 0x40", "BendRatioCoarse", bend_coarse)
+    c_table(out, "pitch bend ratio by bend LSB", "BendRatioFine", bend_fine)
+    c_table(out, "tuning fraction ratio by the MSB of a 14-bit semitone fraction", "TuneRatioCoarse", tune_coarse)
+    c_table(out, "tuning fraction ratio by the LSB", "TuneRatioFine", tune_fine)
+    out.append("#endif /* PITCH_H */")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    with open(SYNTH_PKG) as f:
+        pkg = f.read()
+
+    parser = argparse.ArgumentParser(description="Generate the synth tuning tables.")
+    parser.add_argument("--clk", type=float, default=pkg_constant(pkg, "SYNTH_CLK_HZ"),
+                        help="engine clock in Hz (default: SYNTH_CLK_HZ from synth_pkg)")
+    parser.add_argument("--slots", type=int, default=pkg_constant(pkg, "NUM_NOTES"),
+                        help="note slots per frame (default: NUM_NOTES from synth_pkg)")
+    parser.add_argument("--a4", type=float, default=440.0, help="A4 reference in Hz")
+    parser.add_argument("--bend", type=int, default=2, help="pitch bend range in semitones")
+    parser.add_argument("--check", action="store_true",
+                        help="fail if the checked in files are out of date")
+    args = parser.parse_args()
+
+    clk_hz = int(round(args.clk))
+    words = [note_word(n, clk_hz, args.slots, args.a4) for n in range(NUM_MIDI_NOTES)]
+    outputs = {
+        VHDL_OUT: write_vhdl(words, clk_hz, args.slots, args.a4),
+        C_OUT: write_c(words, clk_hz, args.slots, args.a4, args.bend),
+    }
+
+    stale = []
+    for path, text in outputs.items():
+        old = None
+        if os.path.exists(path):
+            with open(path, encoding="utf-8") as f:
+                old = f.read()
+        if old != text:
+            stale.append(os.path.relpath(path, ROOT))
+            if not args.check:
+                with open(path, "w", encoding="utf-8") as f:
+                    f.write(text)
+
+    if args.check and stale:
+        sys.exit("gen_tuning: out of date, rerun src/tools/gen_tuning.py: " + ", ".join(stale))
+    for path in stale:
+        print("gen_tuning: wrote " + path)
+
+
+if __name__ == "__main__":
+    main()
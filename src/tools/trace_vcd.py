@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+trace_vcd.py
+
+Turns a pipeline trace capture into a VCD for a waveform viewer. The
+capture is the buffer of the pipeline trace in synth_engine, read over
+AXI by pipeline_trace_tb or by "zcon.py trace".
+
+A capture file has a header line with the trace control and status words,
+then one entry a line in hex, oldest first:
+
+  ctrl 0x00003914 status 0x04000004
+  01390000
+  ...
+
+Only the entries the status counts are used. Each entry is one slot on one
+engine clock, so a frame trace is one entry a clock and a slot trace is one
+entry a frame, 128 clocks apart. The VCD has the note index, the cycle
+start flag, the adsr state and the sample, as a vector and as a real for
+an analog view.
+
+Usage:
+  trace_vcd.py CAPTURE [--out FILE.vcd]
+
+Only the Python standard library is used.
+
+REVISION HISTORY:
+
+Ver   Who    Date     Changes
+----- ------ -------- -----------------------------------------------------
+0.00  agt    10/19/26 Initial file
+"""
+
+import argparse
+import os
+import sys
+
+# synth_pkg.vhd
+ENGINE_CLK_HZ = 12288000
+NUM_NOTES = 128
+TRACE_DEPTH = 1024
+TRACE_FRAME = 1
+TRACE_TRIG_LSB = 2
+TRACE_STATE_LSB = 4
+TRACE_SLOT_LSB = 8
+TRACE_LEVEL_LSB = 16
+TRACE_DONE = 2
+TRACE_COUNT_LSB = 16
+TRACE_NOTE_LSB = 16
+TRACE_CYCLE_BIT = 23
+TRACE_ADSR_LSB = 24
+
+ADSR_STATES = ["start", "attack", "decay", "sustain", "release"]
+TRIGGERS = ["now", "state", "level", "never"]
+
+PS_PER_CLOCK = 1e12 / ENGINE_CLK_HZ
+
+
+class TraceError(Exception):
+    pass
+
+
+def decode(word):
+    """Note index, cycle start, adsr state and signed sample of an entry."""
+    sample = word & 0xFFFF
+    if sample & 0x8000:
+        sample -= 0x10000
+    return ((word >> TRACE_NOTE_LSB) & 0x7F,
+            (word >> TRACE_CYCLE_BIT) & 1,
+            (word >> TRACE_ADSR_LSB) & 0x7,
+            sample)
+
+
+def entry_count(status):
+    return (status >> TRACE_COUNT_LSB) & (2 * TRACE_DEPTH - 1)
+
+
+def describe(ctrl):
+    trig = TRIGGERS[(ctrl >> TRACE_TRIG_LSB) & 3]
+    text = "%s trace of slot %d, trigger %s" % (
+        "frame" if ctrl & (1 << TRACE_FRAME) else "slot",
+        (ctrl >> TRACE_SLOT_LSB) & 0x7F, trig)
+    if trig == "state":
+        state = (ctrl >> TRACE_STATE_LSB) & 0x7
+        text += " %s" % (ADSR_STATES[state] if state < len(ADSR_STATES) else state)
+    elif trig == "level":
+        text += " %d" % ((ctrl >> TRACE_LEVEL_LSB) & 0xFFFF)
+    return text
+
+
+def load(path):
+    """Control word, status word and the counted entries of a capture."""
+    with open(path) as f:
+        lines = [line.split() for line in f if line.strip()]
+    if not lines or len(lines[0]) != 4 or lines[0][0] != "ctrl" or lines[0][2] != "status":
+        raise TraceError("%s: no ctrl and status header" % path)
+    ctrl, status = int(lines[0][1], 16), int(lines[0][3], 16)
+    words = [int(line[0], 16) for line in lines[1:]]
+    count = entry_count(status)
+    if count > len(words):
+        raise TraceError("%s: status counts %d entries, %d in the file" % (path, count, len(words)))
+    return ctrl, status, words[:count]
+
+
+def save(path, ctrl, status, words):
+    """Capture file in the pipeline_trace_tb format."""
+    with open(path, "w") as f:
+        f.write("ctrl 0x%08X status 0x%08X\n" % (ctrl, status))
+        for w in words:
+            f.write("%08X\n" % w)
+
+
+def write_vcd(f, ctrl, words):
+    clocks = 1 if ctrl & (1 << TRACE_FRAME) else NUM_NOTES
+    signals = [("!", 7, "note_index"), ('"', 1, "cycle_start"),
+               ("#", 3, "adsr_state"), ("$", 16, "sample")]
+
+    f.write("$comment %s, %d entries $end\n" % (describe(ctrl), len(words)))
+    f.write("$comment adsr_state %s $end\n" %
+            ", ".join("%d %s" % s for s in enumerate(ADSR_STATES)))
+    f.write("$timescale 1 ps $end\n")
+    f.write("$scope module pipeline_trace $end\n")
+    for code, width, name in signals:
+        f.write("$var wire %d %s %s $end\n" % (width, code, name))
+    f.write("$var real 64 % sample_real $end\n")
+    f.write("$upscope $end\n$enddefinitions $end\n")
+
+    last = None
+    for k, word in enumerate(words):
+        values = decode(word)
+        f.write("#%d\n" % round(k * clocks * PS_PER_CLOCK))
+        if k == 0:
+            f.write("$dumpvars\n")
+        for i, (code, width, _) in enumerate(signals):
+            if last is None or values[i] != last[i]:
+                f.write("b%s %s\n" % (format(values[i] & ((1 << width) - 1), "b"), code))
+        if last is None or values[3] != last[3]:
+            f.write("r%d %%\n" % values[3])
+        if k == 0:
+            f.write("$end\n")
+        last = values
+    f.write("#%d\n" % round(len(words) * clocks * PS_PER_CLOCK))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Pipeline trace capture to VCD")
+    ap.add_argument("capture")
+    ap.add_argument("--out", help="default is the capture name with .vcd")
+    args = ap.parse_args()
+
+    try:
+        ctrl, status, words = load(args.capture)
+    except (OSError, ValueError, TraceError) as e:
+        sys.exit("trace_vcd: %s" % e)
+    out = args.out or os.path.splitext(args.capture)[0] + ".vcd"
+    with open(out, "w") as f:
+        write_vcd(f, ctrl, words)
+    print("%s: %s, %d entries%s" % (out, describe(ctrl), len(words),
+                                    "" if status & (1 << TRACE_DONE) else ", not done"))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,406 @@
+#!/usr/bin/env python3
+"""
+zcon.py
+
+Host side of the binary console on the debug UART. Peeks and pokes the
+engine registers, takes register snapshots, dumps the codec registers,
+reads the counters and latency histograms and uploads presets, without
+rebuilding the firmware. See src/sw/console/console.h for the frames and
+commands.
+
+Debug text from the firmware shares the UART. Anything outside a frame is
+passed through to stderr, and a frame that text landed in fails its CRC
+and the request is sent again.
+
+Usage:
+  zcon.py [--port DEV] [--baud N] COMMAND ...
+
+  ping
+  peek OFFSET [COUNT]           engine byte offset, words
+  poke OFFSET VALUE ...
+  snapshot [--out FILE]         every engine register
+  codec
+  counters
+  latency [--clear]
+  preset PROGRAM FILE.syx       a patch dump or preset store message
+  trace [--slot N] [--frame] [--trig now|state|level] [--state S]
+        [--level N] [--timeout S] [--out FILE]
+                                arm the pipeline trace, wait for the
+                                capture and write it as a VCD, or as a
+                                capture file if FILE is not .vcd
+  monitor                       show the debug text
+
+Only the Python standard library is used, the port is opened with termios.
+
+REVISION HISTORY:
+
+Ver   Who    Date     Changes
+----- ------ -------- -----------------------------------------------------
+0.00  agt    10/19/26 Initial file
+0.01  agt    10/19/26 Pipeline trace capture
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import termios
+import time
+
+import trace_vcd
+
+# console.h
+CMD_PING = 0x01
+CMD_READ = 0x02
+CMD_WRITE = 0x03
+CMD_CODEC = 0x04
+CMD_COUNTERS = 0x05
+CMD_LATENCY = 0x06
+CMD_PRESET = 0x07
+RESPONSE = 0x80
+LATENCY_CLEAR = 0x01
+MAX_WORDS = 128
+
+STATUS = {
+    0: "ok",
+    1: "unknown command",
+    2: "bad length",
+    3: "out of range",
+    4: "device did not answer",
+}
+
+COUNTERS = [
+    "i2c done", "i2c retries", "i2c timeouts", "i2c failed",
+    "midi stray bytes", "sysex overflows", "sysex aborts",
+    "coalesced", "early flushes",
+    "console frames", "console bad frames",
+    "boot ready (us)", "first note (us)",
+]
+
+# synth_ctrl.h and latency.h
+SYNTH_ADDR_SPAN = 0x1000
+SYNTH_TRACE_OFFSET = 0xE00
+REG_TRACE_CTRL = 0x200 + 4 * 112
+REG_TRACE_STAT = 0x200 + 4 * 113
+REG_TRACE_PAGE = 0x200 + 4 * 114
+LAT_NAMES = ["total", "isr to push", "push to parse", "parse to dispatch", "dispatch to write"]
+LAT_BUCKETS = 20
+LAT_BUCKET0_NS = 128
+
+# midi_sysex.h
+SYSEX_ID = bytes([0x7D, 0x5A])
+SYSEX_CMD_PATCH_DUMP = 0x01
+SYSEX_CMD_PRESET_STORE = 0x02
+SYSEX_PATCH_LEN = 19
+
+CODEC_NAMES = {
+    0: "left ADC volume", 1: "right ADC volume", 2: "left DAC volume",
+    3: "right DAC volume", 4: "analog path", 5: "digital path",
+    6: "power management", 7: "digital interface", 8: "sample rate",
+    9: "active", 16: "ALC control 1", 17: "ALC control 2", 18: "noise gate",
+}
+
+TRIES = 3
+TIMEOUT = 1.0
+
+
+class ConsoleError(Exception):
+    pass
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, as conCrc16."""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_at, code = 0, 1
+    for b in data:
+        if b == 0:
+            out[code_at] = code
+            code_at, code = len(out), 1
+            out.append(0)
+        else:
+            out.append(b)
+            code += 1
+            if code == 0xFF:
+                out[code_at] = code
+                code_at, code = len(out), 1
+                out.append(0)
+    out[code_at] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class Console:
+    """A console link over a serial port."""
+
+    def __init__(self, port, baud):
+        self.fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+        attrs = termios.tcgetattr(self.fd)
+        speed = getattr(termios, "B%d" % baud)
+        attrs[0] = 0                                    # iflag
+        attrs[1] = 0                                    # oflag
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[3] = 0                                    # lflag
+        attrs[4] = attrs[5] = speed
+        attrs[6][termios.VMIN] = 0
+        attrs[6][termios.VTIME] = 0
+        termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        termios.tcflush(self.fd, termios.TCIOFLUSH)
+        self.seq = 0
+        self.frame = None
+
+    def read_bytes(self, timeout):
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        return os.read(self.fd, 4096) if ready else b""
+
+    def frames(self, timeout):
+        """Yields received frames, passing the text between them through."""
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            for b in self.read_bytes(max(0.0, deadline - time.time())):
+                if b == 0:
+                    if self.frame:
+                        yield bytes(self.frame)
+                    self.frame = bytearray()
+                elif self.frame is not None:
+                    self.frame.append(b)
+                else:
+                    sys.stderr.write(chr(b))
+
+    def request(self, cmd, payload=b""):
+        """Sends a request and returns the response payload."""
+        self.seq = (self.seq + 1) & 0xFF
+        msg = bytes([cmd, self.seq]) + payload
+        frame = b"\x00" + cobs_encode(msg + struct.pack("<H", crc16(msg))) + b"\x00"
+
+        for _ in range(TRIES):
+            os.write(self.fd, frame)
+            for raw in self.frames(TIMEOUT):
+                self.frame = None
+                resp = cobs_decode(raw)
+                if resp is None or len(resp) < 5:
+                    continue
+                if crc16(resp[:-2]) != struct.unpack("<H", resp[-2:])[0]:
+                    continue
+                if resp[0] != cmd | RESPONSE or resp[1] != self.seq:
+                    continue
+                if resp[2] != 0:
+                    raise ConsoleError(STATUS.get(resp[2], "status %d" % resp[2]))
+                return resp[3:-2]
+            self.frame = None
+        raise ConsoleError("no response")
+
+    def read(self, offset, count):
+        words = []
+        while count > 0:
+            n = min(count, MAX_WORDS)
+            data = self.request(CMD_READ, struct.pack("<HB", offset, n))
+            words += struct.unpack("<%dI" % n, data)
+            offset += 4 * n
+            count -= n
+        return words
+
+
+def patch_to_preset(program, msg):
+    """Preset store message from a patch dump or preset store SysEx file."""
+    if msg[:1] == b"\xf0":
+        msg = msg[1:]
+    if msg[-1:] == b"\xf7":
+        msg = msg[:-1]
+    if msg[:2] != SYSEX_ID:
+        raise ConsoleError("not a synth SysEx message")
+    if msg[2] == SYSEX_CMD_PATCH_DUMP and len(msg) == 3 + SYSEX_PATCH_LEN + 1:
+        payload = msg[3:3 + SYSEX_PATCH_LEN]
+    elif msg[2] == SYSEX_CMD_PRESET_STORE and len(msg) == 3 + SYSEX_PATCH_LEN + 2:
+        payload = msg[4:4 + SYSEX_PATCH_LEN]
+    else:
+        raise ConsoleError("not a patch dump or preset store message")
+    payload = bytes([program]) + payload
+    checksum = (-sum(payload)) & 0x7F
+    return SYSEX_ID + bytes([SYSEX_CMD_PRESET_STORE]) + payload + bytes([checksum])
+
+
+def print_words(offset, words):
+    for i in range(0, len(words), 4):
+        row = " ".join("%08X" % w for w in words[i:i + 4])
+        print("%03X: %s" % (offset + 4 * i, row))
+
+
+def cmd_latency(con, clear):
+    data = con.request(CMD_LATENCY, bytes([LATENCY_CLEAR if clear else 0]))
+    per_hist = 4 + LAT_BUCKETS
+    values = struct.unpack("<%dI" % (len(data) // 4), data)
+    print("%-18s %7s %10s %10s %10s" % ("latency", "count", "min (ns)", "mean (ns)", "max (ns)"))
+    for p, name in enumerate(LAT_NAMES):
+        count, lo, hi, mean = values[p * per_hist:p * per_hist + 4]
+        buckets = values[p * per_hist + 4:(p + 1) * per_hist]
+        print("%-18s %7d %10d %10d %10d" % (name, count, lo, mean, hi))
+        for b, n in enumerate(buckets):
+            if n == 0:
+                continue
+            if b == LAT_BUCKETS - 1:
+                print("  >= %8d ns %7d" % (LAT_BUCKET0_NS << (b - 1), n))
+            else:
+                print("  <  %8d ns %7d" % (LAT_BUCKET0_NS << b, n))
+
+
+def write_words(con, offset, *values):
+    payload = struct.pack("<H%dI" % len(values), offset, *values)
+    con.request(CMD_WRITE, payload)
+
+
+def cmd_trace(con, args):
+    if not 0 <= args.level <= 0xFFFF:
+        raise ConsoleError("level is 16 bits")
+    trig = trace_vcd.TRIGGERS.index(args.trig)
+    state = trace_vcd.ADSR_STATES.index(args.state)
+    ctrl = (1 | (args.frame << trace_vcd.TRACE_FRAME) |
+            (trig << trace_vcd.TRACE_TRIG_LSB) |
+            (state << trace_vcd.TRACE_STATE_LSB) |
+            (args.slot << trace_vcd.TRACE_SLOT_LSB) |
+            (args.level << trace_vcd.TRACE_LEVEL_LSB))
+    write_words(con, REG_TRACE_CTRL, ctrl)
+    # arm is a command and reads back clear
+    ctrl &= ~1
+    print(trace_vcd.describe(ctrl), file=sys.stderr)
+
+    end = time.monotonic() + args.timeout
+    while True:
+        status = con.read(REG_TRACE_STAT, 1)[0]
+        if status & (1 << trace_vcd.TRACE_DONE) or time.monotonic() > end:
+            break
+        time.sleep(0.05)
+
+    # whatever was captured by the timeout is read, a page at a time
+    count = trace_vcd.entry_count(status)
+    words = []
+    for page in range((count + MAX_WORDS - 1) // MAX_WORDS):
+        write_words(con, REG_TRACE_PAGE, page)
+        words += con.read(SYNTH_TRACE_OFFSET, min(MAX_WORDS, count - len(words)))
+    if not status & (1 << trace_vcd.TRACE_DONE):
+        print("trace not done, %d entries" % count, file=sys.stderr)
+
+    out = args.out or "trace.vcd"
+    if out.endswith(".vcd"):
+        with open(out, "w") as f:
+            trace_vcd.write_vcd(f, ctrl, words)
+    else:
+        trace_vcd.save(out, ctrl, status, words)
+    print("%s: %d entries" % (out, len(words)))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Zynth debug UART console")
+    ap.add_argument("--port", default="/dev/ttyUSB1")
+    ap.add_argument("--baud", type=int, default=115200)
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    sub.add_parser("ping")
+    p = sub.add_parser("peek")
+    p.add_argument("offset", type=lambda s: int(s, 0))
+    p.add_argument("count", type=int, nargs="?", default=1)
+    p = sub.add_parser("poke")
+    p.add_argument("offset", type=lambda s: int(s, 0))
+    p.add_argument("values", type=lambda s: int(s, 0), nargs="+")
+    p = sub.add_parser("snapshot")
+    p.add_argument("--out")
+    sub.add_parser("codec")
+    sub.add_parser("counters")
+    p = sub.add_parser("latency")
+    p.add_argument("--clear", action="store_true")
+    p = sub.add_parser("preset")
+    p.add_argument("program", type=int)
+    p.add_argument("file")
+    p = sub.add_parser("trace")
+    p.add_argument("--slot", type=int, choices=range(128), default=0, metavar="0-127")
+    p.add_argument("--frame", action="store_true", help="every slot from a frame start")
+    p.add_argument("--trig", choices=trace_vcd.TRIGGERS[:3], default="now")
+    p.add_argument("--state", choices=trace_vcd.ADSR_STATES, default="attack")
+    p.add_argument("--level", type=lambda s: int(s, 0), default=0)
+    p.add_argument("--timeout", type=float, default=5.0)
+    p.add_argument("--out", help="default trace.vcd")
+    sub.add_parser("monitor")
+    args = ap.parse_args()
+
+    con = Console(args.port, args.baud)
+    try:
+        if args.cmd == "ping":
+            rev, date, words = struct.unpack("<IIH", con.request(CMD_PING))
+            print("engine rev %08X, date %08X, %d words a read" % (rev, date, words))
+
+        elif args.cmd == "peek":
+            print_words(args.offset, con.read(args.offset, args.count))
+
+        elif args.cmd == "poke":
+            if len(args.values) > MAX_WORDS:
+                raise ConsoleError("at most %d words a write" % MAX_WORDS)
+            write_words(con, args.offset, *args.values)
+
+        elif args.cmd == "snapshot":
+            words = con.read(0, SYNTH_ADDR_SPAN // 4)
+            if args.out:
+                with open(args.out, "w") as f:
+                    for i, w in enumerate(words):
+                        f.write("%03X %08X\n" % (4 * i, w))
+            else:
+                print_words(0, words)
+
+        elif args.cmd == "codec":
+            data = con.request(CMD_CODEC)
+            for i in range(0, len(data), 3):
+                reg, value = struct.unpack("<BH", data[i:i + 3])
+                print("R%-2d %-18s 0x%03X" % (reg, CODEC_NAMES.get(reg, ""), value))
+
+        elif args.cmd == "counters":
+            data = con.request(CMD_COUNTERS)
+            for i, value in enumerate(struct.unpack("<%dI" % (len(data) // 4), data)):
+                name = COUNTERS[i] if i < len(COUNTERS) else "counter %d" % i
+                print("%-20s %10d" % (name, value))
+
+        elif args.cmd == "latency":
+            cmd_latency(con, args.clear)
+
+        elif args.cmd == "preset":
+            with open(args.file, "rb") as f:
+                con.request(CMD_PRESET, patch_to_preset(args.program, f.read()))
+            print("preset %d stored" % args.program)
+
+        elif args.cmd == "trace":
+            cmd_trace(con, args)
+
+        elif args.cmd == "monitor":
+            while True:
+                for _ in con.frames(3600):
+                    pass
+
+    except ConsoleError as e:
+        sys.exit("zcon: %s" % e)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()